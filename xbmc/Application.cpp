@@ -1692,6 +1692,9 @@ bool CApplication::LoadSkin(const SkinPtr& skin)
   g_graphicsContext.SetMediaDir(skin->Path());
   g_directoryCache.ClearSubPaths(skin->Path());
 
+  // window files are read on the job manager while fonts, strings and includes load
+  g_SkinInfo->PreloadWindows();
+
   g_colorManager.Load(CSettings::GetInstance().GetString(CSettings::SETTING_LOOKANDFEEL_SKINCOLORS));
 
   g_fontManager.LoadFonts(CSettings::GetInstance().GetString(CSettings::SETTING_LOOKANDFEEL_FONT));
@@ -2025,8 +2028,8 @@ void CApplication::Render()
 
   // reset our info cache - we do this at the end of Render so that it is
   // fresh for the next process(), or after a windowclose animation (where process()
-  // isn't called)
-  g_infoManager.ResetCache();
+  // isn't called). Only conditions whose sources changed are re-evaluated.
+  g_infoManager.ResetChangedCache();
 
 
   unsigned int now = XbmcThreads::SystemClockMillis();
@@ -4291,6 +4294,26 @@ bool CApplication::OnMessage(CGUIMessage& message)
 
       if (m_pPlayer->IsPlayingAudio())
       {
+        // let the player get the upcoming songs ready before they are queued
+        if (g_advancedSettings.m_audioDecodeAhead > 0.0f)
+        {
+          CFileItemList prefetch;
+          for (int i = 1; i <= g_advancedSettings.m_audioDecodeAheadFiles; i++)
+          {
+            int next = g_playlistPlayer.GetNextSong(i);
+            if (next < 0 || next >= playList.size())
+              break;
+
+            // plugins and upnp items are resolved when they get queued, live streams can't be read ahead
+            CFileItemPtr item = playList[next];
+            if (!item->IsAudio() || item->IsVideo() || item->IsPlugin() || item->IsCDDA() ||
+                item->IsInternetStream() || URIUtils::IsUPnP(item->GetPath()))
+              continue;
+            prefetch.Add(CFileItemPtr(new CFileItem(*item)));
+          }
+          m_pPlayer->PrefetchFiles(prefetch);
+        }
+
         // Start our cdg parser as appropriate
 #ifdef HAS_KARAOKE
         if (m_pKaraokeMgr && CSettings::GetInstance().GetBool(CSettings::SETTING_KARAOKE_ENABLED) && !m_itemCurrentFile->IsInternetStream())
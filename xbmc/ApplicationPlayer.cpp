@@ -501,6 +501,13 @@ void CApplicationPlayer::OnNothingToQueueNotify()
     player->OnNothingToQueueNotify();
 }
 
+void CApplicationPlayer::PrefetchFiles(const CFileItemList &files)
+{
+  std::shared_ptr<IPlayer> player = GetInternal();
+  if (player)
+    player->PrefetchFiles(files);
+}
+
 void CApplicationPlayer::GetVideoStreamInfo(SPlayerVideoStreamInfo &info)
 {
   std::shared_ptr<IPlayer> player = GetInternal();
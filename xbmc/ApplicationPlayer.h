@@ -160,6 +160,7 @@ public:
   bool  OnAction(const CAction &action);
   void  OnNothingToQueueNotify();
   void  Pause();
+  void  PrefetchFiles(const CFileItemList &files);
   bool  QueueNextFile(const CFileItem &file);
   bool  Record(bool bOnOff);
   void  Seek(bool bPlus = true, bool bLargeStep = false, bool bChapterOverride = false);
@@ -124,7 +124,7 @@ CFileItem::CFileItem(const CEpgInfoTagPtr& tag)
   Initialize();
 
   m_bIsFolder = false;
-  m_epgInfoTag = tag;
+  PVRTags().m_epgInfoTag = tag;
   m_strPath = tag->Path();
   SetLabel(tag->Title());
   m_strLabel2 = tag->Plot();
@@ -148,7 +148,7 @@ CFileItem::CFileItem(const CPVRChannelPtr& channel)
 
   m_strPath = channel->Path();
   m_bIsFolder = false;
-  m_pvrChannelInfoTag = channel;
+  PVRTags().m_pvrChannelInfoTag = channel;
   SetLabel(channel->ChannelName());
   m_strLabel2 = epgNow ? epgNow->Title() :
       CSettings::GetInstance().GetBool(CSettings::SETTING_EPG_HIDENOINFOAVAILABLE) ?
@@ -189,7 +189,7 @@ CFileItem::CFileItem(const CPVRRecordingPtr& record)
   Initialize();
 
   m_bIsFolder = false;
-  m_pvrRecordingInfoTag = record;
+  PVRTags().m_pvrRecordingInfoTag = record;
   m_strPath = record->m_strFileNameAndPath;
   SetLabel(record->m_strTitle);
   m_strLabel2 = record->m_strPlot;
@@ -203,7 +203,7 @@ CFileItem::CFileItem(const CPVRTimerInfoTagPtr& timer)
   Initialize();
 
   m_bIsFolder = timer->IsRepeating();
-  m_pvrTimerInfoTag = timer;
+  PVRTags().m_pvrTimerInfoTag = timer;
   m_strPath = timer->Path();
   SetLabel(timer->Title());
   m_strLabel2 = timer->Summary();
@@ -381,11 +381,10 @@ const CFileItem& CFileItem::operator=(const CFileItem& item)
     m_pictureInfoTag = NULL;
   }
 
-  m_epgInfoTag = item.m_epgInfoTag;
-  m_pvrChannelInfoTag = item.m_pvrChannelInfoTag;
-  m_pvrRecordingInfoTag = item.m_pvrRecordingInfoTag;
-  m_pvrTimerInfoTag = item.m_pvrTimerInfoTag;
-  m_pvrRadioRDSInfoTag = item.m_pvrRadioRDSInfoTag;
+  if (item.m_pvrTags)
+    PVRTags() = *item.m_pvrTags;
+  else
+    m_pvrTags.reset();
 
   m_lStartOffset = item.m_lStartOffset;
   m_lStartPartNumber = item.m_lStartPartNumber;
@@ -450,11 +449,7 @@ void CFileItem::Reset()
   m_musicInfoTag=NULL;
   delete m_videoInfoTag;
   m_videoInfoTag=NULL;
-  m_epgInfoTag.reset();
-  m_pvrChannelInfoTag.reset();
-  m_pvrRecordingInfoTag.reset();
-  m_pvrTimerInfoTag.reset();
-  m_pvrRadioRDSInfoTag.reset();
+  m_pvrTags.reset();
   delete m_pictureInfoTag;
   m_pictureInfoTag=NULL;
   m_extrainfo.clear();
@@ -507,10 +502,10 @@ void CFileItem::Archive(CArchive& ar)
     }
     else
       ar << 0;
-    if (m_pvrRadioRDSInfoTag)
+    if (HasPVRRadioRDSInfoTag())
     {
       ar << 1;
-      ar << *m_pvrRadioRDSInfoTag;
+      ar << *m_pvrTags->m_pvrRadioRDSInfoTag;
     }
     else
       ar << 0;
@@ -559,7 +554,7 @@ void CFileItem::Archive(CArchive& ar)
       ar >> *GetVideoInfoTag();
     ar >> iType;
     if (iType == 1)
-      ar >> *m_pvrRadioRDSInfoTag;
+      ar >> *PVRTags().m_pvrRadioRDSInfoTag;
     ar >> iType;
     if (iType == 1)
       ar >> *GetPictureInfoTag();
@@ -587,8 +582,8 @@ void CFileItem::Serialize(CVariant& value) const
   if (m_videoInfoTag)
     (*m_videoInfoTag).Serialize(value["videoInfoTag"]);
 
-  if (m_pvrRadioRDSInfoTag)
-    m_pvrRadioRDSInfoTag->Serialize(value["rdsInfoTag"]);
+  if (HasPVRRadioRDSInfoTag())
+    m_pvrTags->m_pvrRadioRDSInfoTag->Serialize(value["rdsInfoTag"]);
 
   if (m_pictureInfoTag)
     (*m_pictureInfoTag).Serialize(value["pictureInfoTag"]);
@@ -742,12 +737,12 @@ bool CFileItem::IsPVRRecording() const
 
 bool CFileItem::IsUsablePVRRecording() const
 {
-  return (m_pvrRecordingInfoTag && !m_pvrRecordingInfoTag->IsDeleted());
+  return (HasPVRRecordingInfoTag() && !m_pvrTags->m_pvrRecordingInfoTag->IsDeleted());
 }
 
 bool CFileItem::IsDeletedPVRRecording() const
 {
-  return (m_pvrRecordingInfoTag && m_pvrRecordingInfoTag->IsDeleted());
+  return (HasPVRRecordingInfoTag() && m_pvrTags->m_pvrRecordingInfoTag->IsDeleted());
 }
 
 bool CFileItem::IsPVRTimer() const
@@ -1291,8 +1286,8 @@ void CFileItem::FillInMimeType(bool lookup /*= true*/)
   {
     if( m_bIsFolder )
       m_mimetype = "x-directory/normal";
-    else if( m_pvrChannelInfoTag )
-      m_mimetype = m_pvrChannelInfoTag->InputFormat();
+    else if( HasPVRChannelInfoTag() )
+      m_mimetype = m_pvrTags->m_pvrChannelInfoTag->InputFormat();
     else if( StringUtils::StartsWithNoCase(m_strPath, "shout://")
           || StringUtils::StartsWithNoCase(m_strPath, "http://")
           || StringUtils::StartsWithNoCase(m_strPath, "https://"))
@@ -1390,8 +1385,8 @@ void CFileItem::UpdateInfo(const CFileItem &item, bool replaceLabels /*=true*/)
   { // copy info across (TODO: premiered info is normally stored in m_dateTime by the db)
     *GetVideoInfoTag() = *item.GetVideoInfoTag();
     // preferably use some information from PVR info tag if available
-    if (m_pvrRecordingInfoTag)
-      m_pvrRecordingInfoTag->CopyClientInfo(GetVideoInfoTag());
+    if (HasPVRRecordingInfoTag())
+      m_pvrTags->m_pvrRecordingInfoTag->CopyClientInfo(GetVideoInfoTag());
     SetOverlayImage(ICON_OVERLAY_UNWATCHED, GetVideoInfoTag()->m_playCount > 0);
     SetInvalid();
   }
@@ -1402,7 +1397,7 @@ void CFileItem::UpdateInfo(const CFileItem &item, bool replaceLabels /*=true*/)
   }
   if (item.HasPVRRadioRDSInfoTag())
   {
-    m_pvrRadioRDSInfoTag = item.m_pvrRadioRDSInfoTag;
+    PVRTags().m_pvrRadioRDSInfoTag = item.m_pvrTags->m_pvrRadioRDSInfoTag;
     SetInvalid();
   }
   if (item.HasPictureInfoTag())
@@ -2889,8 +2884,8 @@ std::string CFileItem::GetMovieName(bool bUseFolderNames /* = false */) const
   if (IsLabelPreformated())
     return GetLabel();
 
-  if (m_pvrRecordingInfoTag)
-    return m_pvrRecordingInfoTag->m_strTitle;
+  if (HasPVRRecordingInfoTag())
+    return m_pvrTags->m_pvrRecordingInfoTag->m_strTitle;
   else if (CUtil::IsTVRecording(m_strPath))
   {
     std::string title = CPVRRecording::GetTitleFromURL(m_strPath);
@@ -3289,15 +3284,15 @@ int CFileItem::GetVideoContentType() const
 bool CFileItem::IsResumePointSet() const
 {
   return (HasVideoInfoTag() && GetVideoInfoTag()->m_resumePoint.IsSet()) ||
-      (m_pvrRecordingInfoTag && m_pvrRecordingInfoTag->GetLastPlayedPosition() > 0);
+      (HasPVRRecordingInfoTag() && m_pvrTags->m_pvrRecordingInfoTag->GetLastPlayedPosition() > 0);
 }
 
 double CFileItem::GetCurrentResumeTime() const
 {
-  if (m_pvrRecordingInfoTag)
+  if (HasPVRRecordingInfoTag())
   {
     // This will retrieve 'fresh' resume information from the PVR server
-    int rc = m_pvrRecordingInfoTag->GetLastPlayedPosition();
+    int rc = m_pvrTags->m_pvrRecordingInfoTag->GetLastPlayedPosition();
     if (rc > 0)
       return rc;
     // Fall through to default value
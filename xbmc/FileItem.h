@@ -267,62 +267,64 @@ public:
 
   inline bool HasEPGInfoTag() const
   {
-    return m_epgInfoTag.get() != NULL;
+    return m_pvrTags && m_pvrTags->m_epgInfoTag.get() != NULL;
   }
 
   inline const EPG::CEpgInfoTagPtr GetEPGInfoTag() const
   {
-    return m_epgInfoTag;
+    return m_pvrTags ? m_pvrTags->m_epgInfoTag : EPG::CEpgInfoTagPtr();
   }
 
   inline void SetEPGInfoTag(const EPG::CEpgInfoTagPtr& tag)
   {
-    m_epgInfoTag = tag;
+    if (tag || m_pvrTags)
+      PVRTags().m_epgInfoTag = tag;
   }
 
   inline bool HasPVRChannelInfoTag() const
   {
-    return m_pvrChannelInfoTag.get() != NULL;
+    return m_pvrTags && m_pvrTags->m_pvrChannelInfoTag.get() != NULL;
   }
 
   inline const PVR::CPVRChannelPtr GetPVRChannelInfoTag() const
   {
-    return m_pvrChannelInfoTag;
+    return m_pvrTags ? m_pvrTags->m_pvrChannelInfoTag : PVR::CPVRChannelPtr();
   }
 
   inline bool HasPVRRecordingInfoTag() const
   {
-    return m_pvrRecordingInfoTag.get() != NULL;
+    return m_pvrTags && m_pvrTags->m_pvrRecordingInfoTag.get() != NULL;
   }
 
   inline const PVR::CPVRRecordingPtr GetPVRRecordingInfoTag() const
   {
-    return m_pvrRecordingInfoTag;
+    return m_pvrTags ? m_pvrTags->m_pvrRecordingInfoTag : PVR::CPVRRecordingPtr();
   }
 
   inline bool HasPVRTimerInfoTag() const
   {
-    return m_pvrTimerInfoTag != NULL;
+    return m_pvrTags && m_pvrTags->m_pvrTimerInfoTag != NULL;
   }
 
   inline const PVR::CPVRTimerInfoTagPtr GetPVRTimerInfoTag() const
   {
-    return m_pvrTimerInfoTag;
+    return m_pvrTags ? m_pvrTags->m_pvrTimerInfoTag : PVR::CPVRTimerInfoTagPtr();
   }
 
   inline bool HasPVRRadioRDSInfoTag() const
   {
-    return m_pvrRadioRDSInfoTag.get() != NULL;
+    return m_pvrTags && m_pvrTags->m_pvrRadioRDSInfoTag.get() != NULL;
   }
 
   inline const PVR::CPVRRadioRDSInfoTagPtr GetPVRRadioRDSInfoTag() const
   {
-    return m_pvrRadioRDSInfoTag;
+    return m_pvrTags ? m_pvrTags->m_pvrRadioRDSInfoTag : PVR::CPVRRadioRDSInfoTagPtr();
   }
 
   inline void SetPVRRadioRDSInfoTag(const PVR::CPVRRadioRDSInfoTagPtr& tag)
   {
-    m_pvrRadioRDSInfoTag = tag;
+    if (tag || m_pvrTags)
+      PVRTags().m_pvrRadioRDSInfoTag = tag;
   }
 
   /*!
@@ -506,24 +508,40 @@ private:
    */
   void Initialize();
 
+  /*! \brief EPG and PVR tags, only allocated for the (few) items that have any of them
+   */
+  struct CPVRTags
+  {
+    EPG::CEpgInfoTagPtr m_epgInfoTag;
+    PVR::CPVRChannelPtr m_pvrChannelInfoTag;
+    PVR::CPVRRecordingPtr m_pvrRecordingInfoTag;
+    PVR::CPVRTimerInfoTagPtr m_pvrTimerInfoTag;
+    PVR::CPVRRadioRDSInfoTagPtr m_pvrRadioRDSInfoTag;
+  };
+
+  /*! \brief Retrieve the EPG and PVR tags of the item, allocating them if need be
+   */
+  CPVRTags &PVRTags()
+  {
+    if (!m_pvrTags)
+      m_pvrTags.reset(new CPVRTags);
+    return *m_pvrTags;
+  }
+
   std::string m_strPath;            ///< complete path to item
 
   SortSpecial m_specialSort;
   bool m_bIsParentFolder;
   bool m_bCanQueue;
   bool m_bLabelPreformated;
+  bool m_doContentLookup;
+  bool m_bIsAlbum;
   std::string m_mimetype;
   std::string m_extrainfo;
-  bool m_doContentLookup;
   MUSIC_INFO::CMusicInfoTag* m_musicInfoTag;
   CVideoInfoTag* m_videoInfoTag;
-  EPG::CEpgInfoTagPtr m_epgInfoTag;
-  PVR::CPVRChannelPtr m_pvrChannelInfoTag;
-  PVR::CPVRRecordingPtr m_pvrRecordingInfoTag;
-  PVR::CPVRTimerInfoTagPtr m_pvrTimerInfoTag;
-  PVR::CPVRRadioRDSInfoTagPtr m_pvrRadioRDSInfoTag;
   CPictureInfoTag* m_pictureInfoTag;
-  bool m_bIsAlbum;
+  std::unique_ptr<CPVRTags> m_pvrTags;
 
   CCueDocumentPtr m_cueDocument;
 };
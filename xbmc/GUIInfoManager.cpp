@@ -132,6 +132,10 @@ CGUIInfoManager::CGUIInfoManager(void) :
   m_playerShowCodec = false;
   m_playerShowInfo = false;
   m_fps = 0.0f;
+  m_changedSources = INFO_SOURCE_ALL;
+  m_infoBoolUpdates = 0;
+  m_playerWasPlaying = false;
+  m_lastMinuteOfDay = -1;
   ResetLibraryBools();
 }
 
@@ -2374,14 +2378,6 @@ bool CGUIInfoManager::GetInt(int &value, int info, int contextWindow, const CGUI
   return false;
 }
 
-// functor for comparison InfoPtr's
-struct InfoBoolFinder
-{
-  InfoBoolFinder(const std::string &expression, int context) : m_bool(expression, context) {};
-  bool operator() (const InfoPtr &right) const { return m_bool == *right; };
-  InfoBool m_bool;
-};
-
 INFO::InfoPtr CGUIInfoManager::Register(const std::string &expression, int context)
 {
   std::string condition(CGUIInfoLabel::ReplaceLocalize(expression));
@@ -2390,18 +2386,29 @@ INFO::InfoPtr CGUIInfoManager::Register(const std::string &expression, int conte
   if (condition.empty())
     return INFO::InfoPtr();
 
+  // info bools compare their expressions in lower case
+  std::pair<std::string, int> key(condition, context);
+  StringUtils::ToLower(key.first);
+
   CSingleLock lock(m_critInfo);
   // do we have the boolean expression already registered?
-  std::vector<InfoPtr>::const_iterator i = std::find_if(m_bools.begin(), m_bools.end(), InfoBoolFinder(condition, context));
-  if (i != m_bools.end())
-    return *i;
+  std::map<std::pair<std::string, int>, std::weak_ptr<InfoBool> >::const_iterator i = m_boolIndex.find(key);
+  if (i != m_boolIndex.end())
+  {
+    InfoPtr info = i->second.lock();
+    if (info)
+      return info;
+  }
 
+  InfoPtr info;
   if (condition.find_first_of("|+[]!") != condition.npos)
-    m_bools.push_back(std::make_shared<InfoExpression>(condition, context));
+    info = std::make_shared<InfoExpression>(condition, context);
   else
-    m_bools.push_back(std::make_shared<InfoSingle>(condition, context));
+    info = std::make_shared<InfoSingle>(condition, context);
 
-  return m_bools.back();
+  m_bools.push_back(info);
+  m_boolIndex[key] = info;
+  return info;
 }
 
 bool CGUIInfoManager::EvaluateBool(const std::string &expression, int contextWindow)
@@ -4816,6 +4823,16 @@ void CGUIInfoManager::Clear()
   // log which ones are used - they should all be gone by now
   for (std::vector<InfoPtr>::const_iterator i = m_bools.begin(); i != m_bools.end(); ++i)
     CLog::Log(LOGDEBUG, "Infobool '%s' still used by %u instances", (*i)->GetExpression().c_str(), (unsigned int) i->use_count());
+  for (std::map<std::pair<std::string, int>, std::weak_ptr<InfoBool> >::iterator i = m_boolIndex.begin(); i != m_boolIndex.end(); )
+  {
+    if (i->second.expired())
+      m_boolIndex.erase(i++);
+    else
+      ++i;
+  }
+
+  // whatever survived is evaluated against the new skin
+  m_changedSources = INFO_SOURCE_ALL;
 }
 
 void CGUIInfoManager::UpdateFPS()
@@ -5993,6 +6010,151 @@ void CGUIInfoManager::ResetCache()
     (*i)->SetDirty();
 }
 
+void CGUIInfoManager::ResetChangedCache()
+{
+  m_containerMoves.clear();
+
+  // no change notification for these, poll them every frame
+  unsigned int sources = INFO_SOURCE_LIST | INFO_SOURCE_GUI | INFO_SOURCE_SYSTEM;
+
+  // player state changes all the time while playing, and is constant when not
+  bool playing = g_application.m_pPlayer->IsPlaying();
+  if (playing || m_playerWasPlaying)
+    sources |= INFO_SOURCE_PLAYER;
+  m_playerWasPlaying = playing;
+
+  // time conditions have a resolution of a minute
+  int minuteOfDay = CDateTime::GetCurrentDateTime().GetMinuteOfDay();
+  if (minuteOfDay != m_lastMinuteOfDay)
+  {
+    sources |= INFO_SOURCE_TIME;
+    m_lastMinuteOfDay = minuteOfDay;
+  }
+
+  CSingleLock lock(m_critInfo);
+  sources |= m_changedSources;
+  m_changedSources = INFO_SOURCE_NONE;
+  for (std::vector<InfoPtr>::iterator i = m_bools.begin(); i != m_bools.end(); ++i)
+  {
+    if ((*i)->GetSources() & sources)
+      (*i)->SetDirty();
+  }
+  m_infoBoolUpdates = InfoBool::ResetUpdateCount();
+}
+
+void CGUIInfoManager::PublishChange(unsigned int sources)
+{
+  CSingleLock lock(m_critInfo);
+  m_changedSources |= sources;
+}
+
+unsigned int CGUIInfoManager::GetInfoSources(int condition) const
+{
+  condition = abs(condition);
+
+  if (condition >= LISTITEM_START && condition < LISTITEM_END)
+    return INFO_SOURCE_LIST | INFO_SOURCE_GUI;
+
+  if (condition >= MULTI_INFO_START && condition <= MULTI_INFO_END)
+  {
+    switch (abs(m_multiInfo[condition - MULTI_INFO_START].m_info))
+    {
+    case SKIN_BOOL:
+    case SKIN_STRING:
+    case SKIN_HAS_THEME:
+      return INFO_SOURCE_SKIN;
+    case SYSTEM_TIME:
+    case SYSTEM_DATE:
+      return INFO_SOURCE_TIME;
+    default:
+      return INFO_SOURCE_ALL;
+    }
+  }
+
+  switch (condition)
+  {
+  case SYSTEM_ALWAYS_TRUE:
+  case SYSTEM_ALWAYS_FALSE:
+  case SYSTEM_ETHERNET_LINK_ACTIVE:
+  case SYSTEM_PLATFORM_LINUX:
+  case SYSTEM_PLATFORM_WINDOWS:
+  case SYSTEM_PLATFORM_DARWIN:
+  case SYSTEM_PLATFORM_DARWIN_OSX:
+  case SYSTEM_PLATFORM_DARWIN_IOS:
+  case SYSTEM_PLATFORM_DARWIN_ATV2:
+  case SYSTEM_PLATFORM_ANDROID:
+  case SYSTEM_PLATFORM_LINUX_RASPBERRY_PI:
+  case SYSTEM_HAS_PVR:
+  case SYSTEM_HAS_ADSP:
+    return INFO_SOURCE_NONE;
+  case LIBRARY_HAS_MUSIC:
+  case LIBRARY_HAS_MOVIES:
+  case LIBRARY_HAS_MOVIE_SETS:
+  case LIBRARY_HAS_TVSHOWS:
+  case LIBRARY_HAS_MUSICVIDEOS:
+  case LIBRARY_HAS_SINGLES:
+  case LIBRARY_HAS_COMPILATIONS:
+    return INFO_SOURCE_LIBRARY;
+  // the conditions only evaluated while playing, see GetBool()
+  case PLAYER_HAS_MEDIA:
+  case PLAYER_HAS_AUDIO:
+  case PLAYER_HAS_VIDEO:
+  case PLAYER_PLAYING:
+  case PLAYER_PAUSED:
+  case PLAYER_REWINDING:
+  case PLAYER_FORWARDING:
+  case PLAYER_REWINDING_2x:
+  case PLAYER_REWINDING_4x:
+  case PLAYER_REWINDING_8x:
+  case PLAYER_REWINDING_16x:
+  case PLAYER_REWINDING_32x:
+  case PLAYER_FORWARDING_2x:
+  case PLAYER_FORWARDING_4x:
+  case PLAYER_FORWARDING_8x:
+  case PLAYER_FORWARDING_16x:
+  case PLAYER_FORWARDING_32x:
+  case PLAYER_CAN_RECORD:
+  case PLAYER_CAN_PAUSE:
+  case PLAYER_CAN_SEEK:
+  case PLAYER_RECORDING:
+  case PLAYER_DISPLAY_AFTER_SEEK:
+  case PLAYER_CACHING:
+  case PLAYER_SEEKBAR:
+  case PLAYER_SEEKING:
+  case PLAYER_SHOWTIME:
+  case PLAYER_PASSTHROUGH:
+  case PLAYER_ISINTERNETSTREAM:
+  case PLAYER_HASDURATION:
+  case MUSICPM_ENABLED:
+  case MUSICPLAYER_HASPREVIOUS:
+  case MUSICPLAYER_HASNEXT:
+  case MUSICPLAYER_PLAYLISTPLAYING:
+  case VIDEOPLAYER_USING_OVERLAYS:
+  case VIDEOPLAYER_ISFULLSCREEN:
+  case VIDEOPLAYER_HASMENU:
+  case VIDEOPLAYER_HASTELETEXT:
+  case VIDEOPLAYER_HASSUBTITLES:
+  case VIDEOPLAYER_SUBTITLESENABLED:
+  case VIDEOPLAYER_HAS_EPG:
+  case VIDEOPLAYER_IS_STEREOSCOPIC:
+  case VIDEOPLAYER_CAN_RESUME_LIVE_TV:
+  case PLAYLIST_ISRANDOM:
+  case PLAYLIST_ISREPEAT:
+  case PLAYLIST_ISREPEATONE:
+  case VISUALISATION_LOCKED:
+  case VISUALISATION_ENABLED:
+  case VISUALISATION_HAS_PRESETS:
+  case RDS_HAS_RDS:
+  case RDS_HAS_RADIOTEXT:
+  case RDS_HAS_RADIOTEXT_PLUS:
+  case RDS_HAS_HOTLINE_DATA:
+  case RDS_HAS_STUDIO_DATA:
+    return INFO_SOURCE_PLAYER;
+  default:
+    return INFO_SOURCE_ALL;
+  }
+}
+
 std::string CGUIInfoManager::GetPictureLabel(int info)
 {
   if (info == SLIDE_FILE_NAME)
@@ -6160,6 +6322,7 @@ void CGUIInfoManager::SetLibraryBool(int condition, bool value)
     default:
       break;
   }
+  PublishChange(INFO_SOURCE_LIBRARY);
 }
 
 void CGUIInfoManager::ResetLibraryBools()
@@ -6171,6 +6334,7 @@ void CGUIInfoManager::ResetLibraryBools()
   m_libraryHasMovieSets = -1;
   m_libraryHasSingles = -1;
   m_libraryHasCompilations = -1;
+  PublishChange(INFO_SOURCE_LIBRARY);
 }
 
 bool CGUIInfoManager::GetLibraryBool(int condition)
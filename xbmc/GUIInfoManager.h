@@ -102,6 +102,7 @@ private:
 class CGUIInfoManager : public IMsgTargetCallback, public Observable,
                         public KODI::MESSAGING::IMessageTarget
 {
+  friend class TestGUIInfoManager;
 public:
   CGUIInfoManager(void);
   virtual ~CGUIInfoManager(void);
@@ -206,7 +207,30 @@ public:
   void SetNextWindow(int windowID) { m_nextWindowID = windowID; };
   void SetPreviousWindow(int windowID) { m_prevWindowID = windowID; };
 
+  /*! \brief Mark all registered info bools dirty
+   \sa ResetChangedCache
+   */
   void ResetCache();
+
+  /*! \brief Mark the info bools dirty whose sources changed since the last call
+   Called at the end of each frame. Sources that don't publish their changes
+   (windows, lists and most system info, and the player while it's playing)
+   are treated as changed on every frame.
+   \sa PublishChange
+   */
+  void ResetChangedCache();
+
+  /*! \brief Notify that a data source changed
+   Info bools depending on the source are re-evaluated from the next frame on.
+   \param sources a combination of INFO::InfoSource flags
+   */
+  void PublishChange(unsigned int sources);
+
+  /*! \brief Number of info bools re-evaluated in the last frame */
+  unsigned int GetInfoBoolUpdates() const { return m_infoBoolUpdates; };
+  /*! \brief Number of registered info bools */
+  unsigned int GetInfoBoolCount() const { return m_bools.size(); };
+
   bool GetItemInt(int &value, const CGUIListItem *item, int info) const;
   std::string GetItemLabel(const CFileItem *item, int info, std::string *fallback = NULL);
   std::string GetItemImage(const CFileItem *item, int info, std::string *fallback = NULL);
@@ -241,6 +265,12 @@ protected:
   bool GetBool(int condition, int contextWindow = 0, const CGUIListItem *item=NULL);
   int TranslateSingleString(const std::string &strCondition, bool &listItemDependent);
 
+  /*! \brief Get the data sources a condition depends on
+   \param condition the condition from TranslateSingleString()
+   \return a combination of INFO::InfoSource flags
+   */
+  unsigned int GetInfoSources(int condition) const;
+
   // routines for window retrieval
   bool CheckWindowCondition(CGUIWindow *window, int condition) const;
   CGUIWindow *GetWindowWithCondition(int contextWindow, int condition) const;
@@ -329,6 +359,11 @@ protected:
   int m_prevWindowID;
 
   std::vector<INFO::InfoPtr> m_bools;
+  std::map<std::pair<std::string, int>, std::weak_ptr<INFO::InfoBool> > m_boolIndex; ///< m_bools by lower case expression and context
+  unsigned int m_changedSources;     ///< sources published since the last ResetChangedCache()
+  unsigned int m_infoBoolUpdates;    ///< info bools re-evaluated in the last frame
+  bool m_playerWasPlaying;
+  int m_lastMinuteOfDay;
   std::vector<INFO::CSkinVariableString> m_skinVariableStrings;
 
   int m_libraryHasMusic;
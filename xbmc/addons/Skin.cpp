@@ -32,6 +32,7 @@
 #include "messaging/helpers/DialogHelper.h"
 #include "settings/Settings.h"
 #include "settings/lib/Setting.h"
+#include "utils/Crc32.h"
 #include "utils/log.h"
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
@@ -288,6 +289,60 @@ void CSkinInfo::ResolveIncludes(TiXmlElement *node, std::map<INFO::InfoPtr, bool
   m_includes.ResolveIncludes(node, xmlIncludeConditions);
 }
 
+void CSkinInfo::PreloadWindows()
+{
+  std::vector<std::string> paths;
+  GetSkinPaths(paths);
+
+  // the key changes with any file of the skin, includes get resolved from all of them
+  std::vector<std::string> files;
+  std::set<std::string> names;
+  Crc32 stamps;
+  for (std::vector<std::string>::const_iterator path = paths.begin(); path != paths.end(); ++path)
+  {
+    CFileItemList items;
+    CDirectory::GetDirectory(*path, items, ".xml", DIR_FLAG_NO_FILE_DIRS);
+    for (int i = 0; i < items.Size(); ++i)
+    {
+      if (items[i]->m_bIsFolder)
+        continue;
+      std::string name = URIUtils::GetFileName(items[i]->GetPath());
+      std::string lower(name);
+      StringUtils::ToLower(lower);
+      // files of the resolution folder replace the ones of the default folder
+      if (!names.insert(lower).second)
+        continue;
+      files.push_back(URIUtils::AddFileToFolder(*path, name));
+      stamps.Compute(StringUtils::Format("%s:%" PRId64 ":%s", lower.c_str(), items[i]->m_dwSize,
+                                         items[i]->m_dateTime.GetAsDBDateTime().c_str()));
+    }
+  }
+
+  std::string key = StringUtils::Format("%s:%s:%s:%08x", ID().c_str(), Version().asString().c_str(),
+                                        StringUtils::Join(paths, ",").c_str(), (uint32_t)stamps);
+  CLog::Log(LOGINFO, "Reading %u skin files in the background", (unsigned int)files.size());
+
+  m_windowCache.reset(new CGUIWindowXMLCache);
+  m_windowCache->Preload(key, files);
+}
+
+TiXmlElement* CSkinInfo::LoadWindowXML(const std::string &strPath)
+{
+  if (!m_windowCache)
+    return NULL;
+  return m_windowCache->GetWindow(strPath);
+}
+
+TiXmlElement* CSkinInfo::ResolveWindowIncludes(const std::string &strPath, const TiXmlElement *root, std::map<INFO::InfoPtr, bool>* xmlIncludeConditions /* = NULL */)
+{
+  if (m_windowCache)
+    return m_windowCache->ResolveIncludes(strPath, root, m_includes, xmlIncludeConditions);
+
+  TiXmlElement *resolved = (TiXmlElement*)root->Clone();
+  ResolveIncludes(resolved, xmlIncludeConditions);
+  return resolved;
+}
+
 int CSkinInfo::GetStartWindow() const
 {
   int windowID = CSettings::GetInstance().GetInt(CSettings::SETTING_LOOKANDFEEL_STARTUPWINDOW);
@@ -27,6 +27,7 @@
 #include "addons/Addon.h"
 #include "guilib/GraphicContext.h" // needed for the RESOLUTION members
 #include "guilib/GUIIncludes.h"    // needed for the GUIInclude member
+#include "guilib/GUIWindowXMLCache.h"
 
 #define CREDIT_LINE_LENGTH 50
 
@@ -155,6 +156,27 @@ public:
 
   void ResolveIncludes(TiXmlElement *node, std::map<INFO::InfoPtr, bool>* xmlIncludeConditions = NULL);
 
+  /*! \brief Start reading the window files of the skin on the job manager
+   Files are read from the cache in special://temp if the skin didn't change since they were cached.
+   \sa CGUIWindowXMLCache
+   */
+  void PreloadWindows();
+
+  /*! \brief Get a copy of a window file read by PreloadWindows()
+   \param strPath path of the window file
+   \return the window element to be deleted by the caller, NULL if the file wasn't preloaded
+   */
+  TiXmlElement* LoadWindowXML(const std::string &strPath);
+
+  /*! \brief Get a copy of a window with its includes resolved
+   Windows read by PreloadWindows() reuse their expanded copy while the include conditions keep their values.
+   \param strPath path of the window file root was read from, empty if it wasn't read by LoadWindowXML()
+   \param root the window element
+   \param xmlIncludeConditions [out] conditions used to resolve the includes
+   \return the expanded window element to be deleted by the caller
+   */
+  TiXmlElement* ResolveWindowIncludes(const std::string &strPath, const TiXmlElement *root, std::map<INFO::InfoPtr, bool>* xmlIncludeConditions = NULL);
+
   float GetEffectsSlowdown() const { return m_effectsSlowDown; };
 
   const std::vector<CStartupWindow> &GetStartupWindows() const { return m_startupWindows; };
@@ -228,6 +250,7 @@ protected:
 
   float m_effectsSlowDown;
   CGUIIncludes m_includes;
+  std::shared_ptr<CGUIWindowXMLCache> m_windowCache;
   std::string m_currentAspect;
 
   std::vector<CStartupWindow> m_startupWindows;
@@ -26,6 +26,7 @@ using namespace ActiveAE;
 #include "cores/AudioEngine/DSPAddons/ActiveAEDSP.h"
 #include "cores/AudioEngine/DSPAddons/ActiveAEDSPProcess.h"
 #include "cores/AudioEngine/Utils/AEUtil.h"
+#include "cores/AudioEngine/Utils/AEKernels.h"
 #include "cores/AudioEngine/AEResampleFactory.h"
 #include "cores/AudioEngine/Encoders/AEEncoderFFmpeg.h"
 
@@ -1174,7 +1175,7 @@ void CActiveAE::Configure(AEAudioFormat *desiredFmt)
     else
     {
       outputFormat = m_sinkFormat;
-      outputFormat.m_dataFormat = AE_IS_PLANAR(outputFormat.m_dataFormat) ? AE_FMT_FLOATP : AE_FMT_FLOAT;
+      outputFormat.m_dataFormat = GetInternalFormat(inputFormat.m_dataFormat, m_sinkFormat.m_dataFormat);
       outputFormat.m_frameSize = outputFormat.m_channelLayout.Count() *
                                  (CAEUtil::DataFormatToBits(outputFormat.m_dataFormat) >> 3);
 
@@ -1261,6 +1262,7 @@ void CActiveAE::Configure(AEAudioFormat *desiredFmt)
 
         // resample buffers
         m_vizBuffers = new CActiveAEBufferPoolResample(m_internalFormat, vizFormat, m_settings.resampleQuality);
+        m_vizBuffers->m_stage = AUDIO_RESAMPLE_VIZ;
         // TODO use cache of sync + water level
         m_vizBuffers->Create(2000, false, false);
         m_vizInitialized = false;
@@ -1284,6 +1286,7 @@ void CActiveAE::Configure(AEAudioFormat *desiredFmt)
   if (!m_sinkBuffers)
   {
     m_sinkBuffers = new CActiveAEBufferPoolResample(sinkInputFormat, m_sinkFormat, m_settings.resampleQuality);
+    m_sinkBuffers->m_stage = AUDIO_RESAMPLE_SINK;
     m_sinkBuffers->Create(MAX_WATER_LEVEL*1000, true, false);
   }
 
@@ -1966,38 +1969,30 @@ bool CActiveAE::RunStages()
               nb_loops = out->pkt->nb_samples;
             }
 
-            for(int i=0; i<nb_loops; i++)
+            if (nb_loops > 1)
             {
-              if ((*it)->m_fadingSamples > 0)
+              const float *gains = GetFrameGains(*it, out->pkt, fadingStep);
+              for(int j=0; j<out->pkt->planes; j++)
               {
-                (*it)->m_volume += fadingStep;
-                (*it)->m_fadingSamples--;
-
-                if ((*it)->m_fadingSamples == 0)
+                float *fbuffer = (float*)out->pkt->data[j];
+                if (nb_floats == 1)
+                  CAEKernels::MulGainArray(fbuffer, gains, nb_loops);
+                else
                 {
-                  // set variables being polled via stream interface
-                  CSingleLock lock((*it)->m_streamLock);
-                  (*it)->m_streamFading = false;
+                  for (int i = 0; i < nb_loops; i++)
+                  {
+                    for (int k = 0; k < nb_floats; k++)
+                      fbuffer[i*nb_floats+k] *= gains[i];
+                  }
                 }
               }
-
+            }
+            else
+            {
               // volume for stream
               float volume = (*it)->m_volume * (*it)->m_rgain;
-              if(nb_loops > 1)
-                volume *= (*it)->m_limiter.Run((float**)out->pkt->data, out->pkt->config.channels, i*nb_floats, out->pkt->planes > 1);
-
               for(int j=0; j<out->pkt->planes; j++)
-              {
-#ifdef __SSE__
-                CAEUtil::SSEMulArray((float*)out->pkt->data[j]+i*nb_floats, volume, nb_floats);
-#else
-                float* fbuffer = (float*) out->pkt->data[j]+i*nb_floats;
-                for (int k = 0; k < nb_floats; ++k)
-                {
-                  fbuffer[k] *= volume;
-                }
-#endif
-              }
+                CAEKernels::MulArray((float*)out->pkt->data[j], volume, nb_floats);
             }
           }
           else
@@ -2029,53 +2024,39 @@ bool CActiveAE::RunStages()
             // we need to run on a per sample basis
             if ((*it)->m_amplify != 1.0 || !(*it)->m_resampleBuffers->m_normalize)
             {
-              nb_floats = out->pkt->config.channels / out->pkt->planes;
-              nb_loops = out->pkt->nb_samples;
+              nb_floats = mix->pkt->config.channels / mix->pkt->planes;
+              nb_loops = mix->pkt->nb_samples;
             }
 
-            for(int i=0; i<nb_loops; i++)
+            const float *gains = NULL;
+            float volume = 0.0f;
+            if (nb_loops > 1)
+              gains = GetFrameGains(*it, mix->pkt, fadingStep);
+            else
             {
-              if ((*it)->m_fadingSamples > 0)
-              {
-                (*it)->m_volume += fadingStep;
-                (*it)->m_fadingSamples--;
-
-                if ((*it)->m_fadingSamples == 0)
-                {
-                  // set variables being polled via stream interface
-                  CSingleLock lock((*it)->m_streamLock);
-                  (*it)->m_streamFading = false;
-                }
-              }
-
               // volume for stream
-              float volume = (*it)->m_volume * (*it)->m_rgain;
-              if(nb_loops > 1)
-                volume *= (*it)->m_limiter.Run((float**)mix->pkt->data, mix->pkt->config.channels, i*nb_floats, mix->pkt->planes > 1);
+              volume = (*it)->m_volume * (*it)->m_rgain;
+            }
 
-              for(int j=0; j<out->pkt->planes && j<mix->pkt->planes; j++)
+            for(int j=0; j<out->pkt->planes && j<mix->pkt->planes; j++)
+            {
+              float *dst = (float*)out->pkt->data[j];
+              float *src = (float*)mix->pkt->data[j];
+              float peak = 0.0f;
+              if (!gains)
+                peak = CAEKernels::MulAddArray(dst, src, volume, nb_floats);
+              else if (nb_floats == 1)
+                peak = CAEKernels::MulAddGainArray(dst, src, gains, nb_loops);
+              else
               {
-                float *dst = (float*)out->pkt->data[j]+i*nb_floats;
-                float *src = (float*)mix->pkt->data[j]+i*nb_floats;
-#ifdef __SSE__
-                CAEUtil::SSEMulAddArray(dst, src, volume, nb_floats);
-                for (int k = 0; k < nb_floats; ++k)
+                for (int i = 0; i < nb_loops * nb_floats; i++)
                 {
-                  if (fabs(dst[k]) > 1.0f)
-                  {
-                    needClamp = true;
-                    break;
-                  }
-                }
-#else
-                for (int k = 0; k < nb_floats; ++k)
-                {
-                  dst[k] += src[k] * volume;
-                  if (fabs(dst[k]) > 1.0f)
-                    needClamp = true;
+                  dst[i] += src[i] * gains[i / nb_floats];
+                  peak = std::max(peak, fabsf(dst[i]));
                 }
-#endif
               }
+              if (peak > 1.0f)
+                needClamp = true;
             }
             mix->Return();
           }
@@ -2089,7 +2070,7 @@ bool CActiveAE::RunStages()
         int nb_floats = out->pkt->nb_samples * out->pkt->config.channels / out->pkt->planes;
         for(int i=0; i<out->pkt->planes; i++)
         {
-          CAEUtil::ClampArray((float*)out->pkt->data[i], nb_floats);
+          CAEKernels::ClampArray((float*)out->pkt->data[i], nb_floats);
         }
       }
 
@@ -2353,12 +2334,7 @@ void CActiveAE::MixSounds(CSoundPacket &dstSample)
       out = (float*)dstSample.data[j];
       sample_buffer = (float*)(it->sound->GetSound(false)->data[j]+start);
       int nb_floats = mix_samples * dstSample.config.channels / dstSample.planes;
-#ifdef __SSE__
-      CAEUtil::SSEMulAddArray(out, sample_buffer, volume, nb_floats);
-#else
-      for (int k = 0; k < nb_floats; ++k)
-        *out++ += *sample_buffer++ * volume;
-#endif
+      CAEKernels::MulAddArray(out, sample_buffer, volume, nb_floats);
     }
 
     it->samples_played += mix_samples;
@@ -2373,6 +2349,49 @@ void CActiveAE::MixSounds(CSoundPacket &dstSample)
   }
 }
 
+const float* CActiveAE::GetFrameGains(CActiveAEStream *stream, CSoundPacket *pkt, float fadingStep)
+{
+  int frames = pkt->nb_samples;
+  int nb_floats = pkt->config.channels / pkt->planes;
+  if (frames <= 0)
+    return NULL;
+
+  // the limiter works on the highest sample of each frame
+  m_framePeaks.assign(frames, 0.0f);
+  m_frameGains.resize(frames);
+  for (int j = 0; j < pkt->planes; j++)
+  {
+    float *fbuffer = (float*)pkt->data[j];
+    if (nb_floats == 1)
+      CAEKernels::PeakArray(&m_framePeaks[0], fbuffer, frames);
+    else
+    {
+      for (int i = 0; i < frames * nb_floats; i++)
+        m_framePeaks[i / nb_floats] = std::max(m_framePeaks[i / nb_floats], fabsf(fbuffer[i]));
+    }
+  }
+
+  for (int i = 0; i < frames; i++)
+  {
+    if (stream->m_fadingSamples > 0)
+    {
+      stream->m_volume += fadingStep;
+      stream->m_fadingSamples--;
+
+      if (stream->m_fadingSamples == 0)
+      {
+        // set variables being polled via stream interface
+        CSingleLock lock(stream->m_streamLock);
+        stream->m_streamFading = false;
+      }
+    }
+
+    // volume for stream
+    m_frameGains[i] = stream->m_volume * stream->m_rgain * stream->m_limiter.Run(m_framePeaks[i]);
+  }
+  return &m_frameGains[0];
+}
+
 void CActiveAE::Deamplify(CSoundPacket &dstSample)
 {
   if (m_volumeScaled < 1.0 || m_muted)
@@ -2384,13 +2403,7 @@ void CActiveAE::Deamplify(CSoundPacket &dstSample)
     for(int j=0; j<dstSample.planes; j++)
     {
       buffer = (float*)dstSample.data[j];
-#ifdef __SSE__
-      CAEUtil::SSEMulArray(buffer, volume, nb_floats);
-#else
-      float *fbuffer = buffer;
-      for (int i = 0; i < nb_floats; i++)
-        *fbuffer++ *= volume;
-#endif
+      CAEKernels::MulArray(buffer, volume, nb_floats);
     }
   }
 }
@@ -2697,6 +2710,19 @@ AEAudioFormat CActiveAE::GetCurrentSinkFormat()
   return m_stats.GetCurrentSinkFormat();
 }
 
+AEDataFormat CActiveAE::GetInternalFormat(AEDataFormat inputFormat, AEDataFormat sinkFormat)
+{
+  AEDataFormat format = AE_IS_PLANAR(sinkFormat) ? AE_FMT_FLOATP : AE_FMT_FLOAT;
+
+  // if the sink does not take float, the sink stage converts anyway and can
+  // interleave or deinterleave on the way. keeping the layout of the input
+  // lets the buffers of float streams pass their stage without a copy
+  if (sinkFormat != format && (inputFormat == AE_FMT_FLOAT || inputFormat == AE_FMT_FLOATP))
+    format = inputFormat;
+
+  return format;
+}
+
 void CActiveAE::OnLostDevice()
 {
   Message *reply;
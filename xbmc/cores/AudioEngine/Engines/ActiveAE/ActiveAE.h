@@ -259,6 +259,14 @@ public:
   virtual bool HasDSP();
   virtual AEAudioFormat GetCurrentSinkFormat();
 
+  /*! \brief Format streams are mixed in before they go to a sink taking PCM
+   \param inputFormat format of the stream
+   \param sinkFormat format the sink takes
+   \return float, planar if the sink is planar. The layout of float input is kept
+           if the sink doesn't take float anyway.
+   */
+  static AEDataFormat GetInternalFormat(AEDataFormat inputFormat, AEDataFormat sinkFormat);
+
   virtual void RegisterAudioCallback(IAudioCallback* pCallback);
   virtual void UnregisterAudioCallback();
 
@@ -318,6 +326,7 @@ protected:
   bool ResampleSound(CActiveAESound *sound);
   void MixSounds(CSoundPacket &dstSample);
   void Deamplify(CSoundPacket &dstSample);
+  const float* GetFrameGains(CActiveAEStream *stream, CSoundPacket *pkt, float fadingStep);
 
   bool CompareFormat(AEAudioFormat &lhs, AEAudioFormat &rhs);
 
@@ -363,6 +372,8 @@ protected:
   // streams
   std::list<CActiveAEStream*> m_streams;
   std::list<CActiveAEBufferPool*> m_discardBufferPools;
+  std::vector<float> m_framePeaks; // scratch for GetFrameGains
+  std::vector<float> m_frameGains;
 
   // gui sounds
   struct SoundState
@@ -24,6 +24,8 @@
 #include "cores/AudioEngine/Engines/ActiveAE/ActiveAE.h"
 #include "cores/AudioEngine/Utils/AEUtil.h"
 #include "cores/AudioEngine/AEResampleFactory.h"
+#include "cores/DataCacheCore.h"
+#include "utils/log.h"
 
 using namespace ActiveAE;
 
@@ -160,10 +162,27 @@ CActiveAEBufferPoolResample::CActiveAEBufferPoolResample(AEAudioFormat inputForm
   m_bypassDSP = false;
   m_changeResampler = false;
   m_changeDSP = false;
+  m_forwardedBuffers = 0;
+  m_dspCopies = 0;
+  m_resampleCopies = 0;
+  m_delaySum = 0.0;
+  m_delayCount = 0;
+  m_stage = AUDIO_RESAMPLE_STREAM;
 }
 
 CActiveAEBufferPoolResample::~CActiveAEBufferPoolResample()
 {
+  if (m_forwardedBuffers || m_dspCopies || m_resampleCopies)
+  {
+    CLog::Log(LOGDEBUG, "CActiveAEBufferPoolResample - %s %dHz %dch -> %s %dHz %dch: %u buffers forwarded, %u copied by dsp, %u by resampler, average delay %.1f ms",
+              CAEUtil::DataFormatToStr(m_inputFormat.m_dataFormat), m_inputFormat.m_sampleRate, m_inputFormat.m_channelLayout.Count(),
+              CAEUtil::DataFormatToStr(m_format.m_dataFormat), m_format.m_sampleRate, m_format.m_channelLayout.Count(),
+              m_forwardedBuffers, m_dspCopies, m_resampleCopies, GetAverageDelay() * 1000);
+
+    // the stage is gone, a stage replacing it publishes again with its first buffers
+    g_dataCacheCore.SetAudioResampleInfo(m_stage, SAudioResampleInfo());
+  }
+
   delete m_resampler;
   if (m_useDSP)
     CActiveAEDSP::GetInstance().DestroyDSPs(m_streamId);
@@ -379,6 +398,7 @@ bool CActiveAEBufferPoolResample::ResampleBuffers(int64_t timestamp)
         in->clockId = -1;
       }
       m_outputSamples.push_back(in);
+      m_forwardedBuffers++;
       busy = true;
     }
   }
@@ -423,6 +443,7 @@ bool CActiveAEBufferPoolResample::ResampleBuffers(int64_t timestamp)
 
         if (m_dspSample && m_processor->Process(in, m_dspSample))
         {
+          m_dspCopies++;
           in->Return();
           in = m_dspSample;
           m_dspSample = NULL;
@@ -457,6 +478,8 @@ bool CActiveAEBufferPoolResample::ResampleBuffers(int64_t timestamp)
       }
 
       m_procSample->pkt->nb_samples += out_samples;
+      if (in)
+        m_resampleCopies++;
       busy = true;
       m_empty = (out_samples == 0);
 
@@ -524,6 +547,14 @@ bool CActiveAEBufferPoolResample::ResampleBuffers(int64_t timestamp)
         in->Return();
     }
   }
+
+  if (busy)
+  {
+    m_delaySum += GetDelay();
+    m_delayCount++;
+    if (m_publishTimer.IsTimePast())
+      PublishInfo();
+  }
   return busy;
 }
 
@@ -533,9 +564,9 @@ float CActiveAEBufferPoolResample::GetDelay()
   std::deque<CSampleBuffer*>::iterator itBuf;
 
   if (m_procSample)
-    delay += m_procSample->pkt->nb_samples / m_procSample->pkt->config.sample_rate;
+    delay += (float)m_procSample->pkt->nb_samples / m_procSample->pkt->config.sample_rate;
   if (m_dspSample)
-    delay += m_dspSample->pkt->nb_samples / m_dspSample->pkt->config.sample_rate;
+    delay += (float)m_dspSample->pkt->nb_samples / m_dspSample->pkt->config.sample_rate;
 
   for(itBuf=m_inputSamples.begin(); itBuf!=m_inputSamples.end(); ++itBuf)
   {
@@ -561,6 +592,25 @@ float CActiveAEBufferPoolResample::GetDelay()
   return delay;
 }
 
+float CActiveAEBufferPoolResample::GetAverageDelay()
+{
+  if (m_delayCount == 0)
+    return 0.0f;
+  return m_delaySum / m_delayCount;
+}
+
+void CActiveAEBufferPoolResample::PublishInfo()
+{
+  SAudioResampleInfo info;
+  info.active = true;
+  info.forwardedBuffers = m_forwardedBuffers;
+  info.dspCopies = m_dspCopies;
+  info.resampleCopies = m_resampleCopies;
+  info.averageDelay = GetAverageDelay();
+  g_dataCacheCore.SetAudioResampleInfo(m_stage, info);
+  m_publishTimer.Set(1000);
+}
+
 void CActiveAEBufferPoolResample::Flush()
 {
   if (m_procSample)
@@ -22,6 +22,8 @@
 #include "cores/AudioEngine/Utils/AEAudioFormat.h"
 #include "cores/AudioEngine/Interfaces/AE.h"
 #include "cores/AudioEngine/DSPAddons/ActiveAEDSP.h"
+#include "cores/DataCacheCore.h"
+#include "threads/SystemClock.h"
 #include <deque>
 
 extern "C" {
@@ -102,6 +104,8 @@ public:
   void ChangeAudioDSP();
   bool ResampleBuffers(int64_t timestamp = 0);
   float GetDelay();
+  float GetAverageDelay();
+  void PublishInfo();
   void Flush();
   AEAudioFormat m_inputFormat;
   AEAudioFormat m_dspFormat;
@@ -132,6 +136,13 @@ public:
   enum AVMatrixEncoding m_MatrixEncoding;
   enum AVAudioServiceType m_AudioServiceType;
   int m_Profile;
+  unsigned int m_forwardedBuffers;       // input buffers handed on as they are, no resampler and no dsp
+  unsigned int m_dspCopies;              // input buffers copied by the dsp
+  unsigned int m_resampleCopies;         // input buffers copied by the resampler, after the dsp if there is one
+  double m_delaySum;                     // sum of GetDelay() after each busy run, see GetAverageDelay
+  unsigned int m_delayCount;
+  EAudioResampleStage m_stage;           // stage the counts and the delay are published for
+  XbmcThreads::EndTime m_publishTimer;
 };
 
 }
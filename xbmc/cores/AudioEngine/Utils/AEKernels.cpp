@@ -0,0 +1,490 @@
+/*
+ *      Copyright (C) 2010-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "AEKernels.h"
+#include "utils/SIMDDispatch.h"
+
+#include <algorithm>
+#include <math.h>
+
+namespace
+{
+
+struct KernelTable
+{
+  void  (*MulArray)       (float *data, float mul, unsigned int count);
+  float (*MulAddArray)    (float *data, const float *add, float mul, unsigned int count);
+  void  (*MulGainArray)   (float *data, const float *gains, unsigned int count);
+  float (*MulAddGainArray)(float *data, const float *add, const float *gains, unsigned int count);
+  void  (*PeakArray)      (float *peaks, const float *data, unsigned int count);
+  void  (*ClampArray)     (float *data, unsigned int count);
+};
+
+/*
+  Soft clamping is a rational function to approximate a tanh-like soft clipper.
+  It is based on the pade-approximation of the tanh function with tweaked coefficients,
+  see: http://www.musicdsp.org/showone.php?id=238
+  The curve reaches +-1 at +-3, input is limited to that range first.
+*/
+#define CLAMP_LIMIT 3.0f
+#define CLAMP_C1    27.0f
+#define CLAMP_C2    9.0f
+
+//-----------------------------------------------------------------------------
+// C
+//-----------------------------------------------------------------------------
+
+void MulArrayC(float *data, float mul, unsigned int count)
+{
+  for (unsigned int i = 0; i < count; i++)
+    data[i] *= mul;
+}
+
+float MulAddArrayC(float *data, const float *add, float mul, unsigned int count)
+{
+  float peak = 0.0f;
+  for (unsigned int i = 0; i < count; i++)
+  {
+    data[i] += add[i] * mul;
+    peak = std::max(peak, fabsf(data[i]));
+  }
+  return peak;
+}
+
+void MulGainArrayC(float *data, const float *gains, unsigned int count)
+{
+  for (unsigned int i = 0; i < count; i++)
+    data[i] *= gains[i];
+}
+
+float MulAddGainArrayC(float *data, const float *add, const float *gains, unsigned int count)
+{
+  float peak = 0.0f;
+  for (unsigned int i = 0; i < count; i++)
+  {
+    data[i] += add[i] * gains[i];
+    peak = std::max(peak, fabsf(data[i]));
+  }
+  return peak;
+}
+
+void PeakArrayC(float *peaks, const float *data, unsigned int count)
+{
+  for (unsigned int i = 0; i < count; i++)
+    peaks[i] = std::max(peaks[i], fabsf(data[i]));
+}
+
+void ClampArrayC(float *data, unsigned int count)
+{
+  for (unsigned int i = 0; i < count; i++)
+  {
+    float x = std::min(std::max(data[i], -CLAMP_LIMIT), CLAMP_LIMIT);
+    float y = x * x;
+    data[i] = x * (CLAMP_C1 + y) / (CLAMP_C1 + CLAMP_C2 * y);
+  }
+}
+
+const KernelTable kernelsC =
+{
+  MulArrayC,
+  MulAddArrayC,
+  MulGainArrayC,
+  MulAddGainArrayC,
+  PeakArrayC,
+  ClampArrayC
+};
+
+//-----------------------------------------------------------------------------
+// SSE2
+//-----------------------------------------------------------------------------
+
+#if defined(HAS_SSE2_KERNELS)
+inline __m128 AbsSSE2(__m128 x)
+{
+  return _mm_and_ps(x, _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff)));
+}
+
+inline float MaxSSE2(__m128 x)
+{
+  x = _mm_max_ps(x, _mm_movehl_ps(x, x));
+  x = _mm_max_ss(x, _mm_shuffle_ps(x, x, 1));
+  return _mm_cvtss_f32(x);
+}
+
+void MulArraySSE2(float *data, float mul, unsigned int count)
+{
+  const __m128 m = _mm_set1_ps(mul);
+  unsigned int i = 0;
+  for (; i + 4 <= count; i += 4)
+    _mm_storeu_ps(data + i, _mm_mul_ps(_mm_loadu_ps(data + i), m));
+  MulArrayC(data + i, mul, count - i);
+}
+
+float MulAddArraySSE2(float *data, const float *add, float mul, unsigned int count)
+{
+  const __m128 m = _mm_set1_ps(mul);
+  __m128 peak = _mm_setzero_ps();
+  unsigned int i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    __m128 d = _mm_add_ps(_mm_loadu_ps(data + i), _mm_mul_ps(_mm_loadu_ps(add + i), m));
+    _mm_storeu_ps(data + i, d);
+    peak = _mm_max_ps(peak, AbsSSE2(d));
+  }
+  return std::max(MaxSSE2(peak), MulAddArrayC(data + i, add + i, mul, count - i));
+}
+
+void MulGainArraySSE2(float *data, const float *gains, unsigned int count)
+{
+  unsigned int i = 0;
+  for (; i + 4 <= count; i += 4)
+    _mm_storeu_ps(data + i, _mm_mul_ps(_mm_loadu_ps(data + i), _mm_loadu_ps(gains + i)));
+  MulGainArrayC(data + i, gains + i, count - i);
+}
+
+float MulAddGainArraySSE2(float *data, const float *add, const float *gains, unsigned int count)
+{
+  __m128 peak = _mm_setzero_ps();
+  unsigned int i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    __m128 d = _mm_add_ps(_mm_loadu_ps(data + i), _mm_mul_ps(_mm_loadu_ps(add + i), _mm_loadu_ps(gains + i)));
+    _mm_storeu_ps(data + i, d);
+    peak = _mm_max_ps(peak, AbsSSE2(d));
+  }
+  return std::max(MaxSSE2(peak), MulAddGainArrayC(data + i, add + i, gains + i, count - i));
+}
+
+void PeakArraySSE2(float *peaks, const float *data, unsigned int count)
+{
+  unsigned int i = 0;
+  for (; i + 4 <= count; i += 4)
+    _mm_storeu_ps(peaks + i, _mm_max_ps(_mm_loadu_ps(peaks + i), AbsSSE2(_mm_loadu_ps(data + i))));
+  PeakArrayC(peaks + i, data + i, count - i);
+}
+
+void ClampArraySSE2(float *data, unsigned int count)
+{
+  const __m128 lo = _mm_set1_ps(-CLAMP_LIMIT);
+  const __m128 hi = _mm_set1_ps(CLAMP_LIMIT);
+  const __m128 c1 = _mm_set1_ps(CLAMP_C1);
+  const __m128 c2 = _mm_set1_ps(CLAMP_C2);
+  unsigned int i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    __m128 x = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(data + i), lo), hi);
+    __m128 y = _mm_mul_ps(x, x);
+    _mm_storeu_ps(data + i, _mm_div_ps(_mm_mul_ps(x, _mm_add_ps(c1, y)),
+                                       _mm_add_ps(c1, _mm_mul_ps(c2, y))));
+  }
+  ClampArrayC(data + i, count - i);
+}
+
+const KernelTable kernelsSSE2 =
+{
+  MulArraySSE2,
+  MulAddArraySSE2,
+  MulGainArraySSE2,
+  MulAddGainArraySSE2,
+  PeakArraySSE2,
+  ClampArraySSE2
+};
+#endif
+
+//-----------------------------------------------------------------------------
+// AVX2
+//-----------------------------------------------------------------------------
+
+#if defined(HAS_AVX2_KERNELS)
+TARGET_AVX2 inline __m256 AbsAVX2(__m256 x)
+{
+  return _mm256_and_ps(x, _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff)));
+}
+
+TARGET_AVX2 inline float MaxAVX2(__m256 x)
+{
+  __m128 m = _mm_max_ps(_mm256_castps256_ps128(x), _mm256_extractf128_ps(x, 1));
+  m = _mm_max_ps(m, _mm_movehl_ps(m, m));
+  m = _mm_max_ss(m, _mm_shuffle_ps(m, m, 1));
+  return _mm_cvtss_f32(m);
+}
+
+TARGET_AVX2 void MulArrayAVX2(float *data, float mul, unsigned int count)
+{
+  const __m256 m = _mm256_set1_ps(mul);
+  unsigned int i = 0;
+  for (; i + 8 <= count; i += 8)
+    _mm256_storeu_ps(data + i, _mm256_mul_ps(_mm256_loadu_ps(data + i), m));
+  MulArrayC(data + i, mul, count - i);
+}
+
+TARGET_AVX2 float MulAddArrayAVX2(float *data, const float *add, float mul, unsigned int count)
+{
+  const __m256 m = _mm256_set1_ps(mul);
+  __m256 peak = _mm256_setzero_ps();
+  unsigned int i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    __m256 d = _mm256_add_ps(_mm256_loadu_ps(data + i), _mm256_mul_ps(_mm256_loadu_ps(add + i), m));
+    _mm256_storeu_ps(data + i, d);
+    peak = _mm256_max_ps(peak, AbsAVX2(d));
+  }
+  return std::max(MaxAVX2(peak), MulAddArrayC(data + i, add + i, mul, count - i));
+}
+
+TARGET_AVX2 void MulGainArrayAVX2(float *data, const float *gains, unsigned int count)
+{
+  unsigned int i = 0;
+  for (; i + 8 <= count; i += 8)
+    _mm256_storeu_ps(data + i, _mm256_mul_ps(_mm256_loadu_ps(data + i), _mm256_loadu_ps(gains + i)));
+  MulGainArrayC(data + i, gains + i, count - i);
+}
+
+TARGET_AVX2 float MulAddGainArrayAVX2(float *data, const float *add, const float *gains, unsigned int count)
+{
+  __m256 peak = _mm256_setzero_ps();
+  unsigned int i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    __m256 d = _mm256_add_ps(_mm256_loadu_ps(data + i), _mm256_mul_ps(_mm256_loadu_ps(add + i), _mm256_loadu_ps(gains + i)));
+    _mm256_storeu_ps(data + i, d);
+    peak = _mm256_max_ps(peak, AbsAVX2(d));
+  }
+  return std::max(MaxAVX2(peak), MulAddGainArrayC(data + i, add + i, gains + i, count - i));
+}
+
+TARGET_AVX2 void PeakArrayAVX2(float *peaks, const float *data, unsigned int count)
+{
+  unsigned int i = 0;
+  for (; i + 8 <= count; i += 8)
+    _mm256_storeu_ps(peaks + i, _mm256_max_ps(_mm256_loadu_ps(peaks + i), AbsAVX2(_mm256_loadu_ps(data + i))));
+  PeakArrayC(peaks + i, data + i, count - i);
+}
+
+TARGET_AVX2 void ClampArrayAVX2(float *data, unsigned int count)
+{
+  const __m256 lo = _mm256_set1_ps(-CLAMP_LIMIT);
+  const __m256 hi = _mm256_set1_ps(CLAMP_LIMIT);
+  const __m256 c1 = _mm256_set1_ps(CLAMP_C1);
+  const __m256 c2 = _mm256_set1_ps(CLAMP_C2);
+  unsigned int i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    __m256 x = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(data + i), lo), hi);
+    __m256 y = _mm256_mul_ps(x, x);
+    _mm256_storeu_ps(data + i, _mm256_div_ps(_mm256_mul_ps(x, _mm256_add_ps(c1, y)),
+                                             _mm256_add_ps(c1, _mm256_mul_ps(c2, y))));
+  }
+  ClampArrayC(data + i, count - i);
+}
+
+const KernelTable kernelsAVX2 =
+{
+  MulArrayAVX2,
+  MulAddArrayAVX2,
+  MulGainArrayAVX2,
+  MulAddGainArrayAVX2,
+  PeakArrayAVX2,
+  ClampArrayAVX2
+};
+#endif
+
+//-----------------------------------------------------------------------------
+// NEON
+//-----------------------------------------------------------------------------
+
+#if defined(HAS_NEON_KERNELS)
+inline float MaxNEON(float32x4_t x)
+{
+#if defined(__aarch64__)
+  return vmaxvq_f32(x);
+#else
+  float32x2_t m = vpmax_f32(vget_low_f32(x), vget_high_f32(x));
+  m = vpmax_f32(m, m);
+  return vget_lane_f32(m, 0);
+#endif
+}
+
+inline float32x4_t DivNEON(float32x4_t a, float32x4_t b)
+{
+#if defined(__aarch64__)
+  return vdivq_f32(a, b);
+#else
+  // reciprocal estimate refined by two newton-raphson steps
+  float32x4_t r = vrecpeq_f32(b);
+  r = vmulq_f32(vrecpsq_f32(b, r), r);
+  r = vmulq_f32(vrecpsq_f32(b, r), r);
+  return vmulq_f32(a, r);
+#endif
+}
+
+void MulArrayNEON(float *data, float mul, unsigned int count)
+{
+  const float32x4_t m = vdupq_n_f32(mul);
+  unsigned int i = 0;
+  for (; i + 4 <= count; i += 4)
+    vst1q_f32(data + i, vmulq_f32(vld1q_f32(data + i), m));
+  MulArrayC(data + i, mul, count - i);
+}
+
+float MulAddArrayNEON(float *data, const float *add, float mul, unsigned int count)
+{
+  const float32x4_t m = vdupq_n_f32(mul);
+  float32x4_t peak = vdupq_n_f32(0.0f);
+  unsigned int i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    float32x4_t d = vaddq_f32(vld1q_f32(data + i), vmulq_f32(vld1q_f32(add + i), m));
+    vst1q_f32(data + i, d);
+    peak = vmaxq_f32(peak, vabsq_f32(d));
+  }
+  return std::max(MaxNEON(peak), MulAddArrayC(data + i, add + i, mul, count - i));
+}
+
+void MulGainArrayNEON(float *data, const float *gains, unsigned int count)
+{
+  unsigned int i = 0;
+  for (; i + 4 <= count; i += 4)
+    vst1q_f32(data + i, vmulq_f32(vld1q_f32(data + i), vld1q_f32(gains + i)));
+  MulGainArrayC(data + i, gains + i, count - i);
+}
+
+float MulAddGainArrayNEON(float *data, const float *add, const float *gains, unsigned int count)
+{
+  float32x4_t peak = vdupq_n_f32(0.0f);
+  unsigned int i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    float32x4_t d = vaddq_f32(vld1q_f32(data + i), vmulq_f32(vld1q_f32(add + i), vld1q_f32(gains + i)));
+    vst1q_f32(data + i, d);
+    peak = vmaxq_f32(peak, vabsq_f32(d));
+  }
+  return std::max(MaxNEON(peak), MulAddGainArrayC(data + i, add + i, gains + i, count - i));
+}
+
+void PeakArrayNEON(float *peaks, const float *data, unsigned int count)
+{
+  unsigned int i = 0;
+  for (; i + 4 <= count; i += 4)
+    vst1q_f32(peaks + i, vmaxq_f32(vld1q_f32(peaks + i), vabsq_f32(vld1q_f32(data + i))));
+  PeakArrayC(peaks + i, data + i, count - i);
+}
+
+void ClampArrayNEON(float *data, unsigned int count)
+{
+  const float32x4_t lo = vdupq_n_f32(-CLAMP_LIMIT);
+  const float32x4_t hi = vdupq_n_f32(CLAMP_LIMIT);
+  const float32x4_t c1 = vdupq_n_f32(CLAMP_C1);
+  const float32x4_t c2 = vdupq_n_f32(CLAMP_C2);
+  unsigned int i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    float32x4_t x = vminq_f32(vmaxq_f32(vld1q_f32(data + i), lo), hi);
+    float32x4_t y = vmulq_f32(x, x);
+    vst1q_f32(data + i, DivNEON(vmulq_f32(x, vaddq_f32(c1, y)),
+                                vaddq_f32(c1, vmulq_f32(c2, y))));
+  }
+  ClampArrayC(data + i, count - i);
+}
+
+const KernelTable kernelsNEON =
+{
+  MulArrayNEON,
+  MulAddArrayNEON,
+  MulGainArrayNEON,
+  MulAddGainArrayNEON,
+  PeakArrayNEON,
+  ClampArrayNEON
+};
+#endif
+
+//-----------------------------------------------------------------------------
+// Dispatch
+//-----------------------------------------------------------------------------
+
+const KernelTable* const tables[CSIMDKernels::TYPE_COUNT] =
+{
+  &kernelsC,
+#if defined(HAS_SSE2_KERNELS)
+  &kernelsSSE2,
+#else
+  NULL,
+#endif
+  NULL,
+#if defined(HAS_AVX2_KERNELS)
+  &kernelsAVX2,
+#else
+  NULL,
+#endif
+#if defined(HAS_NEON_KERNELS)
+  &kernelsNEON
+#else
+  NULL
+#endif
+};
+
+CSIMDDispatch<KernelTable> kernels(tables);
+
+inline const KernelTable* Kernels()
+{
+  return kernels.Get();
+}
+
+}
+
+bool CAEKernels::SetType(Type type)
+{
+  return kernels.SetType(type);
+}
+
+CAEKernels::Type CAEKernels::GetType()
+{
+  return kernels.GetType();
+}
+
+void CAEKernels::MulArray(float *data, float mul, unsigned int count)
+{
+  Kernels()->MulArray(data, mul, count);
+}
+
+float CAEKernels::MulAddArray(float *data, const float *add, float mul, unsigned int count)
+{
+  return Kernels()->MulAddArray(data, add, mul, count);
+}
+
+void CAEKernels::MulGainArray(float *data, const float *gains, unsigned int count)
+{
+  Kernels()->MulGainArray(data, gains, count);
+}
+
+float CAEKernels::MulAddGainArray(float *data, const float *add, const float *gains, unsigned int count)
+{
+  return Kernels()->MulAddGainArray(data, add, gains, count);
+}
+
+void CAEKernels::PeakArray(float *peaks, const float *data, unsigned int count)
+{
+  Kernels()->PeakArray(peaks, data, count);
+}
+
+void CAEKernels::ClampArray(float *data, unsigned int count)
+{
+  Kernels()->ClampArray(data, count);
+}
@@ -0,0 +1,59 @@
+#pragma once
+/*
+ *      Copyright (C) 2010-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/SIMDKernels.h"
+
+/*! \brief Sample processing kernels for float buffers.
+
+ The implementation (AVX2, SSE2, NEON or plain C) is picked on first use from the
+ features reported by CPUInfo. Buffers don't need to be aligned.
+ */
+class CAEKernels : public CSIMDKernels
+{
+public:
+  /*! \brief Select the implementation to use
+   \return false if the implementation isn't available on this CPU or build
+   */
+  static bool SetType(Type type);
+  static Type GetType();
+
+  /*! \brief data[i] *= mul */
+  static void MulArray(float *data, float mul, unsigned int count);
+
+  /*! \brief data[i] += add[i] * mul
+   \return highest absolute value in data afterwards
+   */
+  static float MulAddArray(float *data, const float *add, float mul, unsigned int count);
+
+  /*! \brief data[i] *= gains[i] */
+  static void MulGainArray(float *data, const float *gains, unsigned int count);
+
+  /*! \brief data[i] += add[i] * gains[i]
+   \return highest absolute value in data afterwards
+   */
+  static float MulAddGainArray(float *data, const float *add, const float *gains, unsigned int count);
+
+  /*! \brief peaks[i] = max(peaks[i], |data[i]|) */
+  static void PeakArray(float *peaks, const float *data, unsigned int count);
+
+  /*! \brief Soft clamps data to [-1, 1] with a tanh like curve */
+  static void ClampArray(float *data, unsigned int count);
+};
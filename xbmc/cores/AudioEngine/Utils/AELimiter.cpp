@@ -34,25 +34,9 @@ CAELimiter::CAELimiter()
   m_increase = 0.0f;
 }
 
-float CAELimiter::Run(float* frame[AE_CH_MAX], int channels, int offset /*= 0*/, bool planar /*= false*/)
+float CAELimiter::Run(float peak)
 {
-  float highest = 0.0f;
-  if (!planar)
-  {
-    for(int i=0; i<channels; i++)
-    {
-      highest = std::max(highest, fabsf(*(frame[0]+offset+i)));
-    }
-  }
-  else
-  {
-    for(int i=0; i<channels; i++)
-    {
-      highest = std::max(highest, fabsf(*(frame[i]+offset)));
-    }
-  }
-
-  float sample = highest * m_amplify;
+  float sample = peak * m_amplify;
   if (sample * m_attenuation > 1.0f)
   {
     m_attenuation = 1.0f / sample;
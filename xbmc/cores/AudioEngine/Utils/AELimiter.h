@@ -49,5 +49,9 @@ class CAELimiter
       m_samplerate = (float)samplerate;
     }
 
-    float Run(float* frame[AE_CH_MAX], int channels, int offset = 0, bool planar = false);
+    /*! \brief Process one frame
+     \param peak highest absolute sample value of the frame
+     \return gain to apply to the frame
+     */
+    float Run(float peak);
 };
@@ -0,0 +1,117 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/AudioEngine/Utils/AEKernels.h"
+#include "test/TestKernels.h"
+#include "test/TestUtils.h"
+
+#include "gtest/gtest.h"
+
+#include <math.h>
+#include <vector>
+
+class TestAEKernels : public TestKernels<CAEKernels>
+{
+};
+
+TEST_F(TestAEKernels, Correctness)
+{
+  // odd sizes and offsets exercise the unaligned heads and the scalar tails
+  const unsigned int count = 1027;
+  const unsigned int offset = 1;
+
+  std::vector<float> data = CTestRandom(1).Floats(count + offset, 1.5f);
+  std::vector<float> add = CTestRandom(2).Floats(count + offset, 1.5f);
+  std::vector<float> gains = CTestRandom(3).Floats(count + offset, 1.0f);
+  std::vector<float> clamp = CTestRandom(4).Floats(count + offset, 5.0f);
+
+  ASSERT_TRUE(CAEKernels::SetType(CAEKernels::TYPE_C));
+  std::vector<float> mul(data), mulAdd(data), mulGain(data), mulAddGain(data), peaks(gains), clamped(clamp);
+  CAEKernels::MulArray(&mul[offset], 0.5f, count);
+  float mulAddPeak = CAEKernels::MulAddArray(&mulAdd[offset], &add[offset], 0.7f, count);
+  CAEKernels::MulGainArray(&mulGain[offset], &gains[offset], count);
+  float mulAddGainPeak = CAEKernels::MulAddGainArray(&mulAddGain[offset], &add[offset], &gains[offset], count);
+  CAEKernels::PeakArray(&peaks[offset], &data[offset], count);
+  CAEKernels::ClampArray(&clamped[offset], count);
+
+  for (unsigned int i = offset; i < count + offset; i++)
+  {
+    EXPECT_LE(fabsf(clamped[i]), 1.0f);
+    if (fabsf(clamp[i]) >= 3.0f)
+      EXPECT_EQ(clamp[i] > 0.0f ? 1.0f : -1.0f, clamped[i]);
+  }
+
+  ForEachType([&](CAEKernels::Type type)
+  {
+    if (type == CAEKernels::TYPE_C)
+      return;
+
+    std::vector<float> mul2(data), mulAdd2(data), mulGain2(data), mulAddGain2(data), peaks2(gains), clamped2(clamp);
+    CAEKernels::MulArray(&mul2[offset], 0.5f, count);
+    EXPECT_FLOAT_EQ(mulAddPeak, CAEKernels::MulAddArray(&mulAdd2[offset], &add[offset], 0.7f, count));
+    CAEKernels::MulGainArray(&mulGain2[offset], &gains[offset], count);
+    EXPECT_FLOAT_EQ(mulAddGainPeak, CAEKernels::MulAddGainArray(&mulAddGain2[offset], &add[offset], &gains[offset], count));
+    CAEKernels::PeakArray(&peaks2[offset], &data[offset], count);
+    CAEKernels::ClampArray(&clamped2[offset], count);
+
+    // nothing outside the range may be touched
+    EXPECT_EQ(data[0], mul2[0]);
+    EXPECT_EQ(clamp[0], clamped2[0]);
+
+    for (unsigned int i = 0; i < count + offset; i++)
+    {
+      EXPECT_FLOAT_EQ(mul[i], mul2[i]);
+      EXPECT_FLOAT_EQ(mulAdd[i], mulAdd2[i]);
+      EXPECT_FLOAT_EQ(mulGain[i], mulGain2[i]);
+      EXPECT_FLOAT_EQ(mulAddGain[i], mulAddGain2[i]);
+      EXPECT_FLOAT_EQ(peaks[i], peaks2[i]);
+      // division by reciprocal estimates on some CPUs
+      EXPECT_NEAR(clamped[i], clamped2[i], 1e-5f);
+    }
+  });
+}
+
+TEST_F(TestAEKernels, Throughput)
+{
+  // one second of 7.1 audio at 48kHz in periods of 1024 frames
+  const unsigned int frames = 1024;
+  const unsigned int channels = 8;
+  const unsigned int periods = 48000 / frames;
+
+  std::vector<float> data = CTestRandom(1).Floats(frames * channels, 1.0f);
+  std::vector<float> add = CTestRandom(2).Floats(frames * channels, 1.0f);
+  std::vector<float> gains = CTestRandom(3).Floats(frames, 1.0f);
+
+  ForEachType([&](CAEKernels::Type type)
+  {
+    RecordThroughput(type, "", periods, [&]()
+    {
+      for (unsigned int c = 0; c < channels; c++)
+      {
+        float *plane = &data[c * frames];
+        CAEKernels::PeakArray(&gains[0], plane, frames);
+        CAEKernels::MulGainArray(plane, &gains[0], frames);
+        CAEKernels::MulAddArray(plane, &add[c * frames], 0.5f, frames);
+        CAEKernels::ClampArray(plane, frames);
+        CAEKernels::MulArray(plane, 0.25f, frames);
+      }
+    });
+  });
+}
@@ -0,0 +1,48 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/AudioEngine/Engines/ActiveAE/ActiveAE.h"
+
+#include "gtest/gtest.h"
+
+using namespace ActiveAE;
+
+TEST(TestActiveAE, InternalFormatFloatSink)
+{
+  // float sinks get their layout, whatever the input is
+  EXPECT_EQ(AE_FMT_FLOAT, CActiveAE::GetInternalFormat(AE_FMT_FLOATP, AE_FMT_FLOAT));
+  EXPECT_EQ(AE_FMT_FLOAT, CActiveAE::GetInternalFormat(AE_FMT_S16NE, AE_FMT_FLOAT));
+  EXPECT_EQ(AE_FMT_FLOATP, CActiveAE::GetInternalFormat(AE_FMT_FLOAT, AE_FMT_FLOATP));
+  EXPECT_EQ(AE_FMT_FLOATP, CActiveAE::GetInternalFormat(AE_FMT_S32NE, AE_FMT_FLOATP));
+}
+
+TEST(TestActiveAE, InternalFormatNonFloatSink)
+{
+  // float input keeps its layout, the sink stage converts anyway
+  EXPECT_EQ(AE_FMT_FLOATP, CActiveAE::GetInternalFormat(AE_FMT_FLOATP, AE_FMT_S16NE));
+  EXPECT_EQ(AE_FMT_FLOAT, CActiveAE::GetInternalFormat(AE_FMT_FLOAT, AE_FMT_S16NE));
+  EXPECT_EQ(AE_FMT_FLOATP, CActiveAE::GetInternalFormat(AE_FMT_FLOATP, AE_FMT_S32NEP));
+  EXPECT_EQ(AE_FMT_FLOAT, CActiveAE::GetInternalFormat(AE_FMT_FLOAT, AE_FMT_S32NEP));
+
+  // other input is mixed in float of the sink's layout
+  EXPECT_EQ(AE_FMT_FLOAT, CActiveAE::GetInternalFormat(AE_FMT_S16NE, AE_FMT_S16NE));
+  EXPECT_EQ(AE_FMT_FLOAT, CActiveAE::GetInternalFormat(AE_FMT_S16NEP, AE_FMT_S32NE));
+  EXPECT_EQ(AE_FMT_FLOATP, CActiveAE::GetInternalFormat(AE_FMT_S16NE, AE_FMT_S16NEP));
+}
@@ -19,6 +19,7 @@
 */
 
 #include "cores/DataCacheCore.h"
+#include "threads/SingleLock.h"
 
 bool CDataCacheCore::HasAVInfoChanges()
 {
@@ -35,4 +36,28 @@ void CDataCacheCore::SignalVideoInfoChange()
 void CDataCacheCore::SignalAudioInfoChange()
 {
   m_hasAVInfoChanges = true;
-}
\ No newline at end of file
+}
+
+void CDataCacheCore::SetDemuxPacketPoolInfo(const SDemuxPacketPoolInfo &info)
+{
+  CSingleLock lock(m_demuxSection);
+  m_demuxPacketPoolInfo = info;
+}
+
+SDemuxPacketPoolInfo CDataCacheCore::GetDemuxPacketPoolInfo()
+{
+  CSingleLock lock(m_demuxSection);
+  return m_demuxPacketPoolInfo;
+}
+
+void CDataCacheCore::SetAudioResampleInfo(EAudioResampleStage stage, const SAudioResampleInfo &info)
+{
+  CSingleLock lock(m_audioSection);
+  m_audioResampleInfo[stage] = info;
+}
+
+SAudioResampleInfo CDataCacheCore::GetAudioResampleInfo(EAudioResampleStage stage)
+{
+  CSingleLock lock(m_audioSection);
+  return m_audioResampleInfo[stage];
+}
@@ -20,6 +20,39 @@
 *
 */
 
+#include "threads/CriticalSection.h"
+
+#include <stdint.h>
+
+struct SDemuxPacketPoolInfo
+{
+  unsigned int packetsInUse = 0;      ///< packets handed out and not yet freed
+  unsigned int peakPacketsInUse = 0;  ///< high-water mark of packetsInUse
+  uint64_t bytesInUse = 0;            ///< payload capacity of the packets in use
+  uint64_t peakBytesInUse = 0;        ///< high-water mark of bytesInUse
+  uint64_t bytesPooled = 0;           ///< payload capacity held for reuse
+  uint64_t peakBytesPooled = 0;       ///< high-water mark of bytesPooled
+  uint64_t allocations = 0;           ///< number of packets allocated
+  uint64_t poolHits = 0;              ///< allocations served from the pool
+};
+
+enum EAudioResampleStage
+{
+  AUDIO_RESAMPLE_STREAM = 0,          ///< resampling of a stream to the internal format
+  AUDIO_RESAMPLE_SINK,                ///< resampling of the mixed output to the sink format
+  AUDIO_RESAMPLE_VIZ,                 ///< resampling for the visualisation
+  AUDIO_RESAMPLE_STAGES
+};
+
+struct SAudioResampleInfo
+{
+  bool active = false;                ///< the stage has processed buffers
+  uint64_t forwardedBuffers = 0;      ///< buffers handed on by reference, no dsp and no resampler
+  uint64_t dspCopies = 0;             ///< buffers copied by the audio dsp
+  uint64_t resampleCopies = 0;        ///< buffers copied by the resampler
+  double averageDelay = 0.0;          ///< average delay of the stage in seconds
+};
+
 class CDataCacheCore
 {
 public:
@@ -27,8 +60,21 @@ public:
   void SignalVideoInfoChange();
   void SignalAudioInfoChange();
 
+  void SetDemuxPacketPoolInfo(const SDemuxPacketPoolInfo &info);
+  SDemuxPacketPoolInfo GetDemuxPacketPoolInfo();
+
+  /*! \brief Set the buffer counts and delay of a resample stage of the audio engine */
+  void SetAudioResampleInfo(EAudioResampleStage stage, const SAudioResampleInfo &info);
+  SAudioResampleInfo GetAudioResampleInfo(EAudioResampleStage stage);
+
 protected:
   volatile bool m_hasAVInfoChanges;
+
+  CCriticalSection m_demuxSection;
+  SDemuxPacketPoolInfo m_demuxPacketPoolInfo;
+
+  CCriticalSection m_audioSection;
+  SAudioResampleInfo m_audioResampleInfo[AUDIO_RESAMPLE_STAGES];
 };
 
 extern CDataCacheCore g_dataCacheCore;
\ No newline at end of file
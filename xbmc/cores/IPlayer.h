@@ -34,6 +34,7 @@ class TiXmlElement;
 class CStreamDetails;
 class CAction;
 class CRenderCapture;
+class CFileItemList;
 
 namespace PVR
 {
@@ -241,6 +242,10 @@ public:
   virtual bool OpenFile(const CFileItem& file, const CPlayerOptions& options){ return false;}
   virtual bool QueueNextFile(const CFileItem &file) { return false; }
   virtual void OnNothingToQueueNotify() {}
+  /*! \brief Hint of the files likely to be queued next, in playlist order.
+   Players may open and decode them ahead, so a later QueueNextFile doesn't have to wait for the source.
+   */
+  virtual void PrefetchFiles(const CFileItemList &files) {}
   virtual bool CloseFile(bool reopen = false) = 0;
   virtual bool IsPlaying() const { return false;}
   virtual bool CanPause() { return true; };
@@ -0,0 +1,377 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "DVDPlaneKernels.h"
+#include "utils/SIMDDispatch.h"
+
+#include <string.h>
+
+namespace
+{
+
+struct KernelTable
+{
+  void (*CopyRows)   (uint8_t *dst, int dstStride, const uint8_t *src, int srcStride, int width, int height);
+  void (*Interleave) (uint8_t *dst, int dstStride, const uint8_t *u, int uStride, const uint8_t *v, int vStride, int width, int height);
+};
+
+// planes from this size on bypass the cache, smaller ones are likely read again soon
+#define STREAM_THRESHOLD (1024 * 1024)
+
+//-----------------------------------------------------------------------------
+// C
+//-----------------------------------------------------------------------------
+
+void CopyRowsC(uint8_t *dst, int dstStride, const uint8_t *src, int srcStride, int width, int height)
+{
+  for (int y = 0; y < height; y++)
+  {
+    memcpy(dst, src, width);
+    src += srcStride;
+    dst += dstStride;
+  }
+}
+
+void InterleaveRowC(uint8_t *dst, const uint8_t *u, const uint8_t *v, int width)
+{
+  for (int x = 0; x < width; x++)
+  {
+    *dst++ = *u++;
+    *dst++ = *v++;
+  }
+}
+
+void InterleaveC(uint8_t *dst, int dstStride, const uint8_t *u, int uStride, const uint8_t *v, int vStride, int width, int height)
+{
+  for (int y = 0; y < height; y++)
+  {
+    InterleaveRowC(dst, u, v, width);
+    dst += dstStride;
+    u += uStride;
+    v += vStride;
+  }
+}
+
+const KernelTable kernelsC =
+{
+  CopyRowsC,
+  InterleaveC
+};
+
+//-----------------------------------------------------------------------------
+// SSE2
+//-----------------------------------------------------------------------------
+#if defined(HAS_SSE2_KERNELS)
+
+// bytes needed to align p to the vector size
+inline int AlignHead(const uint8_t *p, int align, int width)
+{
+  int head = (int)((align - ((uintptr_t)p & (align - 1))) & (align - 1));
+  return head < width ? head : width;
+}
+
+void CopyRowsSSE2(uint8_t *dst, int dstStride, const uint8_t *src, int srcStride, int width, int height)
+{
+  if (width * height < STREAM_THRESHOLD)
+  {
+    CopyRowsC(dst, dstStride, src, srcStride, width, height);
+    return;
+  }
+
+  for (int y = 0; y < height; y++)
+  {
+    int x = AlignHead(dst, 16, width);
+    memcpy(dst, src, x);
+    for (; x + 64 <= width; x += 64)
+    {
+      __m128i a = _mm_loadu_si128((const __m128i*)(src + x));
+      __m128i b = _mm_loadu_si128((const __m128i*)(src + x + 16));
+      __m128i c = _mm_loadu_si128((const __m128i*)(src + x + 32));
+      __m128i d = _mm_loadu_si128((const __m128i*)(src + x + 48));
+      _mm_stream_si128((__m128i*)(dst + x), a);
+      _mm_stream_si128((__m128i*)(dst + x + 16), b);
+      _mm_stream_si128((__m128i*)(dst + x + 32), c);
+      _mm_stream_si128((__m128i*)(dst + x + 48), d);
+    }
+    for (; x + 16 <= width; x += 16)
+      _mm_stream_si128((__m128i*)(dst + x), _mm_loadu_si128((const __m128i*)(src + x)));
+    memcpy(dst + x, src + x, width - x);
+
+    src += srcStride;
+    dst += dstStride;
+  }
+  _mm_sfence();
+}
+
+void InterleaveSSE2(uint8_t *dst, int dstStride, const uint8_t *u, int uStride, const uint8_t *v, int vStride, int width, int height)
+{
+  for (int y = 0; y < height; y++)
+  {
+    int x = 0;
+    for (; x + 16 <= width; x += 16)
+    {
+      __m128i uu = _mm_loadu_si128((const __m128i*)(u + x));
+      __m128i vv = _mm_loadu_si128((const __m128i*)(v + x));
+      _mm_storeu_si128((__m128i*)(dst + 2 * x), _mm_unpacklo_epi8(uu, vv));
+      _mm_storeu_si128((__m128i*)(dst + 2 * x + 16), _mm_unpackhi_epi8(uu, vv));
+    }
+    InterleaveRowC(dst + 2 * x, u + x, v + x, width - x);
+
+    dst += dstStride;
+    u += uStride;
+    v += vStride;
+  }
+}
+
+const KernelTable kernelsSSE2 =
+{
+  CopyRowsSSE2,
+  InterleaveSSE2
+};
+
+#endif
+
+//-----------------------------------------------------------------------------
+// SSE4.1
+//-----------------------------------------------------------------------------
+#if defined(HAS_SSE4_KERNELS)
+
+// streaming loads only pay off when the source is write-combined memory (mapped
+// hardware surfaces), on normal memory they behave like aligned loads
+TARGET_SSE4 void CopyRowsSSE4(uint8_t *dst, int dstStride, const uint8_t *src, int srcStride, int width, int height)
+{
+  if (width * height < STREAM_THRESHOLD)
+  {
+    CopyRowsC(dst, dstStride, src, srcStride, width, height);
+    return;
+  }
+
+  for (int y = 0; y < height; y++)
+  {
+    int x = AlignHead(dst, 16, width);
+    memcpy(dst, src, x);
+    if (((uintptr_t)(src + x) & 15) == 0)
+    {
+      for (; x + 64 <= width; x += 64)
+      {
+        __m128i a = _mm_stream_load_si128((__m128i*)(src + x));
+        __m128i b = _mm_stream_load_si128((__m128i*)(src + x + 16));
+        __m128i c = _mm_stream_load_si128((__m128i*)(src + x + 32));
+        __m128i d = _mm_stream_load_si128((__m128i*)(src + x + 48));
+        _mm_stream_si128((__m128i*)(dst + x), a);
+        _mm_stream_si128((__m128i*)(dst + x + 16), b);
+        _mm_stream_si128((__m128i*)(dst + x + 32), c);
+        _mm_stream_si128((__m128i*)(dst + x + 48), d);
+      }
+      for (; x + 16 <= width; x += 16)
+        _mm_stream_si128((__m128i*)(dst + x), _mm_stream_load_si128((__m128i*)(src + x)));
+    }
+    else
+    {
+      for (; x + 16 <= width; x += 16)
+        _mm_stream_si128((__m128i*)(dst + x), _mm_loadu_si128((const __m128i*)(src + x)));
+    }
+    memcpy(dst + x, src + x, width - x);
+
+    src += srcStride;
+    dst += dstStride;
+  }
+  _mm_sfence();
+}
+
+const KernelTable kernelsSSE4 =
+{
+  CopyRowsSSE4,
+  InterleaveSSE2
+};
+
+#endif
+
+//-----------------------------------------------------------------------------
+// AVX2
+//-----------------------------------------------------------------------------
+#if defined(HAS_AVX2_KERNELS)
+
+TARGET_AVX2 void CopyRowsAVX2(uint8_t *dst, int dstStride, const uint8_t *src, int srcStride, int width, int height)
+{
+  if (width * height < STREAM_THRESHOLD)
+  {
+    CopyRowsC(dst, dstStride, src, srcStride, width, height);
+    return;
+  }
+
+  for (int y = 0; y < height; y++)
+  {
+    int x = AlignHead(dst, 32, width);
+    memcpy(dst, src, x);
+    for (; x + 64 <= width; x += 64)
+    {
+      __m256i a = _mm256_loadu_si256((const __m256i*)(src + x));
+      __m256i b = _mm256_loadu_si256((const __m256i*)(src + x + 32));
+      _mm256_stream_si256((__m256i*)(dst + x), a);
+      _mm256_stream_si256((__m256i*)(dst + x + 32), b);
+    }
+    for (; x + 32 <= width; x += 32)
+      _mm256_stream_si256((__m256i*)(dst + x), _mm256_loadu_si256((const __m256i*)(src + x)));
+    memcpy(dst + x, src + x, width - x);
+
+    src += srcStride;
+    dst += dstStride;
+  }
+  _mm_sfence();
+}
+
+TARGET_AVX2 void InterleaveAVX2(uint8_t *dst, int dstStride, const uint8_t *u, int uStride, const uint8_t *v, int vStride, int width, int height)
+{
+  for (int y = 0; y < height; y++)
+  {
+    int x = 0;
+    for (; x + 32 <= width; x += 32)
+    {
+      __m256i uu = _mm256_loadu_si256((const __m256i*)(u + x));
+      __m256i vv = _mm256_loadu_si256((const __m256i*)(v + x));
+      // unpack works within 128 bit lanes, put the lane halves back in order
+      __m256i lo = _mm256_unpacklo_epi8(uu, vv);
+      __m256i hi = _mm256_unpackhi_epi8(uu, vv);
+      _mm256_storeu_si256((__m256i*)(dst + 2 * x), _mm256_permute2x128_si256(lo, hi, 0x20));
+      _mm256_storeu_si256((__m256i*)(dst + 2 * x + 32), _mm256_permute2x128_si256(lo, hi, 0x31));
+    }
+    InterleaveRowC(dst + 2 * x, u + x, v + x, width - x);
+
+    dst += dstStride;
+    u += uStride;
+    v += vStride;
+  }
+}
+
+const KernelTable kernelsAVX2 =
+{
+  CopyRowsAVX2,
+  InterleaveAVX2
+};
+
+#endif
+
+//-----------------------------------------------------------------------------
+// NEON
+//-----------------------------------------------------------------------------
+#if defined(HAS_NEON_KERNELS)
+
+// libc memcpy is already NEON optimised on these platforms, only the interleave needs help
+void InterleaveNEON(uint8_t *dst, int dstStride, const uint8_t *u, int uStride, const uint8_t *v, int vStride, int width, int height)
+{
+  for (int y = 0; y < height; y++)
+  {
+    int x = 0;
+    for (; x + 16 <= width; x += 16)
+    {
+      uint8x16x2_t uv;
+      uv.val[0] = vld1q_u8(u + x);
+      uv.val[1] = vld1q_u8(v + x);
+      vst2q_u8(dst + 2 * x, uv);
+    }
+    InterleaveRowC(dst + 2 * x, u + x, v + x, width - x);
+
+    dst += dstStride;
+    u += uStride;
+    v += vStride;
+  }
+}
+
+const KernelTable kernelsNEON =
+{
+  CopyRowsC,
+  InterleaveNEON
+};
+
+#endif
+
+//-----------------------------------------------------------------------------
+// Dispatch
+//-----------------------------------------------------------------------------
+
+const KernelTable* const tables[CSIMDKernels::TYPE_COUNT] =
+{
+  &kernelsC,
+#if defined(HAS_SSE2_KERNELS)
+  &kernelsSSE2,
+#else
+  NULL,
+#endif
+#if defined(HAS_SSE4_KERNELS)
+  &kernelsSSE4,
+#else
+  NULL,
+#endif
+#if defined(HAS_AVX2_KERNELS)
+  &kernelsAVX2,
+#else
+  NULL,
+#endif
+#if defined(HAS_NEON_KERNELS)
+  &kernelsNEON
+#else
+  NULL
+#endif
+};
+
+CSIMDDispatch<KernelTable> kernels(tables);
+
+inline const KernelTable* Kernels()
+{
+  return kernels.Get();
+}
+
+}
+
+bool CDVDPlaneKernels::SetType(Type type)
+{
+  return kernels.SetType(type);
+}
+
+CDVDPlaneKernels::Type CDVDPlaneKernels::GetType()
+{
+  return kernels.GetType();
+}
+
+void CDVDPlaneKernels::CopyPlane(uint8_t *dst, int dstStride, const uint8_t *src, int srcStride, int width, int height)
+{
+  if (width <= 0 || height <= 0)
+    return;
+
+  // contiguous planes are copied as one row
+  if (width == srcStride && width == dstStride)
+  {
+    width *= height;
+    height = 1;
+  }
+  Kernels()->CopyRows(dst, dstStride, src, srcStride, width, height);
+}
+
+void CDVDPlaneKernels::InterleavePlanes(uint8_t *dst, int dstStride,
+                                        const uint8_t *u, int uStride,
+                                        const uint8_t *v, int vStride,
+                                        int width, int height)
+{
+  if (width <= 0 || height <= 0)
+    return;
+
+  Kernels()->Interleave(dst, dstStride, u, uStride, v, vStride, width, height);
+}
@@ -0,0 +1,51 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdint.h>
+
+#include "utils/SIMDKernels.h"
+
+/*! \brief Copy kernels for 8 bit picture planes, used by CDVDCodecUtils.
+
+ The implementation (AVX2, SSE4.1, SSE2, NEON or plain C) is picked on first use
+ from the features reported by CPUInfo. Planes don't need to be aligned. Planes
+ larger than the cache are written with non-temporal stores, so a 4K frame
+ doesn't evict the decoder's working set and uploads to write-combined memory
+ (mapped PBOs) run at full speed.
+ */
+class CDVDPlaneKernels : public CSIMDKernels
+{
+public:
+  /*! \brief Select the implementation to use
+   \return false if the implementation isn't available on this CPU or build
+   */
+  static bool SetType(Type type);
+  static Type GetType();
+
+  /*! \brief Copy width bytes of height rows */
+  static void CopyPlane(uint8_t *dst, int dstStride, const uint8_t *src, int srcStride, int width, int height);
+
+  /*! \brief Interleave two chroma planes of width samples into one (NV12 from YV12) */
+  static void InterleavePlanes(uint8_t *dst, int dstStride,
+                               const uint8_t *u, int uStride,
+                               const uint8_t *v, int vStride,
+                               int width, int height);
+};
@@ -0,0 +1,435 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "DVDDecodeBenchmark.h"
+#include "DVDStreamInfo.h"
+#include "DVDInputStreams/DVDInputStream.h"
+#include "DVDInputStreams/DVDFactoryInputStream.h"
+#include "DVDDemuxers/DVDDemux.h"
+#include "DVDDemuxers/DVDDemuxUtils.h"
+#include "DVDDemuxers/DVDFactoryDemuxer.h"
+#include "DVDCodecs/DVDCodecs.h"
+#include "DVDCodecs/DVDFactoryCodec.h"
+#include "DVDCodecs/Audio/DVDAudioCodec.h"
+#include "DVDCodecs/Overlay/DVDOverlay.h"
+#include "DVDCodecs/Overlay/DVDOverlayCodec.h"
+#include "DVDCodecs/Video/DVDVideoCodec.h"
+#include "URL.h"
+#include "cores/FFmpeg.h"
+#include "utils/log.h"
+#include "utils/TimeUtils.h"
+
+#include <algorithm>
+#include <inttypes.h>
+#include <string.h>
+
+#if defined(TARGET_POSIX)
+#include <sys/resource.h>
+#endif
+#if defined(TARGET_LINUX)
+#include <malloc.h>
+#include <stdio.h>
+#endif
+
+namespace
+{
+
+// heap and thread counters are sampled every this many packets
+#define SAMPLE_INTERVAL 64
+
+// pictures still buffered in the decoder at the end of the file
+#define MAX_DRAIN_CALLS 64
+
+struct Decoder
+{
+  Decoder() : video(NULL), audio(NULL), overlay(NULL), pending(0) {}
+  CDVDVideoCodec   *video;
+  CDVDAudioCodec   *audio;
+  CDVDOverlayCodec *overlay;
+  CDVDDecodeBenchmark::StreamResult result;
+  std::vector<double> latencies;
+  int64_t pending; ///< codec time since the last frame
+};
+
+double ToSeconds(int64_t ticks)
+{
+  return (double)ticks / CurrentHostFrequency();
+}
+
+void FrameDone(Decoder &decoder)
+{
+  decoder.result.frames++;
+  decoder.latencies.push_back(ToSeconds(decoder.pending) * 1000.0);
+  decoder.pending = 0;
+}
+
+double Percentile(const std::vector<double> &sorted, double p)
+{
+  if (sorted.empty())
+    return 0.0;
+  size_t i = std::min(sorted.size() - 1, (size_t)(p * sorted.size()));
+  return sorted[i];
+}
+
+double CpuSeconds()
+{
+#if defined(TARGET_POSIX)
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) == 0)
+    return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec +
+           (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1000000.0;
+#endif
+  return 0.0;
+}
+
+int64_t HeapInUse()
+{
+#if defined(TARGET_LINUX)
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+  // mallinfo() is deprecated from glibc 2.33 on, its counters wrap at 4 GiB
+  struct mallinfo2 info = mallinfo2();
+  return (int64_t)info.uordblks + (int64_t)info.hblkhd;
+#else
+  struct mallinfo info = mallinfo();
+  return (int64_t)(unsigned int)info.uordblks + (int64_t)(unsigned int)info.hblkhd;
+#endif
+#else
+  return 0;
+#endif
+}
+
+unsigned int ThreadCount()
+{
+  unsigned int threads = 0;
+#if defined(TARGET_LINUX)
+  FILE *status = fopen("/proc/self/status", "r");
+  if (status)
+  {
+    char line[128];
+    while (fgets(line, sizeof(line), status))
+    {
+      if (sscanf(line, "Threads: %u", &threads) == 1)
+        break;
+    }
+    fclose(status);
+  }
+#endif
+  return threads;
+}
+
+void DecodeVideo(Decoder &decoder, DemuxPacket *packet)
+{
+  DVDVideoPicture picture;
+  memset(&picture, 0, sizeof(picture));
+
+  int64_t start = CurrentHostCounter();
+  int state;
+  if (packet)
+    state = decoder.video->Decode(packet->pData, packet->iSize, packet->dts, packet->pts);
+  else
+    state = decoder.video->Decode(NULL, 0, DVD_NOPTS_VALUE, DVD_NOPTS_VALUE);
+
+  // same calling sequence as CVideoPlayerVideo
+  while (!(state & VC_ERROR))
+  {
+    if (state & VC_PICTURE)
+    {
+      decoder.video->ClearPicture(&picture);
+      if (decoder.video->GetPicture(&picture) && !(picture.iFlags & DVP_FLAG_DROPPED))
+      {
+        decoder.pending += CurrentHostCounter() - start;
+        start = CurrentHostCounter();
+        FrameDone(decoder);
+      }
+    }
+    // a drain call that gives nothing back is the end of the stream
+    if ((state & VC_BUFFER) || (!packet && !(state & VC_PICTURE)))
+      break;
+    state = decoder.video->Decode(NULL, 0, DVD_NOPTS_VALUE, DVD_NOPTS_VALUE);
+  }
+  decoder.video->ClearPicture(&picture);
+  decoder.pending += CurrentHostCounter() - start;
+
+  if (state & VC_ERROR)
+    decoder.result.errors++;
+}
+
+void DecodeAudio(Decoder &decoder, DemuxPacket *packet)
+{
+  uint8_t *data = packet->pData;
+  int size = packet->iSize;
+
+  int64_t start = CurrentHostCounter();
+  while (size > 0)
+  {
+    int len = decoder.audio->Decode(data, size);
+    if (len < 0 || len > size)
+    {
+      decoder.result.errors++;
+      decoder.audio->Reset();
+      break;
+    }
+    data += len;
+    size -= len;
+
+    DVDAudioFrame frame;
+    decoder.audio->GetData(frame);
+    if (frame.nb_frames)
+    {
+      decoder.pending += CurrentHostCounter() - start;
+      start = CurrentHostCounter();
+      FrameDone(decoder);
+    }
+    else if (len == 0)
+      break;
+  }
+  decoder.pending += CurrentHostCounter() - start;
+}
+
+void DecodeOverlay(Decoder &decoder, DemuxPacket *packet)
+{
+  int64_t start = CurrentHostCounter();
+  int result = decoder.overlay->Decode(packet);
+  if (result & OC_ERROR)
+    decoder.result.errors++;
+  else if (result & OC_OVERLAY)
+  {
+    CDVDOverlay *overlay;
+    while ((overlay = decoder.overlay->GetOverlay()) != NULL)
+    {
+      overlay->Release();
+      decoder.pending += CurrentHostCounter() - start;
+      start = CurrentHostCounter();
+      FrameDone(decoder);
+    }
+  }
+  decoder.pending += CurrentHostCounter() - start;
+}
+
+}
+
+CDVDDecodeBenchmark::CDVDDecodeBenchmark()
+  : m_maxSeconds(0.0)
+  , m_decodeAll(false)
+{
+}
+
+bool CDVDDecodeBenchmark::Run(const std::string &file, Result &result)
+{
+  std::string redactPath = CURL::GetRedacted(file);
+  result = Result();
+
+  CDVDInputStream *pInputStream = CDVDFactoryInputStream::CreateInputStream(NULL, file, "");
+  if (!pInputStream)
+  {
+    CLog::Log(LOGERROR, "CDVDDecodeBenchmark::Run - error creating stream for %s", redactPath.c_str());
+    return false;
+  }
+
+  if (!pInputStream->Open(file.c_str(), "", true))
+  {
+    CLog::Log(LOGERROR, "CDVDDecodeBenchmark::Run - error opening %s", redactPath.c_str());
+    delete pInputStream;
+    return false;
+  }
+
+  CDVDDemux *pDemuxer = NULL;
+  try
+  {
+    pDemuxer = CDVDFactoryDemuxer::CreateDemuxer(pInputStream);
+  }
+  catch(...)
+  {
+    CLog::Log(LOGERROR, "CDVDDecodeBenchmark::Run - exception thrown when opening demuxer");
+    pDemuxer = NULL;
+  }
+  if (!pDemuxer)
+  {
+    delete pInputStream;
+    return false;
+  }
+
+  std::vector<Decoder> decoders;
+  bool haveVideo = false;
+  for (int i = 0; i < pDemuxer->GetNrOfStreams(); i++)
+  {
+    CDemuxStream *pStream = pDemuxer->GetStream(i);
+    if (!pStream)
+      continue;
+
+    Decoder decoder;
+    CDVDStreamInfo hint(*pStream, true);
+    if (pStream->type == STREAM_VIDEO && !haveVideo && !(pStream->flags & AV_DISPOSITION_ATTACHED_PIC))
+    {
+      // there is nothing to render to, keep hardware decoders out of it
+      hint.software = true;
+      decoder.video = CDVDFactoryCodec::CreateVideoCodec(hint);
+      if (decoder.video)
+      {
+        decoder.result.type = "video";
+        decoder.result.codec = decoder.video->GetName();
+        haveVideo = true;
+      }
+    }
+    else if (pStream->type == STREAM_AUDIO && m_decodeAll)
+    {
+      decoder.audio = CDVDFactoryCodec::CreateAudioCodec(hint);
+      if (decoder.audio)
+      {
+        decoder.result.type = "audio";
+        decoder.result.codec = decoder.audio->GetName();
+      }
+    }
+    else if (pStream->type == STREAM_SUBTITLE && m_decodeAll)
+    {
+      decoder.overlay = CDVDFactoryCodec::CreateOverlayCodec(hint);
+      if (decoder.overlay)
+      {
+        decoder.result.type = "subtitle";
+        decoder.result.codec = decoder.overlay->GetName();
+      }
+    }
+
+    if (decoder.video || decoder.audio || decoder.overlay)
+    {
+      decoder.result.id = pStream->iId;
+      decoders.push_back(decoder);
+    }
+    else
+      pStream->SetDiscard(AVDISCARD_ALL);
+  }
+
+  if (decoders.empty())
+  {
+    CLog::Log(LOGERROR, "CDVDDecodeBenchmark::Run - no decodable stream in %s", redactPath.c_str());
+    delete pDemuxer;
+    delete pInputStream;
+    return false;
+  }
+
+  int64_t heapStart = HeapInUse();
+  double cpuStart = CpuSeconds();
+  int64_t wallStart = CurrentHostCounter();
+  int64_t wallEnd = m_maxSeconds > 0.0 ? wallStart + (int64_t)(m_maxSeconds * CurrentHostFrequency()) : 0;
+  result.threadsPeak = ThreadCount();
+
+  while (true)
+  {
+    DemuxPacket *pPacket = pDemuxer->Read();
+    if (!pPacket)
+      break;
+
+    result.packetAllocations++;
+    result.packetBytes += pPacket->iSize;
+
+    for (std::vector<Decoder>::iterator it = decoders.begin(); it != decoders.end(); ++it)
+    {
+      if (it->result.id != pPacket->iStreamId)
+        continue;
+
+      int64_t start = CurrentHostCounter();
+      if (it->video)
+        DecodeVideo(*it, pPacket);
+      else if (it->audio)
+        DecodeAudio(*it, pPacket);
+      else if (it->overlay)
+        DecodeOverlay(*it, pPacket);
+      it->result.seconds += ToSeconds(CurrentHostCounter() - start);
+      it->result.packets++;
+      break;
+    }
+    CDVDDemuxUtils::FreeDemuxPacket(pPacket);
+
+    if (result.packetAllocations % SAMPLE_INTERVAL == 0)
+    {
+      result.heapPeak = std::max(result.heapPeak, HeapInUse() - heapStart);
+      result.threadsPeak = std::max(result.threadsPeak, ThreadCount());
+    }
+
+    if (wallEnd && CurrentHostCounter() > wallEnd)
+      break;
+  }
+
+  // collect what the video decoders still hold
+  for (std::vector<Decoder>::iterator it = decoders.begin(); it != decoders.end(); ++it)
+  {
+    if (!it->video)
+      continue;
+    int64_t start = CurrentHostCounter();
+    for (int i = 0; i < MAX_DRAIN_CALLS; i++)
+    {
+      unsigned int frames = it->result.frames;
+      DecodeVideo(*it, NULL);
+      if (frames == it->result.frames)
+        break;
+    }
+    it->result.seconds += ToSeconds(CurrentHostCounter() - start);
+  }
+
+  result.wallSeconds = ToSeconds(CurrentHostCounter() - wallStart);
+  result.cpuSeconds = CpuSeconds() - cpuStart;
+  if (result.wallSeconds > 0.0)
+    result.threadUtilization = result.cpuSeconds / result.wallSeconds;
+  result.threadsPeak = std::max(result.threadsPeak, ThreadCount());
+  result.heapPeak = std::max(result.heapPeak, HeapInUse() - heapStart);
+
+  bool decoded = false;
+  for (std::vector<Decoder>::iterator it = decoders.begin(); it != decoders.end(); ++it)
+  {
+    std::sort(it->latencies.begin(), it->latencies.end());
+    StreamResult &stream = it->result;
+    if (stream.seconds > 0.0)
+      stream.fps = stream.frames / stream.seconds;
+    stream.latencyP50 = Percentile(it->latencies, 0.50);
+    stream.latencyP95 = Percentile(it->latencies, 0.95);
+    stream.latencyP99 = Percentile(it->latencies, 0.99);
+    stream.latencyMax = it->latencies.empty() ? 0.0 : it->latencies.back();
+    result.streams.push_back(stream);
+    decoded |= stream.frames > 0;
+
+    delete it->video;
+    delete it->audio;
+    delete it->overlay;
+  }
+
+  delete pDemuxer;
+  delete pInputStream;
+
+  // measured once everything is released, what's left leaked or stays cached
+  result.heapGrowth = HeapInUse() - heapStart;
+
+  return decoded;
+}
+
+void CDVDDecodeBenchmark::Log(const std::string &file, const Result &result)
+{
+  CLog::Log(LOGNOTICE, "CDVDDecodeBenchmark - %s: %.2fs wall, %.2fs cpu, utilization %.2f, %u threads, "
+                       "%u packets (%" PRId64 " bytes), heap peak %" PRId64 " growth %" PRId64,
+            CURL::GetRedacted(file).c_str(), result.wallSeconds, result.cpuSeconds, result.threadUtilization,
+            result.threadsPeak, result.packetAllocations, result.packetBytes, result.heapPeak, result.heapGrowth);
+
+  for (std::vector<StreamResult>::const_iterator it = result.streams.begin(); it != result.streams.end(); ++it)
+  {
+    CLog::Log(LOGNOTICE, "CDVDDecodeBenchmark - stream %d %s (%s): %u packets, %u frames, %u errors, %.1f fps, "
+                         "latency p50 %.2fms p95 %.2fms p99 %.2fms max %.2fms",
+              it->id, it->type.c_str(), it->codec.c_str(), it->packets, it->frames, it->errors, it->fps,
+              it->latencyP50, it->latencyP95, it->latencyP99, it->latencyMax);
+  }
+}
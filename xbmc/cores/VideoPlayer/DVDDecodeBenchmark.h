@@ -0,0 +1,89 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/*! \brief Decodes a file without a player, renderer or audio engine.
+
+ Packets are read with the demuxer from CDVDFactoryDemuxer and fed to the
+ codecs from CDVDFactoryCodec as fast as they are consumed, decoded pictures,
+ audio frames and overlays are dropped. Used by the test suite to track the
+ decoder throughput on headless machines.
+ */
+class CDVDDecodeBenchmark
+{
+public:
+  struct StreamResult
+  {
+    StreamResult() : id(-1), packets(0), frames(0), errors(0), seconds(0.0),
+                     fps(0.0), latencyP50(0.0), latencyP95(0.0), latencyP99(0.0), latencyMax(0.0) {}
+    int          id;
+    std::string  type;       ///< "video", "audio" or "subtitle"
+    std::string  codec;      ///< name reported by the codec
+    unsigned int packets;
+    unsigned int frames;     ///< pictures, audio frames or overlays
+    unsigned int errors;
+    double       seconds;    ///< time spent in the codec
+    double       fps;        ///< frames per second of codec time
+    double       latencyP50; ///< codec time per frame in ms
+    double       latencyP95;
+    double       latencyP99;
+    double       latencyMax;
+  };
+
+  struct Result
+  {
+    Result() : wallSeconds(0.0), cpuSeconds(0.0), threadUtilization(0.0), threadsPeak(0),
+               heapGrowth(0), heapPeak(0), packetAllocations(0), packetBytes(0) {}
+    std::vector<StreamResult> streams;
+    double       wallSeconds;
+    double       cpuSeconds;        ///< user and system time of all threads
+    double       threadUtilization; ///< cpu time / wall time, 1.0 is one busy core
+    unsigned int threadsPeak;       ///< highest number of threads in the process
+    int64_t      heapGrowth;        ///< heap in use after the run minus before
+    int64_t      heapPeak;          ///< highest heap in use above the start
+    unsigned int packetAllocations; ///< demux packets allocated
+    int64_t      packetBytes;       ///< payload bytes of those packets
+  };
+
+  CDVDDecodeBenchmark();
+
+  /*! \brief Stop after this many seconds of wall time, 0 decodes the whole file */
+  void SetMaxSeconds(double seconds) { m_maxSeconds = seconds; }
+
+  /*! \brief Also decode audio and subtitle streams, by default only the first video stream is decoded */
+  void SetDecodeAll(bool all) { m_decodeAll = all; }
+
+  /*! \brief Decode the file
+   \return false if the file couldn't be opened or no stream could be decoded
+   */
+  bool Run(const std::string &file, Result &result);
+
+  /*! \brief Log a summary of the result */
+  static void Log(const std::string &file, const Result &result);
+
+private:
+  double m_maxSeconds;
+  bool   m_decodeAll;
+};
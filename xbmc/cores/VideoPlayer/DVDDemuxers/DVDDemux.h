@@ -21,6 +21,7 @@
  */
 
 #include <string>
+#include <vector>
 #include "system.h"
 #include "DVDDemuxPacket.h"
 
@@ -377,4 +378,17 @@ public:
    * return a user-presentable codec name of the given stream
    */
   virtual void GetStreamCodecName(int iStreamId, std::string &strName) {};
+
+  /*
+   * keep streams replaced or removed by the demuxer until they are taken with
+   * TakeDisposedStreams(), instead of deleting them. Needed when the streams are
+   * used on another thread than the one calling into the demuxer.
+   * returns false if the demuxer doesn't support it
+   */
+  virtual bool KeepDisposedStreams(bool keep) { return false; }
+
+  /*
+   * hand the streams kept since the last call over to the caller, who deletes them
+   */
+  virtual void TakeDisposedStreams(std::vector<CDemuxStream*> &streams) {}
 };
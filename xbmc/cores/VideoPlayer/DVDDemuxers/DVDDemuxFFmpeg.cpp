@@ -44,7 +44,9 @@
 #include "filesystem/Directory.h"
 #include "utils/log.h"
 #include "threads/SystemClock.h"
+#include "utils/JobManager.h"
 #include "utils/StringUtils.h"
+#include "video/VideoDatabase.h"
 #include "URL.h"
 #include "cores/FFmpeg.h"
 
@@ -71,6 +73,55 @@ static const struct StereoModeConversionMap WmvToInternalStereoModeMap[] =
 };
 
 #define FF_MAX_EXTRADATA_SIZE ((1 << 28) - FF_INPUT_BUFFER_PADDING_SIZE)
+// minimum distance of seek index entries in ms and the maximum number of entries
+#define SEEKINDEX_INTERVAL 5000
+#define SEEKINDEX_MAX_ENTRIES 4096
+// entries around the seek target must be this close (ms) for the index to be used,
+// otherwise that part of the file was never played and the index has a hole there
+#define SEEKINDEX_MAX_GAP 15000
+
+namespace
+{
+
+/*! \brief Stores the seek index of a file in the video database, off the player thread.
+ Entries stored by earlier playbacks are merged in if they weren't loaded.
+ */
+class CSaveSeekIndexJob : public CJob
+{
+public:
+  CSaveSeekIndexJob(const std::string &path, int64_t fileSize, const std::map<int, int64_t> &index, bool complete)
+    : m_path(path), m_fileSize(fileSize), m_index(index), m_complete(complete)
+  {
+  }
+
+  virtual bool DoWork()
+  {
+    CVideoDatabase db;
+    if (!db.Open())
+      return false;
+
+    std::map<int, int64_t> index;
+    if (!m_complete)
+      db.GetSeekIndex(m_path, m_fileSize, index);
+    for (std::map<int, int64_t>::const_iterator it = m_index.begin(); it != m_index.end() && index.size() < SEEKINDEX_MAX_ENTRIES; ++it)
+      index[it->first] = it->second;
+
+    db.SetSeekIndex(m_path, m_fileSize, index);
+    db.Close();
+    return true;
+  }
+
+  virtual const char *GetType() const { return "seekindex"; }
+  virtual bool IsIOBound() const { return true; }
+
+private:
+  std::string m_path;
+  int64_t m_fileSize;
+  std::map<int, int64_t> m_index;
+  bool m_complete;
+};
+
+}
 
 void CDemuxStreamAudioFFmpeg::GetStreamInfo(std::string& strInfo)
 {
@@ -175,11 +226,16 @@ CDVDDemuxFFmpeg::CDVDDemuxFFmpeg() : CDVDDemux()
   memset(&m_pkt.pkt, 0, sizeof(AVPacket));
   m_streaminfo = true; /* set to true if we want to look for streams before playback */
   m_checkvideo = false;
+  m_seekIndexStream = -1;
+  m_seekIndexChanged = false;
+  m_seekIndexLoaded = false;
+  m_keepDisposedStreams = false;
 }
 
 CDVDDemuxFFmpeg::~CDVDDemuxFFmpeg()
 {
   Dispose();
+  KeepDisposedStreams(false);
   ff_flush_avutil_log_buffers();
 }
 
@@ -506,6 +562,9 @@ bool CDVDDemuxFFmpeg::Open(CDVDInputStream* pInput, bool streaminfo, bool filein
   if (skipCreateStreams && GetNrOfStreams() == 0)
     m_program = 0;
 
+  if (!fileinfo)
+    InitSeekIndex();
+
   return true;
 }
 
@@ -514,6 +573,8 @@ void CDVDDemuxFFmpeg::Dispose()
   m_pkt.result = -1;
   av_free_packet(&m_pkt.pkt);
 
+  SaveSeekIndex();
+
   if (m_pFormatContext)
   {
     for (unsigned int i = 0; i < m_pFormatContext->nb_streams; i++)
@@ -812,6 +873,9 @@ DemuxPacket* CDVDDemuxFFmpeg::Read()
         if (pPacket->dts != DVD_NOPTS_VALUE && (pPacket->dts > m_currentPts || m_currentPts == DVD_NOPTS_VALUE))
           m_currentPts = pPacket->dts;
 
+        if (m_pkt.pkt.stream_index == m_seekIndexStream && (m_pkt.pkt.flags & AV_PKT_FLAG_KEY))
+          AddSeekIndexEntry(&m_pkt.pkt, pPacket->dts != DVD_NOPTS_VALUE ? pPacket->dts : pPacket->pts);
+
 
         // check if stream has passed full duration, needed for live streams
         bool bAllowDurationExt = (stream->codec && (stream->codec->codec_type == AVMEDIA_TYPE_VIDEO || stream->codec->codec_type == AVMEDIA_TYPE_AUDIO));
@@ -923,6 +987,13 @@ bool CDVDDemuxFFmpeg::SeekTime(int time, bool backwords, double *startpts)
     return false;
   }
 
+  if (SeekIndexed(time, backwords))
+  {
+    if(startpts)
+      *startpts = DVD_MSEC_TO_TIME(time);
+    return true;
+  }
+
   int64_t seek_pts = (int64_t)time * (AV_TIME_BASE / 1000);
   bool ismp3 = m_pFormatContext->iformat && (strcmp(m_pFormatContext->iformat->name, "mp3") == 0);
   if (m_pFormatContext->start_time != (int64_t)AV_NOPTS_VALUE && !ismp3)
@@ -969,6 +1040,113 @@ bool CDVDDemuxFFmpeg::SeekByte(int64_t pos)
   return (ret >= 0);
 }
 
+void CDVDDemuxFFmpeg::InitSeekIndex()
+{
+  m_seekIndex.clear();
+  m_seekIndexChanged = false;
+  m_seekIndexLoaded = false;
+  m_seekIndexStream = -1;
+
+  // only for plain files whose format has no index ffmpeg could seek with, those are
+  // seeked by bisecting the file which takes lots of reads on network shares
+  if (!m_pInput->IsStreamType(DVDSTREAM_TYPE_FILE)
+  ||  !m_pInput->Seek(0, SEEK_POSSIBLE)
+  ||  m_pInput->GetLength() <= 0
+  ||  (m_pFormatContext->iformat->flags & AVFMT_NO_BYTE_SEEK))
+    return;
+
+  int idx = av_find_default_stream_index(m_pFormatContext);
+  if (idx < 0)
+    return;
+  AVStream *stream = m_pFormatContext->streams[idx];
+  if (!stream->codec || stream->codec->codec_type != AVMEDIA_TYPE_VIDEO || stream->nb_index_entries > 0)
+    return;
+
+  m_seekIndexStream = idx;
+}
+
+void CDVDDemuxFFmpeg::LoadSeekIndex()
+{
+  m_seekIndexLoaded = true;
+
+  std::map<int, int64_t> index;
+  CVideoDatabase db;
+  if (!db.Open())
+    return;
+  if (db.GetSeekIndex(m_pInput->GetFileName(), m_pInput->GetLength(), index))
+    CLog::Log(LOGDEBUG, "%s - loaded %d seek index entries", __FUNCTION__, (int)index.size());
+  db.Close();
+
+  // keep the entries recorded so far
+  for (std::map<int, int64_t>::const_iterator it = index.begin(); it != index.end() && m_seekIndex.size() < SEEKINDEX_MAX_ENTRIES; ++it)
+    m_seekIndex.insert(*it);
+}
+
+void CDVDDemuxFFmpeg::SaveSeekIndex()
+{
+  if (!m_seekIndexChanged || !m_pInput)
+    return;
+  m_seekIndexChanged = false;
+
+  CJobManager::GetInstance().AddJob(new CSaveSeekIndexJob(m_pInput->GetFileName(), m_pInput->GetLength(), m_seekIndex, m_seekIndexLoaded), NULL, CJob::PRIORITY_LOW);
+}
+
+void CDVDDemuxFFmpeg::AddSeekIndexEntry(const AVPacket *pkt, double dts)
+{
+  if (pkt->pos < 0 || dts == DVD_NOPTS_VALUE || m_seekIndex.size() >= SEEKINDEX_MAX_ENTRIES)
+    return;
+
+  int time = DVD_TIME_TO_MSEC(dts);
+  std::map<int, int64_t>::iterator next = m_seekIndex.lower_bound(time);
+  if (next != m_seekIndex.end() && next->first - time < SEEKINDEX_INTERVAL)
+    return;
+  if (next != m_seekIndex.begin())
+  {
+    std::map<int, int64_t>::iterator prev = next;
+    --prev;
+    if (time - prev->first < SEEKINDEX_INTERVAL)
+      return;
+  }
+
+  m_seekIndex.insert(next, std::make_pair(time, pkt->pos));
+  m_seekIndexChanged = true;
+}
+
+bool CDVDDemuxFFmpeg::SeekIndexed(int time, bool backwords)
+{
+  if (m_seekIndexStream < 0)
+    return false;
+  // the database is only read once it's needed, most playbacks don't seek
+  if (!m_seekIndexLoaded)
+    LoadSeekIndex();
+  if (m_seekIndex.empty())
+    return false;
+
+  // the keyframes before and after the seek target must both be known
+  std::map<int, int64_t>::const_iterator next = m_seekIndex.lower_bound(time);
+  if (next == m_seekIndex.end())
+    return false;
+  std::map<int, int64_t>::const_iterator prev = next;
+  if (next->first != time)
+  {
+    if (prev == m_seekIndex.begin())
+      return false;
+    --prev;
+  }
+  if (next->first - prev->first > SEEKINDEX_MAX_GAP)
+    return false;
+
+  std::map<int, int64_t>::const_iterator target = backwords ? prev : next;
+
+  CSingleLock lock(m_critSection);
+  if (av_seek_frame(m_pFormatContext, -1, target->second, AVSEEK_FLAG_BYTE) < 0)
+    return false;
+
+  m_currentPts = DVD_MSEC_TO_TIME(target->first);
+  CLog::Log(LOGDEBUG, "%s - seek to %d ended up on indexed time %d", __FUNCTION__, time, target->first);
+  return true;
+}
+
 void CDVDDemuxFFmpeg::UpdateCurrentPTS()
 {
   m_currentPts = DVD_NOPTS_VALUE;
@@ -1089,11 +1267,37 @@ void CDVDDemuxFFmpeg::DisposeStreams()
 {
   std::map<int, CDemuxStream*>::iterator it;
   for(it = m_streams.begin(); it != m_streams.end(); ++it)
-    delete it->second;
+    DisposeStream(it->second);
   m_streams.clear();
   m_stream_index.clear();
 }
 
+void CDVDDemuxFFmpeg::DisposeStream(CDemuxStream* stream)
+{
+  if (m_keepDisposedStreams)
+    m_disposedStreams.push_back(stream);
+  else
+    delete stream;
+}
+
+bool CDVDDemuxFFmpeg::KeepDisposedStreams(bool keep)
+{
+  m_keepDisposedStreams = keep;
+  if (!keep)
+  {
+    for (std::vector<CDemuxStream*>::iterator it = m_disposedStreams.begin(); it != m_disposedStreams.end(); ++it)
+      delete *it;
+    m_disposedStreams.clear();
+  }
+  return true;
+}
+
+void CDVDDemuxFFmpeg::TakeDisposedStreams(std::vector<CDemuxStream*> &streams)
+{
+  streams.insert(streams.end(), m_disposedStreams.begin(), m_disposedStreams.end());
+  m_disposedStreams.clear();
+}
+
 CDemuxStream* CDVDDemuxFFmpeg::AddStream(int iId)
 {
   AVStream* pStream = m_pFormatContext->streams[iId];
@@ -1365,7 +1569,7 @@ void CDVDDemuxFFmpeg::AddStream(int iId, CDemuxStream* stream)
     /* replace old stream, keeping old index */
     stream->iId = res.first->second->iId;
 
-    delete res.first->second;
+    DisposeStream(res.first->second);
     res.first->second = stream;
   }
   if(g_advancedSettings.m_logLevel > LOG_LEVEL_NORMAL)
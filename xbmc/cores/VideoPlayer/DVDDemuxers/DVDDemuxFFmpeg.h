@@ -112,6 +112,8 @@ public:
   void GetChapterName(std::string& strChapterName, int chapterIdx=-1);
   int64_t GetChapterPos(int chapterIdx=-1);
   virtual void GetStreamCodecName(int iStreamId, std::string &strName);
+  virtual bool KeepDisposedStreams(bool keep);
+  virtual void TakeDisposedStreams(std::vector<CDemuxStream*> &streams);
 
   bool Aborted();
 
@@ -129,6 +131,7 @@ protected:
   CDemuxStream* GetStreamInternal(int iStreamId);
   void CreateStreams(unsigned int program = UINT_MAX);
   void DisposeStreams();
+  void DisposeStream(CDemuxStream* stream);
   void ParsePacket(AVPacket *pkt);
   bool IsVideoReady();
   void ResetVideoStreams();
@@ -143,9 +146,26 @@ protected:
 
   void GetL16Parameters(int &channels, int &samplerate);
 
+  void InitSeekIndex();
+  void LoadSeekIndex();
+  void SaveSeekIndex();
+  void AddSeekIndexEntry(const AVPacket *pkt, double dts);
+  bool SeekIndexed(int time, bool backwords);
+
   CCriticalSection m_critSection;
   std::map<int, CDemuxStream*> m_streams;
   std::vector<std::map<int, CDemuxStream*>::iterator> m_stream_index;
+  // streams replaced or removed, kept for TakeDisposedStreams() if m_keepDisposedStreams is set
+  bool m_keepDisposedStreams;
+  std::vector<CDemuxStream*> m_disposedStreams;
+
+  // keyframe time in ms to byte position, built while playing formats without a seek index
+  // of their own and persisted in the video database, so later seeks need a single read.
+  // Stored entries are read on the first seek and written by a job when the demuxer is closed.
+  std::map<int, int64_t> m_seekIndex;
+  int  m_seekIndexStream;  // ffmpeg stream the index is built for, -1 if not used
+  bool m_seekIndexChanged;
+  bool m_seekIndexLoaded;  // entries stored by earlier playbacks were read
 
   AVIOContext* m_ioContext;
 
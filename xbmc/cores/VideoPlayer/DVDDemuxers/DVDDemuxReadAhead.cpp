@@ -0,0 +1,412 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "DVDDemuxReadAhead.h"
+#include "DVDClock.h"
+#include "DVDDemuxUtils.h"
+#include "DVDInputStreams/DVDInputStream.h"
+#include "threads/SingleLock.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <cstring>
+
+// safety net for the buffer, in case the time span can't be determined
+#define READAHEAD_MAX_BYTES   (32 * 1024 * 1024)
+#define READAHEAD_MAX_PACKETS 20000
+// how long Read() waits for a packet before returning an empty one
+#define READAHEAD_READ_TIMEOUT 100
+
+CDVDDemuxReadAhead::InputState::InputState()
+  : eof(false),
+    length(0),
+    position(0),
+    hasCacheStatus(false),
+    bitrate(0.0)
+{
+  memset(&cacheStatus, 0, sizeof(cacheStatus));
+}
+
+CDVDDemuxReadAhead::CDVDDemuxReadAhead(CDVDDemux *demuxer, CDVDInputStream *input, double seconds)
+  : CThread("DemuxReadAhead"),
+    m_demuxer(demuxer),
+    m_input(input),
+    m_readAhead(seconds),
+    m_bytes(0),
+    m_generation(0),
+    m_paused(false),
+    m_chapter(0),
+    m_streamLength(0),
+    m_abort(false)
+{
+  m_fileName = m_demuxer->GetFileName();
+  m_chapter = m_demuxer->GetChapter();
+  if (!m_demuxer->KeepDisposedStreams(true))
+    CLog::Log(LOGWARNING, "CDVDDemuxReadAhead - demuxer deletes its streams while they may be in use");
+  UpdateInfo(NULL);
+  UpdateInputState();
+  CLog::Log(LOGDEBUG, "CDVDDemuxReadAhead - reading %.1f seconds ahead of %s", m_readAhead, m_fileName.c_str());
+  Create();
+}
+
+CDVDDemuxReadAhead::~CDVDDemuxReadAhead()
+{
+  m_bStop = true;
+  m_demuxer->Abort();
+  m_spaceEvent.Set();
+  StopThread();
+
+  DropPackets();
+  FreeRetiredStreams();
+  delete m_demuxer;
+}
+
+void CDVDDemuxReadAhead::Process()
+{
+  while (!m_bStop)
+  {
+    {
+      CSingleLock lock(m_section);
+      if (m_paused || m_abort || IsBufferFull())
+      {
+        lock.Leave();
+        if (!m_spaceEvent.WaitMSec(READAHEAD_READ_TIMEOUT))
+        {
+          // keep the cache status current while the buffer is full
+          CSingleLock demuxLock(m_demuxSection);
+          UpdateInputState();
+        }
+        continue;
+      }
+    }
+
+    ReadAheadPacket entry;
+    unsigned int generation;
+    {
+      // the generation is taken with the demuxer locked, seeks change it with the demuxer locked
+      CSingleLock demuxLock(m_demuxSection);
+      {
+        CSingleLock lock(m_section);
+        generation = m_generation;
+      }
+      entry.packet = m_demuxer->Read();
+      entry.chapter = m_demuxer->GetChapter();
+      UpdateInfo(entry.packet);
+      UpdateInputState();
+    }
+
+    // empty packets only signal a read timeout of the demuxer, Read() makes up its own
+    if (entry.packet && entry.packet->iSize == 0 && entry.packet->iStreamId == -1)
+    {
+      CDVDDemuxUtils::FreeDemuxPacket(entry.packet);
+      continue;
+    }
+
+    CSingleLock lock(m_section);
+    if (generation != m_generation)
+    {
+      // read before a seek or flush
+      CDVDDemuxUtils::FreeDemuxPacket(entry.packet);
+      continue;
+    }
+
+    m_packets.push_back(entry);
+    if (entry.packet)
+      m_bytes += entry.packet->iSize;
+    else
+      m_paused = true; // the player has to see the end of stream (or error) first
+    m_packetEvent.Set();
+  }
+}
+
+DemuxPacket* CDVDDemuxReadAhead::Read()
+{
+  // the player asks for the next packet, so it is done with the streams of the last one
+  FreeRetiredStreams();
+
+  CSingleLock lock(m_section);
+  while (m_packets.empty())
+  {
+    if (m_abort)
+      return NULL;
+
+    lock.Leave();
+    if (!m_packetEvent.WaitMSec(READAHEAD_READ_TIMEOUT))
+    {
+      // let the player process its messages while the source stalls
+      return CDVDDemuxUtils::AllocateDemuxPacket(0);
+    }
+    lock.Enter();
+  }
+
+  ReadAheadPacket entry = m_packets.front();
+  m_packets.pop_front();
+  if (entry.packet)
+    m_bytes -= entry.packet->iSize;
+  else
+    m_paused = false;
+  m_chapter = entry.chapter;
+  m_spaceEvent.Set();
+
+  return entry.packet;
+}
+
+bool CDVDDemuxReadAhead::IsBufferFull() const
+{
+  if (m_bytes >= READAHEAD_MAX_BYTES || m_packets.size() >= READAHEAD_MAX_PACKETS)
+    return true;
+
+  // time span between the oldest and the newest packet with a timestamp
+  double front = DVD_NOPTS_VALUE;
+  double back = DVD_NOPTS_VALUE;
+  for (std::deque<ReadAheadPacket>::const_iterator it = m_packets.begin(); it != m_packets.end() && back == DVD_NOPTS_VALUE; ++it)
+  {
+    if (it->packet)
+      back = it->packet->dts != DVD_NOPTS_VALUE ? it->packet->dts : it->packet->pts;
+  }
+  for (std::deque<ReadAheadPacket>::const_reverse_iterator it = m_packets.rbegin(); it != m_packets.rend() && front == DVD_NOPTS_VALUE; ++it)
+  {
+    if (it->packet)
+      front = it->packet->dts != DVD_NOPTS_VALUE ? it->packet->dts : it->packet->pts;
+  }
+  if (front == DVD_NOPTS_VALUE || back == DVD_NOPTS_VALUE)
+    return false;
+
+  return (front - back) / DVD_TIME_BASE >= m_readAhead;
+}
+
+void CDVDDemuxReadAhead::DropPackets()
+{
+  // nothing is read ahead any more, the wrapped demuxer is at the player position
+  int chapter = m_demuxer->GetChapter();
+
+  CSingleLock lock(m_section);
+  for (std::deque<ReadAheadPacket>::iterator it = m_packets.begin(); it != m_packets.end(); ++it)
+    CDVDDemuxUtils::FreeDemuxPacket(it->packet);
+  m_packets.clear();
+  m_bytes = 0;
+  m_generation++;
+  m_paused = false;
+  m_chapter = chapter;
+  m_spaceEvent.Set();
+}
+
+void CDVDDemuxReadAhead::UpdateInfo(const DemuxPacket *packet)
+{
+  // only called with m_demuxSection held, which also guards against the other writers
+  std::vector<CDemuxStream*> disposed;
+  m_demuxer->TakeDisposedStreams(disposed);
+
+  int count = m_demuxer->GetNrOfStreams();
+  bool streamsChanged = !packet || !disposed.empty() || count != (int)m_streams.size();
+  if (!streamsChanged && packet->iStreamId == DMX_SPECIALID_STREAMCHANGE)
+    streamsChanged = true;
+  if (!streamsChanged && packet->iStreamId >= 0 && packet->iStreamId < count)
+    streamsChanged = m_demuxer->GetStream(packet->iStreamId) != m_streams[packet->iStreamId].stream;
+
+  std::vector<StreamInfo> streams;
+  if (streamsChanged)
+  {
+    streams.resize(count);
+    for (int i = 0; i < count; i++)
+    {
+      streams[i].stream = m_demuxer->GetStream(i);
+      m_demuxer->GetStreamCodecName(i, streams[i].codecName);
+    }
+  }
+
+  int chapterCount = m_demuxer->GetChapterCount();
+  std::vector<std::pair<std::string, int64_t> > chapters;
+  bool chaptersChanged = !packet || chapterCount != (int)m_chapters.size();
+  if (chaptersChanged)
+  {
+    chapters.resize(std::max(chapterCount, 0));
+    for (int i = 0; i < chapterCount; i++)
+    {
+      m_demuxer->GetChapterName(chapters[i].first, i + 1);
+      chapters[i].second = m_demuxer->GetChapterPos(i + 1);
+    }
+  }
+
+  int streamLength = m_demuxer->GetStreamLength();
+
+  CSingleLock lock(m_section);
+  if (streamsChanged)
+    m_streams.swap(streams);
+  m_retiredStreams.insert(m_retiredStreams.end(), disposed.begin(), disposed.end());
+  if (chaptersChanged)
+    m_chapters.swap(chapters);
+  m_streamLength = streamLength;
+}
+
+void CDVDDemuxReadAhead::UpdateInputState()
+{
+  // only called with m_demuxSection held, so the input stream isn't read meanwhile
+  InputState state;
+  if (m_input)
+    GetInputState(m_input, state);
+
+  CSingleLock lock(m_section);
+  m_inputState = state;
+}
+
+void CDVDDemuxReadAhead::FreeRetiredStreams()
+{
+  std::vector<CDemuxStream*> streams;
+  {
+    CSingleLock lock(m_section);
+    streams.swap(m_retiredStreams);
+  }
+  for (std::vector<CDemuxStream*>::iterator it = streams.begin(); it != streams.end(); ++it)
+    delete *it;
+}
+
+void CDVDDemuxReadAhead::Reset()
+{
+  CSingleLock lock(m_demuxSection);
+  m_demuxer->Reset();
+  DropPackets();
+  UpdateInfo(NULL);
+  UpdateInputState();
+}
+
+void CDVDDemuxReadAhead::Abort()
+{
+  {
+    CSingleLock lock(m_section);
+    m_abort = true;
+  }
+  // may be called from another thread while the demuxer is reading, so it's not locked
+  m_demuxer->Abort();
+  m_packetEvent.Set();
+}
+
+void CDVDDemuxReadAhead::Flush()
+{
+  CSingleLock lock(m_demuxSection);
+  m_demuxer->Flush();
+  DropPackets();
+  UpdateInputState();
+}
+
+bool CDVDDemuxReadAhead::SeekTime(int time, bool backwords, double* startpts)
+{
+  CSingleLock lock(m_demuxSection);
+  bool ret = m_demuxer->SeekTime(time, backwords, startpts);
+  DropPackets();
+  UpdateInputState();
+  return ret;
+}
+
+bool CDVDDemuxReadAhead::SeekChapter(int chapter, double* startpts)
+{
+  CSingleLock lock(m_demuxSection);
+  bool ret = m_demuxer->SeekChapter(chapter, startpts);
+  DropPackets();
+  UpdateInputState();
+  return ret;
+}
+
+int CDVDDemuxReadAhead::GetChapterCount()
+{
+  CSingleLock lock(m_section);
+  return (int)m_chapters.size();
+}
+
+int CDVDDemuxReadAhead::GetChapter()
+{
+  CSingleLock lock(m_section);
+  return m_chapter;
+}
+
+void CDVDDemuxReadAhead::GetChapterName(std::string& strChapterName, int chapterIdx)
+{
+  // the current chapter of the wrapped demuxer is the one at the read-ahead position
+  if (chapterIdx == -1)
+    chapterIdx = GetChapter();
+
+  CSingleLock lock(m_section);
+  if (chapterIdx > 0 && chapterIdx <= (int)m_chapters.size())
+    strChapterName = m_chapters[chapterIdx - 1].first;
+}
+
+int64_t CDVDDemuxReadAhead::GetChapterPos(int chapterIdx)
+{
+  if (chapterIdx == -1)
+    chapterIdx = GetChapter();
+
+  CSingleLock lock(m_section);
+  if (chapterIdx > 0 && chapterIdx <= (int)m_chapters.size())
+    return m_chapters[chapterIdx - 1].second;
+  return 0;
+}
+
+void CDVDDemuxReadAhead::SetSpeed(int iSpeed)
+{
+  CSingleLock lock(m_demuxSection);
+  m_demuxer->SetSpeed(iSpeed);
+}
+
+int CDVDDemuxReadAhead::GetStreamLength()
+{
+  CSingleLock lock(m_section);
+  return m_streamLength;
+}
+
+CDemuxStream* CDVDDemuxReadAhead::GetStream(int iStreamId)
+{
+  CSingleLock lock(m_section);
+  if (iStreamId < 0 || iStreamId >= (int)m_streams.size())
+    return NULL;
+  return m_streams[iStreamId].stream;
+}
+
+int CDVDDemuxReadAhead::GetNrOfStreams()
+{
+  CSingleLock lock(m_section);
+  return (int)m_streams.size();
+}
+
+std::string CDVDDemuxReadAhead::GetFileName()
+{
+  return m_fileName;
+}
+
+void CDVDDemuxReadAhead::GetStreamCodecName(int iStreamId, std::string &strName)
+{
+  CSingleLock lock(m_section);
+  if (iStreamId >= 0 && iStreamId < (int)m_streams.size())
+    strName = m_streams[iStreamId].codecName;
+}
+
+void CDVDDemuxReadAhead::GetInputState(InputState &state)
+{
+  CSingleLock lock(m_section);
+  state = m_inputState;
+}
+
+void CDVDDemuxReadAhead::GetInputState(CDVDInputStream *input, InputState &state)
+{
+  state.eof = input->IsEOF();
+  state.length = input->GetLength();
+  state.position = input->Seek(0, SEEK_CUR);
+  state.hasCacheStatus = input->GetCacheStatus(&state.cacheStatus);
+  state.bitrate = input->GetBitstreamStats().GetBitrate();
+}
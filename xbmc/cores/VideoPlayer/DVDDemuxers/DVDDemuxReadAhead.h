@@ -0,0 +1,147 @@
+#pragma once
+/*
+ *      Copyright (C) 2012-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "DVDDemux.h"
+#include "filesystem/IFileTypes.h"
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+#include "threads/Thread.h"
+
+#include <deque>
+#include <string>
+#include <utility>
+#include <vector>
+
+/*! \brief Demuxer decorator reading packets of the wrapped demuxer ahead on its own thread.
+
+ Packets are kept in a buffer bounded by the time span they cover (and by size as a
+ safety net), so a stalling read of a network source does not block the player as
+ long as the buffer lasts. Seeks, flushes and resets drop the buffer, chapters are
+ reported for the packets the player has read, not for the read-ahead position.
+
+ All calls into the wrapped demuxer are serialized, as demuxers are not thread-safe.
+ Streams, stream length and chapters are answered from a copy taken by the reader
+ thread, so the player doesn't block on them while a read stalls. The same goes for
+ the input stream, which the player must query through GetInputState() instead.
+
+ Streams replaced or removed by the wrapped demuxer are kept until the player's next
+ Read(), so the demuxer has to support KeepDisposedStreams().
+ */
+class CDVDDemuxReadAhead : public CDVDDemux, private CThread
+{
+public:
+  /*! \brief State of the input stream, as seen by the reader thread */
+  struct InputState
+  {
+    InputState();
+
+    bool eof;
+    int64_t length;
+    int64_t position;
+    bool hasCacheStatus;              ///< the input stream is cached, cacheStatus is valid
+    XFILE::SCacheStatus cacheStatus;
+    double bitrate;                   ///< bits per second
+  };
+
+  /*!
+   \param demuxer the demuxer to read from, owned by the read-ahead demuxer from now on.
+   \param input the input stream the demuxer reads from, not owned. May be NULL.
+   \param seconds time span of packets to read ahead.
+   */
+  CDVDDemuxReadAhead(CDVDDemux *demuxer, CDVDInputStream *input, double seconds);
+  virtual ~CDVDDemuxReadAhead();
+
+  virtual void Reset();
+  virtual void Abort();
+  virtual void Flush();
+  virtual DemuxPacket* Read();
+  virtual bool SeekTime(int time, bool backwords = false, double* startpts = NULL);
+  virtual bool SeekChapter(int chapter, double* startpts = NULL);
+  virtual int GetChapterCount();
+  virtual int GetChapter();
+  virtual void GetChapterName(std::string& strChapterName, int chapterIdx=-1);
+  virtual int64_t GetChapterPos(int chapterIdx=-1);
+  virtual void SetSpeed(int iSpeed);
+  virtual int GetStreamLength();
+  virtual CDemuxStream* GetStream(int iStreamId);
+  virtual int GetNrOfStreams();
+  virtual std::string GetFileName();
+  virtual void GetStreamCodecName(int iStreamId, std::string &strName);
+
+  /*! \brief Gets the state of the input stream without touching it, see GetInputState(CDVDInputStream*, InputState&) */
+  void GetInputState(InputState &state);
+
+  /*! \brief Queries the state of an input stream
+   Must not be called for the input stream of a read-ahead demuxer, as that is read on its reader thread.
+   */
+  static void GetInputState(CDVDInputStream *input, InputState &state);
+
+protected:
+  virtual void Process();
+
+private:
+  struct ReadAheadPacket
+  {
+    DemuxPacket *packet; // NULL if the wrapped demuxer returned NULL
+    int chapter;         // chapter after the packet was read
+  };
+
+  struct StreamInfo
+  {
+    CDemuxStream *stream;
+    std::string codecName;
+  };
+
+  /*! \brief Drops all read ahead packets, must be called with m_demuxSection held */
+  void DropPackets();
+  /*! \brief Updates the copy of the demuxer info, must be called with m_demuxSection held
+   \param packet the packet just read, or NULL to update everything.
+   */
+  void UpdateInfo(const DemuxPacket *packet);
+  /*! \brief Updates the copy of the input stream state, must be called with m_demuxSection held */
+  void UpdateInputState();
+  /*! \brief Deletes the streams retired by UpdateInfo(), the player no longer uses them */
+  void FreeRetiredStreams();
+  bool IsBufferFull() const;
+
+  CDVDDemux *m_demuxer;
+  CDVDInputStream *m_input;
+  double m_readAhead;
+  std::string m_fileName;
+
+  CCriticalSection m_demuxSection; ///< serializes calls into m_demuxer
+
+  CCriticalSection m_section;      ///< guards the members below
+  std::deque<ReadAheadPacket> m_packets;
+  size_t m_bytes;
+  unsigned int m_generation;       ///< changes whenever the buffer is dropped
+  bool m_paused;                   ///< reading stops after a NULL read until it was handed out
+  int m_chapter;                   ///< chapter at the player position, taken by the reader with each packet
+  std::vector<StreamInfo> m_streams;
+  int m_streamLength;
+  std::vector<std::pair<std::string, int64_t> > m_chapters; ///< name and position of chapter 1 on
+  std::vector<CDemuxStream*> m_retiredStreams; ///< disposed by the demuxer, the player may still use them
+  InputState m_inputState;
+  bool m_abort;
+  CEvent m_packetEvent;
+  CEvent m_spaceEvent;
+};
@@ -23,19 +23,187 @@
 #endif
 #include "DVDDemuxUtils.h"
 #include "DVDClock.h"
+#include "cores/DataCacheCore.h"
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
 #include "utils/log.h"
 
+#include <algorithm>
+#include <vector>
+
 extern "C" {
 #include "libavcodec/avcodec.h"
 }
 
+// payloads are rounded up to one of four sizes per power of two from this size on
+#define PACKET_POOL_MIN_SIZE  1024
+// payloads larger than this are allocated and freed on every use
+#define PACKET_POOL_MAX_SIZE  (8 * 1024 * 1024)
+// upper bound of the payload memory kept around for reuse
+#define PACKET_POOL_MAX_BYTES (16 * 1024 * 1024)
+// upper bound of the packets without payload kept around for reuse
+#define PACKET_POOL_MAX_EMPTY 256
+
+namespace
+{
+
+/*! \brief A DemuxPacket together with the capacity of its payload buffer.
+ The packet has to be the first member, packets handed out are cast back on free.
+ */
+struct CPooledPacket
+{
+  DemuxPacket packet;
+  uint8_t *buffer;
+  size_t capacity;
+};
+
+/*! \brief Thread-safe pool recycling packet headers and their padded payload buffers.
+ Payloads are size-classed so a recycled buffer fits any packet of its class.
+ */
+class CDemuxPacketPool
+{
+public:
+  CDemuxPacketPool()
+  {
+    m_classes.push_back(PACKET_POOL_MIN_SIZE);
+    for (size_t size = PACKET_POOL_MIN_SIZE; size < PACKET_POOL_MAX_SIZE; size *= 2)
+    {
+      for (size_t step = 1; step <= 4; step++)
+        m_classes.push_back(size + size / 4 * step);
+    }
+    m_free.resize(m_classes.size());
+  }
+
+  ~CDemuxPacketPool()
+  {
+    for (std::vector<std::vector<CPooledPacket*> >::iterator it = m_free.begin(); it != m_free.end(); ++it)
+      std::for_each(it->begin(), it->end(), Destroy);
+    std::for_each(m_freeEmpty.begin(), m_freeEmpty.end(), Destroy);
+  }
+
+  CPooledPacket* Acquire(size_t size)
+  {
+    size_t cls = GetClass(size);
+    CPooledPacket *pooled = NULL;
+    {
+      CSingleLock lock(m_section);
+      std::vector<CPooledPacket*> *freeList = GetFreeList(cls);
+      if (freeList && !freeList->empty())
+      {
+        pooled = freeList->back();
+        freeList->pop_back();
+        m_info.bytesPooled -= pooled->capacity;
+        m_info.poolHits++;
+      }
+      m_info.allocations++;
+      m_info.packetsInUse++;
+      m_info.bytesInUse += cls < m_classes.size() ? m_classes[cls] : size;
+      m_info.peakPacketsInUse = std::max(m_info.peakPacketsInUse, m_info.packetsInUse);
+      m_info.peakBytesInUse = std::max(m_info.peakBytesInUse, m_info.bytesInUse);
+    }
+
+    if (!pooled)
+    {
+      pooled = new CPooledPacket;
+      pooled->buffer = NULL;
+      pooled->capacity = 0;
+      if (size > 0)
+      {
+        pooled->capacity = cls < m_classes.size() ? m_classes[cls] : size;
+        pooled->buffer = (uint8_t*)_aligned_malloc(pooled->capacity, 16);
+        if (!pooled->buffer)
+        {
+          delete pooled;
+          CSingleLock lock(m_section);
+          m_info.packetsInUse--;
+          m_info.bytesInUse -= m_classes.size() > cls ? m_classes[cls] : size;
+          return NULL;
+        }
+      }
+    }
+
+    return pooled;
+  }
+
+  void Release(CPooledPacket *pooled)
+  {
+    size_t cls = pooled->buffer ? GetClass(pooled->capacity) : m_classes.size();
+    {
+      CSingleLock lock(m_section);
+      m_info.packetsInUse--;
+      m_info.bytesInUse -= pooled->capacity;
+
+      std::vector<CPooledPacket*> *freeList = GetFreeList(cls);
+      if (freeList && (pooled->buffer ? m_info.bytesPooled + pooled->capacity <= PACKET_POOL_MAX_BYTES
+                                      : freeList->size() < PACKET_POOL_MAX_EMPTY))
+      {
+        freeList->push_back(pooled);
+        m_info.bytesPooled += pooled->capacity;
+        m_info.peakBytesPooled = std::max(m_info.peakBytesPooled, m_info.bytesPooled);
+        pooled = NULL;
+      }
+    }
+
+    if (pooled)
+      Destroy(pooled);
+  }
+
+  SDemuxPacketPoolInfo GetInfo()
+  {
+    CSingleLock lock(m_section);
+    return m_info;
+  }
+
+private:
+  /*! \brief Index of the smallest class fitting size, m_classes.size() for packets
+   without payload and m_classes.size() + 1 for payloads too large to be pooled.
+   */
+  size_t GetClass(size_t size) const
+  {
+    if (size == 0)
+      return m_classes.size();
+    if (size > PACKET_POOL_MAX_SIZE)
+      return m_classes.size() + 1;
+    return std::lower_bound(m_classes.begin(), m_classes.end(), size) - m_classes.begin();
+  }
+
+  std::vector<CPooledPacket*>* GetFreeList(size_t cls)
+  {
+    if (cls < m_free.size())
+      return &m_free[cls];
+    if (cls == m_classes.size())
+      return &m_freeEmpty;
+    return NULL;
+  }
+
+  static void Destroy(CPooledPacket *pooled)
+  {
+    if (pooled->buffer)
+      _aligned_free(pooled->buffer);
+    delete pooled;
+  }
+
+  std::vector<size_t> m_classes;
+  std::vector<std::vector<CPooledPacket*> > m_free;
+  std::vector<CPooledPacket*> m_freeEmpty;
+  SDemuxPacketPoolInfo m_info;
+  CCriticalSection m_section;
+};
+
+CDemuxPacketPool& GetPacketPool()
+{
+  static CDemuxPacketPool pool;
+  return pool;
+}
+
+}
+
 void CDVDDemuxUtils::FreeDemuxPacket(DemuxPacket* pPacket)
 {
   if (pPacket)
   {
     try {
-      if (pPacket->pData) _aligned_free(pPacket->pData);
-      delete pPacket;
+      GetPacketPool().Release(reinterpret_cast<CPooledPacket*>(pPacket));
     }
     catch(...) {
       CLog::Log(LOGERROR, "%s - Exception thrown while freeing packet", __FUNCTION__);
@@ -45,45 +213,48 @@ void CDVDDemuxUtils::FreeDemuxPacket(DemuxPacket* pPacket)
 
 DemuxPacket* CDVDDemuxUtils::AllocateDemuxPacket(int iDataSize)
 {
-  DemuxPacket* pPacket = new DemuxPacket;
-  if (!pPacket) return NULL;
-
+  CPooledPacket* pPooled = NULL;
   try
   {
-    memset(pPacket, 0, sizeof(DemuxPacket));
-
-    if (iDataSize > 0)
-    {
-      // need to allocate a few bytes more.
-      // From avcodec.h (ffmpeg)
-      /**
-        * Required number of additionally allocated bytes at the end of the input bitstream for decoding.
-        * this is mainly needed because some optimized bitstream readers read
-        * 32 or 64 bit at once and could read over the end<br>
-        * Note, if the first 23 bits of the additional bytes are not 0 then damaged
-        * MPEG bitstreams could cause overread and segfault
-        */
-      pPacket->pData =(uint8_t*)_aligned_malloc(iDataSize + FF_INPUT_BUFFER_PADDING_SIZE, 16);
-      if (!pPacket->pData)
-      {
-        FreeDemuxPacket(pPacket);
-        return NULL;
-      }
-
-      // reset the last 8 bytes to 0;
-      memset(pPacket->pData + iDataSize, 0, FF_INPUT_BUFFER_PADDING_SIZE);
-    }
-
-    // setup defaults
-    pPacket->dts       = DVD_NOPTS_VALUE;
-    pPacket->pts       = DVD_NOPTS_VALUE;
-    pPacket->iStreamId = -1;
+    // need to allocate a few bytes more.
+    // From avcodec.h (ffmpeg)
+    /**
+      * Required number of additionally allocated bytes at the end of the input bitstream for decoding.
+      * this is mainly needed because some optimized bitstream readers read
+      * 32 or 64 bit at once and could read over the end<br>
+      * Note, if the first 23 bits of the additional bytes are not 0 then damaged
+      * MPEG bitstreams could cause overread and segfault
+      */
+    pPooled = GetPacketPool().Acquire(iDataSize > 0 ? iDataSize + FF_INPUT_BUFFER_PADDING_SIZE : 0);
   }
   catch(...)
   {
     CLog::Log(LOGERROR, "%s - Exception thrown", __FUNCTION__);
-    FreeDemuxPacket(pPacket);
-    pPacket = NULL;
+    return NULL;
   }
+  if (!pPooled)
+    return NULL;
+
+  DemuxPacket* pPacket = &pPooled->packet;
+  memset(pPacket, 0, sizeof(DemuxPacket));
+
+  if (iDataSize > 0)
+  {
+    pPacket->pData = pPooled->buffer;
+    // reset the padding to 0
+    memset(pPacket->pData + iDataSize, 0, FF_INPUT_BUFFER_PADDING_SIZE);
+  }
+
+  // setup defaults
+  pPacket->dts       = DVD_NOPTS_VALUE;
+  pPacket->pts       = DVD_NOPTS_VALUE;
+  pPacket->iStreamId = -1;
+
   return pPacket;
 }
+
+void CDVDDemuxUtils::UpdatePacketPoolInfo()
+{
+  // the data cache has a lock of its own, so it's not updated per packet but by the player
+  g_dataCacheCore.SetDemuxPacketPoolInfo(GetPacketPool().GetInfo());
+}
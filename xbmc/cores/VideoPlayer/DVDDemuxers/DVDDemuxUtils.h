@@ -27,5 +27,7 @@ class CDVDDemuxUtils
 public:
   static void FreeDemuxPacket(DemuxPacket* pPacket);
   static DemuxPacket* AllocateDemuxPacket(int iDataSize = 0);
+  /*! \brief Publishes the current statistics of the packet pool to the data cache */
+  static void UpdatePacketPoolInfo();
 };
 
@@ -18,15 +18,38 @@
  *
  */
 
+
 #include "DVDMessageQueue.h"
 #include "utils/log.h"
 #include "threads/SingleLock.h"
 #include "DVDClock.h"
 #include "utils/MathUtils.h"
 
+// number of demux packets the lock-free ring holds, must be a power of 2
+#define MSGQ_RING_SIZE 4096
+
+#define DATA_GENERATION(state) ((unsigned)((state) >> 32))
+#define DATA_SIZE(state)       ((int)((state) & 0xFFFFFFFF))
+#define DATA_STATE(generation, size) (((uint64_t)(generation) << 32) | (uint32_t)(size))
+
+#define PUBLISH_SEQUENCE(state) ((unsigned)((state) >> 32))
+#define PUBLISH_WRITE(state)    ((unsigned)((state) & 0xFFFFFFFF))
+#define PUBLISH_STATE(sequence, write) (((uint64_t)(sequence) << 32) | (uint32_t)(write))
+
+static bool IsDataPacket(CDVDMsg* pMsg, int priority)
+{
+  return priority == 0 && pMsg->IsType(CDVDMsg::DEMUXER_PACKET);
+}
+
+// true if sequence a was assigned before sequence b
+static bool SequenceBefore(unsigned a, unsigned b)
+{
+  return (int)(a - b) < 0;
+}
+
 CDVDMessageQueue::CDVDMessageQueue(const std::string &owner) : m_hEvent(true), m_owner(owner)
 {
-  m_iDataSize     = 0;
+  m_dataState     = 0;
   m_bAbortRequest = false;
   m_bInitialized  = false;
   m_bCaching      = false;
@@ -34,24 +57,35 @@ CDVDMessageQueue::CDVDMessageQueue(const std::string &owner) : m_hEvent(true), m
 
   m_TimeBack      = DVD_NOPTS_VALUE;
   m_TimeFront     = DVD_NOPTS_VALUE;
+  m_frontGeneration = 0;
+  m_backGeneration  = 0;
   m_TimeSize      = 1.0 / 4.0; /* 4 seconds */
   m_iMaxDataSize  = 0;
+
+  m_listCount     = 0;
+  m_ring.resize(MSGQ_RING_SIZE);
+  m_publishState  = 0;
+  m_ringRead      = 0;
+  m_ringProducing = false;
+  m_ringCount     = 0;
+  m_waiting       = false;
 }
 
 CDVDMessageQueue::~CDVDMessageQueue()
 {
   // remove all remaining messages
   Flush(CDVDMsg::NONE);
+  DrainRing();
 }
 
 void CDVDMessageQueue::Init()
 {
-  m_iDataSize     = 0;
+  DrainRing();
+
+  m_dataState     = DATA_STATE(DATA_GENERATION(m_dataState) + 1, 0);
   m_bAbortRequest = false;
   m_bEmptied      = true;
   m_bInitialized  = true;
-  m_TimeBack      = DVD_NOPTS_VALUE;
-  m_TimeFront     = DVD_NOPTS_VALUE;
 }
 
 void CDVDMessageQueue::Flush(CDVDMsg::Message type)
@@ -61,16 +95,21 @@ void CDVDMessageQueue::Flush(CDVDMsg::Message type)
   for(SList::iterator it = m_list.begin(); it != m_list.end();)
   {
     if (it->message->IsType(type) ||  type == CDVDMsg::NONE)
+    {
       it = m_list.erase(it);
+      m_listCount--;
+    }
     else
       ++it;
   }
 
   if (type == CDVDMsg::DEMUXER_PACKET ||  type == CDVDMsg::NONE)
   {
-    m_iDataSize = 0;
-    m_TimeBack  = DVD_NOPTS_VALUE;
-    m_TimeFront = DVD_NOPTS_VALUE;
+    // packets still in the ring belong to the old generation and are dropped
+    // by the reader, as it may be taking them out concurrently
+    uint64_t state = m_dataState;
+    while (!m_dataState.compare_exchange_weak(state, DATA_STATE(DATA_GENERATION(state) + 1, 0)))
+      ;
     m_bEmptied = true;
   }
 }
@@ -89,17 +128,16 @@ void CDVDMessageQueue::End()
   CSingleLock lock(m_section);
 
   Flush(CDVDMsg::NONE);
+  // the reader has stopped at this point
+  DrainRing();
 
   m_bInitialized  = false;
-  m_iDataSize     = 0;
   m_bAbortRequest = false;
 }
 
 
 MsgQueueReturnCode CDVDMessageQueue::Put(CDVDMsg* pMsg, int priority)
 {
-  CSingleLock lock(m_section);
-
   if (!m_bInitialized)
   {
     CLog::Log(LOGWARNING, "CDVDMessageQueue(%s)::Put MSGQ_NOT_INITIALIZED", m_owner.c_str());
@@ -112,6 +150,16 @@ MsgQueueReturnCode CDVDMessageQueue::Put(CDVDMsg* pMsg, int priority)
     return MSGQ_INVALID_MSG;
   }
 
+  if (IsDataPacket(pMsg, priority) && PushRing(pMsg))
+  {
+    // only wake the reader if it is waiting, the check pairs with the one in Get()
+    if (m_waiting)
+      m_hEvent.Set();
+    return MSGQ_OK;
+  }
+
+  CSingleLock lock(m_section);
+
   SList::iterator it = m_list.begin();
   while(it != m_list.end())
   {
@@ -119,23 +167,20 @@ MsgQueueReturnCode CDVDMessageQueue::Put(CDVDMsg* pMsg, int priority)
       break;
     ++it;
   }
-  m_list.insert(it, DVDMessageListItem(pMsg, priority));
-
-  if (pMsg->IsType(CDVDMsg::DEMUXER_PACKET) && priority == 0)
+  it = m_list.insert(it, DVDMessageListItem(pMsg, priority));
+  // counted before it gets its sequence, so a reader seeing a later ring message sees the count too
+  m_listCount++;
+  if (priority == 0)
   {
-    DemuxPacket* packet = ((CDVDMsgDemuxerPacket*)pMsg)->GetPacket();
-    if(packet)
-    {
-      m_iDataSize += packet->iSize;
-      if     (packet->dts != DVD_NOPTS_VALUE)
-        m_TimeFront = packet->dts;
-      else if(packet->pts != DVD_NOPTS_VALUE)
-        m_TimeFront = packet->pts;
-      if(m_TimeBack == DVD_NOPTS_VALUE)
-        m_TimeBack = m_TimeFront;
-    }
+    uint64_t state = m_publishState;
+    while (!m_publishState.compare_exchange_weak(state, PUBLISH_STATE(PUBLISH_SEQUENCE(state) + 1, PUBLISH_WRITE(state))))
+      ;
+    it->sequence = PUBLISH_SEQUENCE(state);
   }
 
+  if (IsDataPacket(pMsg, priority))
+    AccountPut(pMsg);
+
   pMsg->Release();
 
   m_hEvent.Set(); // inform waiter for new packet
@@ -145,8 +190,6 @@ MsgQueueReturnCode CDVDMessageQueue::Put(CDVDMsg* pMsg, int priority)
 
 MsgQueueReturnCode CDVDMessageQueue::Get(CDVDMsg** pMsg, unsigned int iTimeoutInMilliSeconds, int &priority)
 {
-  CSingleLock lock(m_section);
-
   *pMsg = NULL;
 
   int ret = 0;
@@ -157,7 +200,7 @@ MsgQueueReturnCode CDVDMessageQueue::Get(CDVDMsg** pMsg, unsigned int iTimeoutIn
     return MSGQ_NOT_INITIALIZED;
   }
 
-  if(m_list.empty() && m_bEmptied == false && priority == 0 && m_owner != "teletext" && m_owner != "rds")
+  if(m_listCount == 0 && PeekRing() == NULL && m_bEmptied == false && priority == 0 && m_owner != "teletext" && m_owner != "rds")
   {
 #if !defined(TARGET_RASPBERRY_PI)
     CLog::Log(LOGWARNING, "CDVDMessageQueue(%s)::Get - asked for new data packet, with nothing available", m_owner.c_str());
@@ -167,49 +210,77 @@ MsgQueueReturnCode CDVDMessageQueue::Get(CDVDMsg** pMsg, unsigned int iTimeoutIn
 
   while (!m_bAbortRequest)
   {
-    if(!m_list.empty() && m_list.back().priority >= priority && !m_bCaching)
+    if (!m_bCaching && m_listCount == 0)
     {
-      DVDMessageListItem& item(m_list.back());
-      priority = item.priority;
+      // fast path, only the ring can hold messages
+      DVDMessageRingItem* ringItem = priority <= 0 ? PeekRing() : NULL;
+
+      // a list message may have been put before the ring message, compare them under the lock
+      if (ringItem && m_listCount != 0)
+        continue;
 
-      if (item.message->IsType(CDVDMsg::DEMUXER_PACKET) && item.priority == 0)
+      if (ringItem)
       {
-        DemuxPacket* packet = ((CDVDMsgDemuxerPacket*)item.message)->GetPacket();
-        if(packet)
-        {
-          m_iDataSize -= packet->iSize;
-          if     (packet->dts != DVD_NOPTS_VALUE)
-            m_TimeBack = packet->dts;
-          else if(packet->pts != DVD_NOPTS_VALUE)
-            m_TimeBack = packet->pts;
-        }
-
-        if(m_bEmptied && m_iDataSize > 0)
-          m_bEmptied = false;
+        CDVDMsg* msg = ringItem->message;
+        if (!PopRing())
+          continue;
+        *pMsg = msg;
+        priority = 0;
+        ret = MSGQ_OK;
+        break;
       }
+    }
+    else if (!m_bCaching)
+    {
+      CSingleLock lock(m_section);
 
-      *pMsg = item.message->Acquire();
-      m_list.pop_back();
+      DVDMessageListItem* item = m_list.empty() ? NULL : &m_list.back();
+      DVDMessageRingItem* ringItem = priority <= 0 ? PeekRing() : NULL;
 
-      ret = MSGQ_OK;
-      break;
+      // ring messages have priority 0, of equal priority messages the one put first is taken
+      if (ringItem && item && (item->priority > 0 || (item->priority == 0 && SequenceBefore(item->sequence, ringItem->sequence))))
+        ringItem = NULL;
+
+      if (ringItem)
+      {
+        CDVDMsg* msg = ringItem->message;
+        if (!PopRing())
+          continue;
+        *pMsg = msg;
+        priority = 0;
+        ret = MSGQ_OK;
+        break;
+      }
+      else if (item && item->priority >= priority)
+      {
+        priority = item->priority;
+
+        if (IsDataPacket(item->message, item->priority))
+          AccountGet(item->message, DATA_GENERATION(m_dataState));
+
+        *pMsg = item->message->Acquire();
+        m_list.pop_back();
+        m_listCount--;
+
+        ret = MSGQ_OK;
+        break;
+      }
     }
-    else if (!iTimeoutInMilliSeconds)
+
+    if (!iTimeoutInMilliSeconds)
     {
       ret = MSGQ_TIMEOUT;
       break;
     }
-    else
-    {
-      m_hEvent.Reset();
-      lock.Leave();
 
-      // wait for a new message
-      if (!m_hEvent.WaitMSec(iTimeoutInMilliSeconds))
-        return MSGQ_TIMEOUT;
-
-      lock.Enter();
-    }
+    // wait for a new message, writers only signal if m_waiting is set,
+    // so check again after setting it
+    m_hEvent.Reset();
+    m_waiting = true;
+    bool available = HasMessage(priority) || m_hEvent.WaitMSec(iTimeoutInMilliSeconds);
+    m_waiting = false;
+    if (!available)
+      return MSGQ_TIMEOUT;
   }
 
   if (m_bAbortRequest) return MSGQ_ABORT;
@@ -232,6 +303,11 @@ unsigned CDVDMessageQueue::GetPacketCount(CDVDMsg::Message type)
       count++;
   }
 
+  // packets left in the ring from before a flush are dropped by the reader
+  uint64_t ringCount = m_ringCount;
+  if (type == CDVDMsg::DEMUXER_PACKET && DATA_GENERATION(ringCount) == DATA_GENERATION(m_dataState))
+    count += DATA_SIZE(ringCount);
+
   return count;
 }
 
@@ -246,32 +322,184 @@ void CDVDMessageQueue::WaitUntilEmpty()
 
 int CDVDMessageQueue::GetLevel() const
 {
-  CSingleLock lock(m_section);
-
-  if(m_iDataSize > m_iMaxDataSize)
+  int dataSize = GetDataSize();
+  if(dataSize > m_iMaxDataSize)
     return 100;
-  if(m_iDataSize == 0)
+  if(dataSize == 0)
     return 0;
 
   if(IsDataBased())
-    return std::min(100, 100 * m_iDataSize / m_iMaxDataSize);
+    return std::min(100, 100 * dataSize / m_iMaxDataSize);
 
-  return std::min(100, MathUtils::round_int(100.0 * m_TimeSize * (m_TimeFront - m_TimeBack) / DVD_TIME_BASE ));
+  double front, back;
+  GetTimes(front, back);
+  return std::min(100, MathUtils::round_int(100.0 * m_TimeSize * (front - back) / DVD_TIME_BASE ));
 }
 
 int CDVDMessageQueue::GetTimeSize() const
 {
-  CSingleLock lock(m_section);
-
   if(IsDataBased())
     return 0;
-  else
-    return (int)((m_TimeFront - m_TimeBack) / DVD_TIME_BASE);
+
+  double front, back;
+  GetTimes(front, back);
+  return (int)((front - back) / DVD_TIME_BASE);
 }
 
 bool CDVDMessageQueue::IsDataBased() const
 {
-  return (m_TimeBack == DVD_NOPTS_VALUE  ||
-          m_TimeFront == DVD_NOPTS_VALUE ||
-          m_TimeFront <= m_TimeBack);
+  double front, back;
+  GetTimes(front, back);
+  return (back == DVD_NOPTS_VALUE  ||
+          front == DVD_NOPTS_VALUE ||
+          front <= back);
+}
+
+void CDVDMessageQueue::GetTimes(double &front, double &back) const
+{
+  unsigned generation = DATA_GENERATION(m_dataState);
+  front = m_frontGeneration == generation ? (double)m_TimeFront : DVD_NOPTS_VALUE;
+  back  = m_backGeneration  == generation ? (double)m_TimeBack  : DVD_NOPTS_VALUE;
+}
+
+unsigned CDVDMessageQueue::AccountPut(CDVDMsg* pMsg)
+{
+  DemuxPacket* packet = ((CDVDMsgDemuxerPacket*)pMsg)->GetPacket();
+  int size = packet ? packet->iSize : 0;
+
+  uint64_t state = m_dataState;
+  while (!m_dataState.compare_exchange_weak(state, DATA_STATE(DATA_GENERATION(state), DATA_SIZE(state) + size)))
+    ;
+  unsigned generation = DATA_GENERATION(state);
+
+  if (packet)
+  {
+    if (packet->dts != DVD_NOPTS_VALUE || packet->pts != DVD_NOPTS_VALUE)
+    {
+      m_TimeFront = packet->dts != DVD_NOPTS_VALUE ? packet->dts : packet->pts;
+      m_frontGeneration = generation;
+    }
+    if (m_backGeneration != generation || m_TimeBack == DVD_NOPTS_VALUE)
+    {
+      m_TimeBack = m_frontGeneration == generation ? (double)m_TimeFront : DVD_NOPTS_VALUE;
+      m_backGeneration = generation;
+    }
+  }
+
+  return generation;
+}
+
+bool CDVDMessageQueue::AccountGet(CDVDMsg* pMsg, unsigned generation)
+{
+  DemuxPacket* packet = ((CDVDMsgDemuxerPacket*)pMsg)->GetPacket();
+  int size = packet ? packet->iSize : 0;
+
+  uint64_t state = m_dataState;
+  do
+  {
+    if (DATA_GENERATION(state) != generation)
+      return false;
+  } while (!m_dataState.compare_exchange_weak(state, DATA_STATE(generation, DATA_SIZE(state) - size)));
+
+  if (packet)
+  {
+    if (packet->dts != DVD_NOPTS_VALUE || packet->pts != DVD_NOPTS_VALUE)
+    {
+      m_TimeBack = packet->dts != DVD_NOPTS_VALUE ? packet->dts : packet->pts;
+      m_backGeneration = generation;
+    }
+  }
+
+  if(m_bEmptied && DATA_SIZE(state) - size > 0)
+    m_bEmptied = false;
+
+  return true;
+}
+
+bool CDVDMessageQueue::PushRing(CDVDMsg* pMsg)
+{
+  // the ring has a single writer, concurrent writers fall back to the list
+  if (m_ringProducing.exchange(true, std::memory_order_acquire))
+    return false;
+
+  // only this thread moves the write position, list puts may advance the sequence
+  uint64_t state = m_publishState;
+  unsigned write = PUBLISH_WRITE(state);
+  if (write - m_ringRead.load(std::memory_order_acquire) >= m_ring.size())
+  {
+    m_ringProducing.store(false, std::memory_order_release);
+    return false;
+  }
+
+  DVDMessageRingItem& item = m_ring[write & (m_ring.size() - 1)];
+  item.message = pMsg;
+  item.generation = AccountPut(pMsg);
+
+  uint64_t count = m_ringCount;
+  while (!m_ringCount.compare_exchange_weak(count, DATA_STATE(item.generation, DATA_GENERATION(count) == item.generation ? DATA_SIZE(count) + 1 : 1)))
+    ;
+
+  // the item isn't visible before the exchange succeeds, so its sequence can be set on every attempt
+  do
+  {
+    item.sequence = PUBLISH_SEQUENCE(state);
+  } while (!m_publishState.compare_exchange_weak(state, PUBLISH_STATE(PUBLISH_SEQUENCE(state) + 1, write + 1)));
+
+  m_ringProducing.store(false, std::memory_order_release);
+  return true;
+}
+
+DVDMessageRingItem* CDVDMessageQueue::PeekRing()
+{
+  unsigned read = m_ringRead.load(std::memory_order_relaxed);
+  while (read != PUBLISH_WRITE(m_publishState))
+  {
+    DVDMessageRingItem* item = &m_ring[read & (m_ring.size() - 1)];
+    if (DATA_GENERATION(m_dataState) == item->generation)
+      return item;
+
+    // flushed after it was put
+    item->message->Release();
+    m_ringRead.store(++read, std::memory_order_release);
+  }
+  return NULL;
+}
+
+bool CDVDMessageQueue::PopRing()
+{
+  unsigned read = m_ringRead.load(std::memory_order_relaxed);
+  DVDMessageRingItem& item = m_ring[read & (m_ring.size() - 1)];
+  bool current = AccountGet(item.message, item.generation);
+  if (current)
+  {
+    uint64_t count = m_ringCount;
+    while (DATA_GENERATION(count) == item.generation &&
+           !m_ringCount.compare_exchange_weak(count, DATA_STATE(item.generation, DATA_SIZE(count) - 1)))
+      ;
+  }
+  else
+    item.message->Release();
+  m_ringRead.store(read + 1, std::memory_order_release);
+  return current;
+}
+
+void CDVDMessageQueue::DrainRing()
+{
+  unsigned read = m_ringRead.load(std::memory_order_relaxed);
+  for (; read != PUBLISH_WRITE(m_publishState); read++)
+    m_ring[read & (m_ring.size() - 1)].message->Release();
+  m_ringRead.store(read, std::memory_order_release);
+}
+
+bool CDVDMessageQueue::HasMessage(int priority)
+{
+  if (m_bAbortRequest)
+    return true;
+  if (priority <= 0 && PUBLISH_WRITE(m_publishState) != m_ringRead)
+    return true;
+  if (m_listCount == 0)
+    return false;
+
+  CSingleLock lock(m_section);
+  return !m_list.empty() && m_list.back().priority >= priority;
 }
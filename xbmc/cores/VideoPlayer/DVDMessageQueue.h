@@ -23,7 +23,10 @@
 #include "DVDMessage.h"
 #include <string>
 #include <list>
+#include <vector>
 #include <algorithm>
+#include <atomic>
+#include <stdint.h>
 #include "threads/CriticalSection.h"
 #include "threads/Event.h"
 
@@ -33,11 +36,13 @@ struct DVDMessageListItem
   {
     message  = msg->Acquire();
     priority = prio;
+    sequence = 0;
   }
   DVDMessageListItem()
   {
     message  = NULL;
     priority = 0;
+    sequence = 0;
   }
   DVDMessageListItem(const DVDMessageListItem& item)
   {
@@ -46,6 +51,7 @@ struct DVDMessageListItem
     else
       message = NULL;
     priority = item.priority;
+    sequence = item.sequence;
   }
  ~DVDMessageListItem()
   {
@@ -62,11 +68,20 @@ struct DVDMessageListItem
     else
       message = NULL;
     priority = item.priority;
+    sequence = item.sequence;
     return *this;
   }
 
   CDVDMsg* message;
   int      priority;
+  unsigned sequence; // order of priority 0 messages across list and ring
+};
+
+struct DVDMessageRingItem
+{
+  CDVDMsg* message;
+  unsigned sequence;
+  unsigned generation; // data generation at the time of Put, see CDVDMessageQueue::Flush
 };
 
 enum MsgQueueReturnCode
@@ -106,7 +121,7 @@ public:
     return Get(pMsg, iTimeoutInMilliSeconds, priority);
   }
 
-  int GetDataSize() const               { return m_iDataSize; }
+  int GetDataSize() const               { return (int)(m_dataState & 0xFFFFFFFF); }
   int GetTimeSize() const;
   unsigned GetPacketCount(CDVDMsg::Message type);
   bool ReceivedAbortRequest()           { return m_bAbortRequest; }
@@ -125,23 +140,59 @@ public:
 
 private:
 
+  /*! \brief Adds a demux packet to the data size and time accounting.
+   \return the data generation the packet was accounted in.
+   */
+  unsigned AccountPut(CDVDMsg* pMsg);
+  /*! \brief Removes a demux packet from the data size and time accounting.
+   \return false if the packet was flushed after it was put and must be dropped.
+   */
+  bool AccountGet(CDVDMsg* pMsg, unsigned generation);
+  void GetTimes(double &front, double &back) const;
+
+  bool PushRing(CDVDMsg* pMsg);
+  DVDMessageRingItem* PeekRing();
+  /*! \brief Takes the message returned by PeekRing() out of the ring.
+   \return false if it was flushed in the meantime, it has been released then.
+   */
+  bool PopRing();
+  void DrainRing();
+  bool HasMessage(int priority);
+
   CEvent m_hEvent;
   mutable CCriticalSection m_section;
 
-  bool m_bAbortRequest;
+  volatile bool m_bAbortRequest;
   bool m_bInitialized;
   bool m_bCaching;
 
-  int m_iDataSize;
-  double m_TimeFront;
-  double m_TimeBack;
+  // data generation (upper 32 bits) and data size (lower 32 bits), a flush starts a new generation
+  std::atomic<uint64_t> m_dataState;
+  // time front/back and the generation they were set in
+  std::atomic<double> m_TimeFront;
+  std::atomic<double> m_TimeBack;
+  std::atomic<unsigned> m_frontGeneration;
+  std::atomic<unsigned> m_backGeneration;
   double m_TimeSize;
 
   int m_iMaxDataSize;
-  bool m_bEmptied;
+  std::atomic<bool> m_bEmptied;
   std::string m_owner;
 
   typedef std::list<DVDMessageListItem> SList;
   SList m_list;
+  std::atomic<unsigned> m_listCount;
+
+  // priority 0 demux packets go through a lock-free single-producer/single-consumer
+  // ring, everything else (and packets not fitting the ring) through the locked list
+  std::vector<DVDMessageRingItem> m_ring;
+  // sequence of the next priority 0 message (upper 32 bits) and ring write position (lower 32 bits),
+  // advanced together so a ring message gets its sequence when it becomes visible to the reader
+  std::atomic<uint64_t> m_publishState;
+  std::atomic<unsigned> m_ringRead;
+  std::atomic<bool> m_ringProducing;
+  // data generation (upper 32 bits) and number of ring packets put in it (lower 32 bits)
+  std::atomic<uint64_t> m_ringCount;
+  std::atomic<bool> m_waiting;
 };
 
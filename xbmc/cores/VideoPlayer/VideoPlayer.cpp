@@ -32,6 +32,7 @@
 #include "DVDDemuxers/DVDDemuxVobsub.h"
 #include "DVDDemuxers/DVDFactoryDemuxer.h"
 #include "DVDDemuxers/DVDDemuxFFmpeg.h"
+#include "DVDDemuxers/DVDDemuxReadAhead.h"
 
 #include "DVDFileInfo.h"
 
@@ -193,6 +194,18 @@ public:
   }
 };
 
+/*! \brief Gets the state of the input stream, from the read-ahead demuxer if there is one
+ The read-ahead demuxer reads the input stream on its own thread, where a read may stall
+ while holding the input stream locked.
+ */
+static void GetInputState(CDVDInputStream* input, CDVDDemux* demuxer, CDVDDemuxReadAhead::InputState &state)
+{
+  if (CDVDDemuxReadAhead* readAhead = dynamic_cast<CDVDDemuxReadAhead*>(demuxer))
+    readAhead->GetInputState(state);
+  else
+    CDVDDemuxReadAhead::GetInputState(input, state);
+}
+
 static bool PredicateAudioPriority(const SelectionStream& lh, const SelectionStream& rh)
 {
   PREDICATE_RETURN(lh.type_index == CMediaSettings::GetInstance().GetCurrentVideoSettings().m_AudioStream
@@ -840,6 +853,13 @@ bool CVideoPlayer::OpenDemuxStream()
   if(len > 0 && tim > 0)
     m_pInputStream->SetReadRate((unsigned int) (len * 1000 / tim));
 
+  // keep a stalling network source from starving the player, from now on
+  // the input stream must only be queried through GetInputState()
+  if (g_advancedSettings.m_demuxReadAhead > 0.0f
+  &&  m_pInputStream->IsStreamType(DVDSTREAM_TYPE_FILE)
+  &&  URIUtils::IsRemote(m_pInputStream->GetFileName()))
+    m_pDemuxer = new CDVDDemuxReadAhead(m_pDemuxer, m_pInputStream, g_advancedSettings.m_demuxReadAhead);
+
   return true;
 }
 
@@ -1444,7 +1464,9 @@ void CVideoPlayer::Process()
       }
 #endif
 
-      if (!m_pInputStream->IsEOF())
+      CDVDDemuxReadAhead::InputState input;
+      GetInputState(m_pInputStream, m_pDemuxer, input);
+      if (!input.eof)
         CLog::Log(LOGINFO, "%s - eof reading from demuxer", __FUNCTION__);
 
       m_CurrentAudio.started    = false;
@@ -1682,17 +1704,18 @@ bool CVideoPlayer::GetCachingTimes(double& level, double& delay, double& offset)
   if(!m_pInputStream || !m_pDemuxer)
     return false;
 
-  XFILE::SCacheStatus status;
-  if (!m_pInputStream->GetCacheStatus(&status))
+  CDVDDemuxReadAhead::InputState input;
+  GetInputState(m_pInputStream, m_pDemuxer, input);
+  if (!input.hasCacheStatus)
     return false;
 
-  int64_t cached   = status.forward;
-  unsigned currate = status.currate;
-  unsigned maxrate = status.maxrate;
-  bool full        = status.full;
+  int64_t cached   = input.cacheStatus.forward;
+  unsigned currate = input.cacheStatus.currate;
+  unsigned maxrate = input.cacheStatus.maxrate;
+  bool full        = input.cacheStatus.full;
 
-  int64_t length  = m_pInputStream->GetLength();
-  int64_t remain  = length - m_pInputStream->Seek(0, SEEK_CUR);
+  int64_t length  = input.length;
+  int64_t remain  = length - input.position;
 
   if(cached < 0 || length <= 0 || remain < 0)
     return false;
@@ -2998,12 +3021,44 @@ bool CVideoPlayer::SeekScene(bool bPlus)
   return false;
 }
 
+/*! \brief Statistics of the demux packet pool for the debug info */
+static std::string GetPacketPoolInfo()
+{
+  SDemuxPacketPoolInfo info = g_dataCacheCore.GetDemuxPacketPoolInfo();
+  if (info.allocations == 0)
+    return "";
+
+  return StringUtils::Format(" pkt:%u/%u %s/%s pool:%s/%s hit:%d%%"
+                             , info.packetsInUse
+                             , info.peakPacketsInUse
+                             , StringUtils::SizeToString(info.bytesInUse).c_str()
+                             , StringUtils::SizeToString(info.peakBytesInUse).c_str()
+                             , StringUtils::SizeToString(info.bytesPooled).c_str()
+                             , StringUtils::SizeToString(info.peakBytesPooled).c_str()
+                             , (int)(info.poolHits * 100 / info.allocations));
+}
+
 void CVideoPlayer::GetAudioInfo(std::string& strAudioInfo)
 {
   { CSingleLock lock(m_StateSection);
     strAudioInfo = StringUtils::Format("D(%s)", m_StateInput.demux_audio.c_str());
   }
   strAudioInfo += StringUtils::Format("\nP(%s)", m_VideoPlayerAudio->GetPlayerInfo().c_str());
+
+  // buffers forwarded and copied by the resample stages of the audio engine, with their average delay
+  static const char* stageNames[AUDIO_RESAMPLE_STAGES] = { "stream", "sink", "viz" };
+  std::string strStages;
+  for (int i = 0; i < AUDIO_RESAMPLE_STAGES; i++)
+  {
+    SAudioResampleInfo info = g_dataCacheCore.GetAudioResampleInfo((EAudioResampleStage)i);
+    if (!info.active)
+      continue;
+    strStages += StringUtils::Format(" %s fwd:%" PRIu64 " dsp:%" PRIu64 " rs:%" PRIu64 " %.1fms",
+                                     stageNames[i], info.forwardedBuffers, info.dspCopies,
+                                     info.resampleCopies, info.averageDelay * 1000);
+  }
+  if (!strStages.empty())
+    strAudioInfo += StringUtils::Format("\nE(%s )", strStages.c_str());
 }
 
 void CVideoPlayer::GetVideoInfo(std::string& strVideoInfo)
@@ -3042,6 +3097,7 @@ void CVideoPlayer::GetGeneralInfo(std::string& strGeneralInfo)
         if(m_playSpeed == 0 || m_caching == CACHESTATE_FULL)
           strBuf += StringUtils::Format(" %d sec", DVD_TIME_TO_SEC(m_StateInput.cache_delay));
       }
+      strBuf += GetPacketPoolInfo();
 
       strGeneralInfo = StringUtils::Format("C( ad:% 6.3f, a/v:% 6.3f%s, dcpu:%2i%% acpu:%2i%% vcpu:%2i%%%s af:%d%% vf:%d%% amp:% 5.2f )"
           , dDelay
@@ -3078,6 +3134,7 @@ void CVideoPlayer::GetGeneralInfo(std::string& strGeneralInfo)
         if(m_playSpeed == 0 || m_caching == CACHESTATE_FULL)
           strBuf += StringUtils::Format(" %d sec", DVD_TIME_TO_SEC(m_StateInput.cache_delay));
       }
+      strBuf += GetPacketPoolInfo();
 
       strGeneralInfo = StringUtils::Format("C( ad:% 6.3f, a/v:% 6.3f%s, dcpu:%2i%% acpu:%2i%% vcpu:%2i%%%s )"
                                            , dDelay
@@ -4376,6 +4433,13 @@ void CVideoPlayer::GetVideoStreamInfo(SPlayerVideoStreamInfo &info)
 
 int CVideoPlayer::GetSourceBitrate()
 {
+  // the input stream belongs to the reader thread of a read-ahead demuxer
+  if (CDVDDemuxReadAhead* readAhead = dynamic_cast<CDVDDemuxReadAhead*>(m_pDemuxer))
+  {
+    CDVDDemuxReadAhead::InputState input;
+    readAhead->GetInputState(input);
+    return (int)input.bitrate;
+  }
   if (m_pInputStream)
     return (int)m_pInputStream->GetBitstreamStats().GetBitrate();
 
@@ -4629,16 +4693,20 @@ void CVideoPlayer::UpdatePlayState(double timeout)
     state.cache_offset = GetQueueTime() / state.time_total;
   }
 
-  XFILE::SCacheStatus status;
-  if(m_pInputStream && m_pInputStream->GetCacheStatus(&status))
+  CDVDDemuxReadAhead::InputState input;
+  if (m_pInputStream)
+    GetInputState(m_pInputStream, m_pDemuxer, input);
+  if (input.hasCacheStatus)
   {
-    state.cache_bytes = status.forward;
+    state.cache_bytes = input.cacheStatus.forward;
     if(state.time_total)
-      state.cache_bytes += m_pInputStream->GetLength() * (int64_t) (GetQueueTime() / state.time_total);
+      state.cache_bytes += input.length * (int64_t) (GetQueueTime() / state.time_total);
   }
   else
     state.cache_bytes = 0;
 
+  CDVDDemuxUtils::UpdatePacketPoolInfo();
+
   UpdateClockMaster();
 
   state.timestamp = CDVDClock::GetAbsoluteClock();
@@ -138,7 +138,6 @@ CLinuxRendererGL::CLinuxRendererGL()
 
   m_rgbBuffer = NULL;
   m_rgbBufferSize = 0;
-  m_context = NULL;
   m_rgbPbo = 0;
   m_fbo.width = 0.0;
   m_fbo.height = 0.0;
@@ -171,11 +170,7 @@ CLinuxRendererGL::~CLinuxRendererGL()
     m_rgbBuffer = NULL;
   }
 
-  if (m_context)
-  {
-    sws_freeContext(m_context);
-    m_context = NULL;
-  }
+  m_swConverter.Reset();
 
   if (m_pYUVShader)
   {
@@ -1005,11 +1000,7 @@ void CLinuxRendererGL::UnInit()
   }
   m_rgbBufferSize = 0;
 
-  if (m_context)
-  {
-    sws_freeContext(m_context);
-    m_context = NULL;
-  }
+  m_swConverter.Reset();
 
   // YV12 textures
   for (int i = 0; i < NUM_BUFFERS; ++i)
@@ -2478,14 +2469,9 @@ void CLinuxRendererGL::ToRGBFrame(YV12Image* im, unsigned flipIndexPlane, unsign
     m_rgbBuffer = (BYTE*)glMapBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, GL_WRITE_ONLY_ARB) + PBO_OFFSET;
   }
 
-  m_context = sws_getCachedContext(m_context,
-                                                 im->width, im->height, (AVPixelFormat)srcFormat,
-                                                 im->width, im->height, (AVPixelFormat)PIX_FMT_BGRA,
-                                                 SWS_FAST_BILINEAR | SwScaleCPUFlags(), NULL, NULL, NULL);
-
-  uint8_t *dst[]       = { m_rgbBuffer, 0, 0, 0 };
-  int      dstStride[] = { (int)m_sourceWidth * 4, 0, 0, 0 };
-  sws_scale(m_context, src, srcStride, 0, im->height, dst, dstStride);
+  m_swConverter.Convert(src, srcStride, srcFormat, im->width, im->height,
+                        m_rgbBuffer, (int)m_sourceWidth * 4, PIX_FMT_BGRA,
+                        SWS_FAST_BILINEAR | SwScaleCPUFlags());
 
   if (m_rgbPbo)
   {
@@ -2558,18 +2544,14 @@ void CLinuxRendererGL::ToRGBFields(YV12Image* im, unsigned flipIndexPlaneTop, un
     m_rgbBuffer = (BYTE*)glMapBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, GL_WRITE_ONLY_ARB) + PBO_OFFSET;
   }
 
-  m_context = sws_getCachedContext(m_context,
-                                                 im->width, im->height >> 1, (AVPixelFormat)srcFormat,
-                                                 im->width, im->height >> 1, (AVPixelFormat)PIX_FMT_BGRA,
-                                                 SWS_FAST_BILINEAR | SwScaleCPUFlags(), NULL, NULL, NULL);
-  uint8_t *dstTop[]    = { m_rgbBuffer, 0, 0, 0 };
-  uint8_t *dstBot[]    = { m_rgbBuffer + m_sourceWidth * m_sourceHeight * 2, 0, 0, 0 };
-  int      dstStride[] = { (int)m_sourceWidth * 4, 0, 0, 0 };
-
   //convert each YUV field to an RGB field, the top field is placed at the top of the rgb buffer
   //the bottom field is placed at the bottom of the rgb buffer
-  sws_scale(m_context, srcTop, srcStrideTop, 0, im->height >> 1, dstTop, dstStride);
-  sws_scale(m_context, srcBot, srcStrideBot, 0, im->height >> 1, dstBot, dstStride);
+  m_swConverter.Convert(srcTop, srcStrideTop, srcFormat, im->width, im->height >> 1,
+                        m_rgbBuffer, (int)m_sourceWidth * 4, PIX_FMT_BGRA,
+                        SWS_FAST_BILINEAR | SwScaleCPUFlags());
+  m_swConverter.Convert(srcBot, srcStrideBot, srcFormat, im->width, im->height >> 1,
+                        m_rgbBuffer + m_sourceWidth * m_sourceHeight * 2, (int)m_sourceWidth * 4, PIX_FMT_BGRA,
+                        SWS_FAST_BILINEAR | SwScaleCPUFlags());
 
   if (m_rgbPbo)
   {
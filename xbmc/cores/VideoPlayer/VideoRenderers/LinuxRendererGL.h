@@ -32,6 +32,7 @@
 #include "RenderFormats.h"
 #include "guilib/GraphicContext.h"
 #include "BaseRenderer.h"
+#include "RenderSwConverter.h"
 
 #include "threads/Event.h"
 
@@ -270,7 +271,7 @@ protected:
   BYTE              *m_rgbBuffer;  // if software scale is used, this will hold the result image
   unsigned int       m_rgbBufferSize;
   GLuint             m_rgbPbo;
-  struct SwsContext *m_context;
+  CRenderSwConverter m_swConverter;
 
   void BindPbo(YUVBUFFER& buff);
   void UnBindPbo(YUVBUFFER& buff);
@@ -54,10 +54,6 @@ extern "C" {
 #include "libswscale/swscale.h"
 }
 
-#if defined(__ARM_NEON__)
-#include "yuv2rgb.neon.h"
-#include "utils/CPUInfo.h"
-#endif
 #ifdef HAVE_VIDEOTOOLBOXDECODER
 #include "DVDCodecs/Video/DVDVideoCodecVideoToolBox.h"
 #include <CoreVideo/CoreVideo.h>
@@ -150,7 +146,6 @@ CLinuxRendererGLES::CLinuxRendererGLES()
   m_rgbBuffer = NULL;
   m_rgbBufferSize = 0;
 
-  m_sw_context = NULL;
   m_NumYV12Buffers = 0;
   m_iLastRenderBuffer = 0;
   m_bConfigured = false;
@@ -984,11 +979,7 @@ void CLinuxRendererGLES::UnInit()
   for (int i = 0; i < NUM_BUFFERS; ++i)
     (this->*m_textureDelete)(i);
 
-  if (m_sw_context)
-  {
-    sws_freeContext(m_sw_context);
-    m_sw_context = NULL;
-  }
+  m_swConverter.Reset();
 
   // cleanup framebuffer object if it was in use
   m_fbo.Cleanup();
@@ -1932,26 +1923,10 @@ void CLinuxRendererGLES::UploadYV12Texture(int source)
       m_rgbBuffer = new BYTE[m_rgbBufferSize];
     }
 
-#if defined(__ARM_NEON__)
-    if (g_cpuInfo.GetCPUFeatures() & CPU_FEATURE_NEON)
-    {
-      yuv420_2_rgb8888_neon(m_rgbBuffer, im->plane[0], im->plane[2], im->plane[1],
-        m_sourceWidth, m_sourceHeight, im->stride[0], im->stride[1], m_sourceWidth * 4);
-    }
-    else
-#endif
-    {
-      m_sw_context = sws_getCachedContext(m_sw_context,
-        im->width, im->height, PIX_FMT_YUV420P,
-        im->width, im->height, PIX_FMT_RGBA,
-        SWS_FAST_BILINEAR, NULL, NULL, NULL);
-
-      uint8_t *src[]  = { im->plane[0], im->plane[1], im->plane[2], 0 };
-      int srcStride[] = { int(im->stride[0]), int(im->stride[1]), int(im->stride[2]), 0 };
-      uint8_t *dst[]  = { m_rgbBuffer, 0, 0, 0 };
-      int dstStride[] = { int(m_sourceWidth*4), 0, 0, 0 };
-      sws_scale(m_sw_context, src, srcStride, 0, im->height, dst, dstStride);
-    }
+    uint8_t *src[]  = { im->plane[0], im->plane[1], im->plane[2], 0 };
+    int srcStride[] = { int(im->stride[0]), int(im->stride[1]), int(im->stride[2]), 0 };
+    m_swConverter.Convert(src, srcStride, PIX_FMT_YUV420P, im->width, im->height,
+                          m_rgbBuffer, int(m_sourceWidth*4), PIX_FMT_RGBA, SWS_FAST_BILINEAR);
   }
 
   bool deinterlacing = false;
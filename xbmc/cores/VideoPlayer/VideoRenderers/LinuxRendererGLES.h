@@ -32,6 +32,7 @@
 #include "RenderFormats.h"
 #include "guilib/GraphicContext.h"
 #include "BaseRenderer.h"
+#include "RenderSwConverter.h"
 #include "xbmc/cores/VideoPlayer/DVDCodecs/Video/DVDVideoCodec.h"
 
 class CRenderCapture;
@@ -331,7 +332,7 @@ protected:
   float m_clearColour;
 
   // software scale libraries (fallback if required gl version is not available)
-  struct SwsContext *m_sw_context;
+  CRenderSwConverter m_swConverter;
   BYTE	      *m_rgbBuffer;  // if software scale is used, this will hold the result image
   unsigned int m_rgbBufferSize;
   float        m_textureMatrix[16];
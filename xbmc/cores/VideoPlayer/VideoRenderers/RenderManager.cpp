@@ -34,6 +34,7 @@
 #include "settings/MediaSettings.h"
 #include "settings/Settings.h"
 #include "guilib/GUIFontManager.h"
+#include "guilib/GUIFontTTF.h"
 #include "cores/DataCacheCore.h"
 
 #if defined(HAS_GL)
@@ -952,6 +953,9 @@ void CRenderManager::Render(bool clear, DWORD flags, DWORD alpha, bool gui)
   if (!gui && m_pRenderer->IsGuiLayer())
     return;
 
+  // text collected by the fonts was rendered before the video
+  CGUIFontTTFBase::FlushBatch();
+
   if (!gui || m_pRenderer->IsGuiLayer())
   {
     SPresent& m = m_Queue[m_presentsource];
@@ -0,0 +1,243 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "RenderSwConverter.h"
+#include "cores/FFmpeg.h"
+#include "utils/CPUInfo.h"
+#include "utils/log.h"
+
+#include <algorithm>
+
+extern "C" {
+#include "libswscale/swscale.h"
+}
+
+#if defined(__ARM_NEON__)
+#include "yuv2rgb.neon.h"
+#endif
+
+#define MAX_THREADS 4
+
+// bands smaller than this aren't worth a thread switch
+#define MIN_BAND_ROWS 64
+
+CRenderSwConverter::CWorker::CWorker(CRenderSwConverter &owner, unsigned int band)
+  : CThread("RenderSwConverter")
+  , m_owner(owner)
+  , m_band(band)
+{
+}
+
+void CRenderSwConverter::CWorker::StopThread(bool bWait /*= true*/)
+{
+  m_bStop = true;
+  m_start.Set();
+  CThread::StopThread(bWait);
+}
+
+void CRenderSwConverter::CWorker::Start()
+{
+  m_start.Set();
+}
+
+void CRenderSwConverter::CWorker::WaitDone()
+{
+  m_done.Wait();
+}
+
+void CRenderSwConverter::CWorker::Process()
+{
+  while (!m_bStop)
+  {
+    m_start.Wait();
+    if (m_bStop)
+      break;
+
+    m_owner.ConvertBand(m_owner.m_bands[m_band]);
+    m_done.Set();
+  }
+}
+
+CRenderSwConverter::CRenderSwConverter(unsigned int threads /*= 0*/)
+  : m_threads(threads)
+  , m_width(0)
+  , m_srcFormat(-1)
+  , m_dstFormat(-1)
+  , m_flags(0)
+{
+  if (m_threads == 0)
+    m_threads = std::min(std::max(g_cpuInfo.getCPUCount(), 1), MAX_THREADS);
+}
+
+CRenderSwConverter::~CRenderSwConverter()
+{
+  Reset();
+}
+
+void CRenderSwConverter::Reset()
+{
+  for (std::vector<CWorker*>::iterator it = m_workers.begin(); it != m_workers.end(); ++it)
+  {
+    (*it)->StopThread();
+    delete *it;
+  }
+  m_workers.clear();
+
+  for (std::vector<Band>::iterator it = m_bands.begin(); it != m_bands.end(); ++it)
+  {
+    if (it->context)
+      sws_freeContext(it->context);
+  }
+  m_bands.clear();
+}
+
+unsigned int CRenderSwConverter::GetBandCount(int srcFormat, int height, unsigned int &rowAlign) const
+{
+  // swscale converts these without vertical filtering, each output row only
+  // depends on its luma row and chroma row y >> 1. Bands start on multiples
+  // of 16 rows so chroma pairs and ordered dither patterns line up as well.
+  switch (srcFormat)
+  {
+  case PIX_FMT_YUV420P:
+  case PIX_FMT_YUYV422:
+  case PIX_FMT_UYVY422:
+    rowAlign = 16;
+    break;
+  default:
+    // the generic 4:2:0 path interpolates chroma between rows
+    rowAlign = 0;
+    return 1;
+  }
+
+  // all bands must have an even height, a band ending on an odd row would get
+  // a chroma row of its own, so pictures of odd height are not split
+  if (height & 1)
+    return 1;
+
+  unsigned int count = std::max(height / MIN_BAND_ROWS, 1);
+  return std::min(count, m_threads);
+}
+
+void CRenderSwConverter::StartWorkers(unsigned int count)
+{
+  // band 0 is converted by the calling thread
+  while (m_workers.size() + 1 < count)
+  {
+    CWorker *worker = new CWorker(*this, m_workers.size() + 1);
+    worker->Create();
+    m_workers.push_back(worker);
+  }
+}
+
+bool CRenderSwConverter::Convert(uint8_t* const src[], const int srcStride[], int srcFormat, int width, int height,
+                                 uint8_t *dst, int dstStride, int dstFormat, int flags)
+{
+  unsigned int rowAlign;
+  unsigned int count = GetBandCount(srcFormat, height, rowAlign);
+
+  // contexts are cached per band, drop them when the picture changes shape
+  if (m_width != width || m_srcFormat != srcFormat || m_dstFormat != dstFormat || m_flags != flags)
+  {
+    for (std::vector<Band>::iterator it = m_bands.begin(); it != m_bands.end(); ++it)
+    {
+      if (it->context)
+        sws_freeContext(it->context);
+      it->context = NULL;
+    }
+    m_width = width;
+    m_srcFormat = srcFormat;
+    m_dstFormat = dstFormat;
+    m_flags = flags;
+  }
+
+  if (m_bands.size() < count)
+    m_bands.resize(count);
+  if (count > 1)
+    StartWorkers(count);
+
+  // bands are a multiple of rowAlign, the last one takes the even rest
+  int bandHeight = height;
+  if (count > 1)
+    bandHeight = ((height / count + rowAlign - 1) / rowAlign) * rowAlign;
+
+  int chromaShift = srcFormat == PIX_FMT_YUV420P ? 1 : 0;
+  int y = 0;
+  for (unsigned int i = 0; i < count; i++)
+  {
+    Band &band = m_bands[i];
+    band.height = std::min(bandHeight, height - y);
+    for (int p = 0; p < 4; p++)
+    {
+      int rows = p == 0 ? y : y >> chromaShift;
+      band.src[p] = src[p] ? src[p] + rows * srcStride[p] : NULL;
+      band.srcStride[p] = srcStride[p];
+    }
+    band.dst = dst + y * dstStride;
+    band.dstStride = dstStride;
+    band.result = true;
+    y += band.height;
+  }
+
+  for (unsigned int i = 1; i < count; i++)
+    m_workers[i - 1]->Start();
+
+  ConvertBand(m_bands[0]);
+
+  bool result = m_bands[0].result;
+  for (unsigned int i = 1; i < count; i++)
+  {
+    m_workers[i - 1]->WaitDone();
+    result &= m_bands[i].result;
+  }
+
+  if (!result)
+    CLog::Log(LOGERROR, "CRenderSwConverter::Convert - unable to convert format %d to %d", srcFormat, dstFormat);
+  return result;
+}
+
+void CRenderSwConverter::ConvertBand(Band &band)
+{
+  if (band.height <= 0)
+    return;
+
+#if defined(__ARM_NEON__)
+  if (m_srcFormat == PIX_FMT_YUV420P && m_dstFormat == PIX_FMT_RGBA &&
+      (g_cpuInfo.GetCPUFeatures() & CPU_FEATURE_NEON))
+  {
+    yuv420_2_rgb8888_neon(band.dst, band.src[0], band.src[2], band.src[1],
+                          m_width, band.height, band.srcStride[0], band.srcStride[1], band.dstStride);
+    return;
+  }
+#endif
+
+  band.context = sws_getCachedContext(band.context,
+                                      m_width, band.height, (AVPixelFormat)m_srcFormat,
+                                      m_width, band.height, (AVPixelFormat)m_dstFormat,
+                                      m_flags, NULL, NULL, NULL);
+  if (!band.context)
+  {
+    band.result = false;
+    return;
+  }
+
+  uint8_t *dst[]       = { band.dst, 0, 0, 0 };
+  int      dstStride[] = { band.dstStride, 0, 0, 0 };
+  sws_scale(band.context, band.src, band.srcStride, 0, band.height, dst, dstStride);
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "threads/Event.h"
+#include "threads/Thread.h"
+
+#include <stdint.h>
+#include <vector>
+
+struct SwsContext;
+
+/*! \brief Software YUV to packed RGB conversion for renderers without shader support.
+
+ The picture is cut into horizontal bands which are converted on a small pool of
+ worker threads, each with its own swscale context. Only formats where every
+ output row depends on its own source rows are split (planar 4:2:0 on even rows,
+ packed 4:2:2), so the result is identical to converting the picture in one go.
+ Bands always have an even height, pictures of odd height and other formats are
+ converted on the calling thread.
+
+ The worker threads are started on the first conversion that is split.
+ */
+class CRenderSwConverter
+{
+public:
+  /*! \param threads number of bands converted at once, 0 picks one per core up to 4 */
+  CRenderSwConverter(unsigned int threads = 0);
+  ~CRenderSwConverter();
+
+  /*! \brief Convert a picture, source and destination have the same size
+   \param src source planes
+   \param srcStride source line sizes
+   \param srcFormat source AVPixelFormat
+   \param width picture width
+   \param height picture height
+   \param dst destination buffer
+   \param dstStride destination line size
+   \param dstFormat packed destination AVPixelFormat
+   \param flags swscale flags
+   \return false if swscale can't handle the conversion
+   */
+  bool Convert(uint8_t* const src[], const int srcStride[], int srcFormat, int width, int height,
+               uint8_t *dst, int dstStride, int dstFormat, int flags);
+
+  /*! \brief Release the swscale contexts and stop the worker threads */
+  void Reset();
+
+private:
+  struct Band
+  {
+    Band() : context(NULL), dst(NULL), dstStride(0), height(0), result(true) {}
+    SwsContext *context;
+    uint8_t    *src[4];
+    int         srcStride[4];
+    uint8_t    *dst;
+    int         dstStride;
+    int         height;
+    bool        result;
+  };
+
+  class CWorker : public CThread
+  {
+  public:
+    CWorker(CRenderSwConverter &owner, unsigned int band);
+    virtual void StopThread(bool bWait = true);
+    void Start();
+    void WaitDone();
+  protected:
+    virtual void Process();
+  private:
+    CRenderSwConverter &m_owner;
+    unsigned int m_band;
+    CEvent m_start;
+    CEvent m_done;
+  };
+
+  /*! \brief Number of bands a picture can be split into without changing the result */
+  unsigned int GetBandCount(int srcFormat, int height, unsigned int &rowAlign) const;
+  void ConvertBand(Band &band);
+  void StartWorkers(unsigned int count);
+
+  unsigned int m_threads;
+  std::vector<Band> m_bands;
+  std::vector<CWorker*> m_workers;
+
+  // parameters of the current conversion, shared by all bands
+  int m_width;
+  int m_srcFormat;
+  int m_dstFormat;
+  int m_flags;
+};
@@ -0,0 +1,97 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/VideoPlayer/DVDDecodeBenchmark.h"
+#include "test/TestUtils.h"
+#include "utils/StringUtils.h"
+
+#include "gtest/gtest.h"
+
+namespace
+{
+
+void Record(const std::string &name, double value)
+{
+  testing::Test::RecordProperty(name.c_str(), StringUtils::Format("%.2f", value).c_str());
+}
+
+void RunBenchmark(bool decodeAll)
+{
+  std::vector<std::string> files =
+    CXBMCTestUtils::Instance().getDecodeBenchmarkFiles();
+
+  if (files.empty())
+  {
+    // nothing to decode, the benchmark is skipped
+    testing::Test::RecordProperty("skipped", "no files given, use --add-decodebenchmark-file to run the decode benchmark");
+    return;
+  }
+
+  for (size_t f = 0; f < files.size(); ++f)
+  {
+    // properties end up in the xml report, file<n>_stream<id>_<value>
+    std::string prefix = StringUtils::Format("file%u_", (unsigned int)f);
+    testing::Test::RecordProperty((prefix + "path").c_str(), files[f].c_str());
+
+    CDVDDecodeBenchmark benchmark;
+    benchmark.SetMaxSeconds(CXBMCTestUtils::Instance().getDecodeBenchmarkSeconds());
+    benchmark.SetDecodeAll(decodeAll);
+
+    CDVDDecodeBenchmark::Result result;
+    EXPECT_TRUE(benchmark.Run(files[f], result)) << files[f];
+    CDVDDecodeBenchmark::Log(files[f], result);
+
+    Record(prefix + "wallSeconds", result.wallSeconds);
+    Record(prefix + "threadUtilization", result.threadUtilization);
+    testing::Test::RecordProperty((prefix + "threadsPeak").c_str(), result.threadsPeak);
+    testing::Test::RecordProperty((prefix + "packetAllocations").c_str(), result.packetAllocations);
+    testing::Test::RecordProperty((prefix + "heapPeakKB").c_str(), (int)(result.heapPeak / 1024));
+    testing::Test::RecordProperty((prefix + "heapGrowthKB").c_str(), (int)(result.heapGrowth / 1024));
+
+    for (std::vector<CDVDDecodeBenchmark::StreamResult>::const_iterator it = result.streams.begin();
+         it != result.streams.end(); ++it)
+    {
+      std::string stream = prefix + StringUtils::Format("stream%d_", it->id);
+      testing::Test::RecordProperty((stream + "codec").c_str(), it->codec.c_str());
+      testing::Test::RecordProperty((stream + "frames").c_str(), it->frames);
+      testing::Test::RecordProperty((stream + "errors").c_str(), it->errors);
+      Record(stream + "fps", it->fps);
+      Record(stream + "latencyP50Ms", it->latencyP50);
+      Record(stream + "latencyP95Ms", it->latencyP95);
+      Record(stream + "latencyP99Ms", it->latencyP99);
+      Record(stream + "latencyMaxMs", it->latencyMax);
+    }
+  }
+}
+
+}
+
+/* The media files are given as arguments to the main testsuite program,
+ * nothing is decoded without them.
+ */
+TEST(TestDVDDecodeBenchmark, Video)
+{
+  RunBenchmark(false);
+}
+
+TEST(TestDVDDecodeBenchmark, AllStreams)
+{
+  RunBenchmark(true);
+}
@@ -0,0 +1,242 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/VideoPlayer/DVDClock.h"
+#include "cores/VideoPlayer/DVDDemuxers/DVDDemuxReadAhead.h"
+#include "cores/VideoPlayer/DVDDemuxers/DVDDemuxUtils.h"
+#include "threads/Event.h"
+
+#include "gtest/gtest.h"
+
+namespace
+{
+
+// time span of a packet of the fake demuxer
+const double PACKET_DURATION = DVD_TIME_BASE / 10.0;
+
+int g_deletedStreams = 0;
+
+class CFakeStream : public CDemuxStream
+{
+public:
+  virtual ~CFakeStream() { g_deletedStreams++; }
+};
+
+/*! \brief Demuxer returning packets with increasing dts, one stream and no input stream */
+class CFakeDemux : public CDVDDemux
+{
+public:
+  /*!
+   \param count number of packets before the end of stream.
+   \param stall block in Read() until aborted, as a stalled network source does.
+   \param changeStreamAt replace the stream before reading this packet, -1 for never.
+   */
+  CFakeDemux(int count, bool stall = false, int changeStreamAt = -1)
+    : m_count(count), m_next(0), m_flushedAt(-1), m_stall(stall), m_changeStreamAt(changeStreamAt),
+      m_keepDisposed(false), m_stream(new CFakeStream)
+  {
+  }
+
+  virtual ~CFakeDemux()
+  {
+    delete m_stream;
+    KeepDisposedStreams(false);
+  }
+
+  virtual void Reset() { m_next = 0; }
+  virtual void Abort() { m_resume.Set(); }
+  virtual void Flush() { m_flushedAt = m_next; }
+
+  virtual DemuxPacket* Read()
+  {
+    if (m_stall)
+    {
+      m_resume.Wait();
+      return NULL;
+    }
+    if (m_next >= m_count)
+      return NULL;
+
+    if (m_next == m_changeStreamAt)
+    {
+      if (m_keepDisposed)
+        m_disposed.push_back(m_stream);
+      else
+        delete m_stream;
+      m_stream = new CFakeStream;
+    }
+
+    DemuxPacket* packet = CDVDDemuxUtils::AllocateDemuxPacket(1);
+    packet->iSize = 1;
+    packet->iStreamId = 0;
+    packet->dts = packet->pts = m_next++ * PACKET_DURATION;
+    return packet;
+  }
+
+  virtual bool SeekTime(int time, bool backwords = false, double* startpts = NULL)
+  {
+    m_next = (int)(DVD_MSEC_TO_TIME(time) / PACKET_DURATION);
+    return true;
+  }
+
+  virtual void SetSpeed(int iSpeed) {}
+  virtual int GetStreamLength() { return (int)(m_count * PACKET_DURATION * 1000 / DVD_TIME_BASE); }
+  virtual CDemuxStream* GetStream(int iStreamId) { return iStreamId == 0 ? m_stream : NULL; }
+  virtual int GetNrOfStreams() { return 1; }
+  virtual std::string GetFileName() { return "fake"; }
+
+  virtual bool KeepDisposedStreams(bool keep)
+  {
+    m_keepDisposed = keep;
+    if (!keep)
+    {
+      for (std::vector<CDemuxStream*>::iterator it = m_disposed.begin(); it != m_disposed.end(); ++it)
+        delete *it;
+      m_disposed.clear();
+    }
+    return true;
+  }
+
+  virtual void TakeDisposedStreams(std::vector<CDemuxStream*> &streams)
+  {
+    streams.insert(streams.end(), m_disposed.begin(), m_disposed.end());
+    m_disposed.clear();
+  }
+
+  int m_count;
+  int m_next;
+  int m_flushedAt;
+  bool m_stall;
+  int m_changeStreamAt;
+  bool m_keepDisposed;
+  CEvent m_resume;
+  CDemuxStream* m_stream;
+  std::vector<CDemuxStream*> m_disposed;
+};
+
+// reads the next packet, skipping the empty ones returned while nothing was read ahead yet
+DemuxPacket* ReadPacket(CDVDDemux &demuxer)
+{
+  while (true)
+  {
+    DemuxPacket* packet = demuxer.Read();
+    if (!packet || packet->iSize > 0 || packet->iStreamId != -1)
+      return packet;
+    CDVDDemuxUtils::FreeDemuxPacket(packet);
+  }
+}
+
+int PacketIndex(const DemuxPacket* packet)
+{
+  return (int)(packet->dts / PACKET_DURATION + 0.5);
+}
+
+}
+
+TEST(TestDVDDemuxReadAhead, Order)
+{
+  CFakeDemux* fake = new CFakeDemux(200);
+  CDVDDemuxReadAhead demuxer(fake, NULL, 1.0);
+
+  for (int i = 0; i < 200; i++)
+  {
+    DemuxPacket* packet = ReadPacket(demuxer);
+    ASSERT_TRUE(packet != NULL);
+    EXPECT_EQ(i, PacketIndex(packet));
+    CDVDDemuxUtils::FreeDemuxPacket(packet);
+  }
+  EXPECT_TRUE(ReadPacket(demuxer) == NULL);
+}
+
+TEST(TestDVDDemuxReadAhead, SeekDropsBuffer)
+{
+  CFakeDemux* fake = new CFakeDemux(1000);
+  CDVDDemuxReadAhead demuxer(fake, NULL, 1.0);
+
+  DemuxPacket* packet = ReadPacket(demuxer);
+  ASSERT_TRUE(packet != NULL);
+  EXPECT_EQ(0, PacketIndex(packet));
+  CDVDDemuxUtils::FreeDemuxPacket(packet);
+
+  EXPECT_TRUE(demuxer.SeekTime(50000));
+  for (int i = 500; i < 510; i++)
+  {
+    packet = ReadPacket(demuxer);
+    ASSERT_TRUE(packet != NULL);
+    EXPECT_EQ(i, PacketIndex(packet));
+    CDVDDemuxUtils::FreeDemuxPacket(packet);
+  }
+}
+
+TEST(TestDVDDemuxReadAhead, FlushDropsBuffer)
+{
+  CFakeDemux* fake = new CFakeDemux(1000);
+  CDVDDemuxReadAhead demuxer(fake, NULL, 1.0);
+
+  DemuxPacket* packet = ReadPacket(demuxer);
+  ASSERT_TRUE(packet != NULL);
+  CDVDDemuxUtils::FreeDemuxPacket(packet);
+
+  // whatever was read ahead is gone, reading goes on where the demuxer was
+  demuxer.Flush();
+  ASSERT_GE(fake->m_flushedAt, 1);
+  packet = ReadPacket(demuxer);
+  ASSERT_TRUE(packet != NULL);
+  EXPECT_EQ(fake->m_flushedAt, PacketIndex(packet));
+  CDVDDemuxUtils::FreeDemuxPacket(packet);
+}
+
+TEST(TestDVDDemuxReadAhead, AbortStalledRead)
+{
+  CFakeDemux* fake = new CFakeDemux(1000, true);
+  CDVDDemuxReadAhead demuxer(fake, NULL, 1.0);
+
+  // the player isn't blocked by the stalled source
+  DemuxPacket* packet = demuxer.Read();
+  ASSERT_TRUE(packet != NULL);
+  EXPECT_EQ(0, packet->iSize);
+  CDVDDemuxUtils::FreeDemuxPacket(packet);
+
+  demuxer.Abort();
+  EXPECT_TRUE(ReadPacket(demuxer) == NULL);
+}
+
+TEST(TestDVDDemuxReadAhead, DisposedStreams)
+{
+  g_deletedStreams = 0;
+  {
+    CFakeDemux* fake = new CFakeDemux(20, false, 10);
+    CDVDDemuxReadAhead demuxer(fake, NULL, 1.0);
+    CDemuxStream* first = demuxer.GetStream(0);
+    ASSERT_TRUE(first != NULL);
+
+    for (int i = 0; i < 20; i++)
+    {
+      DemuxPacket* packet = ReadPacket(demuxer);
+      ASSERT_TRUE(packet != NULL);
+      if (i >= 10)
+        EXPECT_TRUE(demuxer.GetStream(0) != first);
+      CDVDDemuxUtils::FreeDemuxPacket(packet);
+    }
+    EXPECT_TRUE(ReadPacket(demuxer) == NULL);
+    EXPECT_EQ(1, g_deletedStreams);
+  }
+  EXPECT_EQ(2, g_deletedStreams);
+}
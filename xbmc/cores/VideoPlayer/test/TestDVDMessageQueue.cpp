@@ -0,0 +1,211 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/VideoPlayer/DVDMessageQueue.h"
+#include "cores/VideoPlayer/DVDDemuxers/DVDDemuxUtils.h"
+
+#include "gtest/gtest.h"
+
+#include <thread>
+
+namespace
+{
+
+const int PACKET_SIZE = 10;
+
+CDVDMsg* Packet(double dts)
+{
+  DemuxPacket* packet = CDVDDemuxUtils::AllocateDemuxPacket(PACKET_SIZE);
+  packet->iSize = PACKET_SIZE;
+  packet->dts = dts;
+  return new CDVDMsgDemuxerPacket(packet);
+}
+
+double GetDts(CDVDMsg* msg)
+{
+  return static_cast<CDVDMsgDemuxerPacket*>(msg)->GetPacket()->dts;
+}
+
+}
+
+class TestDVDMessageQueue : public ::testing::Test
+{
+protected:
+  TestDVDMessageQueue() : m_queue("test")
+  {
+    m_queue.Init();
+  }
+
+  ~TestDVDMessageQueue()
+  {
+    m_queue.End();
+  }
+
+  // takes the next message without waiting, NULL if there is none
+  CDVDMsg* Get(int priority = 0)
+  {
+    CDVDMsg* msg = NULL;
+    if (m_queue.Get(&msg, 0, priority) != MSGQ_OK)
+      return NULL;
+    return msg;
+  }
+
+  void ExpectPacket(double dts)
+  {
+    CDVDMsg* msg = Get();
+    ASSERT_TRUE(msg != NULL);
+    ASSERT_TRUE(msg->IsType(CDVDMsg::DEMUXER_PACKET));
+    EXPECT_EQ(dts, GetDts(msg));
+    msg->Release();
+  }
+
+  void ExpectMessage(CDVDMsg::Message type, int priority = 0)
+  {
+    CDVDMsg* msg = Get(priority);
+    ASSERT_TRUE(msg != NULL);
+    EXPECT_TRUE(msg->IsType(type));
+    msg->Release();
+  }
+
+  CDVDMessageQueue m_queue;
+};
+
+TEST_F(TestDVDMessageQueue, Order)
+{
+  // more packets than the ring holds, the rest goes through the list
+  const int count = 5000;
+  for (int i = 0; i < count; i++)
+    EXPECT_EQ(MSGQ_OK, m_queue.Put(Packet(i)));
+
+  EXPECT_EQ((unsigned)count, m_queue.GetPacketCount(CDVDMsg::DEMUXER_PACKET));
+  EXPECT_EQ(count * PACKET_SIZE, m_queue.GetDataSize());
+
+  for (int i = 0; i < count; i++)
+    ExpectPacket(i);
+
+  EXPECT_TRUE(Get() == NULL);
+  EXPECT_EQ(0u, m_queue.GetPacketCount(CDVDMsg::DEMUXER_PACKET));
+  EXPECT_EQ(0, m_queue.GetDataSize());
+}
+
+TEST_F(TestDVDMessageQueue, Mixed)
+{
+  // packets go through the ring, other messages through the list
+  m_queue.Put(Packet(1));
+  m_queue.Put(new CDVDMsg(CDVDMsg::GENERAL_RESET));
+  m_queue.Put(Packet(2));
+  m_queue.Put(new CDVDMsg(CDVDMsg::GENERAL_FLUSH), 1);
+  m_queue.Put(Packet(3));
+
+  EXPECT_EQ(3u, m_queue.GetPacketCount(CDVDMsg::DEMUXER_PACKET));
+  EXPECT_EQ(1u, m_queue.GetPacketCount(CDVDMsg::GENERAL_RESET));
+
+  // higher priority first, then in the order they were put
+  ExpectMessage(CDVDMsg::GENERAL_FLUSH);
+  ExpectPacket(1);
+  ExpectMessage(CDVDMsg::GENERAL_RESET);
+
+  // only messages of at least the asked priority
+  m_queue.Put(new CDVDMsg(CDVDMsg::GENERAL_RESYNC), 1);
+  ExpectMessage(CDVDMsg::GENERAL_RESYNC, 1);
+  EXPECT_TRUE(Get(1) == NULL);
+
+  ExpectPacket(2);
+  ExpectPacket(3);
+  EXPECT_TRUE(Get() == NULL);
+}
+
+TEST_F(TestDVDMessageQueue, MixedFromThread)
+{
+  // control messages and packets put by another thread come out in the order they were put
+  const int count = 20000;
+  std::thread writer([&]()
+  {
+    for (int i = 0; i < count; i++)
+    {
+      m_queue.Put(Packet(i));
+      m_queue.Put(new CDVDMsgInt(CDVDMsg::PLAYER_SETSPEED, i));
+    }
+  });
+
+  for (int i = 0; i < count; i++)
+  {
+    CDVDMsg* msg = NULL;
+    ASSERT_EQ(MSGQ_OK, m_queue.Get(&msg, 5000));
+    ASSERT_TRUE(msg->IsType(CDVDMsg::DEMUXER_PACKET)) << i;
+    EXPECT_EQ(i, GetDts(msg));
+    msg->Release();
+
+    ASSERT_EQ(MSGQ_OK, m_queue.Get(&msg, 5000));
+    ASSERT_TRUE(msg->IsType(CDVDMsg::PLAYER_SETSPEED)) << i;
+    EXPECT_EQ(i, static_cast<CDVDMsgInt*>(msg)->m_value);
+    msg->Release();
+  }
+
+  writer.join();
+  EXPECT_TRUE(Get() == NULL);
+}
+
+TEST_F(TestDVDMessageQueue, Flush)
+{
+  for (int i = 0; i < 10; i++)
+    m_queue.Put(Packet(i));
+  m_queue.Put(new CDVDMsg(CDVDMsg::GENERAL_RESET));
+
+  m_queue.Flush();
+  EXPECT_EQ(0u, m_queue.GetPacketCount(CDVDMsg::DEMUXER_PACKET));
+  EXPECT_EQ(1u, m_queue.GetPacketCount(CDVDMsg::GENERAL_RESET));
+  EXPECT_EQ(0, m_queue.GetDataSize());
+
+  // packets put after the flush are kept
+  m_queue.Put(Packet(20));
+  EXPECT_EQ(1u, m_queue.GetPacketCount(CDVDMsg::DEMUXER_PACKET));
+  EXPECT_EQ(PACKET_SIZE, m_queue.GetDataSize());
+
+  ExpectMessage(CDVDMsg::GENERAL_RESET);
+  ExpectPacket(20);
+  EXPECT_TRUE(Get() == NULL);
+
+  m_queue.Put(Packet(21));
+  m_queue.Flush(CDVDMsg::NONE);
+  EXPECT_EQ(0u, m_queue.GetPacketCount(CDVDMsg::DEMUXER_PACKET));
+  EXPECT_TRUE(Get() == NULL);
+}
+
+TEST_F(TestDVDMessageQueue, Abort)
+{
+  MsgQueueReturnCode ret = MSGQ_OK;
+  std::thread reader([&]()
+  {
+    CDVDMsg* msg = NULL;
+    ret = m_queue.Get(&msg, 10000);
+  });
+
+  m_queue.Abort();
+  reader.join();
+  EXPECT_EQ(MSGQ_ABORT, ret);
+  EXPECT_TRUE(m_queue.ReceivedAbortRequest());
+
+  // queued packets aren't handed out after an abort
+  m_queue.Put(Packet(1));
+  CDVDMsg* msg = NULL;
+  EXPECT_EQ(MSGQ_ABORT, m_queue.Get(&msg, 0));
+  EXPECT_TRUE(msg == NULL);
+}
@@ -0,0 +1,130 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/VideoPlayer/DVDCodecs/DVDPlaneKernels.h"
+#include "test/TestKernels.h"
+#include "test/TestUtils.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+class TestDVDPlaneKernels : public TestKernels<CDVDPlaneKernels>
+{
+};
+
+TEST_F(TestDVDPlaneKernels, Correctness)
+{
+  // odd widths and offsets exercise the alignment heads and the scalar tails,
+  // the large plane goes through the streaming stores
+  const int sizes[][2] = { { 35, 7 }, { 721, 5 }, { 1283, 823 } };
+
+  ForEachType([&](CDVDPlaneKernels::Type type)
+  {
+    for (unsigned int s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+    {
+      const int width = sizes[s][0];
+      const int height = sizes[s][1];
+      const int srcStride = width + 13;
+      const int dstStride = 2 * width + 7;
+      const int offset = 3;
+
+      std::vector<uint8_t> u = CTestRandom(1).Bytes(srcStride * height + offset);
+      std::vector<uint8_t> v = CTestRandom(2).Bytes(srcStride * height + offset);
+      std::vector<uint8_t> canvas = CTestRandom(3).Bytes(dstStride * height + offset);
+
+      std::vector<uint8_t> copied(canvas);
+      CDVDPlaneKernels::CopyPlane(&copied[offset], dstStride, &u[offset], srcStride, width, height);
+
+      std::vector<uint8_t> interleaved(canvas);
+      CDVDPlaneKernels::InterleavePlanes(&interleaved[offset], dstStride,
+                                         &u[offset], srcStride, &v[offset], srcStride,
+                                         width, height);
+
+      std::vector<uint8_t> contiguous(width * height);
+      CDVDPlaneKernels::CopyPlane(&contiguous[0], width, &u[offset], width, width, height);
+
+      for (int y = 0; y < height; y++)
+      {
+        for (int x = 0; x < dstStride; x++)
+        {
+          uint8_t copy = x < width ? u[offset + y * srcStride + x] : canvas[offset + y * dstStride + x];
+          ASSERT_EQ(copy, copied[offset + y * dstStride + x]) << width << "x" << height << " at " << x << "," << y;
+
+          uint8_t inter = canvas[offset + y * dstStride + x];
+          if (x < 2 * width)
+            inter = (x & 1 ? v : u)[offset + y * srcStride + x / 2];
+          ASSERT_EQ(inter, interleaved[offset + y * dstStride + x]) << width << "x" << height << " at " << x << "," << y;
+        }
+      }
+      EXPECT_TRUE(std::equal(contiguous.begin(), contiguous.end(), u.begin() + offset));
+      // nothing outside the planes may be touched
+      EXPECT_EQ(canvas[0], copied[0]);
+      EXPECT_EQ(canvas[0], interleaved[0]);
+    }
+  });
+}
+
+TEST_F(TestDVDPlaneKernels, Throughput)
+{
+  // YV12 -> YV12 copy and YV12 -> NV12 conversion of 4:2:0 frames with padded
+  // decoder strides, reported in GB/s of picture data per resolution
+  const struct { const char *name; int width; int height; } resolutions[] =
+  {
+    { "SD",   720,  576 },
+    { "HD",  1920, 1080 },
+    { "UHD", 3840, 2160 }
+  };
+  const int frames = 20;
+
+  for (unsigned int r = 0; r < sizeof(resolutions) / sizeof(resolutions[0]); r++)
+  {
+    const int width = resolutions[r].width;
+    const int height = resolutions[r].height;
+    const int stride = width + 64;
+    const int cstride = stride / 2;
+
+    std::vector<uint8_t> src = CTestRandom(1).Bytes(stride * height + 2 * cstride * height / 2);
+    std::vector<uint8_t> dst(width * height * 3 / 2);
+    const uint8_t *srcU = &src[stride * height];
+    const uint8_t *srcV = srcU + cstride * height / 2;
+    const double bytes = (double)width * height * 3 / 2;
+
+    ForEachType([&](CDVDPlaneKernels::Type type)
+    {
+      RecordThroughput(type, std::string(resolutions[r].name) + "Copy", frames, [&]()
+      {
+        uint8_t *dstU = &dst[width * height];
+        CDVDPlaneKernels::CopyPlane(&dst[0], width, &src[0], stride, width, height);
+        CDVDPlaneKernels::CopyPlane(dstU, width / 2, srcU, cstride, width / 2, height / 2);
+        CDVDPlaneKernels::CopyPlane(dstU + width * height / 4, width / 2, srcV, cstride, width / 2, height / 2);
+      }, bytes);
+
+      RecordThroughput(type, std::string(resolutions[r].name) + "NV12", frames, [&]()
+      {
+        CDVDPlaneKernels::CopyPlane(&dst[0], width, &src[0], stride, width, height);
+        CDVDPlaneKernels::InterleavePlanes(&dst[width * height], width, srcU, cstride, srcV, cstride,
+                                           width / 2, height / 2);
+      }, bytes);
+    });
+  }
+}
@@ -0,0 +1,120 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/VideoPlayer/VideoRenderers/RenderSwConverter.h"
+#include "cores/FFmpeg.h"
+#include "test/TestUtils.h"
+
+extern "C" {
+#include "libswscale/swscale.h"
+}
+
+#include "gtest/gtest.h"
+
+#include <vector>
+
+namespace
+{
+
+// the whole picture through one swscale context, the way the renderers used to do it
+std::vector<uint8_t> Reference(uint8_t* const src[], const int srcStride[], int srcFormat, int width, int height)
+{
+  std::vector<uint8_t> rgb(width * height * 4);
+  SwsContext *context = sws_getContext(width, height, (AVPixelFormat)srcFormat,
+                                       width, height, PIX_FMT_BGRA,
+                                       SWS_FAST_BILINEAR | SwScaleCPUFlags(), NULL, NULL, NULL);
+  uint8_t *dst[]       = { &rgb[0], 0, 0, 0 };
+  int      dstStride[] = { width * 4, 0, 0, 0 };
+  sws_scale(context, src, srcStride, 0, height, dst, dstStride);
+  sws_freeContext(context);
+  return rgb;
+}
+
+}
+
+TEST(TestRenderSwConverter, MatchesSingleContext)
+{
+  const int width = 1280;
+  const int heights[] = { 720, 1080, 543 };
+  const int formats[] = { PIX_FMT_YUV420P, PIX_FMT_YUYV422, PIX_FMT_UYVY422, PIX_FMT_NV12 };
+
+  CRenderSwConverter converter(4);
+  for (unsigned int h = 0; h < sizeof(heights) / sizeof(heights[0]); h++)
+  {
+    const int height = heights[h];
+    // padded strides like the decoders hand out
+    const int stride = width * 2 + 64;
+    std::vector<uint8_t> y = CTestRandom(1).Bytes(stride * height);
+    std::vector<uint8_t> u = CTestRandom(2).Bytes(stride * height);
+    std::vector<uint8_t> v = CTestRandom(3).Bytes(stride * height);
+
+    for (unsigned int f = 0; f < sizeof(formats) / sizeof(formats[0]); f++)
+    {
+      SCOPED_TRACE(formats[f]);
+      SCOPED_TRACE(height);
+
+      uint8_t *src[]    = { &y[0], &u[0], &v[0], 0 };
+      int      srcStride[] = { stride, stride / 2, stride / 2, 0 };
+      if (formats[f] == PIX_FMT_NV12)
+        srcStride[1] = stride;
+
+      std::vector<uint8_t> reference = Reference(src, srcStride, formats[f], width, height);
+      std::vector<uint8_t> rgb(width * height * 4);
+      ASSERT_TRUE(converter.Convert(src, srcStride, formats[f], width, height,
+                                    &rgb[0], width * 4, PIX_FMT_BGRA,
+                                    SWS_FAST_BILINEAR | SwScaleCPUFlags()));
+      EXPECT_TRUE(reference == rgb);
+    }
+  }
+}
+
+TEST(TestRenderSwConverter, OddHeight)
+{
+  const int width = 320;
+  const int heights[] = { 1, 33, 241, 1081 };
+  const int formats[] = { PIX_FMT_YUV420P, PIX_FMT_YUYV422, PIX_FMT_UYVY422 };
+
+  CRenderSwConverter converter(4);
+  for (unsigned int h = 0; h < sizeof(heights) / sizeof(heights[0]); h++)
+  {
+    const int height = heights[h];
+    const int stride = width * 2;
+    // 4:2:0 chroma of an odd picture has (height + 1) / 2 rows
+    std::vector<uint8_t> y = CTestRandom(4).Bytes(stride * height);
+    std::vector<uint8_t> u = CTestRandom(5).Bytes(stride * (height + 1) / 2);
+    std::vector<uint8_t> v = CTestRandom(6).Bytes(stride * (height + 1) / 2);
+
+    for (unsigned int f = 0; f < sizeof(formats) / sizeof(formats[0]); f++)
+    {
+      SCOPED_TRACE(formats[f]);
+      SCOPED_TRACE(height);
+
+      uint8_t *src[]    = { &y[0], &u[0], &v[0], 0 };
+      int      srcStride[] = { stride, stride / 2, stride / 2, 0 };
+
+      std::vector<uint8_t> reference = Reference(src, srcStride, formats[f], width, height);
+      std::vector<uint8_t> rgb(width * height * 4);
+      ASSERT_TRUE(converter.Convert(src, srcStride, formats[f], width, height,
+                                    &rgb[0], width * 4, PIX_FMT_BGRA,
+                                    SWS_FAST_BILINEAR | SwScaleCPUFlags()));
+      EXPECT_TRUE(reference == rgb);
+    }
+  }
+}
@@ -26,6 +26,7 @@
 #include "music/tags/MusicInfoTag.h"
 #include "threads/SingleLock.h"
 #include "utils/log.h"
+#include <algorithm>
 #include <math.h>
 
 CAudioDecoder::CAudioDecoder()
@@ -63,7 +64,7 @@ void CAudioDecoder::Destroy()
   m_canPlay = false;
 }
 
-bool CAudioDecoder::Create(const CFileItem &file, int64_t seekOffset)
+bool CAudioDecoder::Create(const CFileItem &file, int64_t seekOffset, float bufferTime, unsigned int maxBufferSize)
 {
   Destroy();
 
@@ -99,8 +100,11 @@ bool CAudioDecoder::Create(const CFileItem &file, int64_t seekOffset)
     return false;
   }
 
-  /* allocate the pcmBuffer for 2 seconds of audio */
-  m_pcmBuffer.Create(2 * blockSize * m_codec->m_SampleRate);
+  /* allocate the pcmBuffer for the requested time, but at least 2 seconds of audio */
+  unsigned int bufferSize = (unsigned int)(bufferTime * m_codec->m_SampleRate) * blockSize;
+  if (maxBufferSize && bufferSize > maxBufferSize)
+    bufferSize = maxBufferSize - maxBufferSize % blockSize;
+  m_pcmBuffer.Create(std::max(bufferSize, 2 * blockSize * m_codec->m_SampleRate));
 
   if (file.HasMusicInfoTag())
   {
@@ -55,7 +55,13 @@ public:
   CAudioDecoder();
   ~CAudioDecoder();
 
-  bool Create(const CFileItem &file, int64_t seekOffset);
+  /*! \brief Open a file for decoding
+   \param file the file to decode
+   \param seekOffset position to start decoding at, in ms
+   \param bufferTime seconds of decoded audio to buffer, at least 2 seconds are buffered
+   \param maxBufferSize limit for the buffer in bytes, 0 for no limit
+   */
+  bool Create(const CFileItem &file, int64_t seekOffset, float bufferTime = 2.0f, unsigned int maxBufferSize = 0);
   void Destroy();
 
   int ReadSamples(int numsamples);
@@ -21,11 +21,15 @@
 #include "PAPlayer.h"
 #include "CodecFactory.h"
 #include "FileItem.h"
+#include "URL.h"
 #include "settings/AdvancedSettings.h"
 #include "settings/Settings.h"
 #include "music/tags/MusicInfoTag.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
 #include "utils/log.h"
 #include "utils/JobManager.h"
+#include "utils/StringUtils.h"
 
 #include "cores/AudioEngine/AEFactory.h"
 #include "cores/AudioEngine/Utils/AEUtil.h"
@@ -35,6 +39,8 @@
 #define TIME_TO_CACHE_NEXT_FILE 5000 /* 5 seconds before end of song, start caching the next song */
 #define FAST_XFADE_TIME           80 /* 80 milliseconds */
 #define MAX_SKIP_XFADE_TIME     2000 /* max 2 seconds crossfade on track skip */
+#define MAX_PREFETCH_BUFFER (64 * 1024 * 1024) /* memory for all decoded ahead files */
+#define MAX_PREFETCH_WAIT       1000 /* max 1 second waiting for a file that is still decoded ahead */
 
 CAEChannelInfo ICodec::GetChannelInfo()
 {
@@ -56,6 +62,25 @@ public:
   }
 };
 
+class CPrefetchFileJob : public CJob
+{
+  CFileItem m_item;
+  PAPlayer &m_player;
+  PAPlayer::PrefetchPtr m_info;
+
+public:
+                CPrefetchFileJob(const CFileItem& item, PAPlayer &player, PAPlayer::PrefetchPtr info)
+                  : m_item(item), m_player(player), m_info(info) {}
+  virtual       ~CPrefetchFileJob() {}
+  virtual bool  DoWork()
+  {
+    // the player may be gone if the file was dropped while the job was queued
+    if (!m_info->Start())
+      return false;
+    return m_player.PrefetchFile(m_item, m_info);
+  }
+};
+
 // PAP: Psycho-acoustic Audio Player
 // Supporting all open  audio codec standards.
 // First one being nullsoft's nsv audio decoder format
@@ -76,7 +101,11 @@ PAPlayer::PAPlayer(IPlayerCallback& callback) :
   m_jobCounter         (0),
   m_continueStream     (false),
   m_newForcedPlayerTime(-1),
-  m_newForcedTotalTime (-1)
+  m_newForcedTotalTime (-1),
+  m_queuedFiles        (0),
+  m_prefetchHits       (0),
+  m_lastTimeToFirstSample(0),
+  m_totalTimeToFirstSample(0)
 {
   memset(&m_playerGUIData, 0, sizeof(m_playerGUIData));
 }
@@ -346,8 +375,12 @@ bool PAPlayer::QueueNextFileEx(const CFileItem &file, bool fadeIn/* = true */, b
     m_continueStream = false;
   }
 
-  StreamInfo *si = new StreamInfo();
-  if (!si->m_decoder.Create(file, (file.m_lStartOffset * 1000) / 75))
+  unsigned int startTime = XbmcThreads::SystemClockMillis();
+  StreamInfo *si = TakePrefetchedStream(file);
+  bool prefetched = si != NULL;
+  if (!si)
+    si = new StreamInfo();
+  if (!prefetched && !si->m_decoder.Create(file, (file.m_lStartOffset * 1000) / 75))
   {
     CLog::Log(LOGWARNING, "PAPlayer::QueueNextFileEx - Failed to create the decoder");
 
@@ -383,6 +416,17 @@ bool PAPlayer::QueueNextFileEx(const CFileItem &file, bool fadeIn/* = true */, b
     CThread::Sleep(1);
   }
 
+  unsigned int timeToFirstSample = XbmcThreads::SystemClockMillis() - startTime;
+  {
+    CSingleLock lock(m_prefetchLock);
+    m_queuedFiles++;
+    if (prefetched)
+      m_prefetchHits++;
+    m_lastTimeToFirstSample = timeToFirstSample;
+    m_totalTimeToFirstSample += timeToFirstSample;
+  }
+  CLog::Log(LOGDEBUG, "PAPlayer::QueueNextFileEx - first samples after %u ms%s", timeToFirstSample, prefetched ? ", decoded ahead" : "");
+
   // set m_upcomingCrossfadeMS depending on type of file and user settings
   UpdateCrossfadeTime(file);
 
@@ -453,6 +497,154 @@ bool PAPlayer::QueueNextFileEx(const CFileItem &file, bool fadeIn/* = true */, b
   return true;
 }
 
+void PAPlayer::PrefetchFiles(const CFileItemList &files)
+{
+  if (g_advancedSettings.m_audioDecodeAhead <= 0.0f)
+    return;
+
+  CSingleLock lock(m_prefetchLock);
+
+  // keep what is still wanted, start the new ones
+  PrefetchList prefetched;
+  for (int i = 0; i < files.Size() && i < g_advancedSettings.m_audioDecodeAheadFiles; i++)
+  {
+    const CFileItemPtr item = files.Get(i);
+    int64_t startOffset = (item->m_lStartOffset * 1000) / 75;
+
+    PrefetchList::iterator it;
+    for (it = m_prefetched.begin(); it != m_prefetched.end(); ++it)
+    {
+      if ((*it)->m_path == item->GetPath() && (*it)->m_startOffset == startOffset)
+        break;
+    }
+    if (it != m_prefetched.end())
+    {
+      prefetched.push_back(*it);
+      m_prefetched.erase(it);
+      continue;
+    }
+
+    PrefetchPtr info(new PrefetchInfo());
+    info->m_path = item->GetPath();
+    info->m_startOffset = startOffset;
+    prefetched.push_back(info);
+
+    {
+      CExclusiveLock streamsLock(m_streamsLock);
+      m_jobCounter++;
+    }
+    info->m_jobId = CJobManager::GetInstance().AddJob(new CPrefetchFileJob(*item, *this, info), this, CJob::PRIORITY_LOW);
+  }
+
+  for (PrefetchList::iterator it = m_prefetched.begin(); it != m_prefetched.end(); ++it)
+    AbortPrefetch(*it);
+  m_prefetched.swap(prefetched);
+}
+
+bool PAPlayer::PrefetchFile(const CFileItem &file, PrefetchPtr info)
+{
+  unsigned int startTime = XbmcThreads::SystemClockMillis();
+
+  StreamInfo *si = new StreamInfo();
+  bool success = si->m_decoder.Create(file, info->m_startOffset, g_advancedSettings.m_audioDecodeAhead,
+                                      MAX_PREFETCH_BUFFER / g_advancedSettings.m_audioDecodeAheadFiles);
+
+  /* decode until the buffer is filled or the file has ended */
+  while (success && si->m_decoder.GetStatus() == STATUS_QUEUING)
+  {
+    if (info->IsAborted())
+    {
+      success = false;
+      break;
+    }
+
+    int ret = si->m_decoder.ReadSamples(PACKET_SIZE);
+    if (ret == RET_ERROR)
+      success = false;
+    else if (ret == RET_SLEEP)
+      CThread::Sleep(1);
+  }
+
+  CSingleLock lock(m_prefetchLock);
+  info->m_done = true;
+  if (success && !info->IsAborted())
+  {
+    info->m_stream = si;
+    si = NULL;
+    CLog::Log(LOGDEBUG, "PAPlayer::PrefetchFile - %s decoded ahead in %u ms", CURL::GetRedacted(file.GetPath()).c_str(), XbmcThreads::SystemClockMillis() - startTime);
+  }
+  m_prefetchEvent.Set();
+  lock.Leave();
+
+  delete si;
+  return success;
+}
+
+PAPlayer::StreamInfo* PAPlayer::TakePrefetchedStream(const CFileItem &file)
+{
+  int64_t startOffset = (file.m_lStartOffset * 1000) / 75;
+
+  CSingleLock lock(m_prefetchLock);
+  PrefetchList::iterator it;
+  for (it = m_prefetched.begin(); it != m_prefetched.end(); ++it)
+  {
+    if ((*it)->m_path == file.GetPath() && (*it)->m_startOffset == startOffset)
+      break;
+  }
+  if (it == m_prefetched.end())
+    return NULL;
+
+  PrefetchPtr info = *it;
+  m_prefetched.erase(it);
+
+  // still queued behind other jobs, opening it here is faster
+  if (AbortPrefetch(info))
+    return NULL;
+
+  // the job has the file open, give it a moment to finish before opening it again
+  XbmcThreads::EndTime timeout(MAX_PREFETCH_WAIT);
+  while (!info->m_done && !timeout.IsTimePast())
+  {
+    lock.Leave();
+    m_prefetchEvent.WaitMSec(std::min(timeout.MillisLeft(), 100u));
+    lock.Enter();
+  }
+  if (!info->m_done)
+  {
+    AbortPrefetch(info);
+    CLog::Log(LOGDEBUG, "PAPlayer::TakePrefetchedStream - %s not decoded ahead in time", CURL::GetRedacted(file.GetPath()).c_str());
+    return NULL;
+  }
+
+  StreamInfo *si = info->m_stream;
+  info->m_stream = NULL;
+  return si;
+}
+
+void PAPlayer::ClearPrefetched()
+{
+  CSingleLock lock(m_prefetchLock);
+  for (PrefetchList::iterator it = m_prefetched.begin(); it != m_prefetched.end(); ++it)
+    AbortPrefetch(*it);
+  m_prefetched.clear();
+}
+
+bool PAPlayer::AbortPrefetch(PrefetchPtr info)
+{
+  // holding the info lock keeps the job from starting until it is cancelled
+  CSingleLock lock(info->m_section);
+  info->m_abort = true;
+  if (info->m_started)
+    return false;
+
+  // the job won't call back once it is cancelled
+  CJobManager::GetInstance().CancelJob(info->m_jobId);
+  CExclusiveLock streamsLock(m_streamsLock);
+  m_jobCounter--;
+  m_jobEvent.Set();
+  return true;
+}
+
 void PAPlayer::UpdateStreamInfoPlayNextAtFrame(StreamInfo *si, unsigned int crossFadingTime)
 {
   if (si)
@@ -531,6 +723,7 @@ bool PAPlayer::CloseFile(bool reopen)
   if (!m_isPaused)
     SoftStop(true, true);
   CloseAllStreams(false);
+  ClearPrefetched();
 
   /* wait for the thread to terminate */
   StopThread(true);//true - wait for end of thread
@@ -887,6 +1080,14 @@ void PAPlayer::OnNothingToQueueNotify()
   m_isFinished = true;
 }
 
+void PAPlayer::GetGeneralInfo(std::string& strGeneralInfo)
+{
+  CSingleLock lock(m_prefetchLock);
+  strGeneralInfo = StringUtils::Format("decoded ahead:%u/%u, first sample:%ums, avg:%ums",
+                                       m_prefetchHits, m_queuedFiles, m_lastTimeToFirstSample,
+                                       m_queuedFiles ? (unsigned int)(m_totalTimeToFirstSample / m_queuedFiles) : 0);
+}
+
 bool PAPlayer::IsPlaying() const
 {
   return m_isPlaying;
@@ -21,11 +21,15 @@
  */
 
 #include <list>
+#include <memory>
+#include <string>
 
 #include "cores/IPlayer.h"
 #include "threads/Thread.h"
 #include "AudioDecoder.h"
+#include "threads/CriticalSection.h"
 #include "threads/SharedSection.h"
+#include "threads/SingleLock.h"
 #include "utils/Job.h"
 
 #include "cores/AudioEngine/Interfaces/IAudioCallback.h"
@@ -37,6 +41,7 @@ class CFileItem;
 class PAPlayer : public IPlayer, public CThread, public IJobCallback
 {
 friend class CQueueNextFileJob;
+friend class CPrefetchFileJob;
 public:
   PAPlayer(IPlayerCallback& callback);
   virtual ~PAPlayer();
@@ -46,6 +51,7 @@ public:
   virtual bool OpenFile(const CFileItem& file, const CPlayerOptions &options);
   virtual bool QueueNextFile(const CFileItem &file);
   virtual void OnNothingToQueueNotify();
+  virtual void PrefetchFiles(const CFileItemList &files);
   virtual bool CloseFile(bool reopen = false);
   virtual bool IsPlaying() const;
   virtual void Pause();
@@ -60,7 +66,7 @@ public:
   virtual void SetDynamicRangeCompression(long drc);
   virtual void GetAudioInfo( std::string& strAudioInfo) {}
   virtual void GetVideoInfo( std::string& strVideoInfo) {}
-  virtual void GetGeneralInfo( std::string& strVideoInfo) {}
+  virtual void GetGeneralInfo( std::string& strGeneralInfo);
   virtual void ToFFRW(int iSpeed = 0);
   virtual int GetCacheLevel() const;
   virtual int64_t GetTotalTime();
@@ -126,6 +132,40 @@ private:
 
   typedef std::list<StreamInfo*> StreamList;
 
+  struct PrefetchInfo
+  {
+    PrefetchInfo() : m_startOffset(0), m_jobId(0), m_stream(NULL), m_abort(false), m_started(false), m_done(false) {}
+    ~PrefetchInfo() { delete m_stream; }
+
+    /*! \brief Called by the job before it opens the file.
+     \return false if the file is no longer wanted, the job must not touch the player then.
+     */
+    bool Start()
+    {
+      CSingleLock lock(m_section);
+      m_started = !m_abort;
+      return m_started;
+    }
+
+    bool IsAborted()
+    {
+      CSingleLock lock(m_section);
+      return m_abort;
+    }
+
+    std::string       m_path;                /* the file being decoded ahead */
+    int64_t           m_startOffset;         /* the stream start offset */
+    unsigned int      m_jobId;               /* the prefetch job, to cancel it while it is queued */
+    StreamInfo*       m_stream;              /* the decoded ahead stream, NULL until done or if it failed */
+    CCriticalSection  m_section;             /* lock for m_abort and m_started */
+    bool              m_abort;               /* if the file is no longer wanted */
+    bool              m_started;             /* if the prefetch job has started */
+    bool              m_done;                /* if the prefetch job has finished */
+  };
+
+  typedef std::shared_ptr<PrefetchInfo> PrefetchPtr;
+  typedef std::list<PrefetchPtr> PrefetchList;
+
   bool                m_signalSpeedChange;   /* true if OnPlaybackSpeedChange needs to be called */
   int                 m_playbackSpeed;       /* the playback speed (1 = normal) */
   bool                m_isPlaying;
@@ -148,7 +188,19 @@ private:
   int64_t             m_newForcedPlayerTime;
   int64_t             m_newForcedTotalTime;
 
+  CCriticalSection    m_prefetchLock;        /* lock for the prefetch list and the metrics below */
+  PrefetchList        m_prefetched;          /* upcoming files, in playlist order */
+  CEvent              m_prefetchEvent;       /* set whenever a prefetch job has finished */
+  unsigned int        m_queuedFiles;         /* number of files queued for playback */
+  unsigned int        m_prefetchHits;        /* number of queued files that were decoded ahead */
+  unsigned int        m_lastTimeToFirstSample;  /* ms from queuing the last file to its first samples */
+  uint64_t            m_totalTimeToFirstSample; /* sum of the above for all queued files */
+
   bool QueueNextFileEx(const CFileItem &file, bool fadeIn = true, bool job = false);
+  bool PrefetchFile(const CFileItem &file, PrefetchPtr info);
+  StreamInfo* TakePrefetchedStream(const CFileItem &file);
+  bool AbortPrefetch(PrefetchPtr info);
+  void ClearPrefetched();
   void SoftStart(bool wait = false);
   void SoftStop(bool wait = false, bool close = true);
   void CloseAllStreams(bool fade = true);
@@ -105,6 +105,9 @@ CDatabase::CDatabase(void)
   m_sqlite = true;
   m_bMultiWrite = false;
   m_multipleExecute = false;
+  m_batch = false;
+  m_batchOpen = false;
+  m_batchFailed = false;
 }
 
 CDatabase::~CDatabase(void)
@@ -580,9 +583,12 @@ void CDatabase::Close()
 
   m_openCount = 0;
   m_multipleExecute = false;
+  m_batch = false;
+  m_batchOpen = false;
 
   if (NULL == m_pDB.get() ) return ;
   if (NULL != m_pDS.get()) m_pDS->close();
+  if (NULL != m_pDS2.get()) m_pDS2->close();
   m_pDB->disconnect();
   m_pDB.reset();
   m_pDS.reset();
@@ -632,6 +638,14 @@ void CDatabase::Interupt()
 
 void CDatabase::BeginTransaction()
 {
+  // transactions within a batch are part of the batch transaction, started by the first of them
+  if (m_batch)
+  {
+    if (m_batchOpen)
+      return;
+    m_batchOpen = true;
+  }
+
   try
   {
     if (NULL != m_pDB.get())
@@ -645,6 +659,9 @@ void CDatabase::BeginTransaction()
 
 bool CDatabase::CommitTransaction()
 {
+  if (m_batch)
+    return true;
+
   try
   {
     if (NULL != m_pDB.get())
@@ -660,6 +677,14 @@ bool CDatabase::CommitTransaction()
 
 void CDatabase::RollbackTransaction()
 {
+  if (m_batch)
+  {
+    CLog::Log(LOGWARNING, "database:rollbacktransaction rolling back the current batch");
+    m_batch = false;
+    m_batchOpen = false;
+    m_batchFailed = true;
+  }
+
   try
   {
     if (NULL != m_pDB.get())
@@ -671,6 +696,41 @@ void CDatabase::RollbackTransaction()
   }
 }
 
+void CDatabase::BeginBatch()
+{
+  if (m_batch)
+    return;
+
+  m_batch = true;
+  m_batchOpen = false;
+  m_batchFailed = false;
+}
+
+bool CDatabase::FlushBatch()
+{
+  if (!m_batch)
+    return !m_batchFailed;
+  if (!m_batchOpen)
+    return true;
+
+  m_batch = false;
+  m_batchOpen = false;
+  if (!CommitTransaction())
+  {
+    m_batchFailed = true;
+    return false;
+  }
+  m_batch = true;
+  return true;
+}
+
+bool CDatabase::CommitBatch()
+{
+  bool committed = FlushBatch();
+  m_batch = false;
+  return committed;
+}
+
 bool CDatabase::InTransaction()
 {
   if (NULL != m_pDB.get()) return false;
@@ -71,6 +71,33 @@ public:
   void RollbackTransaction();
   bool InTransaction();
 
+  /*!
+   * @brief Group all following transactions into a single one until CommitBatch()
+   *        is called. BeginTransaction()/CommitTransaction() pairs issued in between
+   *        become part of the batch rather than committing on their own.
+   *        A RollbackTransaction() rolls back the whole batch and ends it.
+   *        The transaction of the batch only starts with its first BeginTransaction().
+   * @sa CommitBatch, FlushBatch
+   */
+  void BeginBatch();
+
+  /*!
+   * @brief Commit what was written in the batch so far and keep the batch going.
+   *        No lock is held on the database until the next write, so call this before
+   *        anything that may take long, like a scraper lookup.
+   * @return false if the batch was rolled back or the commit failed.
+   * @sa BeginBatch
+   */
+  bool FlushBatch();
+
+  /*!
+   * @brief Commit the batch started with BeginBatch().
+   * @return true if the batch was committed, false if it was rolled back or the commit failed.
+   * @sa BeginBatch
+   */
+  bool CommitBatch();
+  bool InBatch() const { return m_batch; }
+
   std::string PrepareSQL(std::string strStmt, ...) const;
 
   /*!
@@ -220,4 +247,8 @@ private:
 
   bool m_multipleExecute;
   std::vector<std::string> m_multipleQueries;
+
+  bool m_batch;       /*!< True while a batch started with BeginBatch() is open */
+  bool m_batchOpen;   /*!< True once the transaction of the current batch has started */
+  bool m_batchFailed; /*!< True if the current batch has been rolled back */
 };
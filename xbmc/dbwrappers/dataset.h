@@ -212,6 +212,7 @@ protected:
   ParamList plist;              // Paramlist for locate
   bool fbof, feof;
   bool autocommit;		// for transactions
+  bool forward_only;		// stream rows instead of materializing them
 
 
 /* Variables to store SQL statements */
@@ -264,6 +265,10 @@ protected:
 /* Returns old field value (for :OLD) */
   virtual const field_value f_old(const char *f);
 
+/* Returns the value of column index in the current record, or the empty
+   value of fields_object when there is no current record */
+  const field_value& current_value(unsigned int index);
+
 public:
 
  virtual int str_compare(const char * s1, const char * s2);
@@ -386,17 +391,26 @@ public:
 /* Return field name by it index */
 //  virtual char *field_name(int f_index) { return field_by_index(f_index)->get_field_name(); };
 
-/* Getting value of field for current record */
-  virtual const field_value get_field_value(const char *f_name);
-  virtual const field_value get_field_value(int index);
+/* Getting value of field for current record. The reference stays valid
+   until the dataset moves to another record or is closed */
+  virtual const field_value& get_field_value(const char *f_name);
+  virtual const field_value& get_field_value(int index);
 /* Alias to get_field_value */
-  const field_value fv(const char *f) { return get_field_value(f); }
-  const field_value fv(int index) { return get_field_value(index); }
+  const field_value& fv(const char *f) { return get_field_value(f); }
+  const field_value& fv(int index) { return get_field_value(index); }
 
 /* ------------ for transaction ------------------- */
   void set_autocommit(bool v) { autocommit = v; }
   bool get_autocommit() { return autocommit; }
 
+/* ------------ for streaming --------------------- */
+/* When set, following queries may return a forward-only cursor: rows are
+   fetched one at a time on next(), only the current row is held in memory,
+   num_rows() counts the rows fetched so far and first()/prev()/last()/seek()
+   are not available. Backends that can't stream ignore the hint. */
+  void set_forward_only(bool v) { forward_only = v; }
+  bool get_forward_only() { return forward_only; }
+
 /* ----------------- for debug -------------------- */
   Fields *get_fields_object() {return fields_object;};
   Fields *get_edit_object() {return edit_object;};
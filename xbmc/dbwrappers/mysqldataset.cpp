@@ -1381,23 +1381,7 @@ void MysqlDataset::fill_fields() {
       (*fields_object)[i].props = result.record_header[i];
   }
 
-  //Filling result
-  if (result.records.size() != 0)
-  {
-    const sql_record *row = result.records[frecno];
-    if (row)
-    {
-      const unsigned int ncols = row->size();
-      fields_object->resize(ncols);
-      for (unsigned int i = 0; i < ncols; i++)
-        (*fields_object)[i].val = row->at(i);
-      return;
-    }
-  }
-  const unsigned int ncols = result.record_header.size();
-  fields_object->resize(ncols);
-  for (unsigned int i = 0; i < ncols; i++)
-    (*fields_object)[i].val = "";
+  // values are read straight from the current record, see Dataset::current_value()
 }
 
 
@@ -1527,8 +1511,8 @@ bool MysqlDataset::query(const std::string &query) {
   // returned rows
   while ((row = mysql_fetch_row(stmt)))
   { // have a row of data
-    sql_record *res = new sql_record;
-    res->resize(numColumns);
+    unsigned long *lengths = mysql_fetch_lengths(stmt);
+    sql_record *res = new sql_record(numColumns);
     for (unsigned int i = 0; i < numColumns; i++)
     {
       field_value &v = res->at(i);
@@ -1564,18 +1548,16 @@ bool MysqlDataset::query(const std::string &query) {
         case MYSQL_TYPE_STRING:
         case MYSQL_TYPE_VAR_STRING:
         case MYSQL_TYPE_VARCHAR:
-          if (row[i] != NULL) v.set_asString((const char *)row[i] );
-          break;
         case MYSQL_TYPE_TINY_BLOB:
         case MYSQL_TYPE_MEDIUM_BLOB:
         case MYSQL_TYPE_LONG_BLOB:
         case MYSQL_TYPE_BLOB:
-          if (row[i] != NULL) v.set_asString((const char *)row[i]);
+          if (row[i] != NULL) v.set_asStringRef(result.strings.store(row[i], lengths[i]), lengths[i]);
           break;
         case MYSQL_TYPE_NULL:
         default:
           CLog::Log(LOGDEBUG,"MYSQL: Unknown field type: %u", fields[i].type);
-          v.set_asString("");
+          v.set_asStringRef("", 0);
           v.set_isNull();
           break;
       }
@@ -35,6 +35,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #ifndef __GNUC__
 #pragma warning (disable:4800)
@@ -43,78 +44,157 @@
 
 namespace dbiplus {
 
+#define ARENA_BLOCK_SIZE 65536
+
+static const char empty_string[] = "";
+
+//************* string_arena implementation ***************
+
+string_arena::string_arena() {
+  used = 0;
+  capacity = 0;
+}
+
+string_arena::~string_arena() {
+  clear();
+}
+
+const char *string_arena::store(const char *s, unsigned int len) {
+  if (used + len + 1 > capacity)
+  {
+    // oversized strings get a block of their own
+    unsigned int size = len + 1 > ARENA_BLOCK_SIZE ? len + 1 : ARENA_BLOCK_SIZE;
+    blocks.push_back(new char[size]);
+    sizes.push_back(size);
+    used = 0;
+    capacity = size;
+  }
+  char *p = blocks.back() + used;
+  memcpy(p, s, len);
+  p[len] = '\0';
+  used += len + 1;
+  return p;
+}
+
+void string_arena::reset() {
+  if (blocks.empty())
+    return;
+  for (unsigned int i = 1; i < blocks.size(); i++)
+    delete[] blocks[i];
+  blocks.resize(1);
+  sizes.resize(1);
+  used = 0;
+  // the first block may have been an oversized one
+  capacity = sizes[0];
+}
+
+void string_arena::clear() {
+  for (unsigned int i = 0; i < blocks.size(); i++)
+    delete[] blocks[i];
+  blocks.clear();
+  sizes.clear();
+  used = 0;
+  capacity = 0;
+}
+
 //Constructors 
 field_value::field_value()
 {
   field_type = ft_String;
   is_null = false;
+  str_owned = false;
+  str_len = 0;
+  str_value = empty_string;
 }
 
-field_value::field_value(const char *s):
-  str_value(s)
+field_value::field_value(const char *s)
 {
-  field_type = ft_String;
+  field_type = ft_Int;
   is_null = false;
+  str_owned = false;
+  str_len = 0;
+  set_asString(s);
 }
   
 field_value::field_value(const bool b) {
+  str_owned = false;
+  str_len = 0;
   bool_value = b; 
   field_type = ft_Boolean;
   is_null = false;
 }
 
 field_value::field_value(const char c) {
+  str_owned = false;
+  str_len = 0;
   char_value = c; 
   field_type = ft_Char;
   is_null = false;
 }
   
 field_value::field_value(const short s) {
+  str_owned = false;
+  str_len = 0;
   short_value = s; 
   field_type = ft_Short;
   is_null = false;
 }
   
 field_value::field_value(const unsigned short us) {
+  str_owned = false;
+  str_len = 0;
   ushort_value = us; 
   field_type = ft_UShort;
   is_null = false;
 }
   
 field_value::field_value(const int i) {
+  str_owned = false;
+  str_len = 0;
   int_value = i; 
   field_type = ft_Int;
   is_null = false;
 }
   
 field_value::field_value(const unsigned int ui) {
+  str_owned = false;
+  str_len = 0;
   uint_value = ui; 
   field_type = ft_UInt;
   is_null = false;
 }
   
 field_value::field_value(const float f) {
+  str_owned = false;
+  str_len = 0;
   float_value = f; 
   field_type = ft_Float;
   is_null = false;
 }
   
 field_value::field_value(const double d) {
+  str_owned = false;
+  str_len = 0;
   double_value = d; 
   field_type = ft_Double;
   is_null = false;
 }
   
 field_value::field_value(const int64_t i) {
+  str_owned = false;
+  str_len = 0;
   int64_value = i; 
   field_type = ft_Int64;
   is_null = false;
 }
 
 field_value::field_value (const field_value & fv) {
+  field_type = ft_Int;
+  str_owned = false;
+  str_len = 0;
   switch (fv.get_fType()) {
     case ft_String: {
-      set_asString(fv.get_asString());
+      set_asString(fv.str_value, fv.str_len);
       break;
     }
     case ft_Boolean:{
@@ -160,18 +240,24 @@ field_value::field_value (const field_value & fv) {
 }
 
 
-//empty destructor
 field_value::~field_value(){
-
+  free_string();
   }
 
+void field_value::free_string() {
+  if (field_type == ft_String && str_owned)
+    delete[] str_value;
+  str_owned = false;
+  str_len = 0;
+}
+
   
 //Conversations functions
 std::string field_value::get_asString() const {
     std::string tmp;
     switch (field_type) {
     case ft_String: {
-      tmp = str_value;
+      tmp.assign(str_value, str_len);
       return tmp;
     }
     case ft_Boolean:{
@@ -228,7 +314,7 @@ std::string field_value::get_asString() const {
 bool field_value::get_asBool() const {
     switch (field_type) {
     case ft_String: {
-      if (str_value == "True" || str_value == "true" || str_value == "1")
+      if (strcmp(str_value, "True") == 0 || strcmp(str_value, "true") == 0 || strcmp(str_value, "1") == 0)
           return true;
       else
 	return false;
@@ -327,7 +413,7 @@ char field_value::get_asChar() const {
 short field_value::get_asShort() const {
     switch (field_type) {
     case ft_String: {
-      return (short)atoi(str_value.c_str());
+      return (short)atoi(str_value);
     }
     case ft_Boolean:{
       return (short)bool_value;
@@ -365,7 +451,7 @@ short field_value::get_asShort() const {
 unsigned short field_value::get_asUShort() const {
     switch (field_type) {
     case ft_String: {
-      return (unsigned short)atoi(str_value.c_str());
+      return (unsigned short)atoi(str_value);
     }
     case ft_Boolean:{
       return (unsigned short)bool_value;
@@ -402,7 +488,7 @@ unsigned short field_value::get_asUShort() const {
 int field_value::get_asInt() const {
     switch (field_type) {
     case ft_String: {
-      return (int)atoi(str_value.c_str());
+      return (int)atoi(str_value);
     }
     case ft_Boolean:{
       return (int)bool_value;
@@ -439,7 +525,7 @@ int field_value::get_asInt() const {
 unsigned int field_value::get_asUInt() const {
     switch (field_type) {
     case ft_String: {
-      return (unsigned int)atoi(str_value.c_str());
+      return (unsigned int)atoi(str_value);
     }
     case ft_Boolean:{
       return (unsigned int)bool_value;
@@ -476,7 +562,7 @@ unsigned int field_value::get_asUInt() const {
 float field_value::get_asFloat() const {
     switch (field_type) {
     case ft_String: {
-      return (float)atof(str_value.c_str());
+      return (float)atof(str_value);
     }
     case ft_Boolean:{
       return (float)bool_value;
@@ -513,7 +599,7 @@ float field_value::get_asFloat() const {
 double field_value::get_asDouble() const {
     switch (field_type) {
     case ft_String: {
-      return atof(str_value.c_str());
+      return atof(str_value);
     }
     case ft_Boolean:{
       return (double)bool_value;
@@ -550,7 +636,7 @@ double field_value::get_asDouble() const {
 int64_t field_value::get_asInt64() const {
     switch (field_type) {
     case ft_String: {
-      return _atoi64(str_value.c_str());
+      return _atoi64(str_value);
     }
     case ft_Boolean:{
       return (int64_t)bool_value;
@@ -592,7 +678,7 @@ field_value& field_value::operator= (const field_value & fv) {
 
   switch (fv.get_fType()) {
     case ft_String: {
-      set_asString(fv.get_asString());
+      set_asString(fv.str_value, fv.str_len);
       return *this;
       break;
     }
@@ -650,49 +736,73 @@ field_value& field_value::operator= (const field_value & fv) {
 
 //Set functions
 void field_value::set_asString(const char *s) {
-  str_value = s;
-  field_type = ft_String;}
+  set_asString(s, strlen(s));}
 
 void field_value::set_asString(const std::string & s) {
+  set_asString(s.c_str(), s.size());}
+
+void field_value::set_asString(const char *s, unsigned int len) {
+  char *copy = new char[len + 1];
+  memcpy(copy, s, len);
+  copy[len] = '\0';
+  free_string();
+  str_value = copy;
+  str_len = len;
+  str_owned = true;
+  field_type = ft_String;}
+
+void field_value::set_asStringRef(const char *s, unsigned int len) {
+  free_string();
   str_value = s;
+  str_len = len;
+  str_owned = false;
   field_type = ft_String;}
   
 void field_value::set_asBool(const bool b) {
+  free_string();
   bool_value = b; 
   field_type = ft_Boolean;}
   
 void field_value::set_asChar(const char c) {
+  free_string();
   char_value = c; 
   field_type = ft_Char;}
   
 void field_value::set_asShort(const short s) {
+  free_string();
   short_value = s; 
   field_type = ft_Short;}
   
 void field_value::set_asUShort(const unsigned short us) {
+  free_string();
   ushort_value = us; 
   field_type = ft_UShort;
 }
 
 void field_value::set_asInt(const int i) {
+  free_string();
   int_value = i; 
   field_type = ft_Int;
 }
   
 void field_value::set_asUInt(const unsigned int ui) {
+  free_string();
   int_value = ui; 
   field_type = ft_UInt;
 }
   
 void field_value::set_asFloat(const float f) {
+  free_string();
   float_value = f; 
   field_type = ft_Float;}
   
 void field_value::set_asDouble(const double d) {
+  free_string();
   double_value = d; 
   field_type = ft_Double;}
 
 void field_value::set_asInt64(const int64_t i) {
+  free_string();
   int64_value = i; 
   field_type = ft_Int64;}
   
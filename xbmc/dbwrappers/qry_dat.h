@@ -56,10 +56,42 @@ enum fType {
 
 
 
+/* Owns the text of all string values of a result set. Text is copied into
+   large blocks so loading a row doesn't allocate per column, and the whole
+   result set is released at once. */
+class string_arena {
+public:
+  string_arena();
+  ~string_arena();
+
+/* copies len bytes of s (plus a terminating zero) into the arena */
+  const char *store(const char *s, unsigned int len);
+/* drops all stored text, keeping the first block for reuse */
+  void reset();
+/* releases all memory */
+  void clear();
+
+private:
+  string_arena(const string_arena&) = delete;
+  string_arena& operator=(const string_arena&) = delete;
+
+  std::vector<char*> blocks;
+  std::vector<unsigned int> sizes; // size of each block
+  unsigned int used;     // bytes used in the last block
+  unsigned int capacity; // size of the last block
+};
+
+
+/* A single column value. Numbers are kept in their native type; text is
+   either owned by the value or borrowed from the string_arena of the result
+   set the value belongs to. Copies always own their text, so they stay valid
+   after the result set is closed. */
 class field_value {
 private:
   fType field_type;
-  std::string str_value;
+  bool is_null;
+  bool str_owned;
+  unsigned int str_len;
   union {
     bool   bool_value;
     char   char_value;
@@ -71,9 +103,10 @@ private:
     double double_value;
     int64_t int64_value;
     void   *object_value;
+    const char *str_value;
   } ;
 
-  bool is_null;
+  void free_string();
 
 public:
   field_value();
@@ -93,6 +126,9 @@ public:
   fType get_fType() const {return field_type;}
   bool get_isNull() const {return is_null;}
   std::string get_asString() const;
+/* direct access to string values without a copy, zero terminated */
+  const char *get_asCString() const {return field_type == ft_String ? str_value : "";}
+  unsigned int get_length() const {return field_type == ft_String ? str_len : 0;}
   bool get_asBool() const;
   char get_asChar() const;
   short get_asShort() const;
@@ -178,6 +214,9 @@ public:
   void set_isNull(){is_null=true;}
   void set_asString(const char *s);
   void set_asString(const std::string & s);
+  void set_asString(const char *s, unsigned int len);
+/* points the value at text owned by an arena, which must outlive the value */
+  void set_asStringRef(const char *s, unsigned int len);
   void set_asBool(const bool b);
   void set_asChar(const char c);
   void set_asShort(const short s);
@@ -236,10 +275,12 @@ public:
         delete records[i];
     records.clear();
     record_header.clear();
+    strings.clear();
   };
 
   record_prop record_header;
   query_data records;
+  string_arena strings; // text of all string values in records
 };
 
 } // namespace
@@ -28,6 +28,7 @@
 
 #include <iostream>
 #include <string>
+#include <string.h>
 
 #include "sqlitedataset.h"
 #include "utils/log.h"
@@ -38,6 +39,8 @@
 #pragma comment(lib, "sqlite3.lib")
 #endif
 
+#define STATEMENT_CACHE_SIZE 64
+
 namespace dbiplus {
 //************* Callback function ***************************
 
@@ -64,12 +67,13 @@ int callback(void* res_ptr,int ncol, char** reslt,char** cols)
       field_value &v = rec->at(i);
       if (reslt[i] == NULL)
       {
-        v.set_asString("");
+        v.set_asStringRef("", 0);
         v.set_isNull();
       }
       else
       {
-        v.set_asString(reslt[i]);
+        unsigned int len = strlen(reslt[i]);
+        v.set_asStringRef(r->strings.store(reslt[i], len), len);
       }
     }
     r->records.push_back(rec);
@@ -89,6 +93,7 @@ SqliteDatabase::SqliteDatabase() {
 
   active = false;  
   _in_transaction = false;    // for transaction
+  stmt_cache_clock = 0;
 
   error = "Unknown database error";//S_NO_CONNECTION;
   host = "localhost";
@@ -256,6 +261,7 @@ bool SqliteDatabase::exists(void)
 
 void SqliteDatabase::disconnect(void) {
   if (active == false) return;
+  clear_statement_cache();
   sqlite3_close(conn);
   active = false;
 }
@@ -411,6 +417,75 @@ void SqliteDatabase::rollback_transaction() {
 }
 
 
+// methods for the prepared statement cache
+// ---------------------------------------------
+sqlite3_stmt *SqliteDatabase::get_statement(const std::string &sql) {
+  if (!active) return NULL;
+
+  StatementCache::iterator it = stmt_cache.find(sql);
+  if (it != stmt_cache.end() && !it->second.in_use)
+  {
+    it->second.in_use = true;
+    it->second.last_used = ++stmt_cache_clock;
+    return it->second.stmt;
+  }
+
+  sqlite3_stmt *stmt = NULL;
+  if (setErr(sqlite3_prepare_v2(conn, sql.c_str(), -1, &stmt, NULL), sql.c_str()) != SQLITE_OK)
+  {
+    sqlite3_finalize(stmt);
+    return NULL;
+  }
+
+  // a second user of the same SQL gets a private statement
+  if (it != stmt_cache.end())
+    return stmt;
+
+  if (stmt_cache.size() >= STATEMENT_CACHE_SIZE)
+  {
+    // evict the least recently used statement that isn't in use
+    StatementCache::iterator lru = stmt_cache.end();
+    for (StatementCache::iterator i = stmt_cache.begin(); i != stmt_cache.end(); ++i)
+    {
+      if (!i->second.in_use && (lru == stmt_cache.end() || i->second.last_used < lru->second.last_used))
+        lru = i;
+    }
+    if (lru == stmt_cache.end())
+      return stmt;
+    sqlite3_finalize(lru->second.stmt);
+    stmt_cache.erase(lru);
+  }
+
+  CachedStatement entry;
+  entry.stmt = stmt;
+  entry.in_use = true;
+  entry.last_used = ++stmt_cache_clock;
+  stmt_cache.insert(std::make_pair(sql, entry));
+  return stmt;
+}
+
+int SqliteDatabase::release_statement(sqlite3_stmt *stmt) {
+  if (stmt == NULL) return SQLITE_OK;
+
+  const char *sql = sqlite3_sql(stmt);
+  StatementCache::iterator it = stmt_cache.find(sql ? sql : "");
+  if (it != stmt_cache.end() && it->second.stmt == stmt)
+  {
+    int rc = sqlite3_reset(stmt);
+    sqlite3_clear_bindings(stmt);
+    it->second.in_use = false;
+    return rc;
+  }
+  return sqlite3_finalize(stmt);
+}
+
+void SqliteDatabase::clear_statement_cache() {
+  for (StatementCache::iterator it = stmt_cache.begin(); it != stmt_cache.end(); ++it)
+    sqlite3_finalize(it->second.stmt);
+  stmt_cache.clear();
+}
+
+
 // methods for formatting
 // ---------------------------------------------
 std::string SqliteDatabase::vprepare(const char *format, va_list args)
@@ -450,6 +525,9 @@ SqliteDataset::SqliteDataset():Dataset() {
   db = NULL;
   errmsg = NULL;
   autorefresh = false;
+  streaming = false;
+  stream_stmt = NULL;
+  stream_rows = 0;
 }
 
 
@@ -458,9 +536,13 @@ SqliteDataset::SqliteDataset(SqliteDatabase *newDb):Dataset(newDb) {
   db = newDb;
   errmsg = NULL;
   autorefresh = false;
+  streaming = false;
+  stream_stmt = NULL;
+  stream_rows = 0;
 }
 
  SqliteDataset::~SqliteDataset(){
+   release_stream();
    if (errmsg) sqlite3_free(errmsg);
  }
 
@@ -543,23 +625,7 @@ void SqliteDataset::fill_fields() {
       (*fields_object)[i].props = result.record_header[i];
   }
 
-  //Filling result
-  if (result.records.size() != 0)
-  {
-    const sql_record *row = result.records[frecno];
-    if (row)
-    {
-      const unsigned int ncols = row->size();
-      fields_object->resize(ncols);
-      for (unsigned int i = 0; i < ncols; i++)
-        (*fields_object)[i].val = row->at(i);
-      return;
-    }
-  }
-  const unsigned int ncols = result.record_header.size();
-  fields_object->resize(ncols);
-  for (unsigned int i = 0; i < ncols; i++)
-    (*fields_object)[i].val = "";
+  // values are read straight from the current record, see Dataset::current_value()
 }
 
 
@@ -635,6 +701,79 @@ const void* SqliteDataset::getExecRes() {
 }
 
 
+void SqliteDataset::load_row(sqlite3_stmt *stmt, sql_record &rec) {
+  const unsigned int numColumns = rec.size();
+  for (unsigned int i = 0; i < numColumns; i++)
+  {
+    field_value &v = rec[i];
+    switch (sqlite3_column_type(stmt, i))
+    {
+    case SQLITE_INTEGER:
+      v.set_asInt64(sqlite3_column_int64(stmt, i));
+      break;
+    case SQLITE_FLOAT:
+      v.set_asDouble(sqlite3_column_double(stmt, i));
+      break;
+    case SQLITE_TEXT:
+    {
+      const char *text = (const char *)sqlite3_column_text(stmt, i);
+      const unsigned int len = sqlite3_column_bytes(stmt, i);
+      v.set_asStringRef(result.strings.store(text, len), len);
+      break;
+    }
+    case SQLITE_BLOB:
+    {
+      const char *blob = (const char *)sqlite3_column_blob(stmt, i);
+      const unsigned int len = sqlite3_column_bytes(stmt, i);
+      v.set_asStringRef(blob ? result.strings.store(blob, len) : "", blob ? len : 0);
+      break;
+    }
+    case SQLITE_NULL:
+    default:
+      v.set_asStringRef("", 0);
+      v.set_isNull();
+      break;
+    }
+  }
+}
+
+bool SqliteDataset::step_stream() {
+  if (stream_stmt == NULL)
+  {
+    feof = true;
+    return false;
+  }
+
+  if (sqlite3_step(stream_stmt) == SQLITE_ROW)
+  {
+    // only the current row is alive, so its text can reuse the arena
+    result.strings.reset();
+    load_row(stream_stmt, *result.records[0]);
+    stream_rows++;
+    fbof = (stream_rows == 1);
+    feof = false;
+    fill_fields();
+    return true;
+  }
+
+  // end of the result (or an error, which the reset reports)
+  fbof = (stream_rows == 0);
+  feof = true;
+  std::string qry = sqlite3_sql(stream_stmt);
+  if (db->setErr(release_stream(), qry.c_str()) != SQLITE_OK)
+    throw DbErrors(db->getErrorMsg());
+  return false;
+}
+
+int SqliteDataset::release_stream() {
+  if (stream_stmt == NULL) return SQLITE_OK;
+
+  sqlite3_stmt *stmt = stream_stmt;
+  stream_stmt = NULL;
+  if (db == NULL) return sqlite3_finalize(stmt);
+  return static_cast<SqliteDatabase*>(db)->release_statement(stmt);
+}
+
 bool SqliteDataset::query(const std::string &query) {
     if(!handle()) throw DbErrors("No Database Connection");
     std::string qry = query;
@@ -645,8 +784,9 @@ bool SqliteDataset::query(const std::string &query) {
 
   close();
 
-  sqlite3_stmt *stmt = NULL;
-  if (db->setErr(sqlite3_prepare_v2(handle(),query.c_str(),-1,&stmt, NULL),query.c_str()) != SQLITE_OK)
+  SqliteDatabase *sqlite = static_cast<SqliteDatabase*>(db);
+  sqlite3_stmt *stmt = sqlite->get_statement(query);
+  if (stmt == NULL)
     throw DbErrors(db->getErrorMsg());
 
   // column headers
@@ -655,38 +795,28 @@ bool SqliteDataset::query(const std::string &query) {
   for (unsigned int i = 0; i < numColumns; i++)
     result.record_header[i].name = sqlite3_column_name(stmt, i);
 
+  if (forward_only)
+  { // keep the statement open and fetch a single row at a time
+    streaming = true;
+    stream_stmt = stmt;
+    stream_rows = 0;
+    result.records.push_back(new sql_record(numColumns));
+    active = true;
+    ds_state = dsSelect;
+    frecno = 0;
+    fill_fields();
+    step_stream();
+    return true;
+  }
+
   // returned rows
   while (sqlite3_step(stmt) == SQLITE_ROW)
   { // have a row of data
-    sql_record *res = new sql_record;
-    res->resize(numColumns);
-    for (unsigned int i = 0; i < numColumns; i++)
-    {
-      field_value &v = res->at(i);
-      switch (sqlite3_column_type(stmt, i))
-      {
-      case SQLITE_INTEGER:
-        v.set_asInt64(sqlite3_column_int64(stmt, i));
-        break;
-      case SQLITE_FLOAT:
-        v.set_asDouble(sqlite3_column_double(stmt, i));
-        break;
-      case SQLITE_TEXT:
-        v.set_asString((const char *)sqlite3_column_text(stmt, i));
-        break;
-      case SQLITE_BLOB:
-        v.set_asString((const char *)sqlite3_column_text(stmt, i));
-        break;
-      case SQLITE_NULL:
-      default:
-        v.set_asString("");
-        v.set_isNull();
-        break;
-      }
-    }
+    sql_record *res = new sql_record(numColumns);
+    load_row(stmt, *res);
     result.records.push_back(res);
   }
-  if (db->setErr(sqlite3_finalize(stmt),query.c_str()) == SQLITE_OK)
+  if (db->setErr(sqlite->release_statement(stmt),query.c_str()) == SQLITE_OK)
   {
     active = true;
     ds_state = dsSelect;
@@ -715,6 +845,9 @@ void SqliteDataset::open() {
 
 
 void SqliteDataset::close() {
+  release_stream();
+  streaming = false;
+  stream_rows = 0;
   Dataset::close();
   result.clear();
   edit_object->clear();
@@ -735,6 +868,8 @@ void SqliteDataset::cancel() {
 
 
 int SqliteDataset::num_rows() {
+  if (streaming)
+    return stream_rows;
   return result.records.size();
 }
 
@@ -750,21 +885,32 @@ bool SqliteDataset::bof() {
 
 
 void SqliteDataset::first() {
+  if (is_streaming()) {
+    if (stream_rows > 1) throw DbErrors("Can't rewind a forward-only dataset");
+    return;
+  }
   Dataset::first();
   this->fill_fields();
 }
 
 void SqliteDataset::last() {
+  if (is_streaming()) throw DbErrors("Can't seek in a forward-only dataset");
   Dataset::last();
   fill_fields();
 }
 
 void SqliteDataset::prev(void) {
+  if (is_streaming()) throw DbErrors("Can't seek in a forward-only dataset");
   Dataset::prev();
   fill_fields();
 }
 
 void SqliteDataset::next(void) {
+  if (is_streaming()) {
+    if (ds_state == dsSelect && !feof)
+      step_stream();
+    return;
+  }
   Dataset::next();
   if (!eof()) 
       fill_fields();
@@ -784,6 +930,7 @@ void SqliteDataset::free_row(void)
 }
 
 bool SqliteDataset::seek(int pos) {
+  if (is_streaming()) throw DbErrors("Can't seek in a forward-only dataset");
   if (ds_state == dsSelect) {
     Dataset::seek(pos);
     fill_fields();
@@ -30,6 +30,7 @@
 #define _SQLITEDATASET_H
 
 #include <stdio.h>
+#include <map>
 #include "dataset.h"
 #include <sqlite3.h>
 
@@ -46,6 +47,17 @@ protected:
   bool _in_transaction;
   int last_err;
 
+/* prepared statement cache, keyed by the SQL text */
+  struct CachedStatement
+  {
+    sqlite3_stmt *stmt;
+    bool in_use;
+    unsigned int last_used;
+  };
+  typedef std::map<std::string, CachedStatement> StatementCache;
+  StatementCache stmt_cache;
+  unsigned int stmt_cache_clock;
+
 public:
 /* default constructor */
   SqliteDatabase();
@@ -97,6 +109,15 @@ public:
 
   bool in_transaction() {return _in_transaction;}; 	
 
+/* returns a prepared statement for the given SQL, reusing a cached one when
+   it isn't in use by another dataset. Returns NULL and sets the error on failure.
+   Every statement must be handed back with release_statement(). */
+  sqlite3_stmt *get_statement(const std::string &sql);
+/* resets a statement obtained from get_statement() so it can be reused.
+   Returns the result code of the last step. */
+  int release_statement(sqlite3_stmt *stmt);
+/* finalizes all cached statements */
+  void clear_statement_cache();
 };
 
 
@@ -122,6 +143,21 @@ protected:
 
   //static int sqlite_callback(void* res_ptr,int ncol, char** reslt, char** cols);
 
+/* true while a forward-only cursor is open */
+  bool streaming;
+/* statement of an open forward-only cursor */
+  sqlite3_stmt *stream_stmt;
+/* number of rows fetched from stream_stmt */
+  int stream_rows;
+
+/* Copies the current row of stmt into rec */
+  void load_row(sqlite3_stmt *stmt, sql_record &rec);
+  bool is_streaming() const { return streaming; }
+/* Fetches the next row of the forward-only cursor */
+  bool step_stream();
+/* Hands the forward-only cursor statement back to the database */
+  int release_stream();
+
 /* This function works only with MySQL database
   Filling the fields information from select statement */
   virtual void fill_fields();
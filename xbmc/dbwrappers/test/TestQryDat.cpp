@@ -0,0 +1,68 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "dbwrappers/qry_dat.h"
+
+#include "gtest/gtest.h"
+
+#include <string>
+#include <vector>
+
+using namespace dbiplus;
+
+TEST(TestQryDat, ArenaStore)
+{
+  string_arena arena;
+  const char *a = arena.store("abc", 3);
+  const char *b = arena.store("defgh", 2);
+  EXPECT_STREQ("abc", a);
+  EXPECT_STREQ("de", b);
+}
+
+TEST(TestQryDat, ArenaResetAfterOversizedString)
+{
+  string_arena arena;
+
+  // a field larger than a block gets a block of its own after the first one
+  std::string large(200000, 'x');
+  EXPECT_STREQ("first", arena.store("first", 5));
+  const char *stored = arena.store(large.c_str(), large.size());
+  EXPECT_EQ(large, stored);
+
+  // reset() keeps the first block only, filling it must not use the size of the oversized one
+  arena.reset();
+  std::vector<std::string> strings;
+  std::vector<const char *> pointers;
+  for (int i = 0; i < 20000; i++)
+  {
+    strings.push_back("string " + std::to_string(i));
+    pointers.push_back(arena.store(strings.back().c_str(), strings.back().size()));
+  }
+  for (unsigned int i = 0; i < strings.size(); i++)
+    EXPECT_EQ(strings[i], pointers[i]);
+}
+
+TEST(TestQryDat, ArenaClear)
+{
+  string_arena arena;
+  arena.store("abc", 3);
+  arena.clear();
+  EXPECT_STREQ("def", arena.store("def", 3));
+}
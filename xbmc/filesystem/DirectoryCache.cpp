@@ -20,37 +20,69 @@
 
 #include "DirectoryCache.h"
 #include "FileItem.h"
+#include "music/tags/MusicInfoTag.h"
+#include "pictures/PictureInfoTag.h"
+#include "settings/AdvancedSettings.h"
 #include "threads/SingleLock.h"
 #include "utils/log.h"
 #include "utils/URIUtils.h"
 #include "utils/StringUtils.h"
+#include "video/VideoInfoTag.h"
 #include "climits"
 
 #include <algorithm>
+#include <functional>
+#include <vector>
+
+#include "system.h"
+
+#ifdef HAVE_INOTIFY
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
 
 using namespace XFILE;
 
+// rough cost of an item in the path lookup map of a list, on top of the path itself
+#define FAST_LOOKUP_OVERHEAD 64
+
+static size_t EstimateSize(const CFileItem &item)
+{
+  size_t size = sizeof(CFileItem) + FAST_LOOKUP_OVERHEAD;
+  size += 2 * item.GetPath().size() + item.GetLabel().size() + item.GetLabel2().size();
+  if (item.HasVideoInfoTag())
+    size += sizeof(CVideoInfoTag);
+  if (item.HasMusicInfoTag())
+    size += sizeof(MUSIC_INFO::CMusicInfoTag);
+  if (item.HasPictureInfoTag())
+    size += sizeof(CPictureInfoTag);
+  return size;
+}
+
+static size_t EstimateSize(const CFileItemList &items)
+{
+  size_t size = sizeof(CFileItemList);
+  for (int i = 0; i < items.Size(); ++i)
+    size += EstimateSize(*items[i]);
+  return size;
+}
+
 CDirectoryCache::CDir::CDir(DIR_CACHE_TYPE cacheType)
 {
   m_cacheType = cacheType;
-  m_lastAccess = 0;
-  m_Items = new CFileItemList;
+  m_size = 0;
+  m_watch = -1;
+  m_Items.reset(new CFileItemList);
   m_Items->SetFastLookup(true);
 }
 
 CDirectoryCache::CDir::~CDir()
 {
-  delete m_Items;
-}
-
-void CDirectoryCache::CDir::SetLastAccess(unsigned int &accessCounter)
-{
-  m_lastAccess = accessCounter++;
 }
 
 CDirectoryCache::CDirectoryCache(void)
 {
-  m_accessCounter = 0;
+  m_inotify = -1;
 #ifdef _DEBUG
   m_cacheHits = 0;
   m_cacheMisses = 0;
@@ -59,31 +91,48 @@ CDirectoryCache::CDirectoryCache(void)
 
 CDirectoryCache::~CDirectoryCache(void)
 {
+#ifdef HAVE_INOTIFY
+  if (m_inotify >= 0)
+    close(m_inotify);
+#endif
+}
+
+CDirectoryCache::CShard &CDirectoryCache::GetShard(const std::string &storedPath)
+{
+  return m_shards[std::hash<std::string>()(storedPath) % NUM_SHARDS];
 }
 
 bool CDirectoryCache::GetDirectory(const std::string& strPath, CFileItemList &items, bool retrieveAll)
 {
-  CSingleLock lock (m_cs);
+  ProcessChanges();
 
   std::string storedPath = strPath;
   URIUtils::RemoveSlashAtEnd(storedPath);
 
-  ciCache i = m_cache.find(storedPath);
-  if (i != m_cache.end())
+  std::shared_ptr<CFileItemList> cached;
   {
+    CShard &shard = GetShard(storedPath);
+    CSingleLock lock (shard.m_cs);
+
+    iCache i = shard.m_cache.find(storedPath);
+    if (i == shard.m_cache.end())
+      return false;
+
     CDir* dir = i->second;
-    if (dir->m_cacheType == XFILE::DIR_CACHE_ALWAYS ||
-       (dir->m_cacheType == XFILE::DIR_CACHE_ONCE && retrieveAll))
-    {
-      items.Copy(*dir->m_Items);
-      dir->SetLastAccess(m_accessCounter);
+    if (dir->m_cacheType != XFILE::DIR_CACHE_ALWAYS &&
+       (dir->m_cacheType != XFILE::DIR_CACHE_ONCE || !retrieveAll))
+      return false;
+
+    cached = dir->m_Items;
+    Touch(shard, dir);
+  }
+
+  // the listing isn't modified while we hold on to it, so copy the items without the lock
+  items.Copy(*cached);
 #ifdef _DEBUG
-      m_cacheHits+=items.Size();
+  m_cacheHits+=items.Size();
 #endif
-      return true;
-    }
-  }
-  return false;
+  return true;
 }
 
 void CDirectoryCache::SetDirectory(const std::string& strPath, const CFileItemList &items, DIR_CACHE_TYPE cacheType)
@@ -102,19 +151,28 @@ void CDirectoryCache::SetDirectory(const std::string& strPath, const CFileItemLi
   // IDEALLY, any further processing on the item would actually create a new item
   // instead of altering it, but we can't really enforce that in an easy way, so
   // this is the best solution for now.
-  CSingleLock lock (m_cs);
-
   std::string storedPath = strPath;
   URIUtils::RemoveSlashAtEnd(storedPath);
 
-  ClearDirectory(storedPath);
-
-  CheckIfFull();
-
   CDir* dir = new CDir(cacheType);
   dir->m_Items->Copy(items);
-  dir->SetLastAccess(m_accessCounter);
-  m_cache.insert(std::pair<std::string, CDir*>(storedPath, dir));
+  dir->m_size = EstimateSize(*dir->m_Items);
+
+  CShard &shard = GetShard(storedPath);
+  CSingleLock lock (shard.m_cs);
+
+  iCache i = shard.m_cache.find(storedPath);
+  if (i != shard.m_cache.end())
+    Delete(shard, i);
+
+  shard.m_lru.push_front(storedPath);
+  dir->m_lastAccess = shard.m_lru.begin();
+  shard.m_cache.insert(std::pair<std::string, CDir*>(storedPath, dir));
+  if (cacheType != DIR_CACHE_ALWAYS)
+    shard.m_size += dir->m_size;
+
+  CheckIfFull(shard, dir);
+  Watch(dir, storedPath);
 }
 
 void CDirectoryCache::ClearFile(const std::string& strFile)
@@ -124,53 +182,78 @@ void CDirectoryCache::ClearFile(const std::string& strFile)
 
 void CDirectoryCache::ClearDirectory(const std::string& strPath)
 {
-  CSingleLock lock (m_cs);
-
   std::string storedPath = strPath;
   URIUtils::RemoveSlashAtEnd(storedPath);
 
-  iCache i = m_cache.find(storedPath);
-  if (i != m_cache.end())
-    Delete(i);
+  CShard &shard = GetShard(storedPath);
+  CSingleLock lock (shard.m_cs);
+
+  iCache i = shard.m_cache.find(storedPath);
+  if (i != shard.m_cache.end())
+    Delete(shard, i);
 }
 
 void CDirectoryCache::ClearSubPaths(const std::string& strPath)
 {
-  CSingleLock lock (m_cs);
-
   std::string storedPath = strPath;
   URIUtils::RemoveSlashAtEnd(storedPath);
 
-  iCache i = m_cache.begin();
-  while (i != m_cache.end())
+  for (unsigned int s = 0; s < NUM_SHARDS; ++s)
   {
-    if (StringUtils::StartsWith(i->first, storedPath))
-      Delete(i++);
-    else
-      i++;
+    CShard &shard = m_shards[s];
+    CSingleLock lock (shard.m_cs);
+
+    iCache i = shard.m_cache.begin();
+    while (i != shard.m_cache.end())
+    {
+      if (StringUtils::StartsWith(i->first, storedPath))
+        Delete(shard, i++);
+      else
+        i++;
+    }
   }
 }
 
 void CDirectoryCache::AddFile(const std::string& strFile)
 {
-  CSingleLock lock (m_cs);
-
   std::string strPath = URIUtils::GetDirectory(strFile);
   URIUtils::RemoveSlashAtEnd(strPath);
 
-  ciCache i = m_cache.find(strPath);
-  if (i != m_cache.end())
+  CShard &shard = GetShard(strPath);
+  CSingleLock lock (shard.m_cs);
+
+  iCache i = shard.m_cache.find(strPath);
+  if (i != shard.m_cache.end())
   {
     CDir *dir = i->second;
+
+    // readers may be copying from the listing, so give the directory a listing of its own.
+    // The items themselves are never modified, so they can be shared.
+    if (dir->m_Items.use_count() > 1)
+    {
+      std::shared_ptr<CFileItemList> items(new CFileItemList);
+      items->SetFastLookup(true);
+      items->Copy(*dir->m_Items, false);
+      items->Append(*dir->m_Items);
+      dir->m_Items = items;
+    }
+
     CFileItemPtr item(new CFileItem(strFile, false));
     dir->m_Items->Add(item);
-    dir->SetLastAccess(m_accessCounter);
+
+    size_t size = EstimateSize(*item);
+    dir->m_size += size;
+    if (dir->m_cacheType != DIR_CACHE_ALWAYS)
+      shard.m_size += size;
+    Touch(shard, dir);
+    CheckIfFull(shard, dir);
   }
 }
 
 bool CDirectoryCache::FileExists(const std::string& strFile, bool& bInCache)
 {
-  CSingleLock lock (m_cs);
+  ProcessChanges();
+
   bInCache = false;
 
   std::string strPath(strFile);
@@ -178,12 +261,15 @@ bool CDirectoryCache::FileExists(const std::string& strFile, bool& bInCache)
   std::string storedPath = URIUtils::GetDirectory(strPath);
   URIUtils::RemoveSlashAtEnd(storedPath);
 
-  ciCache i = m_cache.find(storedPath);
-  if (i != m_cache.end())
+  CShard &shard = GetShard(storedPath);
+  CSingleLock lock (shard.m_cs);
+
+  iCache i = shard.m_cache.find(storedPath);
+  if (i != shard.m_cache.end())
   {
     bInCache = true;
     CDir *dir = i->second;
-    dir->SetLastAccess(m_accessCounter);
+    Touch(shard, dir);
 #ifdef _DEBUG
     m_cacheHits++;
 #endif
@@ -198,11 +284,15 @@ bool CDirectoryCache::FileExists(const std::string& strFile, bool& bInCache)
 void CDirectoryCache::Clear()
 {
   // this routine clears everything
-  CSingleLock lock (m_cs);
+  for (unsigned int s = 0; s < NUM_SHARDS; ++s)
+  {
+    CShard &shard = m_shards[s];
+    CSingleLock lock (shard.m_cs);
 
-  iCache i = m_cache.begin();
-  while (i != m_cache.end() )
-    Delete(i++);
+    iCache i = shard.m_cache.begin();
+    while (i != shard.m_cache.end() )
+      Delete(shard, i++);
+  }
 }
 
 void CDirectoryCache::InitCache(std::set<std::string>& dirs)
@@ -219,61 +309,156 @@ void CDirectoryCache::InitCache(std::set<std::string>& dirs)
 
 void CDirectoryCache::ClearCache(std::set<std::string>& dirs)
 {
-  iCache i = m_cache.begin();
-  while (i != m_cache.end())
-  {
-    if (dirs.find(i->first) != dirs.end())
-      Delete(i++);
-    else
-      i++;
-  }
+  for (std::set<std::string>::const_iterator dir = dirs.begin(); dir != dirs.end(); ++dir)
+    ClearDirectory(*dir);
+}
+
+void CDirectoryCache::Touch(CShard &shard, CDir *dir)
+{
+  shard.m_lru.splice(shard.m_lru.begin(), shard.m_lru, dir->m_lastAccess);
 }
 
-void CDirectoryCache::CheckIfFull()
+void CDirectoryCache::CheckIfFull(CShard &shard, const CDir *keep)
 {
-  CSingleLock lock (m_cs);
-  static const unsigned int max_cached_dirs = 10;
+  const size_t maxSize = (size_t)g_advancedSettings.m_directoryCacheSize * 1024 * 1024 / NUM_SHARDS;
 
-  // find the last accessed folder, and remove if the number of cached folders is too many
-  iCache lastAccessed = m_cache.end();
-  unsigned int numCached = 0;
-  for (iCache i = m_cache.begin(); i != m_cache.end(); i++)
+  // remove the least recently accessed folders until we're within our share of the memory.
+  // Dirs that are always cached aren't cleared, and the one just cached is kept even if
+  // it takes up all of it on its own.
+  std::list<std::string>::iterator path = shard.m_lru.end();
+  while (shard.m_size > maxSize && path != shard.m_lru.begin())
   {
-    // ensure dirs that are always cached aren't cleared
-    if (i->second->m_cacheType != DIR_CACHE_ALWAYS)
-    {
-      if (lastAccessed == m_cache.end() || i->second->GetLastAccess() < lastAccessed->second->GetLastAccess())
-        lastAccessed = i;
-      numCached++;
-    }
+    --path;
+    iCache i = shard.m_cache.find(*path);
+    if (i == shard.m_cache.end() || i->second == keep || i->second->m_cacheType == DIR_CACHE_ALWAYS)
+      continue;
+
+    // the list entry is erased along with the directory, so step past it first
+    std::list<std::string>::iterator next = path;
+    ++next;
+    Delete(shard, i);
+    path = next;
   }
-  if (lastAccessed != m_cache.end() && numCached >= max_cached_dirs)
-    Delete(lastAccessed);
 }
 
-void CDirectoryCache::Delete(iCache it)
+void CDirectoryCache::Delete(CShard &shard, iCache it)
 {
   CDir* dir = it->second;
+  if (dir->m_cacheType != DIR_CACHE_ALWAYS)
+    shard.m_size -= dir->m_size;
+  shard.m_lru.erase(dir->m_lastAccess);
+  Unwatch(dir);
   delete dir;
-  m_cache.erase(it);
+  shard.m_cache.erase(it);
+}
+
+void CDirectoryCache::Watch(CDir *dir, const std::string &storedPath)
+{
+#ifdef HAVE_INOTIFY
+  // only local directories can be watched
+  if (storedPath.empty() || storedPath[0] != '/')
+    return;
+
+  CSingleLock lock(m_watchSection);
+  if (m_inotify < 0)
+  {
+    m_inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_inotify < 0)
+      return;
+  }
+
+  dir->m_watch = inotify_add_watch(m_inotify, storedPath.c_str(),
+                                   IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_CLOSE_WRITE |
+                                   IN_ATTRIB | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR);
+  if (dir->m_watch >= 0)
+    m_watches[dir->m_watch] = storedPath;
+#endif
+}
+
+void CDirectoryCache::Unwatch(CDir *dir)
+{
+#ifdef HAVE_INOTIFY
+  if (dir->m_watch < 0)
+    return;
+
+  CSingleLock lock(m_watchSection);
+  std::map<int, std::string>::iterator watch = m_watches.find(dir->m_watch);
+  if (watch != m_watches.end())
+  {
+    inotify_rm_watch(m_inotify, dir->m_watch);
+    m_watches.erase(watch);
+  }
+  dir->m_watch = -1;
+#endif
+}
+
+void CDirectoryCache::ProcessChanges()
+{
+#ifdef HAVE_INOTIFY
+  std::vector<std::string> changed;
+  bool overflow = false;
+  {
+    CSingleLock lock(m_watchSection);
+    if (m_watches.empty())
+      return;
+
+    char buffer[4096] __attribute__ ((aligned(__alignof__(struct inotify_event))));
+    ssize_t len;
+    while ((len = read(m_inotify, buffer, sizeof(buffer))) > 0)
+    {
+      for (char *ptr = buffer; ptr < buffer + len; )
+      {
+        const struct inotify_event *event = (const struct inotify_event *)ptr;
+        ptr += sizeof(struct inotify_event) + event->len;
+
+        if (event->mask & IN_Q_OVERFLOW)
+        {
+          overflow = true;
+          continue;
+        }
+
+        std::map<int, std::string>::iterator watch = m_watches.find(event->wd);
+        if (watch == m_watches.end())
+          continue;
+        changed.push_back(watch->second);
+        if (event->mask & IN_IGNORED)
+          m_watches.erase(watch); // the directory is gone
+      }
+    }
+  }
+
+  // we've lost track of what changed
+  if (overflow)
+  {
+    CLog::Log(LOGDEBUG, "%s - too many changes, clearing the cache", __FUNCTION__);
+    Clear();
+    return;
+  }
+
+  for (std::vector<std::string>::const_iterator path = changed.begin(); path != changed.end(); ++path)
+    ClearDirectory(*path);
+#endif
 }
 
 #ifdef _DEBUG
 void CDirectoryCache::PrintStats() const
 {
-  CSingleLock lock (m_cs);
-  CLog::Log(LOGDEBUG, "%s - total of %u cache hits, and %u cache misses", __FUNCTION__, m_cacheHits, m_cacheMisses);
-  // run through and find the oldest and the number of items cached
-  unsigned int oldest = UINT_MAX;
+  CLog::Log(LOGDEBUG, "%s - total of %u cache hits, and %u cache misses", __FUNCTION__, (unsigned int)m_cacheHits, (unsigned int)m_cacheMisses);
+  // run through and count the number of items cached
   unsigned int numItems = 0;
   unsigned int numDirs = 0;
-  for (ciCache i = m_cache.begin(); i != m_cache.end(); i++)
+  size_t size = 0;
+  for (unsigned int s = 0; s < NUM_SHARDS; ++s)
   {
-    CDir *dir = i->second;
-    oldest = std::min(oldest, dir->GetLastAccess());
-    numItems += dir->m_Items->Size();
-    numDirs++;
+    const CShard &shard = m_shards[s];
+    CSingleLock lock (shard.m_cs);
+    for (ciCache i = shard.m_cache.begin(); i != shard.m_cache.end(); i++)
+    {
+      numItems += i->second->m_Items->Size();
+      numDirs++;
+    }
+    size += shard.m_size;
   }
-  CLog::Log(LOGDEBUG, "%s - %u folders cached, with %u items total.  Oldest is %u, current is %u", __FUNCTION__, numDirs, numItems, oldest, m_accessCounter);
+  CLog::Log(LOGDEBUG, "%s - %u folders cached, with %u items total, using about %u kB", __FUNCTION__, numDirs, numItems, (unsigned int)(size / 1024));
 }
 #endif
@@ -23,13 +23,28 @@
 #include "Directory.h"
 #include "threads/CriticalSection.h"
 
+#include <atomic>
+#include <list>
 #include <map>
+#include <memory>
 #include <set>
 
 class CFileItem;
 
 namespace XFILE
 {
+  /*!
+   \brief Cache of directory listings.
+
+   The cache is split into shards by path, each with its own lock and its own least recently
+   used list, so lookups of different directories don't contend.  Each shard is bounded by its
+   share of the memory set by advancedsettings.xml <directorycachesize> and evicts the least
+   recently used directories once the estimated size of their items exceeds it.
+
+   Cached listings are never modified in place once handed out, so readers copy the items
+   outside of the shard lock.  Where inotify is available, local directories are watched and
+   dropped from the cache as soon as they change.
+   */
   class CDirectoryCache
   {
     class CDir
@@ -38,14 +53,28 @@ namespace XFILE
       CDir(DIR_CACHE_TYPE cacheType);
       virtual ~CDir();
 
-      void SetLastAccess(unsigned int &accessCounter);
-      unsigned int GetLastAccess() const { return m_lastAccess; };
-
-      CFileItemList* m_Items;
+      std::shared_ptr<CFileItemList> m_Items; ///< shared with readers copying from it, replaced rather than modified while shared
       DIR_CACHE_TYPE m_cacheType;
-    private:
-      unsigned int m_lastAccess;
+      size_t m_size;                          ///< estimated memory used by the listing, in bytes
+      std::list<std::string>::iterator m_lastAccess; ///< position in the least recently used list of the shard
+      int m_watch;                            ///< inotify watch descriptor, -1 if not watched
+    };
+
+    typedef std::map<std::string, CDir*> DirMap;
+    typedef DirMap::iterator iCache;
+    typedef DirMap::const_iterator ciCache;
+
+    class CShard
+    {
+    public:
+      CShard() : m_size(0) {}
+
+      CCriticalSection m_cs;
+      DirMap m_cache;
+      std::list<std::string> m_lru; ///< paths, most recently used first
+      size_t m_size;                ///< estimated size of the directories that may be evicted
     };
+
   public:
     CDirectoryCache(void);
     virtual ~CDirectoryCache(void);
@@ -63,20 +92,29 @@ namespace XFILE
   protected:
     void InitCache(std::set<std::string>& dirs);
     void ClearCache(std::set<std::string>& dirs);
-    void CheckIfFull();
 
-    std::map<std::string, CDir*> m_cache;
-    typedef std::map<std::string, CDir*>::iterator iCache;
-    typedef std::map<std::string, CDir*>::const_iterator ciCache;
-    void Delete(iCache i);
+    static const unsigned int NUM_SHARDS = 8;
+
+    CShard &GetShard(const std::string &storedPath);
+    void CheckIfFull(CShard &shard, const CDir *keep);
+    void Touch(CShard &shard, CDir *dir);
+    void Delete(CShard &shard, iCache i);
+
+    /*! \brief Watch a cached local directory for changes */
+    void Watch(CDir *dir, const std::string &storedPath);
+    void Unwatch(CDir *dir);
+    /*! \brief Drop the cached directories that changed since we last looked */
+    void ProcessChanges();
 
-    CCriticalSection m_cs;
+    CShard m_shards[NUM_SHARDS];
 
-    unsigned int m_accessCounter;
+    CCriticalSection m_watchSection;
+    int m_inotify;
+    std::map<int, std::string> m_watches;
 
 #ifdef _DEBUG
-    unsigned int m_cacheHits;
-    unsigned int m_cacheMisses;
+    std::atomic<unsigned int> m_cacheHits;
+    std::atomic<unsigned int> m_cacheMisses;
 #endif
   };
 }
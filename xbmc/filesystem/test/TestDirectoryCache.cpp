@@ -0,0 +1,115 @@
+/*
+ *      Copyright (C) 2005-2015 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "system.h"
+#include "filesystem/DirectoryCache.h"
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "FileItem.h"
+#include "settings/AdvancedSettings.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+
+#include "gtest/gtest.h"
+
+static void FillDirectory(CFileItemList &items, const std::string &path, int count)
+{
+  for (int i = 0; i < count; ++i)
+    items.Add(CFileItemPtr(new CFileItem(URIUtils::AddFileToFolder(path, StringUtils::Format("file%04i.mkv", i)), false)));
+}
+
+TEST(TestDirectoryCache, General)
+{
+  XFILE::CDirectoryCache cache;
+  CFileItemList items;
+  FillDirectory(items, "smb://server/share/", 10);
+  cache.SetDirectory("smb://server/share/", items, XFILE::DIR_CACHE_ONCE);
+
+  CFileItemList cached;
+  EXPECT_FALSE(cache.GetDirectory("smb://server/share/", cached));
+  EXPECT_TRUE(cache.GetDirectory("smb://server/share", cached, true));
+  EXPECT_EQ(10, cached.Size());
+
+  bool inCache;
+  EXPECT_TRUE(cache.FileExists("smb://server/share/file0003.mkv", inCache));
+  EXPECT_TRUE(inCache);
+  EXPECT_FALSE(cache.FileExists("smb://server/share/file0010.mkv", inCache));
+  EXPECT_TRUE(inCache);
+
+  // adding a file must not alter listings already handed out
+  cache.AddFile("smb://server/share/file0010.mkv");
+  EXPECT_TRUE(cache.FileExists("smb://server/share/file0010.mkv", inCache));
+  EXPECT_EQ(10, cached.Size());
+
+  cache.ClearDirectory("smb://server/share/");
+  EXPECT_FALSE(cache.FileExists("smb://server/share/file0003.mkv", inCache));
+  EXPECT_FALSE(inCache);
+}
+
+TEST(TestDirectoryCache, MemoryBound)
+{
+  unsigned int cacheSize = g_advancedSettings.m_directoryCacheSize;
+  g_advancedSettings.m_directoryCacheSize = 1;
+
+  XFILE::CDirectoryCache cache;
+  for (int i = 0; i < 64; ++i)
+  {
+    std::string path = StringUtils::Format("smb://server/share/dir%02i/", i);
+    CFileItemList items;
+    FillDirectory(items, path, 500);
+    cache.SetDirectory(path, items, XFILE::DIR_CACHE_ONCE);
+  }
+
+  // the oldest listings are gone, the last one is always kept
+  bool inCache;
+  cache.FileExists("smb://server/share/dir00/file0000.mkv", inCache);
+  EXPECT_FALSE(inCache);
+  EXPECT_TRUE(cache.FileExists("smb://server/share/dir63/file0000.mkv", inCache));
+  EXPECT_TRUE(inCache);
+
+  g_advancedSettings.m_directoryCacheSize = cacheSize;
+}
+
+#ifdef HAVE_INOTIFY
+TEST(TestDirectoryCache, LocalChanges)
+{
+  std::string path = URIUtils::AddFileToFolder(CSpecialProtocol::TranslatePath("special://temp/"), "TestDirectoryCache/");
+  ASSERT_TRUE(XFILE::CDirectory::Create(path));
+
+  XFILE::CDirectoryCache cache;
+  CFileItemList items;
+  cache.SetDirectory(path, items, XFILE::DIR_CACHE_ONCE);
+
+  bool inCache;
+  std::string file = URIUtils::AddFileToFolder(path, "file.txt");
+  EXPECT_FALSE(cache.FileExists(file, inCache));
+  EXPECT_TRUE(inCache);
+
+  // creating a file drops the listing
+  XFILE::CFile newFile;
+  ASSERT_TRUE(newFile.OpenForWrite(file, true));
+  newFile.Close();
+  cache.FileExists(file, inCache);
+  EXPECT_FALSE(inCache);
+
+  EXPECT_TRUE(XFILE::CFile::Delete(file));
+  EXPECT_TRUE(XFILE::CDirectory::Remove(path));
+}
+#endif
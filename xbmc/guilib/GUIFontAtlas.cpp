@@ -0,0 +1,103 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "GUIFontAtlas.h"
+
+#include <algorithm>
+
+CGUIFontAtlas::CGUIFontAtlas()
+{
+  m_width = m_maxHeight = m_shelfHeight = 0;
+  m_usedHeight = 0;
+  m_evictions = 0;
+}
+
+void CGUIFontAtlas::Reset(unsigned int width, unsigned int maxHeight, unsigned int shelfHeight)
+{
+  m_shelves.clear();
+  m_width = width;
+  m_maxHeight = maxHeight;
+  m_shelfHeight = shelfHeight;
+  m_usedHeight = 0;
+}
+
+int CGUIFontAtlas::Allocate(unsigned int width, unsigned int height, unsigned int frame, unsigned int &x, unsigned int &y)
+{
+  if (width > m_width)
+    return -1;
+
+  // the shelf with the least height to spare
+  int best = -1;
+  for (unsigned int i = 0; i < m_shelves.size(); i++)
+  {
+    const Shelf &shelf = m_shelves[i];
+    if (shelf.height >= height && m_width - shelf.used >= width &&
+        (best < 0 || shelf.height < m_shelves[best].height))
+      best = i;
+  }
+
+  if (best < 0)
+  {
+    Shelf shelf;
+    shelf.y = m_usedHeight;
+    shelf.height = std::max(height, m_shelfHeight);
+    shelf.used = 0;
+    shelf.lastUsed = frame;
+    if (shelf.y + shelf.height > m_maxHeight)
+      return -1;
+    m_usedHeight += shelf.height;
+    m_shelves.push_back(shelf);
+    best = m_shelves.size() - 1;
+  }
+
+  Shelf &shelf = m_shelves[best];
+  x = shelf.used;
+  y = shelf.y;
+  shelf.used += width;
+  shelf.lastUsed = frame;
+  return best;
+}
+
+int CGUIFontAtlas::Evict(unsigned int height, unsigned int frame)
+{
+  int oldest = -1;
+  for (unsigned int i = 0; i < m_shelves.size(); i++)
+  {
+    const Shelf &shelf = m_shelves[i];
+    if (shelf.height < height || shelf.lastUsed == frame)
+      continue;
+    // frames wrap around, compare the age
+    if (oldest < 0 || frame - shelf.lastUsed > frame - m_shelves[oldest].lastUsed)
+      oldest = i;
+  }
+
+  if (oldest >= 0)
+  {
+    m_shelves[oldest].used = 0;
+    m_evictions++;
+  }
+  return oldest;
+}
+
+void CGUIFontAtlas::GetShelfRect(int shelf, unsigned int &y, unsigned int &height) const
+{
+  y = m_shelves[shelf].y;
+  height = m_shelves[shelf].height;
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <vector>
+
+/*! \brief Places the glyphs of a font in its texture
+
+ The texture is split into shelves, full width rows that are filled from left to right.
+ A glyph goes on the shelf with the least height to spare that still has room for it,
+ a new shelf is opened below the others when there is none. Once the texture can't
+ grow any further the least recently used shelf is emptied for reuse, so only the
+ glyphs on that shelf have to be cached again instead of all of them.
+ */
+class CGUIFontAtlas
+{
+public:
+  CGUIFontAtlas();
+
+  /*! \brief Start over with an empty texture
+   \param width width of the texture
+   \param maxHeight height the texture may grow to
+   \param shelfHeight height of new shelves, taller glyphs get shelves of their own height
+   */
+  void Reset(unsigned int width, unsigned int maxHeight, unsigned int shelfHeight);
+
+  /*! \brief Find room for a glyph
+   The texture has to be grown to GetUsedHeight() if it's smaller.
+   \param width width of the glyph including the spacing to its neighbours
+   \param height height of the glyph including the spacing to its neighbours
+   \param frame frame the glyph is used in, see Touch()
+   \param x [out] left of the room for the glyph
+   \param y [out] top of the room for the glyph
+   \return the shelf the glyph was put on, -1 if there's no room left
+   */
+  int Allocate(unsigned int width, unsigned int height, unsigned int frame, unsigned int &x, unsigned int &y);
+
+  /*! \brief Mark a shelf as used in a frame */
+  void Touch(int shelf, unsigned int frame) { m_shelves[shelf].lastUsed = frame; }
+
+  /*! \brief Empty the least recently used shelf that is high enough for a glyph
+   Shelves used in the given frame are kept as their glyphs may be drawn already.
+   \param height height of the glyph including spacing
+   \param frame the current frame
+   \return the emptied shelf, -1 if no shelf can be emptied
+   */
+  int Evict(unsigned int height, unsigned int frame);
+
+  /*! \brief Get the area of a shelf in the texture */
+  void GetShelfRect(int shelf, unsigned int &y, unsigned int &height) const;
+
+  unsigned int GetWidth() const { return m_width; }
+  unsigned int GetMaxHeight() const { return m_maxHeight; }
+  unsigned int GetUsedHeight() const { return m_usedHeight; }
+  unsigned int GetShelfCount() const { return (unsigned int)m_shelves.size(); }
+  unsigned int GetEvictions() const { return m_evictions; }
+
+private:
+  struct Shelf
+  {
+    unsigned int y;
+    unsigned int height;
+    unsigned int used;     ///< width taken by glyphs
+    unsigned int lastUsed; ///< frame the shelf was last used in
+  };
+  std::vector<Shelf> m_shelves;
+  unsigned int m_width;
+  unsigned int m_maxHeight;
+  unsigned int m_shelfHeight;
+  unsigned int m_usedHeight;
+  unsigned int m_evictions;
+};
@@ -70,7 +70,8 @@ public:
                 const vecColors &colors, const vecText &text,
                 uint32_t alignment, float maxPixelWidth,
                 bool scrolling,
-                unsigned int nowMillis, bool &dirtyCache);
+                unsigned int nowMillis, bool &dirtyCache,
+                std::vector<int> *&shelves);
   void Flush();
 };
 
@@ -89,6 +90,7 @@ void CGUIFontCacheEntry<Position, Value>::Reassign::operator()(CGUIFontCacheEntr
 
   entry.m_lastUsedMillis = m_nowMillis;
   entry.m_value.clear();
+  entry.m_shelves.clear();
 }
 
 template<class Position, class Value>
@@ -117,12 +119,13 @@ Value &CGUIFontCache<Position, Value>::Lookup(Position &pos,
                                               const vecColors &colors, const vecText &text,
                                               uint32_t alignment, float maxPixelWidth,
                                               bool scrolling,
-                                              unsigned int nowMillis, bool &dirtyCache)
+                                              unsigned int nowMillis, bool &dirtyCache,
+                                              std::vector<int> *&shelves)
 {
   if (m_impl == nullptr)
     m_impl = new CGUIFontCacheImpl<Position, Value>(this);
 
-  return m_impl->Lookup(pos, colors, text, alignment, maxPixelWidth, scrolling, nowMillis, dirtyCache);
+  return m_impl->Lookup(pos, colors, text, alignment, maxPixelWidth, scrolling, nowMillis, dirtyCache, shelves);
 }
 
 template<class Position, class Value>
@@ -130,7 +133,8 @@ Value &CGUIFontCacheImpl<Position, Value>::Lookup(Position &pos,
                                                   const vecColors &colors, const vecText &text,
                                                   uint32_t alignment, float maxPixelWidth,
                                                   bool scrolling,
-                                                  unsigned int nowMillis, bool &dirtyCache)
+                                                  unsigned int nowMillis, bool &dirtyCache,
+                                                  std::vector<int> *&shelves)
 {
   const CGUIFontCacheKey<Position> key(pos,
                                        const_cast<vecColors &>(colors), const_cast<vecText &>(text),
@@ -156,6 +160,7 @@ Value &CGUIFontCacheImpl<Position, Value>::Lookup(Position &pos,
       m_list.template get<Age>().push_back(CGUIFontCacheEntry<Position, Value>(*m_parent, key, nowMillis));
     }
     dirtyCache = true;
+    shelves = &(--m_list.template get<Age>().end())->m_shelves;
     return (--m_list.template get<Age>().end())->m_value;
   }
   else
@@ -168,6 +173,7 @@ Value &CGUIFontCacheImpl<Position, Value>::Lookup(Position &pos,
     i->m_lastUsedMillis = nowMillis;
     m_list.template get<Age>().relocate(m_list.template get<Age>().end(), m_list.template project<Age>(i));
     dirtyCache = false;
+    shelves = &i->m_shelves;
     return i->m_value;
   }
 }
@@ -188,14 +194,14 @@ template CGUIFontCache<CGUIFontCacheStaticPosition, CGUIFontCacheStaticValue>::C
 template CGUIFontCache<CGUIFontCacheStaticPosition, CGUIFontCacheStaticValue>::~CGUIFontCache();
 template void CGUIFontCacheEntry<CGUIFontCacheStaticPosition, CGUIFontCacheStaticValue>::Reassign::operator()(CGUIFontCacheEntry<CGUIFontCacheStaticPosition, CGUIFontCacheStaticValue> &entry);
 template CGUIFontCacheEntry<CGUIFontCacheStaticPosition, CGUIFontCacheStaticValue>::~CGUIFontCacheEntry();
-template CGUIFontCacheStaticValue &CGUIFontCache<CGUIFontCacheStaticPosition, CGUIFontCacheStaticValue>::Lookup(CGUIFontCacheStaticPosition &, const vecColors &, const vecText &, uint32_t, float, bool, unsigned int, bool &);
+template CGUIFontCacheStaticValue &CGUIFontCache<CGUIFontCacheStaticPosition, CGUIFontCacheStaticValue>::Lookup(CGUIFontCacheStaticPosition &, const vecColors &, const vecText &, uint32_t, float, bool, unsigned int, bool &, std::vector<int> *&);
 template void CGUIFontCache<CGUIFontCacheStaticPosition, CGUIFontCacheStaticValue>::Flush();
 
 template CGUIFontCache<CGUIFontCacheDynamicPosition, CGUIFontCacheDynamicValue>::CGUIFontCache(CGUIFontTTFBase &font);
 template CGUIFontCache<CGUIFontCacheDynamicPosition, CGUIFontCacheDynamicValue>::~CGUIFontCache();
 template void CGUIFontCacheEntry<CGUIFontCacheDynamicPosition, CGUIFontCacheDynamicValue>::Reassign::operator()(CGUIFontCacheEntry<CGUIFontCacheDynamicPosition, CGUIFontCacheDynamicValue> &entry);
 template CGUIFontCacheEntry<CGUIFontCacheDynamicPosition, CGUIFontCacheDynamicValue>::~CGUIFontCacheEntry();
-template CGUIFontCacheDynamicValue &CGUIFontCache<CGUIFontCacheDynamicPosition, CGUIFontCacheDynamicValue>::Lookup(CGUIFontCacheDynamicPosition &, const vecColors &, const vecText &, uint32_t, float, bool, unsigned int, bool &);
+template CGUIFontCacheDynamicValue &CGUIFontCache<CGUIFontCacheDynamicPosition, CGUIFontCacheDynamicValue>::Lookup(CGUIFontCacheDynamicPosition &, const vecColors &, const vecText &, uint32_t, float, bool, unsigned int, bool &, std::vector<int> *&);
 template void CGUIFontCache<CGUIFontCacheDynamicPosition, CGUIFontCacheDynamicValue>::Flush();
 
 void CVertexBuffer::clear()
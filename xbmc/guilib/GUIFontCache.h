@@ -85,6 +85,9 @@ struct CGUIFontCacheEntry
    * hash functors, so from the container's point of view, they are mutable. */
   mutable unsigned int m_lastUsedMillis;
   mutable Value m_value;
+  /* Shelves of the font texture the characters of the text are on, touched
+   * on a cache hit so they aren't evicted while the text is on screen */
+  mutable std::vector<int> m_shelves;
 
   CGUIFontCacheEntry(const CGUIFontCache<Position, Value> &cache, const CGUIFontCacheKey<Position> &key, unsigned int nowMillis) :
     m_cache(cache),
@@ -108,7 +111,8 @@ struct CGUIFontCacheEntry
           other.m_key.m_scrolling, m_matrix,
           other.m_key.m_scaleX, other.m_key.m_scaleY),
     m_lastUsedMillis(other.m_lastUsedMillis),
-    m_value(other.m_value)
+    m_value(other.m_value),
+    m_shelves(other.m_shelves)
   {
     m_key.m_colors.assign(other.m_key.m_colors.begin(), other.m_key.m_colors.end());
     m_key.m_text.assign(other.m_key.m_text.begin(), other.m_key.m_text.end());
@@ -177,7 +181,8 @@ public:
                 const vecColors &colors, const vecText &text,
                 uint32_t alignment, float maxPixelWidth,
                 bool scrolling,
-                unsigned int nowMillis, bool &dirtyCache);
+                unsigned int nowMillis, bool &dirtyCache,
+                std::vector<int> *&shelves);
   void Flush();
 };
 
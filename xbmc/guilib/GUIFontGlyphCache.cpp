@@ -0,0 +1,237 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "GUIFontGlyphCache.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "utils/Crc32.h"
+#include "utils/JobManager.h"
+#include "utils/log.h"
+#include "utils/StringUtils.h"
+
+#include <string.h>
+
+namespace
+{
+
+const char     CACHE_MAGIC[]  = { 'K', 'F', 'G', 'C' };
+const uint32_t CACHE_VERSION  = 2;
+const char     CACHE_FOLDER[] = "special://temp/fontcache/";
+
+template<typename T>
+void Write(std::string &data, const T &value)
+{
+  data.append((const char *)&value, sizeof(value));
+}
+
+template<typename T>
+bool Read(const std::string &data, size_t &pos, T &value)
+{
+  if (data.size() - pos < sizeof(value))
+    return false;
+  memcpy(&value, data.c_str() + pos, sizeof(value));
+  pos += sizeof(value);
+  return true;
+}
+
+class CGlyphCacheWriteJob : public CJob
+{
+public:
+  CGlyphCacheWriteJob(const std::string &cacheFile, std::string &data)
+    : m_cacheFile(cacheFile)
+  {
+    m_data.swap(data);
+  }
+
+  virtual const char *GetType() const { return "fontglyphwrite"; }
+
+  virtual bool DoWork()
+  {
+    return CGUIFontGlyphCache::WriteCacheFile(m_cacheFile, m_data);
+  }
+
+private:
+  std::string m_cacheFile;
+  std::string m_data;
+};
+
+}
+
+CGUIFontGlyphCache::CGUIFontGlyphCache()
+{
+  m_textureHeight = 0;
+  m_changed = false;
+}
+
+std::string CGUIFontGlyphCache::GetCacheFile(const std::string &key)
+{
+  Crc32 crc;
+  crc.Compute(key);
+  return StringUtils::Format("%s%08x.glyphs", CACHE_FOLDER, (uint32_t)crc);
+}
+
+void CGUIFontGlyphCache::Load(const std::string &key)
+{
+  Clear();
+  m_key = key;
+
+  XFILE::CFile file;
+  XUTILS::auto_buffer buffer;
+  if (file.LoadFile(GetCacheFile(key), buffer) <= 0)
+    return;
+
+  std::string data(buffer.get(), buffer.length());
+  size_t pos = sizeof(CACHE_MAGIC);
+  uint32_t version, length, textureHeight, count;
+  if (data.size() < pos || memcmp(data.c_str(), CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 ||
+      !Read(data, pos, version) || version != CACHE_VERSION ||
+      !Read(data, pos, length) || data.size() - pos < length || data.compare(pos, length, key) != 0)
+    return;
+  pos += length;
+
+  if (!Read(data, pos, textureHeight) || !Read(data, pos, count))
+    return;
+
+  std::map<uint32_t, Glyph> glyphs;
+  for (uint32_t i = 0; i < count; i++)
+  {
+    uint32_t letterAndStyle, width, rows;
+    int32_t left, top;
+    float advance;
+    if (!Read(data, pos, letterAndStyle) || !Read(data, pos, left) || !Read(data, pos, top) ||
+        !Read(data, pos, width) || !Read(data, pos, rows) || !Read(data, pos, advance))
+      return;
+    size_t size = (size_t)width * rows;
+    if (data.size() - pos < size)
+      return;
+
+    Glyph &glyph = glyphs[letterAndStyle];
+    glyph.left = left;
+    glyph.top = top;
+    glyph.width = width;
+    glyph.rows = rows;
+    glyph.advance = advance;
+    glyph.pixels.assign(data.begin() + pos, data.begin() + pos + size);
+    pos += size;
+  }
+  if (pos != data.size())
+    return;
+
+  m_glyphs.swap(glyphs);
+  m_textureHeight = textureHeight;
+  CLog::Log(LOGDEBUG, "%s: read %u glyphs", __FUNCTION__, (unsigned int)m_glyphs.size());
+}
+
+void CGUIFontGlyphCache::Save(const std::vector<uint32_t> &letters, unsigned int textureHeight)
+{
+  if (!m_changed || m_key.empty())
+    return;
+
+  std::string data(CACHE_MAGIC, sizeof(CACHE_MAGIC));
+  Write(data, CACHE_VERSION);
+  Write(data, (uint32_t)m_key.size());
+  data += m_key;
+  Write(data, (uint32_t)textureHeight);
+  size_t countPos = data.size();
+  uint32_t count = 0;
+  Write(data, count);
+  for (std::vector<uint32_t>::const_iterator it = letters.begin(); it != letters.end(); ++it)
+  {
+    const Glyph *glyph = Get(*it);
+    if (!glyph)
+      continue;
+    Write(data, *it);
+    Write(data, (int32_t)glyph->left);
+    Write(data, (int32_t)glyph->top);
+    Write(data, (uint32_t)glyph->width);
+    Write(data, (uint32_t)glyph->rows);
+    Write(data, glyph->advance);
+    if (!glyph->pixels.empty())
+      data.append((const char *)&glyph->pixels[0], glyph->pixels.size());
+    count++;
+  }
+  data.replace(countPos, sizeof(count), (const char *)&count, sizeof(count));
+  m_changed = false;
+
+  // the job manager no longer takes jobs while the application stops, write right away then
+  CGlyphCacheWriteJob *job = new CGlyphCacheWriteJob(GetCacheFile(m_key), data);
+  if (!CJobManager::GetInstance().AddJob(job, NULL, CJob::PRIORITY_LOW))
+  {
+    job->DoWork();
+    delete job;
+  }
+}
+
+bool CGUIFontGlyphCache::WriteCacheFile(const std::string &cacheFile, const std::string &data)
+{
+  if (!XFILE::CDirectory::Exists(CACHE_FOLDER))
+    XFILE::CDirectory::Create(CACHE_FOLDER);
+
+  std::string tempFile = cacheFile + "." + StringUtils::CreateUUID();
+  XFILE::CFile file;
+  if (!file.OpenForWrite(tempFile, true))
+  {
+    CLog::Log(LOGWARNING, "%s: unable to write %s", __FUNCTION__, tempFile.c_str());
+    return false;
+  }
+  bool written = file.Write(data.c_str(), data.size()) == (ssize_t)data.size();
+  file.Close();
+
+  if (written)
+  {
+    // renaming doesn't replace an existing file everywhere
+    if (XFILE::CFile::Exists(cacheFile))
+      XFILE::CFile::Delete(cacheFile);
+    written = XFILE::CFile::Rename(tempFile, cacheFile);
+  }
+  if (!written)
+  {
+    XFILE::CFile::Delete(tempFile);
+    CLog::Log(LOGWARNING, "%s: unable to write %s", __FUNCTION__, cacheFile.c_str());
+  }
+  return written;
+}
+
+void CGUIFontGlyphCache::Clear()
+{
+  m_glyphs.clear();
+  m_key.clear();
+  m_textureHeight = 0;
+  m_changed = false;
+}
+
+const CGUIFontGlyphCache::Glyph *CGUIFontGlyphCache::Get(uint32_t letterAndStyle) const
+{
+  std::map<uint32_t, Glyph>::const_iterator it = m_glyphs.find(letterAndStyle);
+  if (it == m_glyphs.end())
+    return NULL;
+  return &it->second;
+}
+
+void CGUIFontGlyphCache::Add(uint32_t letterAndStyle, const Glyph &glyph)
+{
+  m_glyphs[letterAndStyle] = glyph;
+  m_changed = true;
+}
+
+void CGUIFontGlyphCache::Remove(uint32_t letterAndStyle)
+{
+  m_glyphs.erase(letterAndStyle);
+}
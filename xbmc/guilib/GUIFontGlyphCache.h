@@ -0,0 +1,93 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <map>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/*! \brief Rendered glyphs of a font, kept on disk between runs
+
+ Glyph bitmaps are stored in special://temp/fontcache/ per font file, size, aspect
+ and border, so glyphs that were used before don't have to be rendered by FreeType
+ again when the font is loaded. Only the glyphs in the font texture are kept in
+ memory, glyphs evicted from it are removed and rendered again when needed.
+ */
+class CGUIFontGlyphCache
+{
+public:
+  struct Glyph
+  {
+    Glyph() : left(0), top(0), width(0), rows(0), advance(0.0f) {}
+    int left;                          ///< horizontal offset of the bitmap from the pen position
+    int top;                           ///< distance from the base line to the top of the bitmap
+    unsigned int width;
+    unsigned int rows;
+    float advance;
+    std::vector<unsigned char> pixels; ///< width * rows 8 bit alpha values
+  };
+
+  CGUIFontGlyphCache();
+
+  /*! \brief Read the glyphs stored for a font, starts empty if there are none
+   \param key identifies the font file, its modification time, size, aspect and border
+   */
+  void Load(const std::string &key);
+
+  /*! \brief Write the glyphs in the font texture if any were added since Load()
+   Only the glyphs still in the texture are kept, so the file never holds more than
+   fits the texture. The file is written by a job, not by the calling thread.
+   \param letters the glyphs in the font texture
+   \param textureHeight height of the texture taken by them, see GetTextureHeight()
+   */
+  void Save(const std::vector<uint32_t> &letters, unsigned int textureHeight);
+
+  /*! \brief Forget all glyphs without writing them */
+  void Clear();
+
+  const Glyph *Get(uint32_t letterAndStyle) const;
+  void Add(uint32_t letterAndStyle, const Glyph &glyph);
+
+  /*! \brief Drop a glyph evicted from the font texture
+   The cache file is left as it is, Save() only writes the glyphs still in the texture.
+   */
+  void Remove(uint32_t letterAndStyle);
+
+  const std::map<uint32_t, Glyph> &GetGlyphs() const { return m_glyphs; }
+  const std::string &GetKey() const { return m_key; }
+
+  /*! \brief Height of the font texture when the glyphs were saved, 0 if none were read */
+  unsigned int GetTextureHeight() const { return m_textureHeight; }
+
+  static std::string GetCacheFile(const std::string &key);
+
+  /*! \brief Write the cache data of a font to its cache file
+   The data goes to a temporary file first, so readers never see a partly written file.
+   */
+  static bool WriteCacheFile(const std::string &cacheFile, const std::string &data);
+
+private:
+  std::string m_key;
+  std::map<uint32_t, Glyph> m_glyphs;
+  unsigned int m_textureHeight;
+  bool m_changed;
+};
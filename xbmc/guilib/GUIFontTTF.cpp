@@ -30,7 +30,10 @@
 #include "URL.h"
 #include "filesystem/File.h"
 #include "threads/SystemClock.h"
+#include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
 
+#include <algorithm>
 #include <math.h>
 #include <memory>
 #include <queue>
@@ -167,7 +170,7 @@ CGUIFontTTFBase::CGUIFontTTFBase(const std::string& strFileName) : m_staticCache
   m_originX = m_originY = 0.0f;
   m_cellBaseLine = m_cellHeight = 0;
   m_numChars = 0;
-  m_posX = m_posY = 0;
+  m_initialTextureHeight = 0;
   m_textureHeight = m_textureWidth = 0;
   m_textureScaleX = m_textureScaleY = 0.0;
   m_ellipsesWidth = m_height = 0.0f;
@@ -206,14 +209,17 @@ void CGUIFontTTFBase::ClearCharacterCache()
   memset(m_charquick, 0, sizeof(m_charquick));
   m_numChars = 0;
   m_maxChars = CHAR_CHUNK;
-  // set the posX and posY so that our texture will be created on first character write.
-  m_posX = m_textureWidth;
-  m_posY = -(int)GetTextureLineHeight();
+  // our texture will be created on first character write.
+  m_atlas.Reset(m_textureWidth, g_Windowing.GetMaxTextureSize(), GetTextureLineHeight());
   m_textureHeight = 0;
 }
 
 void CGUIFontTTFBase::Clear()
 {
+  // keep the glyphs in the texture for the next run
+  SaveGlyphCache();
+  m_glyphCache.Clear();
+
   delete(m_texture);
   m_texture = NULL;
   delete[] m_char;
@@ -221,8 +227,7 @@ void CGUIFontTTFBase::Clear()
   m_char = NULL;
   m_maxChars = 0;
   m_numChars = 0;
-  m_posX = 0;
-  m_posY = 0;
+  m_atlas.Reset(0, 0, 0);
   m_nestedBeginCount = 0;
 
   if (m_face)
@@ -297,6 +302,9 @@ bool CGUIFontTTFBase::Load(const std::string& strFilename, float height, float a
 
   m_height = height;
 
+  SaveGlyphCache();
+  m_glyphCache.Clear();
+
   delete(m_texture);
   m_texture = NULL;
   delete[] m_char;
@@ -316,9 +324,21 @@ bool CGUIFontTTFBase::Load(const std::string& strFilename, float height, float a
     m_textureWidth = g_Windowing.GetMaxTextureSize();
   m_textureScaleX = 1.0f / m_textureWidth;
 
-  // set the posX and posY so that our texture will be created on first character write.
-  m_posX = m_textureWidth;
-  m_posY = -(int)GetTextureLineHeight();
+  // our texture will be created on first character write.
+  m_atlas.Reset(m_textureWidth, g_Windowing.GetMaxTextureSize(), GetTextureLineHeight());
+
+  // glyphs rendered by earlier runs, only valid for the same font file at the same size
+  struct __stat64 st;
+  if (XFILE::CFile::Stat(strFilename, &st) == 0)
+  {
+    m_glyphCache.Load(StringUtils::Format("%s|%" PRId64 "|%" PRId64 "|%f|%f|%d|%d.%d.%d",
+                                          strFilename.c_str(), (int64_t)st.st_size, (int64_t)st.st_mtime,
+                                          height, aspect, border ? 1 : 0,
+                                          FREETYPE_MAJOR, FREETYPE_MINOR, FREETYPE_PATCH));
+  }
+
+  // size the texture as it was when the font was unloaded rather than growing it glyph by glyph
+  m_initialTextureHeight = std::min(m_glyphCache.GetTextureHeight(), g_Windowing.GetMaxTextureSize());
 
   // cache the ellipses width
   Character *ellipse = GetCharacter(L'.');
@@ -349,6 +369,113 @@ void CGUIFontTTFBase::End()
   LastEnd();
 }
 
+CGUIFontTTFBase *CGUIFontTTFBase::m_batchFont = NULL;
+std::vector<SVertex> CGUIFontTTFBase::m_batchVertices;
+CRect CGUIFontTTFBase::m_batchBounds;
+unsigned int CGUIFontTTFBase::m_drawCalls = 0;
+unsigned int CGUIFontTTFBase::m_uploadedBytes = 0;
+unsigned int CGUIFontTTFBase::m_frameDrawCalls = 0;
+unsigned int CGUIFontTTFBase::m_frameUploadedBytes = 0;
+
+void CGUIFontTTFBase::AddToBatch(const std::vector<SVertex> &vertices)
+{
+  if (vertices.empty())
+    return;
+
+  if (m_batchFont != this)
+  {
+    FlushBatch();
+    m_batchFont = this;
+  }
+
+  // the vertices are in final coordinates, the projection of their bounding box
+  // covers everything they can draw to
+  float minX = vertices[0].x, maxX = minX;
+  float minY = vertices[0].y, maxY = minY;
+  float minZ = vertices[0].z, maxZ = minZ;
+  for (std::vector<SVertex>::const_iterator it = vertices.begin(); it != vertices.end(); ++it)
+  {
+    minX = std::min(minX, it->x); maxX = std::max(maxX, it->x);
+    minY = std::min(minY, it->y); maxY = std::max(maxY, it->y);
+    minZ = std::min(minZ, it->z); maxZ = std::max(maxZ, it->z);
+  }
+  CRect bounds;
+  for (int i = 0; i < 8; i++)
+  {
+    float x = i & 1 ? maxX : minX;
+    float y = i & 2 ? maxY : minY;
+    float z = i & 4 ? maxZ : minZ;
+    g_Windowing.Project(x, y, z);
+    if (i == 0)
+      bounds = CRect(x, y, x, y);
+    else
+    {
+      bounds.x1 = std::min(bounds.x1, x); bounds.x2 = std::max(bounds.x2, x);
+      bounds.y1 = std::min(bounds.y1, y); bounds.y2 = std::max(bounds.y2, y);
+    }
+  }
+  // include the edge pixels
+  bounds.x2 += 1;
+  bounds.y2 += 1;
+  if (m_batchVertices.empty())
+    m_batchBounds = bounds;
+  else
+    m_batchBounds.Union(bounds);
+
+  m_batchVertices.insert(m_batchVertices.end(), vertices.begin(), vertices.end());
+}
+
+void CGUIFontTTFBase::DiscardBatch()
+{
+  if (m_batchFont != this)
+    return;
+  m_batchFont = NULL;
+  m_batchVertices.clear();
+}
+
+void CGUIFontTTFBase::FlushBatch()
+{
+  if (!m_batchFont)
+    return;
+
+  // the drawing may change state that flushes again
+  CGUIFontTTFBase *font = m_batchFont;
+  m_batchFont = NULL;
+  if (!m_batchVertices.empty())
+    font->DrawBatch(m_batchVertices);
+  m_batchVertices.clear();
+}
+
+void CGUIFontTTFBase::FlushBatch(const CRect &rect)
+{
+  if (!m_batchFont)
+    return;
+
+  CRect area = g_graphicsContext.generateAABB(rect);
+  if (!area.Intersect(m_batchBounds).IsEmpty())
+    FlushBatch();
+}
+
+void CGUIFontTTFBase::CountDraws(unsigned int drawCalls, unsigned int uploadedBytes)
+{
+  m_drawCalls += drawCalls;
+  m_uploadedBytes += uploadedBytes;
+}
+
+void CGUIFontTTFBase::GetFrameStats(unsigned int &drawCalls, unsigned int &uploadedBytes)
+{
+  drawCalls = m_frameDrawCalls;
+  uploadedBytes = m_frameUploadedBytes;
+}
+
+void CGUIFontTTFBase::NewFrame()
+{
+  m_frameDrawCalls = m_drawCalls;
+  m_frameUploadedBytes = m_uploadedBytes;
+  m_drawCalls = 0;
+  m_uploadedBytes = 0;
+}
+
 void CGUIFontTTFBase::DrawTextInternal(float x, float y, const vecColors &colors, const vecText &text, uint32_t alignment, float maxPixelWidth, bool scrolling)
 {
   Begin();
@@ -365,13 +492,14 @@ void CGUIFontTTFBase::DrawTextInternal(float x, float y, const vecColors &colors
                                               g_graphicsContext.ScaleFinalZCoord(x, y));
   }
   CVertexBuffer unusedVertexBuffer;
+  std::vector<int> *shelves = NULL;
   CVertexBuffer &vertexBuffer = hardwareClipping ?
       m_dynamicCache.Lookup(dynamicPos,
                             colors, text,
                             alignment, maxPixelWidth,
                             scrolling,
                             XbmcThreads::SystemClockMillis(),
-                            dirtyCache) :
+                            dirtyCache, shelves) :
       unusedVertexBuffer;
   std::shared_ptr<std::vector<SVertex> > tempVertices = std::make_shared<std::vector<SVertex> >();
   std::shared_ptr<std::vector<SVertex> > &vertices = hardwareClipping ?
@@ -381,7 +509,7 @@ void CGUIFontTTFBase::DrawTextInternal(float x, float y, const vecColors &colors
                            alignment, maxPixelWidth,
                            scrolling,
                            XbmcThreads::SystemClockMillis(),
-                           dirtyCache));
+                           dirtyCache, shelves));
   if (dirtyCache)
   {
     // save the origin, which is scaled separately
@@ -444,8 +572,13 @@ void CGUIFontTTFBase::DrawTextInternal(float x, float y, const vecColors &colors
     // are not currently cached and cause the texture to be enlarged, which
     // would invalidate the texture coordinates.
     std::queue<Character> characters;
+    std::vector<int> usedShelves;
     if (alignment & XBFONT_TRUNCATED)
-      GetCharacter(L'.');
+    {
+      Character *period = GetCharacter(L'.');
+      if (period && period->shelf >= 0)
+        usedShelves.push_back(period->shelf);
+    }
     for (vecText::const_iterator pos = text.begin(); pos != text.end(); ++pos)
     {
       Character *ch = GetCharacter(*pos);
@@ -456,6 +589,8 @@ void CGUIFontTTFBase::DrawTextInternal(float x, float y, const vecColors &colors
         continue;
       }
       characters.push(*ch);
+      if (ch->shelf >= 0)
+        usedShelves.push_back(ch->shelf);
 
       if (maxPixelWidth > 0 &&
           cursorX + (alignment & XBFONT_TRUNCATED ? ch->advance + 3 * m_ellipsesWidth : 0) > maxPixelWidth)
@@ -522,7 +657,7 @@ void CGUIFontTTFBase::DrawTextInternal(float x, float y, const vecColors &colors
                                                           rawAlignment, maxPixelWidth,
                                                           scrolling,
                                                           XbmcThreads::SystemClockMillis(),
-                                                          dirtyCache);
+                                                          dirtyCache, shelves);
       CVertexBuffer newVertexBuffer = CreateVertexBuffer(*tempVertices);
       vertexBuffer = newVertexBuffer;
       m_vertexTrans.push_back(CTranslatedVertices(0, 0, 0, &vertexBuffer, g_graphicsContext.GetClipRegion()));
@@ -534,13 +669,23 @@ void CGUIFontTTFBase::DrawTextInternal(float x, float y, const vecColors &colors
                            rawAlignment, maxPixelWidth,
                            scrolling,
                            XbmcThreads::SystemClockMillis(),
-                           dirtyCache) = *static_cast<CGUIFontCacheStaticValue *>(&tempVertices);
+                           dirtyCache, shelves) = *static_cast<CGUIFontCacheStaticValue *>(&tempVertices);
       /* Append the new vertices to the set collected since the first Begin() call */
       m_vertex.insert(m_vertex.end(), tempVertices->begin(), tempVertices->end());
     }
+
+    // remember the shelves of the characters so a cache hit keeps them in the texture
+    std::sort(usedShelves.begin(), usedShelves.end());
+    usedShelves.erase(std::unique(usedShelves.begin(), usedShelves.end()), usedShelves.end());
+    shelves->swap(usedShelves);
   }
   else
   {
+    // the characters aren't looked up when drawn from the cache, touch their shelves here
+    unsigned int frame = CTimeUtils::GetFrameTime();
+    for (std::vector<int>::const_iterator shelf = shelves->begin(); shelf != shelves->end(); ++shelf)
+      m_atlas.Touch(*shelf, frame);
+
     if (hardwareClipping)
       m_vertexTrans.push_back(CTranslatedVertices(dynamicPos.m_x, dynamicPos.m_y, dynamicPos.m_z, &vertexBuffer, g_graphicsContext.GetClipRegion()));
     else
@@ -607,30 +752,55 @@ CGUIFontTTFBase::Character* CGUIFontTTFBase::GetCharacter(character_t chr)
   if (letter == L'\r')
     return NULL;
 
+  unsigned int frame = CTimeUtils::GetFrameTime();
+
   // quick access to ascii chars
   if (letter < 255)
   {
     character_t ch = (style << 8) | letter;
     if (m_charquick[ch])
+    {
+      if (m_charquick[ch]->shelf >= 0)
+        m_atlas.Touch(m_charquick[ch]->shelf, frame);
       return m_charquick[ch];
+    }
   }
 
   // letters are stored based on style and letter
   character_t ch = (style << 16) | letter;
 
-  int low = 0;
-  int high = m_numChars - 1;
-  while (low <= high)
+  bool found;
+  int low = FindCharacter(ch, found);
+  if (found)
   {
-    int mid = (low + high) >> 1;
-    if (ch > m_char[mid].letterAndStyle)
-      low = mid + 1;
-    else if (ch < m_char[mid].letterAndStyle)
-      high = mid - 1;
-    else
-      return &m_char[mid];
+    if (m_char[low].shelf >= 0)
+      m_atlas.Touch(m_char[low].shelf, frame);
+    return &m_char[low];
   }
-  // if we get to here, then low is where we should insert the new character
+
+  // render the character to our texture
+  // must End() as we can't render text to our texture during a Begin(), End() block
+  Character character;
+  unsigned int nestedBeginCount = m_nestedBeginCount;
+  m_nestedBeginCount = 1;
+  if (nestedBeginCount) End();
+  if (!CacheCharacter(letter, style, &character))
+  { // unable to cache character - try clearing them all out and starting over
+    CLog::Log(LOGDEBUG, "%s: Unable to cache character.  Clearing character cache of %i characters", __FUNCTION__, m_numChars);
+    ClearCharacterCache();
+    if (!CacheCharacter(letter, style, &character))
+    {
+      CLog::Log(LOGERROR, "%s: Unable to cache character (out of memory?)", __FUNCTION__);
+      if (nestedBeginCount) Begin();
+      m_nestedBeginCount = nestedBeginCount;
+      return NULL;
+    }
+  }
+  if (nestedBeginCount) Begin();
+  m_nestedBeginCount = nestedBeginCount;
+
+  // caching may have evicted characters, so find where the new one goes again
+  low = FindCharacter(ch, found);
 
   // increase the size of the buffer if we need it
   if (m_numChars >= m_maxChars)
@@ -650,28 +820,38 @@ CGUIFontTTFBase::Character* CGUIFontTTFBase::GetCharacter(character_t chr)
   { // just move the data along as necessary
     memmove(m_char + low + 1, m_char + low, (m_numChars - low) * sizeof(Character));
   }
-  // render the character to our texture
-  // must End() as we can't render text to our texture during a Begin(), End() block
-  unsigned int nestedBeginCount = m_nestedBeginCount;
-  m_nestedBeginCount = 1;
-  if (nestedBeginCount) End();
-  if (!CacheCharacter(letter, style, m_char + low))
-  { // unable to cache character - try clearing them all out and starting over
-    CLog::Log(LOGDEBUG, "%s: Unable to cache character.  Clearing character cache of %i characters", __FUNCTION__, m_numChars);
-    ClearCharacterCache();
-    low = 0;
-    if (!CacheCharacter(letter, style, m_char + low))
+  m_char[low] = character;
+  m_numChars++;
+
+  UpdateQuickAccess();
+
+  return m_char + low;
+}
+
+int CGUIFontTTFBase::FindCharacter(character_t letterAndStyle, bool &found) const
+{
+  int low = 0;
+  int high = m_numChars - 1;
+  while (low <= high)
+  {
+    int mid = (low + high) >> 1;
+    if (letterAndStyle > m_char[mid].letterAndStyle)
+      low = mid + 1;
+    else if (letterAndStyle < m_char[mid].letterAndStyle)
+      high = mid - 1;
+    else
     {
-      CLog::Log(LOGERROR, "%s: Unable to cache character (out of memory?)", __FUNCTION__);
-      if (nestedBeginCount) Begin();
-      m_nestedBeginCount = nestedBeginCount;
-      return NULL;
+      found = true;
+      return mid;
     }
   }
-  if (nestedBeginCount) Begin();
-  m_nestedBeginCount = nestedBeginCount;
+  // if we get to here, then low is where we should insert the character
+  found = false;
+  return low;
+}
 
-  // fixup quick access
+void CGUIFontTTFBase::UpdateQuickAccess()
+{
   memset(m_charquick, 0, sizeof(m_charquick));
   for(int i=0;i<m_numChars;i++)
   {
@@ -681,15 +861,51 @@ CGUIFontTTFBase::Character* CGUIFontTTFBase::GetCharacter(character_t chr)
       m_charquick[ch] = m_char+i;
     }
   }
+}
 
-  return m_char + low;
+void CGUIFontTTFBase::SaveGlyphCache()
+{
+  std::vector<uint32_t> letters;
+  letters.reserve(m_numChars);
+  for (int i = 0; i < m_numChars; i++)
+    letters.push_back(m_char[i].letterAndStyle);
+  m_glyphCache.Save(letters, m_atlas.GetUsedHeight());
 }
 
-bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *ch)
+void CGUIFontTTFBase::RemoveShelfCharacters(int shelf)
+{
+  int count = 0;
+  for (int i = 0; i < m_numChars; i++)
+  {
+    if (m_char[i].shelf != shelf)
+      m_char[count++] = m_char[i];
+    else
+      m_glyphCache.Remove(m_char[i].letterAndStyle);
+  }
+  CLog::Log(LOGDEBUG, "%s: evicted %i characters of %s", __FUNCTION__, m_numChars - count, m_strFilename.c_str());
+  m_numChars = count;
+  UpdateQuickAccess();
+
+  // clear the shelf so no remains of the old glyphs show up next to the new ones
+  unsigned int y, height;
+  m_atlas.GetShelfRect(shelf, y, height);
+  height = std::min(height, m_textureHeight - std::min(y, m_textureHeight));
+  if (height)
+  {
+    std::vector<unsigned char> empty(m_textureWidth * height);
+    CopyCharToTexture(&empty[0], m_textureWidth, 0, y, m_textureWidth, y + height);
+  }
+
+  // cached vertices may refer to the evicted characters
+  m_staticCache.Flush();
+  m_dynamicCache.Flush();
+}
+
+bool CGUIFontTTFBase::RenderGlyph(wchar_t letter, uint32_t style, CGUIFontGlyphCache::Glyph &glyph)
 {
   int glyph_index = FT_Get_Char_Index( m_face, letter );
 
-  FT_Glyph glyph = NULL;
+  FT_Glyph ftGlyph = NULL;
   if (FT_Load_Glyph( m_face, glyph_index, FT_LOAD_TARGET_LIGHT ))
   {
     CLog::Log(LOGDEBUG, "%s Failed to load glyph %x", __FUNCTION__, letter);
@@ -702,93 +918,124 @@ bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *
   if (style & FONT_STYLE_ITALICS)
     ObliqueGlyph(m_face->glyph);
   // grab the glyph
-  if (FT_Get_Glyph(m_face->glyph, &glyph))
+  if (FT_Get_Glyph(m_face->glyph, &ftGlyph))
   {
     CLog::Log(LOGDEBUG, "%s Failed to get glyph %x", __FUNCTION__, letter);
     return false;
   }
   if (m_stroker)
-    FT_Glyph_StrokeBorder(&glyph, m_stroker, 0, 1);
+    FT_Glyph_StrokeBorder(&ftGlyph, m_stroker, 0, 1);
   // render the glyph
-  if (FT_Glyph_To_Bitmap(&glyph, FT_RENDER_MODE_NORMAL, NULL, 1))
+  if (FT_Glyph_To_Bitmap(&ftGlyph, FT_RENDER_MODE_NORMAL, NULL, 1))
   {
     CLog::Log(LOGDEBUG, "%s Failed to render glyph %x to a bitmap", __FUNCTION__, letter);
+    FT_Done_Glyph(ftGlyph);
     return false;
   }
-  FT_BitmapGlyph bitGlyph = (FT_BitmapGlyph)glyph;
+  FT_BitmapGlyph bitGlyph = (FT_BitmapGlyph)ftGlyph;
   FT_Bitmap bitmap = bitGlyph->bitmap;
-  bool isEmptyGlyph = (bitmap.width == 0 || bitmap.rows == 0);
 
-  if (!isEmptyGlyph)
+  glyph.left = bitGlyph->left;
+  glyph.top = bitGlyph->top;
+  glyph.advance = (float)MathUtils::round_int( (float)m_face->glyph->advance.x / 64 );
+  glyph.width = 0;
+  glyph.rows = 0;
+  glyph.pixels.clear();
+  if (bitmap.width != 0 && bitmap.rows != 0)
   {
-    if (bitGlyph->left < 0)
-      m_posX += -bitGlyph->left;
+    glyph.width = bitmap.width;
+    glyph.rows = bitmap.rows;
+    glyph.pixels.resize(glyph.width * glyph.rows);
+    for (unsigned int y = 0; y < glyph.rows; y++)
+      memcpy(&glyph.pixels[y * glyph.width], bitmap.buffer + y * bitmap.pitch, glyph.width);
+  }
+
+  // free the glyph
+  FT_Done_Glyph(ftGlyph);
+
+  return true;
+}
+
+bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *ch)
+{
+  character_t letterAndStyle = (style << 16) | letter;
 
-    // check we have enough room for the character
-    if ((m_posX + bitGlyph->left + bitmap.width) > static_cast<int>(m_textureWidth))
-    { // no space - gotta drop to the next line (which means creating a new texture and copying it across)
-      m_posX = 0;
-      m_posY += GetTextureLineHeight();
-      if (bitGlyph->left < 0)
-        m_posX += -bitGlyph->left;
+  // glyphs rendered before only need to be put into the texture
+  const CGUIFontGlyphCache::Glyph *glyph = m_glyphCache.Get(letterAndStyle);
+  if (!glyph)
+  {
+    CGUIFontGlyphCache::Glyph rendered;
+    if (!RenderGlyph(letter, style, rendered))
+      return false;
+    m_glyphCache.Add(letterAndStyle, rendered);
+    glyph = m_glyphCache.Get(letterAndStyle);
+  }
+  bool isEmptyGlyph = (glyph->width == 0 || glyph->rows == 0);
 
-      if(m_posY + GetTextureLineHeight() >= m_textureHeight)
+  unsigned int x = 0, y = 0;
+  int shelf = -1;
+  if (!isEmptyGlyph)
+  {
+    // find room for the character, reusing the least recently used shelf when the texture is full
+    unsigned int frame = CTimeUtils::GetFrameTime();
+    unsigned int width = glyph->width + spacing_between_characters_in_texture;
+    unsigned int height = glyph->rows + spacing_between_characters_in_texture;
+    shelf = m_atlas.Allocate(width, height, frame, x, y);
+    if (shelf < 0)
+    {
+      int evicted = m_atlas.Evict(height, frame);
+      if (evicted < 0)
       {
-        // create the new larger texture
-        unsigned int newHeight = m_posY + GetTextureLineHeight();
-        // check for max height
-        if (newHeight > g_Windowing.GetMaxTextureSize())
-        {
-          CLog::Log(LOGDEBUG, "%s: New cache texture is too large (%u > %u pixels long)", __FUNCTION__, newHeight, g_Windowing.GetMaxTextureSize());
-          FT_Done_Glyph(glyph);
-          return false;
-        }
+        CLog::Log(LOGDEBUG, "%s: No room left in the cache texture (%u pixels long)", __FUNCTION__, m_textureHeight);
+        return false;
+      }
+      RemoveShelfCharacters(evicted);
+      shelf = m_atlas.Allocate(width, height, frame, x, y);
+      if (shelf < 0)
+        return false;
+    }
 
-        CBaseTexture* newTexture = NULL;
-        newTexture = ReallocTexture(newHeight);
-        if(newTexture == NULL)
-        {
-          FT_Done_Glyph(glyph);
-          CLog::Log(LOGDEBUG, "%s: Failed to allocate new texture of height %u", __FUNCTION__, newHeight);
-          return false;
-        }
-        m_texture = newTexture;
+    if (m_atlas.GetUsedHeight() > m_textureHeight)
+    {
+      // create the new larger texture, doubling it so that it is grown only a few times
+      unsigned int newHeight = std::max(std::max(m_atlas.GetUsedHeight(), 2 * m_textureHeight), m_initialTextureHeight);
+      newHeight = std::min(newHeight, m_atlas.GetMaxHeight());
+
+      CBaseTexture* newTexture = NULL;
+      newTexture = ReallocTexture(newHeight);
+      if(newTexture == NULL)
+      {
+        CLog::Log(LOGDEBUG, "%s: Failed to allocate new texture of height %u", __FUNCTION__, newHeight);
+        return false;
       }
+      m_texture = newTexture;
     }
 
     if(m_texture == NULL)
     {
-      FT_Done_Glyph(glyph);
       CLog::Log(LOGDEBUG, "%s: no texture to cache character to", __FUNCTION__);
       return false;
     }
   }
   // set the character in our table
-  ch->letterAndStyle = (style << 16) | letter;
-  ch->offsetX = (short)bitGlyph->left;
-  ch->offsetY = (short)m_cellBaseLine - bitGlyph->top;
-  ch->left = isEmptyGlyph ? 0 : ((float)m_posX + ch->offsetX);
-  ch->top = isEmptyGlyph ? 0 : ((float)m_posY + ch->offsetY);
-  ch->right = ch->left + bitmap.width;
-  ch->bottom = ch->top + bitmap.rows;
-  ch->advance = (float)MathUtils::round_int( (float)m_face->glyph->advance.x / 64 );
+  ch->letterAndStyle = letterAndStyle;
+  ch->offsetX = (short)glyph->left;
+  ch->offsetY = (short)m_cellBaseLine - glyph->top;
+  ch->left = (float)x;
+  ch->top = (float)y;
+  ch->right = ch->left + glyph->width;
+  ch->bottom = ch->top + glyph->rows;
+  ch->advance = glyph->advance;
+  ch->shelf = shelf;
 
   // we need only render if we actually have some pixels
   if (!isEmptyGlyph)
   {
     // ensure our rect will stay inside the texture (it *should* but we need to be certain)
-    unsigned int x1 = std::max(m_posX + ch->offsetX, 0);
-    unsigned int y1 = std::max(m_posY + ch->offsetY, 0);
-    unsigned int x2 = std::min(x1 + bitmap.width, m_textureWidth);
-    unsigned int y2 = std::min(y1 + bitmap.rows, m_textureHeight);
-    CopyCharToTexture(bitGlyph, x1, y1, x2, y2);
-  
-    m_posX += spacing_between_characters_in_texture + (unsigned short)std::max(ch->right - ch->left + ch->offsetX, ch->advance);
+    unsigned int x2 = std::min(x + glyph->width, m_textureWidth);
+    unsigned int y2 = std::min(y + glyph->rows, m_textureHeight);
+    CopyCharToTexture(&glyph->pixels[0], glyph->width, x, y, x2, y2);
   }
-  m_numChars++;
-
-  // free the glyph
-  FT_Done_Glyph(glyph);
 
   return true;
 }
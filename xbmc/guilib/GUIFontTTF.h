@@ -33,6 +33,8 @@
 
 #include "utils/auto_buffer.h"
 #include "Geometry.h"
+#include "GUIFontAtlas.h"
+#include "GUIFontGlyphCache.h"
 
 #ifdef HAS_DX
 #include "DirectXMath.h"
@@ -101,6 +103,24 @@ public:
   virtual CVertexBuffer CreateVertexBuffer(const std::vector<SVertex> &vertices) const { assert(false); return CVertexBuffer(); }
   virtual void DestroyVertexBuffer(CVertexBuffer &bufferHandle) const {}
 
+  /*! \brief Draw the text collected from the strings rendered since the last flush
+   Backends that batch don't draw software clipped text at the end of each string, but
+   collect the vertices of consecutive strings of a font and draw them with a single call.
+   Anything else drawing to the screen has to flush the batch first to keep the order.
+   */
+  static void FlushBatch();
+
+  /*! \brief Draw the collected text if it may be covered by an area about to be drawn
+   \param rect the area in GUI coordinates, transformed by the current final transform
+   */
+  static void FlushBatch(const CRect &rect);
+
+  /*! \brief Get the number of text draw calls and vertex bytes uploaded in the last frame */
+  static void GetFrameStats(unsigned int &drawCalls, unsigned int &uploadedBytes);
+
+  /*! \brief Start counting the draw calls of the next frame */
+  static void NewFrame();
+
   const std::string& GetFileName() const { return m_strFileName; };
 
 protected:
@@ -110,6 +130,7 @@ protected:
     float left, top, right, bottom;
     float advance;
     character_t letterAndStyle;
+    int shelf;                 // shelf of m_atlas holding the glyph, -1 if it has no pixels
   };
   void AddReference();
   void RemoveReference();
@@ -129,12 +150,31 @@ protected:
 
   // Stuff for pre-rendering for speed
   inline Character *GetCharacter(character_t letter);
+  int FindCharacter(character_t letterAndStyle, bool &found) const;
   bool CacheCharacter(wchar_t letter, uint32_t style, Character *ch);
+  bool RenderGlyph(wchar_t letter, uint32_t style, CGUIFontGlyphCache::Glyph &glyph);
+  void RemoveShelfCharacters(int shelf);
+  void SaveGlyphCache();
+  void UpdateQuickAccess();
   void RenderCharacter(float posX, float posY, const Character *ch, color_t color, bool roundX, std::vector<SVertex> &vertices);
   void ClearCharacterCache();
 
+  // batching of text across strings
+  void AddToBatch(const std::vector<SVertex> &vertices);
+  void DiscardBatch();
+  virtual void DrawBatch(const std::vector<SVertex> &vertices) {}
+  static void CountDraws(unsigned int drawCalls, unsigned int uploadedBytes);
+
+  static CGUIFontTTFBase *m_batchFont;           // font the collected vertices belong to
+  static std::vector<SVertex> m_batchVertices;
+  static CRect m_batchBounds;                    // screen area the collected vertices may cover
+  static unsigned int m_drawCalls;               // draw calls and uploads of the current frame
+  static unsigned int m_uploadedBytes;
+  static unsigned int m_frameDrawCalls;          // draw calls and uploads of the last frame
+  static unsigned int m_frameUploadedBytes;
+
   virtual CBaseTexture* ReallocTexture(unsigned int& newHeight) = 0;
-  virtual bool CopyCharToTexture(FT_BitmapGlyph bitGlyph, unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2) = 0;
+  virtual bool CopyCharToTexture(const unsigned char *pixels, unsigned int pitch, unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2) = 0;
   virtual void DeleteHardwareTexture() = 0;
 
   // modifying glyphs
@@ -145,8 +185,9 @@ protected:
 
   unsigned int m_textureWidth;       // width of our texture
   unsigned int m_textureHeight;      // heigth of our texture
-  int m_posX;                        // current position in the texture
-  int m_posY;
+  unsigned int m_initialTextureHeight; // height to allocate the texture with, as it was when the font was last unloaded
+  CGUIFontAtlas m_atlas;             // where the characters are in the texture
+  CGUIFontGlyphCache m_glyphCache;   // rendered glyphs, kept on disk between runs
 
   /*! \brief the height of each line in the texture.
    Accounts for spacing between lines to avoid characters overlapping.
@@ -119,6 +119,7 @@ void CGUIFontTTFDX::LastEnd()
 
       // 6 indices and 4 vertices per character 
       pGUIShader->DrawIndexed(count * 6, 0, character * 4);
+      CountDraws(1, 0);
     }
   }
 
@@ -166,6 +167,7 @@ void CGUIFontTTFDX::LastEnd()
 
         // 6 indices and 4 vertices per character 
         pGUIShader->DrawIndexed(count * 6, 0, character * 4);
+        CountDraws(1, 0);
       }
     }
 
@@ -188,7 +190,10 @@ CVertexBuffer CGUIFontTTFDX::CreateVertexBuffer(const std::vector<SVertex> &vert
     if (!buffer->Create(D3D11_BIND_VERTEX_BUFFER, vertices.size(), sizeof(SVertex), DXGI_FORMAT_UNKNOWN, D3D11_USAGE_IMMUTABLE, &vertices[0]))
       CLog::Log(LOGERROR, "%s - Failed to create vertex buffer.", __FUNCTION__);
     else
+    {
       AddReference((CGUIFontTTFDX*)this, buffer);
+      CountDraws(0, vertices.size() * sizeof(SVertex));
+    }
   }
 
   return CVertexBuffer(reinterpret_cast<void*>(buffer), vertices.size() / 4, this);
@@ -258,15 +263,13 @@ CBaseTexture* CGUIFontTTFDX::ReallocTexture(unsigned int& newHeight)
   return pNewTexture;
 }
 
-bool CGUIFontTTFDX::CopyCharToTexture(FT_BitmapGlyph bitGlyph, unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2)
+bool CGUIFontTTFDX::CopyCharToTexture(const unsigned char *pixels, unsigned int pitch, unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2)
 {
-  FT_Bitmap bitmap = bitGlyph->bitmap;
-
   ID3D11DeviceContext* pContext = g_Windowing.GetImmediateContext();
   if (m_speedupTexture)
   {
     CD3D11_BOX dstBox(x1, y1, 0, x2, y2, 1);
-    pContext->UpdateSubresource(m_speedupTexture->Get(), 0, &dstBox, bitmap.buffer, bitmap.pitch, 0);
+    pContext->UpdateSubresource(m_speedupTexture->Get(), 0, &dstBox, pixels, pitch, 0);
   }
   else
     return false;
@@ -315,6 +318,7 @@ bool CGUIFontTTFDX::UpdateDynamicVertexBuffer(const SVertex* pSysMem, unsigned i
     memcpy(resource.pData, pSysMem, width);
     pContext->Unmap(m_vertexBuffer, 0);
   }
+  CountDraws(0, width);
   return true;
 }
 
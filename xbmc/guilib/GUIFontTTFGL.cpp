@@ -53,10 +53,15 @@ CGUIFontTTFGL::~CGUIFontTTFGL(void)
   // destructed before the CGUIFontTTFGL goes out of scope, because
   // our virtual methods won't be accessible after this point
   m_dynamicCache.Flush();
+  DiscardBatch();
 }
 
 bool CGUIFontTTFGL::FirstBegin()
 {
+  // collected text has to be drawn before the texture changes under it
+  if (m_textureStatus != TEXTURE_READY && m_batchFont == this)
+    FlushBatch();
+
   if (m_textureStatus == TEXTURE_REALLOCATED)
   {
     if (glIsTexture(m_nTexture))
@@ -97,6 +102,11 @@ bool CGUIFontTTFGL::FirstBegin()
     m_textureStatus = TEXTURE_READY;
   }
 
+  return true;
+}
+
+void CGUIFontTTFGL::SetRenderState()
+{
   // Turn Blending On
   glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE_MINUS_DST_ALPHA, GL_ONE);
   glEnable(GL_BLEND);
@@ -138,74 +148,34 @@ bool CGUIFontTTFGL::FirstBegin()
   }
 
 #endif
-  return true;
 }
 
 void CGUIFontTTFGL::LastEnd()
 {
-#ifdef HAS_GL
-  glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
-
-  glColorPointer   (4, GL_UNSIGNED_BYTE, sizeof(SVertex), (char*)&m_vertex[0] + offsetof(SVertex, r));
-  glVertexPointer  (3, GL_FLOAT        , sizeof(SVertex), (char*)&m_vertex[0] + offsetof(SVertex, x));
-  glTexCoordPointer(2, GL_FLOAT        , sizeof(SVertex), (char*)&m_vertex[0] + offsetof(SVertex, u));
-  glEnableClientState(GL_COLOR_ARRAY);
-  glEnableClientState(GL_VERTEX_ARRAY);
-  glEnableClientState(GL_TEXTURE_COORD_ARRAY);
-  glDrawArrays(GL_QUADS, 0, m_vertex.size());
-  glPopClientAttrib();
-
-  glActiveTexture(GL_TEXTURE1);
-  glBindTexture(GL_TEXTURE_2D, 0);
-  glDisable(GL_TEXTURE_2D);
-  glActiveTexture(GL_TEXTURE0);
-  glBindTexture(GL_TEXTURE_2D, 0);
-  glDisable(GL_TEXTURE_2D);
-#else
-  // GLES 2.0 version.
-  g_Windowing.EnableGUIShader(SM_FONTS);
-
-  CreateStaticVertexBuffers();
-
-  GLint posLoc  = g_Windowing.GUIShaderGetPos();
-  GLint colLoc  = g_Windowing.GUIShaderGetCol();
-  GLint tex0Loc = g_Windowing.GUIShaderGetCoord0();
-  GLint modelLoc = g_Windowing.GUIShaderGetModel();
+  // software clipped text is drawn together with that of the following strings
+  AddToBatch(m_vertex);
 
-  // Enable the attributes used by this shader
-  glEnableVertexAttribArray(posLoc);
-  glEnableVertexAttribArray(colLoc);
-  glEnableVertexAttribArray(tex0Loc);
-
-  if (m_vertex.size() > 0)
+#if HAS_GLES
+  if (m_vertexTrans.size() > 0)
   {
-    // Deal with vertices that had to use software clipping
-    std::vector<SVertex> vecVertices( 6 * (m_vertex.size() / 4) );
-    SVertex *vertices = &vecVertices[0];
+    // Deal with the vertices that can be hardware clipped and therefore translated,
+    // after the text collected so far
+    FlushBatch();
+    SetRenderState();
 
-    for (size_t i=0; i<m_vertex.size(); i+=4)
-    {
-      *vertices++ = m_vertex[i];
-      *vertices++ = m_vertex[i+1];
-      *vertices++ = m_vertex[i+2];
-
-      *vertices++ = m_vertex[i+1];
-      *vertices++ = m_vertex[i+3];
-      *vertices++ = m_vertex[i+2];
-    }
+    g_Windowing.EnableGUIShader(SM_FONTS);
 
-    vertices = &vecVertices[0];
+    CreateStaticVertexBuffers();
 
-    glVertexAttribPointer(posLoc,  3, GL_FLOAT,         GL_FALSE, sizeof(SVertex), (char*)vertices + offsetof(SVertex, x));
-    // Normalize color values. Does not affect Performance at all.
-    glVertexAttribPointer(colLoc,  4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(SVertex), (char*)vertices + offsetof(SVertex, r));
-    glVertexAttribPointer(tex0Loc, 2, GL_FLOAT,         GL_FALSE, sizeof(SVertex), (char*)vertices + offsetof(SVertex, u));
+    GLint posLoc  = g_Windowing.GUIShaderGetPos();
+    GLint colLoc  = g_Windowing.GUIShaderGetCol();
+    GLint tex0Loc = g_Windowing.GUIShaderGetCoord0();
+    GLint modelLoc = g_Windowing.GUIShaderGetModel();
 
-    glDrawArrays(GL_TRIANGLES, 0, vecVertices.size());
-  }
-  if (m_vertexTrans.size() > 0)
-  {
-    // Deal with the vertices that can be hardware clipped and therefore translated
+    // Enable the attributes used by this shader
+    glEnableVertexAttribArray(posLoc);
+    glEnableVertexAttribArray(colLoc);
+    glEnableVertexAttribArray(tex0Loc);
 
     // Bind our pre-calculated array to GL_ELEMENT_ARRAY_BUFFER
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_elementArrayHandle);
@@ -248,6 +218,7 @@ void CGUIFontTTFGL::LastEnd()
         glVertexAttribPointer(tex0Loc, 2, GL_FLOAT,         GL_FALSE, sizeof(SVertex), (GLvoid *) (character*sizeof(SVertex)*4 + offsetof(SVertex, u)));
 
         glDrawElements(GL_TRIANGLES, 6 * count, GL_UNSIGNED_SHORT, 0);
+        CountDraws(1, 0);
       }
 
       glMatrixModview.Pop();
@@ -259,7 +230,88 @@ void CGUIFontTTFGL::LastEnd()
     // Unbind GL_ARRAY_BUFFER and GL_ELEMENT_ARRAY_BUFFER
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    // Disable the attributes used by this shader
+    glDisableVertexAttribArray(posLoc);
+    glDisableVertexAttribArray(colLoc);
+    glDisableVertexAttribArray(tex0Loc);
+
+    g_Windowing.DisableGUIShader();
+  }
+#endif
+}
+
+void CGUIFontTTFGL::DrawBatch(const std::vector<SVertex> &vertices)
+{
+  SetRenderState();
+
+  // stream the vertices of all collected strings into a single buffer, orphaning
+  // the storage of the previous batch so the driver doesn't have to wait for it
+  unsigned int size = vertices.size() * sizeof(SVertex);
+  if (!m_batchBuffer)
+    glGenBuffers(1, &m_batchBuffer);
+  glBindBuffer(GL_ARRAY_BUFFER, m_batchBuffer);
+  glBufferData(GL_ARRAY_BUFFER, size, &vertices[0], GL_STREAM_DRAW);
+
+#ifdef HAS_GL
+  glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
+
+  glColorPointer   (4, GL_UNSIGNED_BYTE, sizeof(SVertex), (GLvoid *) offsetof(SVertex, r));
+  glVertexPointer  (3, GL_FLOAT        , sizeof(SVertex), (GLvoid *) offsetof(SVertex, x));
+  glTexCoordPointer(2, GL_FLOAT        , sizeof(SVertex), (GLvoid *) offsetof(SVertex, u));
+  glEnableClientState(GL_COLOR_ARRAY);
+  glEnableClientState(GL_VERTEX_ARRAY);
+  glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+  glDrawArrays(GL_QUADS, 0, vertices.size());
+  CountDraws(1, size);
+  glPopClientAttrib();
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+  glActiveTexture(GL_TEXTURE1);
+  glBindTexture(GL_TEXTURE_2D, 0);
+  glDisable(GL_TEXTURE_2D);
+  glActiveTexture(GL_TEXTURE0);
+  glBindTexture(GL_TEXTURE_2D, 0);
+  glDisable(GL_TEXTURE_2D);
+#else
+  // GLES 2.0 version.
+  g_Windowing.EnableGUIShader(SM_FONTS);
+
+  CreateStaticVertexBuffers();
+
+  GLint posLoc  = g_Windowing.GUIShaderGetPos();
+  GLint colLoc  = g_Windowing.GUIShaderGetCol();
+  GLint tex0Loc = g_Windowing.GUIShaderGetCoord0();
+
+  // Enable the attributes used by this shader
+  glEnableVertexAttribArray(posLoc);
+  glEnableVertexAttribArray(colLoc);
+  glEnableVertexAttribArray(tex0Loc);
+
+  // Bind our pre-calculated array to GL_ELEMENT_ARRAY_BUFFER
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_elementArrayHandle);
+
+  // Do the actual drawing operation, split into groups of characters no
+  // larger than the pre-determined size of the element array
+  size_t characters = vertices.size() / 4;
+  for (size_t character = 0; characters > character; character += ELEMENT_ARRAY_MAX_CHAR_INDEX)
+  {
+    size_t count = characters - character;
+    count = std::min<size_t>(count, ELEMENT_ARRAY_MAX_CHAR_INDEX);
+
+    glVertexAttribPointer(posLoc,  3, GL_FLOAT,         GL_FALSE, sizeof(SVertex), (GLvoid *) (character*sizeof(SVertex)*4 + offsetof(SVertex, x)));
+    // Normalize color values. Does not affect Performance at all.
+    glVertexAttribPointer(colLoc,  4, GL_UNSIGNED_BYTE, GL_TRUE,  sizeof(SVertex), (GLvoid *) (character*sizeof(SVertex)*4 + offsetof(SVertex, r)));
+    glVertexAttribPointer(tex0Loc, 2, GL_FLOAT,         GL_FALSE, sizeof(SVertex), (GLvoid *) (character*sizeof(SVertex)*4 + offsetof(SVertex, u)));
+
+    glDrawElements(GL_TRIANGLES, 6 * count, GL_UNSIGNED_SHORT, 0);
+    CountDraws(1, 0);
   }
+  CountDraws(0, size);
+
+  // Unbind GL_ARRAY_BUFFER and GL_ELEMENT_ARRAY_BUFFER
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 
   // Disable the attributes used by this shader
   glDisableVertexAttribArray(posLoc);
@@ -282,6 +334,7 @@ CVertexBuffer CGUIFontTTFGL::CreateVertexBuffer(const std::vector<SVertex> &vert
   // binding point (i.e. our buffer object) and initialise it from the
   // specified client-side pointer
   glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof (SVertex), &vertices[0], GL_STATIC_DRAW);
+  CountDraws(0, vertices.size() * sizeof (SVertex));
   // Unbind GL_ARRAY_BUFFER
   glBindBuffer(GL_ARRAY_BUFFER, 0);
 
@@ -342,17 +395,15 @@ CBaseTexture* CGUIFontTTFGL::ReallocTexture(unsigned int& newHeight)
   return newTexture;
 }
 
-bool CGUIFontTTFGL::CopyCharToTexture(FT_BitmapGlyph bitGlyph, unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2)
+bool CGUIFontTTFGL::CopyCharToTexture(const unsigned char *pixels, unsigned int pitch, unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2)
 {
-  FT_Bitmap bitmap = bitGlyph->bitmap;
-
-  unsigned char* source = (unsigned char*) bitmap.buffer;
+  const unsigned char* source = pixels;
   unsigned char* target = (unsigned char*) m_texture->GetPixels() + y1 * m_texture->GetPitch() + x1;
 
   for (unsigned int y = y1; y < y2; y++)
   {
     memcpy(target, source, x2-x1);
-    source += bitmap.width;
+    source += pitch;
     target += m_texture->GetPitch();
   }
   
@@ -390,6 +441,9 @@ bool CGUIFontTTFGL::CopyCharToTexture(FT_BitmapGlyph bitGlyph, unsigned int x1,
 
 void CGUIFontTTFGL::DeleteHardwareTexture()
 {
+  if (m_batchFont == this)
+    FlushBatch();
+
   if (m_textureStatus != TEXTURE_VOID)
   {
     if (glIsTexture(m_nTexture))
@@ -424,16 +478,25 @@ void CGUIFontTTFGL::CreateStaticVertexBuffers(void)
   m_staticVertexBufferCreated = true;
 }
 
+GLuint CGUIFontTTFGL::m_elementArrayHandle;
+bool CGUIFontTTFGL::m_staticVertexBufferCreated;
+#endif
+
 void CGUIFontTTFGL::DestroyStaticVertexBuffers(void)
 {
+  if (m_batchBuffer)
+  {
+    glDeleteBuffers(1, &m_batchBuffer);
+    m_batchBuffer = 0;
+  }
+#if HAS_GLES
   if (!m_staticVertexBufferCreated)
     return;
   glDeleteBuffers(1, &m_elementArrayHandle);
   m_staticVertexBufferCreated = false;
+#endif
 }
 
-GLuint CGUIFontTTFGL::m_elementArrayHandle;
-bool CGUIFontTTFGL::m_staticVertexBufferCreated;
-#endif
+GLuint CGUIFontTTFGL::m_batchBuffer = 0;
 
 #endif
@@ -49,13 +49,14 @@ public:
   virtual CVertexBuffer CreateVertexBuffer(const std::vector<SVertex> &vertices) const;
   virtual void DestroyVertexBuffer(CVertexBuffer &bufferHandle) const;
   static void CreateStaticVertexBuffers(void);
-  static void DestroyStaticVertexBuffers(void);
 #endif
+  static void DestroyStaticVertexBuffers(void);
 
 protected:
   virtual CBaseTexture* ReallocTexture(unsigned int& newHeight);
-  virtual bool CopyCharToTexture(FT_BitmapGlyph bitGlyph, unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2);
+  virtual bool CopyCharToTexture(const unsigned char *pixels, unsigned int pitch, unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2);
   virtual void DeleteHardwareTexture();
+  virtual void DrawBatch(const std::vector<SVertex> &vertices);
 
 #if HAS_GLES
 #define ELEMENT_ARRAY_MAX_CHAR_INDEX (1000)
@@ -63,7 +64,11 @@ protected:
   static GLuint m_elementArrayHandle;
 #endif
 
+  static GLuint m_batchBuffer;   // streaming vertex buffer the collected text is drawn from
+
 private:
+  void SetRenderState();
+
   unsigned int m_updateY1;
   unsigned int m_updateY2;
   
@@ -25,11 +25,24 @@
 #include "utils/StringUtils.h"
 #include "utils/Variant.h"
 
+#include <algorithm>
+
 bool CGUIListItem::icompare::operator()(const std::string &s1, const std::string &s2) const
 {
   return StringUtils::CompareNoCase(s1, s2) < 0;
 }
 
+namespace
+{
+struct PropertyKeyLess
+{
+  bool operator()(const std::pair<std::string, CVariant> &property, const std::string &strKey) const
+  {
+    return StringUtils::CompareNoCase(property.first, strKey) < 0;
+  }
+};
+}
+
 CGUIListItem::CGUIListItem(const CGUIListItem& item)
 {
   m_layout = NULL;
@@ -253,9 +266,9 @@ void CGUIListItem::Archive(CArchive &ar)
   {
     ar << m_bIsFolder;
     ar << m_strLabel;
-    ar << m_strLabel2;
+    ar << m_strLabel2.Get();
     ar << m_sortLabel;
-    ar << m_strIcon;
+    ar << m_strIcon.Get();
     ar << m_bSelected;
     ar << m_overlayIcon;
     ar << (int)m_mapProperties.size();
@@ -281,9 +294,12 @@ void CGUIListItem::Archive(CArchive &ar)
   {
     ar >> m_bIsFolder;
     ar >> m_strLabel;
-    ar >> m_strLabel2;
+    std::string label2, icon;
+    ar >> label2;
+    m_strLabel2 = label2;
     ar >> m_sortLabel;
-    ar >> m_strIcon;
+    ar >> icon;
+    m_strIcon = icon;
     ar >> m_bSelected;
 
     int overlayIcon;
@@ -323,9 +339,9 @@ void CGUIListItem::Serialize(CVariant &value)
 {
   value["isFolder"] = m_bIsFolder;
   value["strLabel"] = m_strLabel;
-  value["strLabel2"] = m_strLabel2;
+  value["strLabel2"] = m_strLabel2.Get();
   value["sortLabel"] = m_sortLabel;
-  value["strIcon"] = m_strIcon;
+  value["strIcon"] = m_strIcon.Get();
   value["selected"] = m_bSelected;
 
   for (PropertyMap::const_iterator it = m_mapProperties.begin(); it != m_mapProperties.end(); ++it)
@@ -340,7 +356,7 @@ void CGUIListItem::FreeIcons()
 {
   FreeMemory();
   ClearArt();
-  m_strIcon = "";
+  m_strIcon.clear();
   SetInvalid();
 }
 
@@ -388,12 +404,28 @@ void CGUIListItem::SetInvalid()
   if (m_focusedLayout) m_focusedLayout->SetInvalid();
 }
 
+CGUIListItem::PropertyMap::iterator CGUIListItem::FindProperty(const std::string &strKey)
+{
+  PropertyMap::iterator iter = std::lower_bound(m_mapProperties.begin(), m_mapProperties.end(), strKey, PropertyKeyLess());
+  if (iter != m_mapProperties.end() && StringUtils::EqualsNoCase(iter->first, strKey))
+    return iter;
+  return m_mapProperties.end();
+}
+
+CGUIListItem::PropertyMap::const_iterator CGUIListItem::FindProperty(const std::string &strKey) const
+{
+  PropertyMap::const_iterator iter = std::lower_bound(m_mapProperties.begin(), m_mapProperties.end(), strKey, PropertyKeyLess());
+  if (iter != m_mapProperties.end() && StringUtils::EqualsNoCase(iter->first, strKey))
+    return iter;
+  return m_mapProperties.end();
+}
+
 void CGUIListItem::SetProperty(const std::string &strKey, const CVariant &value)
 {
-  PropertyMap::iterator iter = m_mapProperties.find(strKey);
-  if (iter == m_mapProperties.end())
+  PropertyMap::iterator iter = std::lower_bound(m_mapProperties.begin(), m_mapProperties.end(), strKey, PropertyKeyLess());
+  if (iter == m_mapProperties.end() || !StringUtils::EqualsNoCase(iter->first, strKey))
   {
-    m_mapProperties.insert(make_pair(strKey, value));
+    m_mapProperties.insert(iter, make_pair(strKey, value));
     SetInvalid();
   }
   else if (iter->second != value)
@@ -405,7 +437,7 @@ void CGUIListItem::SetProperty(const std::string &strKey, const CVariant &value)
 
 CVariant CGUIListItem::GetProperty(const std::string &strKey) const
 {
-  PropertyMap::const_iterator iter = m_mapProperties.find(strKey);
+  PropertyMap::const_iterator iter = FindProperty(strKey);
   if (iter == m_mapProperties.end())
     return CVariant(CVariant::VariantTypeNull);
 
@@ -414,16 +446,12 @@ CVariant CGUIListItem::GetProperty(const std::string &strKey) const
 
 bool CGUIListItem::HasProperty(const std::string &strKey) const
 {
-  PropertyMap::const_iterator iter = m_mapProperties.find(strKey);
-  if (iter == m_mapProperties.end())
-    return false;
-
-  return true;
+  return FindProperty(strKey) != m_mapProperties.end();
 }
 
 void CGUIListItem::ClearProperty(const std::string &strKey)
 {
-  PropertyMap::iterator iter = m_mapProperties.find(strKey);
+  PropertyMap::iterator iter = FindProperty(strKey);
   if (iter != m_mapProperties.end())
   {
     m_mapProperties.erase(iter);
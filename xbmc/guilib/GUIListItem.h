@@ -30,6 +30,10 @@
 
 #include <map>
 #include <string>
+#include <utility>
+#include <vector>
+
+#include "utils/InternedString.h"
 
 //  Forward
 class CGUIListItemLayout;
@@ -171,8 +175,8 @@ public:
   CVariant   GetProperty(const std::string &strKey) const;
 
 protected:
-  std::string m_strLabel2;     // text of column2
-  std::string m_strIcon;      // filename of icon
+  CInternedString m_strLabel2; // text of column2, few distinct values (sizes, dates, durations)
+  CInternedString m_strIcon;   // filename of icon, mostly one of a few default icons
   GUIIconOverlay m_overlayIcon; // type of overlay icon
 
   CGUIListItemLayout *m_layout;
@@ -184,8 +188,15 @@ protected:
     bool operator()(const std::string &s1, const std::string &s2) const;
   };
 
-  typedef std::map<std::string, CVariant, icompare> PropertyMap;
+  /*! \brief Properties of the item, sorted case insensitively by key.
+   Items tend to have a handful of properties, so a sorted vector is both smaller and faster to
+   search than a map.
+   */
+  typedef std::vector<std::pair<std::string, CVariant> > PropertyMap;
   PropertyMap m_mapProperties;
+
+  PropertyMap::iterator FindProperty(const std::string &strKey);
+  PropertyMap::const_iterator FindProperty(const std::string &strKey) const;
 private:
   std::wstring m_sortLabel;    // text for sorting. Need to be UTF16 for proper sorting
   std::string m_strLabel;      // text of column1
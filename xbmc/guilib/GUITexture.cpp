@@ -20,6 +20,7 @@
 
 #include "GUITexture.h"
 #include "GraphicContext.h"
+#include "GUIFontTTF.h"
 #include "TextureManager.h"
 #include "GUILargeTextureManager.h"
 #include "utils/MathUtils.h"
@@ -175,6 +176,9 @@ void CGUITextureBase::Render()
 
   color = g_graphicsContext.MergeAlpha(color);
 
+  // text collected by the fonts has to be drawn first if we may cover it
+  CGUIFontTTFBase::FlushBatch(m_vertex);
+
   // setup our renderer
   Begin(color);
 
@@ -21,6 +21,7 @@
 #include "system.h"
 #if defined(HAS_GL)
 #include "GUITextureGL.h"
+#include "GUIFontTTF.h"
 #endif
 #include "Texture.h"
 #include "utils/log.h"
@@ -178,6 +179,8 @@ void CGUITextureGL::Draw(float *x, float *y, float *z, const CRect &texture, con
 
 void CGUITextureGL::DrawQuad(const CRect &rect, color_t color, CBaseTexture *texture, const CRect *texCoords)
 {
+  CGUIFontTTFBase::FlushBatch();
+
   if (texture)
   {
     texture->LoadToGPU();
@@ -21,6 +21,7 @@
 #include "system.h"
 #if defined(HAS_GLES)
 #include "GUITextureGLES.h"
+#include "GUIFontTTF.h"
 #endif
 #include "Texture.h"
 #include "utils/log.h"
@@ -221,6 +222,8 @@ void CGUITextureGLES::Draw(float *x, float *y, float *z, const CRect &texture, c
 
 void CGUITextureGLES::DrawQuad(const CRect &rect, color_t color, CBaseTexture *texture, const CRect *texCoords)
 {
+  CGUIFontTTFBase::FlushBatch();
+
   if (texture)
   {
     texture->LoadToGPU();
@@ -138,16 +138,24 @@ bool CGUIWindow::LoadXML(const std::string &strPath, const std::string &strLower
   // load window xml if we don't have it stored yet
   if (!m_windowXMLRootElement)
   {
-    CXBMCTinyXML xmlDoc;
-    std::string strPathLower = strPath;
-    StringUtils::ToLower(strPathLower);
-    if (!xmlDoc.LoadFile(strPath) && !xmlDoc.LoadFile(strPathLower) && !xmlDoc.LoadFile(strLowerPath))
+    // the skin reads its window files in the background while it loads
+    m_windowXMLRootElement = g_SkinInfo->LoadWindowXML(strPath);
+    if (m_windowXMLRootElement)
+      m_windowXMLFile = strPath;
+    else
     {
-      CLog::Log(LOGERROR, "unable to load:%s, Line %d\n%s", strPath.c_str(), xmlDoc.ErrorRow(), xmlDoc.ErrorDesc());
-      SetID(WINDOW_INVALID);
-      return false;
+      m_windowXMLFile.clear();
+      CXBMCTinyXML xmlDoc;
+      std::string strPathLower = strPath;
+      StringUtils::ToLower(strPathLower);
+      if (!xmlDoc.LoadFile(strPath) && !xmlDoc.LoadFile(strPathLower) && !xmlDoc.LoadFile(strLowerPath))
+      {
+        CLog::Log(LOGERROR, "unable to load:%s, Line %d\n%s", strPath.c_str(), xmlDoc.ErrorRow(), xmlDoc.ErrorDesc());
+        SetID(WINDOW_INVALID);
+        return false;
+      }
+      m_windowXMLRootElement = (TiXmlElement*)xmlDoc.RootElement()->Clone();
     }
-    m_windowXMLRootElement = (TiXmlElement*)xmlDoc.RootElement()->Clone();
   }
   else
     CLog::Log(LOGDEBUG, "Using already stored xml root node for %s", strPath.c_str());
@@ -166,16 +174,14 @@ bool CGUIWindow::Load(TiXmlElement* pRootElement)
     return false;
   }
 
-  // we must create copy of root element as we will manipulate it when resolving includes
-  // and we don't want original root element to change
-  pRootElement = (TiXmlElement*)pRootElement->Clone();
-
   // set the scaling resolution so that any control creation or initialisation can
   // be done with respect to the correct aspect ratio
   g_graphicsContext.SetScalingResolution(m_coordsRes, m_needsScaling);
 
-  // Resolve any includes that may be present and save conditions used to do it
-  g_SkinInfo->ResolveIncludes(pRootElement, &m_xmlIncludeConditions);
+  // Resolve any includes that may be present and save conditions used to do it.
+  // We get a copy of the root element as we don't want the original to change.
+  pRootElement = g_SkinInfo->ResolveWindowIncludes(pRootElement == m_windowXMLRootElement ? m_windowXMLFile : "",
+                                                   pRootElement, &m_xmlIncludeConditions);
   // now load in the skin file
   SetDefaults();
 
@@ -814,6 +820,7 @@ void CGUIWindow::FreeResources(bool forceUnload /*= FALSE */)
   {
     delete m_windowXMLRootElement;
     m_windowXMLRootElement = NULL;
+    m_windowXMLFile.clear();
     m_xmlIncludeConditions.clear();
   }
 }
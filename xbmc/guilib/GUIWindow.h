@@ -277,6 +277,7 @@ protected:
   CGUIAction m_unloadActions;
 
   TiXmlElement* m_windowXMLRootElement;
+  std::string m_windowXMLFile; ///< \brief skin file m_windowXMLRootElement was preloaded from, empty if it was parsed here
 
   bool m_manualRunActions;
 
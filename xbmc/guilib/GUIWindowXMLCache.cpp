@@ -0,0 +1,446 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "GUIWindowXMLCache.h"
+#include "GUIIncludes.h"
+#include "GUIInfoManager.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "threads/SingleLock.h"
+#include "utils/auto_buffer.h"
+#include "utils/Crc32.h"
+#include "utils/log.h"
+#include "utils/StringUtils.h"
+#include "utils/XBMCTinyXML.h"
+
+#include <stdint.h>
+#include <string.h>
+
+namespace
+{
+
+const char     CACHE_MAGIC[]  = { 'K', 'W', 'X', 'C' };
+const uint32_t CACHE_VERSION  = 2;
+
+enum NodeType
+{
+  NODE_ELEMENT = 1,
+  NODE_TEXT,
+  NODE_CDATA
+};
+
+void PutU32(std::string &data, uint32_t value)
+{
+  data.append((const char *)&value, sizeof(value));
+}
+
+void PutString(std::string &data, const char *value, size_t length)
+{
+  PutU32(data, (uint32_t)length);
+  data.append(value, length);
+}
+
+void PutString(std::string &data, const char *value)
+{
+  PutString(data, value, strlen(value));
+}
+
+void PutString(std::string &data, const std::string &value)
+{
+  PutString(data, value.c_str(), value.size());
+}
+
+class CReader
+{
+public:
+  CReader(const std::string &data) : m_data(data), m_pos(0) {}
+
+  bool GetU32(uint32_t &value)
+  {
+    if (m_data.size() - m_pos < sizeof(value))
+      return false;
+    memcpy(&value, m_data.c_str() + m_pos, sizeof(value));
+    m_pos += sizeof(value);
+    return true;
+  }
+
+  bool GetString(std::string &value)
+  {
+    uint32_t length;
+    if (!GetU32(length) || m_data.size() - m_pos < length)
+      return false;
+    value.assign(m_data, m_pos, length);
+    m_pos += length;
+    return true;
+  }
+
+  bool AtEnd() const { return m_pos == m_data.size(); }
+
+private:
+  const std::string &m_data;
+  size_t m_pos;
+};
+
+void SerializeElement(const TiXmlElement *element, std::string &data)
+{
+  PutString(data, element->Value());
+
+  uint32_t count = 0;
+  for (const TiXmlAttribute *attribute = element->FirstAttribute(); attribute; attribute = attribute->Next())
+    count++;
+  PutU32(data, count);
+  for (const TiXmlAttribute *attribute = element->FirstAttribute(); attribute; attribute = attribute->Next())
+  {
+    PutString(data, attribute->Name());
+    PutString(data, attribute->Value());
+  }
+
+  count = 0;
+  for (const TiXmlNode *child = element->FirstChild(); child; child = child->NextSibling())
+  {
+    if (child->ToElement() || child->ToText())
+      count++;
+  }
+  PutU32(data, count);
+  for (const TiXmlNode *child = element->FirstChild(); child; child = child->NextSibling())
+  {
+    if (const TiXmlElement *childElement = child->ToElement())
+    {
+      PutU32(data, NODE_ELEMENT);
+      SerializeElement(childElement, data);
+    }
+    else if (const TiXmlText *text = child->ToText())
+    {
+      PutU32(data, text->CDATA() ? NODE_CDATA : NODE_TEXT);
+      PutString(data, text->Value());
+    }
+  }
+}
+
+TiXmlElement *DeserializeElement(CReader &reader)
+{
+  std::string value;
+  uint32_t count;
+  if (!reader.GetString(value) || !reader.GetU32(count))
+    return NULL;
+
+  std::unique_ptr<TiXmlElement> element(new TiXmlElement(value.c_str()));
+  std::string name;
+  for (uint32_t i = 0; i < count; i++)
+  {
+    if (!reader.GetString(name) || !reader.GetString(value))
+      return NULL;
+    element->SetAttribute(name.c_str(), value.c_str());
+  }
+
+  if (!reader.GetU32(count))
+    return NULL;
+  for (uint32_t i = 0; i < count; i++)
+  {
+    uint32_t type;
+    if (!reader.GetU32(type))
+      return NULL;
+    if (type == NODE_ELEMENT)
+    {
+      TiXmlElement *child = DeserializeElement(reader);
+      if (!child)
+        return NULL;
+      element->LinkEndChild(child);
+    }
+    else if (type == NODE_TEXT || type == NODE_CDATA)
+    {
+      if (!reader.GetString(value))
+        return NULL;
+      TiXmlText *text = new TiXmlText(value.c_str());
+      text->SetCDATA(type == NODE_CDATA);
+      element->LinkEndChild(text);
+    }
+    else
+      return NULL;
+  }
+  return element.release();
+}
+
+bool WriteCacheFile(const std::string &cacheFile, const std::string &data)
+{
+  XFILE::CFile file;
+  if (!file.OpenForWrite(cacheFile, true))
+    return false;
+  bool written = file.Write(data.c_str(), data.size()) == (ssize_t)data.size();
+  file.Close();
+  if (!written)
+    XFILE::CFile::Delete(cacheFile);
+  return written;
+}
+
+class CWindowXMLReadJob : public CJob
+{
+public:
+  CWindowXMLReadJob(const std::string &key, const CGUIWindowXMLCache::EntryPtr &entry)
+    : m_key(key), m_entry(entry)
+  {
+  }
+
+  virtual const char *GetType() const { return "windowxmlread"; }
+
+  virtual bool DoWork()
+  {
+    CGUIWindowXMLCache::CEntry &entry = *m_entry;
+    if (!CGUIWindowXMLCache::ReadCacheFile(m_key, entry))
+    {
+      // files that aren't windows are cached without content so they aren't parsed again
+      CXBMCTinyXML xmlDoc;
+      if (xmlDoc.LoadFile(entry.m_file) && xmlDoc.RootElement() &&
+          StringUtils::EqualsNoCase(xmlDoc.RootElement()->Value(), "window"))
+        CGUIWindowXMLCache::Serialize(xmlDoc.RootElement(), entry.m_parsed);
+
+      std::string data;
+      CGUIWindowXMLCache::WriteCacheData(m_key, entry, data);
+      WriteCacheFile(entry.m_cacheFile, data);
+    }
+    entry.m_loaded.Set();
+    return true;
+  }
+
+private:
+  std::string m_key;
+  CGUIWindowXMLCache::EntryPtr m_entry;
+};
+
+class CWindowXMLWriteJob : public CJob
+{
+public:
+  CWindowXMLWriteJob(const std::string &cacheFile, const std::string &data)
+    : m_cacheFile(cacheFile), m_data(data)
+  {
+  }
+
+  virtual const char *GetType() const { return "windowxmlwrite"; }
+
+  virtual bool DoWork()
+  {
+    return WriteCacheFile(m_cacheFile, m_data);
+  }
+
+private:
+  std::string m_cacheFile;
+  std::string m_data;
+};
+
+}
+
+CGUIWindowXMLCache::CGUIWindowXMLCache(const std::string &folder)
+  : m_folder(folder),
+    m_writeQueue(false, 1, CJob::PRIORITY_LOW)
+{
+}
+
+CGUIWindowXMLCache::~CGUIWindowXMLCache()
+{
+}
+
+void CGUIWindowXMLCache::Preload(const std::string &key, const std::vector<std::string> &files)
+{
+  CSingleLock lock(m_critSection);
+  m_entries.clear();
+  m_key = key;
+
+  if (!XFILE::CDirectory::Exists(m_folder))
+    XFILE::CDirectory::Create(m_folder);
+
+  for (std::vector<std::string>::const_iterator it = files.begin(); it != files.end(); ++it)
+  {
+    EntryPtr entry(new CEntry);
+    entry->m_file = *it;
+    entry->m_cacheFile = GetCacheFile(*it);
+    std::string file(*it);
+    StringUtils::ToLower(file);
+    m_entries[file] = entry;
+    CJobManager::GetInstance().AddJob(new CWindowXMLReadJob(key, entry), NULL, CJob::PRIORITY_HIGH);
+  }
+}
+
+void CGUIWindowXMLCache::Clear()
+{
+  CSingleLock lock(m_critSection);
+  m_entries.clear();
+  m_key.clear();
+}
+
+CGUIWindowXMLCache::EntryPtr CGUIWindowXMLCache::GetEntry(const std::string &file)
+{
+  std::string lower(file);
+  StringUtils::ToLower(lower);
+
+  CSingleLock lock(m_critSection);
+  std::map<std::string, EntryPtr>::const_iterator it = m_entries.find(lower);
+  if (it == m_entries.end())
+    return EntryPtr();
+  return it->second;
+}
+
+TiXmlElement *CGUIWindowXMLCache::GetWindow(const std::string &file)
+{
+  EntryPtr entry = GetEntry(file);
+  if (!entry)
+    return NULL;
+
+  entry->m_loaded.Wait();
+  if (entry->m_parsed.empty())
+    return NULL;
+  return Deserialize(entry->m_parsed);
+}
+
+TiXmlElement *CGUIWindowXMLCache::ResolveIncludes(const std::string &file, const TiXmlElement *root, CGUIIncludes &includes,
+                                                  std::map<INFO::InfoPtr, bool> *xmlIncludeConditions)
+{
+  EntryPtr entry;
+  if (!file.empty())
+    entry = GetEntry(file);
+  if (entry)
+  {
+    entry->m_loaded.Wait();
+    // root didn't come from the cache
+    if (entry->m_parsed.empty())
+      entry.reset();
+  }
+
+  std::map<INFO::InfoPtr, bool> conditions;
+  if (entry && !entry->m_resolved.empty())
+  {
+    bool unchanged = true;
+    for (std::vector<std::pair<std::string, bool> >::const_iterator it = entry->m_conditions.begin(); it != entry->m_conditions.end(); ++it)
+    {
+      INFO::InfoPtr condition = g_infoManager.Register(it->first);
+      if (!condition || condition->Get() != it->second)
+      {
+        unchanged = false;
+        break;
+      }
+      conditions.insert(std::make_pair(condition, it->second));
+    }
+
+    TiXmlElement *resolved = unchanged ? Deserialize(entry->m_resolved) : NULL;
+    if (resolved)
+    {
+      if (xmlIncludeConditions)
+        xmlIncludeConditions->swap(conditions);
+      return resolved;
+    }
+    conditions.clear();
+  }
+
+  TiXmlElement *resolved = (TiXmlElement *)root->Clone();
+  includes.ResolveIncludes(resolved, &conditions);
+
+  if (entry)
+  {
+    entry->m_conditions.clear();
+    for (std::map<INFO::InfoPtr, bool>::const_iterator it = conditions.begin(); it != conditions.end(); ++it)
+      entry->m_conditions.push_back(std::make_pair(it->first->GetExpression(), it->second));
+    Serialize(resolved, entry->m_resolved);
+
+    std::string data;
+    WriteCacheData(m_key, *entry, data);
+    m_writeQueue.AddJob(new CWindowXMLWriteJob(entry->m_cacheFile, data));
+  }
+
+  if (xmlIncludeConditions)
+    xmlIncludeConditions->swap(conditions);
+  return resolved;
+}
+
+void CGUIWindowXMLCache::Serialize(const TiXmlElement *root, std::string &data)
+{
+  data.clear();
+  SerializeElement(root, data);
+}
+
+TiXmlElement *CGUIWindowXMLCache::Deserialize(const std::string &data)
+{
+  CReader reader(data);
+  TiXmlElement *root = DeserializeElement(reader);
+  if (root && !reader.AtEnd())
+  {
+    delete root;
+    return NULL;
+  }
+  return root;
+}
+
+std::string CGUIWindowXMLCache::GetCacheFile(const std::string &file) const
+{
+  Crc32 crc;
+  crc.ComputeFromLowerCase(file);
+  return StringUtils::Format("%s%08x.bin", m_folder.c_str(), (uint32_t)crc);
+}
+
+bool CGUIWindowXMLCache::ReadCacheFile(const std::string &key, CEntry &entry)
+{
+  XFILE::CFile file;
+  XUTILS::auto_buffer buffer;
+  if (file.LoadFile(entry.m_cacheFile, buffer) <= 0)
+    return false;
+
+  std::string data(buffer.get(), buffer.length());
+  if (data.size() < sizeof(CACHE_MAGIC) || memcmp(data.c_str(), CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0)
+    return false;
+  data.erase(0, sizeof(CACHE_MAGIC));
+
+  CReader reader(data);
+  uint32_t version, count;
+  std::string fileKey, parsed, resolved;
+  if (!reader.GetU32(version) || version != CACHE_VERSION ||
+      !reader.GetString(fileKey) || fileKey != key ||
+      !reader.GetString(parsed) || !reader.GetU32(count))
+    return false;
+
+  std::vector<std::pair<std::string, bool> > conditions;
+  for (uint32_t i = 0; i < count; i++)
+  {
+    std::string condition;
+    uint32_t value;
+    if (!reader.GetString(condition) || !reader.GetU32(value))
+      return false;
+    conditions.push_back(std::make_pair(condition, value != 0));
+  }
+  if (!reader.GetString(resolved) || !reader.AtEnd())
+    return false;
+
+  entry.m_parsed.swap(parsed);
+  entry.m_resolved.swap(resolved);
+  entry.m_conditions.swap(conditions);
+  return true;
+}
+
+void CGUIWindowXMLCache::WriteCacheData(const std::string &key, const CEntry &entry, std::string &data)
+{
+  data.assign(CACHE_MAGIC, sizeof(CACHE_MAGIC));
+  PutU32(data, CACHE_VERSION);
+  PutString(data, key);
+  PutString(data, entry.m_parsed);
+  PutU32(data, (uint32_t)entry.m_conditions.size());
+  for (std::vector<std::pair<std::string, bool> >::const_iterator it = entry.m_conditions.begin(); it != entry.m_conditions.end(); ++it)
+  {
+    PutString(data, it->first);
+    PutU32(data, it->second ? 1 : 0);
+  }
+  PutString(data, entry.m_resolved);
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "interfaces/info/InfoBool.h"
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+#include "utils/JobManager.h"
+
+class TiXmlElement;
+class CGUIIncludes;
+
+/*! \brief Window files of the current skin, read in the background while the skin loads
+
+ Preload() queues a job per window file that either reads the file from the cache
+ in special://temp/skincache/ or parses the xml and writes the cache. Windows get
+ their xml from here instead of parsing it on the GUI thread.
+
+ The cache also keeps each window with its includes resolved, together with the values
+ of the include conditions that were used. As long as those conditions keep their values
+ the expanded copy is used as is instead of resolving the includes again. Resolving
+ has to happen on the GUI thread as the conditions are evaluated against the current
+ state and CGUIIncludes loads include files on demand.
+
+ Cache files carry a key made of the skin id, version, resolution folder and the size and
+ modification time of all xml files of the skin, any change to the skin invalidates them.
+ */
+class CGUIWindowXMLCache
+{
+public:
+  /*! \param folder where the cache files are kept */
+  CGUIWindowXMLCache(const std::string &folder = "special://temp/skincache/");
+  ~CGUIWindowXMLCache();
+
+  /*! \brief Start reading window files on the job manager, drops anything read before
+   \param key identifies the skin state the files are read for, stored with the cache files
+   \param files paths of the window files
+   */
+  void Preload(const std::string &key, const std::vector<std::string> &files);
+
+  /*! \brief Forget all window files */
+  void Clear();
+
+  /*! \brief Get a copy of a window file as parsed, waits if the file is still being read
+   \param file path of the window file
+   \return the root element to be deleted by the caller, NULL if the file wasn't preloaded or couldn't be parsed
+   */
+  TiXmlElement *GetWindow(const std::string &file);
+
+  /*! \brief Get a copy of a window with its includes resolved
+   Uses the expanded copy of the window if the include conditions it was made with
+   still have the same values, otherwise a copy of root is resolved and cached.
+   \param file path of the window file root was loaded from, may be empty
+   \param root the window as parsed
+   \param includes includes of the skin
+   \param xmlIncludeConditions [out] conditions used to resolve the includes
+   \return the expanded window to be deleted by the caller
+   */
+  TiXmlElement *ResolveIncludes(const std::string &file, const TiXmlElement *root, CGUIIncludes &includes,
+                                std::map<INFO::InfoPtr, bool> *xmlIncludeConditions);
+
+  /*! \brief Serialize an element and its children to the binary format of the cache
+   Only elements and text are kept, comments and other nodes are dropped.
+   */
+  static void Serialize(const TiXmlElement *root, std::string &data);
+
+  /*! \brief Build an element from data written by Serialize()
+   \return the element to be deleted by the caller, NULL if data is invalid
+   */
+  static TiXmlElement *Deserialize(const std::string &data);
+
+  /*! \brief Get the name of the cache file of a window file */
+  std::string GetCacheFile(const std::string &file) const;
+
+  /*! \brief Window file as held in memory and in the cache file */
+  struct CEntry
+  {
+    CEntry() : m_loaded(true) {}
+    std::string m_file;
+    std::string m_cacheFile;
+    CEvent      m_loaded;   ///< set once the job reading the file is done
+    std::string m_parsed;   ///< serialized window as parsed, empty if the file couldn't be parsed
+    std::string m_resolved; ///< serialized window with includes resolved, empty if not resolved yet
+    std::vector<std::pair<std::string, bool> > m_conditions; ///< include conditions m_resolved was made with
+  };
+  typedef std::shared_ptr<CEntry> EntryPtr;
+
+  /*! \brief Read the cache file of an entry
+   \return false if the file doesn't exist or was written for another key
+   */
+  static bool ReadCacheFile(const std::string &key, CEntry &entry);
+
+  /*! \brief Serialize an entry to the format of the cache file */
+  static void WriteCacheData(const std::string &key, const CEntry &entry, std::string &data);
+
+private:
+  EntryPtr GetEntry(const std::string &file);
+
+  CCriticalSection m_critSection;
+  std::string m_folder;
+  std::string m_key;
+  std::map<std::string, EntryPtr> m_entries; ///< by lower case path
+  CJobQueue m_writeQueue;                    ///< writes of resolved windows, one at a time
+};
@@ -20,6 +20,7 @@
 
 #include "system.h"
 #include "GraphicContext.h"
+#include "GUIFontTTF.h"
 #include "Application.h"
 #include "messaging/ApplicationMessenger.h"
 #include "settings/AdvancedSettings.h"
@@ -1059,7 +1060,9 @@ void CGraphicContext::SetMediaDir(const std::string &strMediaDir)
 
 void CGraphicContext::Flip(const CDirtyRegionList& dirty)
 {
+  CGUIFontTTFBase::FlushBatch();
   g_Windowing.PresentRender(dirty);
+  CGUIFontTTFBase::NewFrame();
 
   if(m_stereoMode != m_nextStereoMode)
   {
@@ -0,0 +1,188 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "filesystem/File.h"
+#include "guilib/GUIFontAtlas.h"
+#include "guilib/GUIFontGlyphCache.h"
+#include "threads/SystemClock.h"
+
+#include "gtest/gtest.h"
+
+#ifdef TARGET_POSIX
+#include "linux/XTimeUtils.h"
+#endif
+
+#include <vector>
+
+namespace
+{
+
+struct Rect
+{
+  unsigned int x1, y1, x2, y2;
+};
+
+bool Overlaps(const Rect &a, const Rect &b)
+{
+  return a.x1 < b.x2 && b.x1 < a.x2 && a.y1 < b.y2 && b.y1 < a.y2;
+}
+
+}
+
+TEST(TestGUIFontAtlas, Allocate)
+{
+  CGUIFontAtlas atlas;
+  atlas.Reset(64, 64, 10);
+
+  std::vector<Rect> rects;
+  unsigned int x, y;
+  for (unsigned int i = 0; i < 40; i++)
+  {
+    unsigned int width = 3 + i % 7;
+    unsigned int height = i % 5 == 0 ? 14 : 4 + i % 6;
+    int shelf = atlas.Allocate(width, height, 1, x, y);
+    if (shelf < 0)
+      break;
+    Rect rect = { x, y, x + width, y + height };
+    EXPECT_LE(rect.x2, 64u);
+    EXPECT_LE(rect.y2, atlas.GetUsedHeight());
+    for (std::vector<Rect>::const_iterator it = rects.begin(); it != rects.end(); ++it)
+      EXPECT_FALSE(Overlaps(*it, rect));
+    rects.push_back(rect);
+  }
+  EXPECT_GT(rects.size(), 20u);
+  EXPECT_LE(atlas.GetUsedHeight(), 64u);
+
+  // small glyphs go on the existing shelves rather than opening new ones
+  unsigned int shelves = atlas.GetShelfCount();
+  atlas.Reset(64, 64, 10);
+  EXPECT_EQ(0, atlas.Allocate(20, 8, 1, x, y));
+  EXPECT_EQ(0, atlas.Allocate(20, 10, 1, x, y));
+  EXPECT_EQ(20u, x);
+  EXPECT_EQ(0u, y);
+  EXPECT_EQ(1, atlas.Allocate(20, 12, 1, x, y));
+  EXPECT_EQ(10u, y);
+  EXPECT_EQ(0, atlas.Allocate(20, 6, 1, x, y));
+  EXPECT_EQ(22u, atlas.GetUsedHeight());
+  EXPECT_GT(shelves, 2u);
+
+  // too wide or no height left
+  EXPECT_EQ(-1, atlas.Allocate(65, 1, 1, x, y));
+  EXPECT_EQ(-1, atlas.Allocate(10, 43, 1, x, y));
+}
+
+TEST(TestGUIFontAtlas, Evict)
+{
+  CGUIFontAtlas atlas;
+  atlas.Reset(32, 30, 10);
+
+  unsigned int x, y;
+  EXPECT_EQ(0, atlas.Allocate(32, 10, 1, x, y));
+  EXPECT_EQ(1, atlas.Allocate(32, 10, 2, x, y));
+  EXPECT_EQ(2, atlas.Allocate(32, 10, 3, x, y));
+  EXPECT_EQ(-1, atlas.Allocate(8, 8, 4, x, y));
+
+  // the least recently used shelf is emptied
+  atlas.Touch(0, 4);
+  EXPECT_EQ(1, atlas.Evict(8, 4));
+  EXPECT_EQ(1u, atlas.GetEvictions());
+  EXPECT_EQ(1, atlas.Allocate(8, 8, 4, x, y));
+  EXPECT_EQ(0u, x);
+  EXPECT_EQ(10u, y);
+
+  // shelves used in the current frame are kept
+  atlas.Touch(2, 4);
+  EXPECT_EQ(-1, atlas.Evict(8, 4));
+  EXPECT_EQ(0, atlas.Evict(8, 5));
+
+  // glyphs taller than every shelf can't be placed
+  EXPECT_EQ(-1, atlas.Evict(11, 6));
+
+  unsigned int shelfY, shelfHeight;
+  atlas.GetShelfRect(2, shelfY, shelfHeight);
+  EXPECT_EQ(20u, shelfY);
+  EXPECT_EQ(10u, shelfHeight);
+}
+
+TEST(TestGUIFontGlyphCache, SaveLoad)
+{
+  const std::string key = "special://temp/TestGUIFontGlyphCache.ttf|1|2|20.0|1.0|0|2.5.5";
+
+  CGUIFontGlyphCache::Glyph glyph;
+  glyph.left = -1;
+  glyph.top = 12;
+  glyph.width = 3;
+  glyph.rows = 2;
+  glyph.advance = 4.0f;
+  for (unsigned char i = 0; i < 6; i++)
+    glyph.pixels.push_back(i * 40);
+
+  XFILE::CFile::Delete(CGUIFontGlyphCache::GetCacheFile(key));
+
+  CGUIFontGlyphCache cache;
+  cache.Load(key);
+  cache.Add('a', glyph);
+  cache.Add('b', glyph);
+  cache.Add(' ', CGUIFontGlyphCache::Glyph());
+
+  // only the glyphs in the texture are kept, 'b' was evicted from it
+  std::vector<uint32_t> letters;
+  letters.push_back(' ');
+  letters.push_back('a');
+  cache.Save(letters, 64);
+
+  // the file is written by a job
+  CGUIFontGlyphCache loaded;
+  XbmcThreads::EndTime timeout(5000);
+  do
+  {
+    loaded.Load(key);
+    if (!loaded.GetGlyphs().empty())
+      break;
+    Sleep(10);
+  } while (!timeout.IsTimePast());
+  ASSERT_EQ(2u, loaded.GetGlyphs().size());
+  EXPECT_EQ(64u, loaded.GetTextureHeight());
+  const CGUIFontGlyphCache::Glyph *a = loaded.Get('a');
+  ASSERT_TRUE(a != NULL);
+  EXPECT_EQ(-1, a->left);
+  EXPECT_EQ(12, a->top);
+  EXPECT_EQ(3u, a->width);
+  EXPECT_EQ(2u, a->rows);
+  EXPECT_EQ(4.0f, a->advance);
+  EXPECT_EQ(glyph.pixels, a->pixels);
+  ASSERT_TRUE(loaded.Get(' ') != NULL);
+  EXPECT_TRUE(loaded.Get(' ')->pixels.empty());
+  EXPECT_TRUE(loaded.Get('b') == NULL);
+
+  // nothing is written when no glyphs were added
+  loaded.Save(std::vector<uint32_t>(), 0);
+  Sleep(100);
+  CGUIFontGlyphCache reloaded;
+  reloaded.Load(key);
+  EXPECT_EQ(2u, reloaded.GetGlyphs().size());
+
+  // a different size or font version doesn't use the glyphs
+  CGUIFontGlyphCache other;
+  other.Load(key + "1");
+  EXPECT_TRUE(other.GetGlyphs().empty());
+
+  XFILE::CFile::Delete(CGUIFontGlyphCache::GetCacheFile(key));
+}
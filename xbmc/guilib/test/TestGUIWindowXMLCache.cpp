@@ -0,0 +1,308 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "FileItem.h"
+#include "GUIInfoManager.h"
+#include "addons/Skin.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "guilib/GUIIncludes.h"
+#include "guilib/GUIWindowXMLCache.h"
+#include "settings/SkinSettings.h"
+#include "test/TestUtils.h"
+#include "threads/SystemClock.h"
+#include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
+#include "utils/URIUtils.h"
+#include "utils/XBMCTinyXML.h"
+
+#ifdef TARGET_POSIX
+#include "linux/XTimeUtils.h"
+#endif
+
+#include "gtest/gtest.h"
+
+#include <stdio.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+std::string Print(const TiXmlElement *element)
+{
+  TiXmlPrinter printer;
+  element->Accept(&printer);
+  return printer.Str();
+}
+
+double Milliseconds(int64_t ticks)
+{
+  return ticks * 1000.0 / CurrentHostFrequency();
+}
+
+// the type of the first control of a window
+std::string GetControlType(const TiXmlElement *window)
+{
+  const TiXmlElement *control = window->FirstChildElement("controls");
+  if (control)
+    control = control->FirstChildElement("control");
+  return control && control->Attribute("type") ? control->Attribute("type") : "";
+}
+
+}
+
+// cache files of their own, so earlier runs and the real skin cache don't matter
+class TestGUIWindowXMLCache : public ::testing::Test
+{
+protected:
+  TestGUIWindowXMLCache()
+  {
+    std::string uuid = StringUtils::CreateUUID();
+    m_folder = URIUtils::AddFileToFolder(CSpecialProtocol::TranslatePath("special://temp/"), "TestGUIWindowXMLCache" + uuid);
+    URIUtils::AddSlashAtEnd(m_folder);
+    m_key = "TestGUIWindowXMLCache" + uuid;
+  }
+
+  ~TestGUIWindowXMLCache()
+  {
+    CFileItemList items;
+    XFILE::CDirectory::GetDirectory(m_folder, items);
+    for (int i = 0; i < items.Size(); i++)
+      XFILE::CFile::Delete(items[i]->GetPath());
+    XFILE::CDirectory::Remove(m_folder);
+  }
+
+  // the Confluence window files and their windows as parsed from the files, serialized
+  void LoadConfluenceWindows(std::vector<std::string> &files, std::vector<std::string> &windows)
+  {
+    std::string xmlPath = URIUtils::AddFileToFolder(XBMC_REF_FILE_PATH("addons/skin.confluence"), "720p");
+    CFileItemList items;
+    ASSERT_TRUE(XFILE::CDirectory::GetDirectory(xmlPath, items, ".xml"));
+
+    for (int i = 0; i < items.Size(); i++)
+    {
+      files.push_back(items[i]->GetPath());
+      CXBMCTinyXML doc;
+      std::string data;
+      if (doc.LoadFile(items[i]->GetPath()) && doc.RootElement() && doc.RootElement()->ValueStr() == "window")
+        CGUIWindowXMLCache::Serialize(doc.RootElement(), data);
+      windows.push_back(data);
+    }
+  }
+
+  std::string m_folder;
+  std::string m_key;
+};
+
+TEST_F(TestGUIWindowXMLCache, Serialize)
+{
+  CXBMCTinyXML doc;
+  doc.Parse("<window id=\"1\" type=\"dialog\">"
+              "<defaultcontrol always=\"true\">2</defaultcontrol>"
+              "<controls>"
+                "<control type=\"label\"><label>a &amp; b</label><info><![CDATA[<b>]]></info></control>"
+                "<control type=\"group\"/>"
+              "</controls>"
+            "</window>");
+  ASSERT_TRUE(doc.RootElement() != NULL);
+
+  std::string data;
+  CGUIWindowXMLCache::Serialize(doc.RootElement(), data);
+  std::unique_ptr<TiXmlElement> root(CGUIWindowXMLCache::Deserialize(data));
+  ASSERT_TRUE(root.get() != NULL);
+  EXPECT_EQ(Print(doc.RootElement()), Print(root.get()));
+
+  // truncated data
+  EXPECT_TRUE(CGUIWindowXMLCache::Deserialize(data.substr(0, data.size() - 1)) == NULL);
+}
+
+/* Reads the Confluence windows by parsing them, then through the cache
+ * without and with cache files and compares the results.
+ */
+TEST_F(TestGUIWindowXMLCache, ConfluenceWindows)
+{
+  std::vector<std::string> files;
+  std::vector<std::string> windows;
+  LoadConfluenceWindows(files, windows);
+  ASSERT_FALSE(files.empty());
+
+  for (int pass = 0; pass < 2; pass++)
+  {
+    // the first pass parses and writes the cache files, the second one reads them
+    SCOPED_TRACE(pass);
+    CGUIWindowXMLCache cache(m_folder);
+    cache.Preload(m_key, files);
+    for (unsigned int i = 0; i < files.size(); i++)
+    {
+      std::unique_ptr<TiXmlElement> root(cache.GetWindow(files[i]));
+      std::string data;
+      if (root.get())
+        CGUIWindowXMLCache::Serialize(root.get(), data);
+      EXPECT_EQ(windows[i], data) << files[i];
+    }
+  }
+
+  CGUIWindowXMLCache::CEntry entry;
+  entry.m_file = files[0];
+  entry.m_cacheFile = CGUIWindowXMLCache(m_folder).GetCacheFile(files[0]);
+  EXPECT_TRUE(CGUIWindowXMLCache::ReadCacheFile(m_key, entry));
+  EXPECT_FALSE(CGUIWindowXMLCache::ReadCacheFile(m_key + "changed", entry));
+}
+
+/* Benchmark rather than test, run with --gtest_also_run_disabled_tests: the time taken to
+ * parse the Confluence windows, to read them through the cache while writing the cache
+ * files and to read them from the cache files, reported as test properties.
+ */
+TEST_F(TestGUIWindowXMLCache, DISABLED_ConfluenceWindowsBenchmark)
+{
+  std::vector<std::string> files;
+  std::vector<std::string> windows;
+  int64_t start = CurrentHostCounter();
+  LoadConfluenceWindows(files, windows);
+  int64_t parse = CurrentHostCounter() - start;
+  ASSERT_FALSE(files.empty());
+
+  int64_t reads[2];
+  for (int pass = 0; pass < 2; pass++)
+  {
+    start = CurrentHostCounter();
+    CGUIWindowXMLCache cache(m_folder);
+    cache.Preload(m_key, files);
+    for (unsigned int i = 0; i < files.size(); i++)
+      std::unique_ptr<TiXmlElement> root(cache.GetWindow(files[i]));
+    reads[pass] = CurrentHostCounter() - start;
+  }
+
+  char value[32];
+  RecordProperty("files", (int)files.size());
+  snprintf(value, sizeof(value), "%.2f", Milliseconds(parse));
+  RecordProperty("parseMs", value);
+  snprintf(value, sizeof(value), "%.2f", Milliseconds(reads[0]));
+  RecordProperty("preloadMs", value);
+  snprintf(value, sizeof(value), "%.2f", Milliseconds(reads[1]));
+  RecordProperty("cachedMs", value);
+}
+
+TEST_F(TestGUIWindowXMLCache, ResolveIncludes)
+{
+  std::shared_ptr<ADDON::CSkinInfo> previousSkin = g_SkinInfo;
+  ADDON::AddonProps props("skin.confluence", ADDON::ADDON_SKIN, "1.0.0", "1.0.0");
+  props.path = XBMC_REF_FILE_PATH("addons/skin.confluence");
+  g_SkinInfo.reset(new ADDON::CSkinInfo(props));
+
+  const std::string condition = "Skin.HasSetting(TestGUIWindowXMLCache)";
+  int setting = CSkinSettings::GetInstance().TranslateBool("TestGUIWindowXMLCache");
+  CSkinSettings::GetInstance().SetBool(setting, true);
+  g_infoManager.ResetChangedCache();
+
+  std::string window = "<window><controls>"
+                         "<include condition=\"" + condition + "\">Label</include>"
+                         "<include condition=\"!" + condition + "\">Image</include>"
+                       "</controls></window>";
+  std::string file = URIUtils::AddFileToFolder(m_folder, "window.xml");
+  XFILE::CDirectory::Create(m_folder);
+  XFILE::CFile xmlFile;
+  ASSERT_TRUE(xmlFile.OpenForWrite(file, true));
+  ASSERT_EQ((ssize_t)window.size(), xmlFile.Write(window.c_str(), window.size()));
+  xmlFile.Close();
+
+  CXBMCTinyXML includesDoc;
+  includesDoc.Parse("<includes>"
+                      "<include name=\"Label\"><control type=\"label\"/></include>"
+                      "<include name=\"Image\"><control type=\"image\"/></include>"
+                    "</includes>");
+  CGUIIncludes includes;
+  ASSERT_TRUE(includes.LoadIncludesFromXML(includesDoc.RootElement()));
+  // resolving with these would drop the includes, only a reused window keeps them
+  CGUIIncludes noIncludes;
+
+  {
+    CGUIWindowXMLCache cache(m_folder);
+    cache.Preload(m_key, std::vector<std::string>(1, file));
+    std::unique_ptr<TiXmlElement> root(cache.GetWindow(file));
+    ASSERT_TRUE(root.get() != NULL);
+
+    std::map<INFO::InfoPtr, bool> conditions;
+    std::unique_ptr<TiXmlElement> resolved(cache.ResolveIncludes(file, root.get(), includes, &conditions));
+    EXPECT_EQ("label", GetControlType(resolved.get()));
+    EXPECT_EQ(2u, conditions.size());
+
+    // conditions unchanged, the expanded window is used as is
+    conditions.clear();
+    resolved.reset(cache.ResolveIncludes(file, root.get(), noIncludes, &conditions));
+    EXPECT_EQ("label", GetControlType(resolved.get()));
+    EXPECT_EQ(2u, conditions.size());
+
+    // a condition changed, the window is resolved again
+    CSkinSettings::GetInstance().SetBool(setting, false);
+    g_infoManager.ResetChangedCache();
+    resolved.reset(cache.ResolveIncludes(file, root.get(), includes, NULL));
+    EXPECT_EQ("image", GetControlType(resolved.get()));
+
+    // the cache file is written in the background
+    CGUIWindowXMLCache::CEntry entry;
+    entry.m_file = file;
+    entry.m_cacheFile = cache.GetCacheFile(file);
+    std::unique_ptr<TiXmlElement> stored;
+    XbmcThreads::EndTime timeout(5000);
+    while (!timeout.IsTimePast())
+    {
+      if (CGUIWindowXMLCache::ReadCacheFile(m_key, entry))
+      {
+        stored.reset(CGUIWindowXMLCache::Deserialize(entry.m_resolved));
+        if (stored.get() && GetControlType(stored.get()) == "image")
+          break;
+      }
+      Sleep(10);
+    }
+    ASSERT_TRUE(stored.get() != NULL);
+    EXPECT_EQ("image", GetControlType(stored.get()));
+
+    // the conditions are kept as written, parameters may be case sensitive
+    ASSERT_EQ(2u, entry.m_conditions.size());
+    for (size_t i = 0; i < entry.m_conditions.size(); i++)
+    {
+      bool inverted = entry.m_conditions[i].first[0] == '!';
+      EXPECT_EQ(inverted ? "!" + condition : condition, entry.m_conditions[i].first);
+      EXPECT_EQ(inverted, entry.m_conditions[i].second);
+    }
+  }
+
+  // the expanded window is used from the cache file, as long as the conditions match
+  {
+    CGUIWindowXMLCache cache(m_folder);
+    cache.Preload(m_key, std::vector<std::string>(1, file));
+    std::unique_ptr<TiXmlElement> root(cache.GetWindow(file));
+    ASSERT_TRUE(root.get() != NULL);
+
+    std::unique_ptr<TiXmlElement> resolved(cache.ResolveIncludes(file, root.get(), noIncludes, NULL));
+    EXPECT_EQ("image", GetControlType(resolved.get()));
+
+    CSkinSettings::GetInstance().SetBool(setting, true);
+    g_infoManager.ResetChangedCache();
+    resolved.reset(cache.ResolveIncludes(file, root.get(), includes, NULL));
+    EXPECT_EQ("label", GetControlType(resolved.get()));
+  }
+
+  g_SkinInfo = previousSkin;
+}
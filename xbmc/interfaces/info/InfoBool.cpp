@@ -23,13 +23,21 @@
 
 namespace INFO
 {
+  std::atomic<unsigned int> InfoBool::m_updateCount(0);
+
   InfoBool::InfoBool(const std::string &expression, int context)
     : m_value(false),
       m_context(context),
       m_listItemDependent(false),
+      m_sources(INFO_SOURCE_ALL),
       m_expression(expression),
       m_dirty(true)
   {
-    StringUtils::ToLower(m_expression);
+  }
+
+  bool InfoBool::operator==(const InfoBool &right) const
+  {
+    return (m_context == right.m_context &&
+            StringUtils::EqualsNoCase(m_expression, right.m_expression));
   }
 }
@@ -20,6 +20,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <string>
 #include <memory>
 
@@ -27,6 +28,23 @@ class CGUIListItem;
 
 namespace INFO
 {
+/*! \brief Data sources an info bool can depend on
+ Registered info bools are only marked dirty at the end of a frame if one of
+ their sources changed, see CGUIInfoManager::PublishChange().
+ */
+enum InfoSource
+{
+  INFO_SOURCE_NONE    = 0x00, ///< constant, e.g. the platform
+  INFO_SOURCE_PLAYER  = 0x01, ///< player state
+  INFO_SOURCE_LIBRARY = 0x02, ///< library contents
+  INFO_SOURCE_TIME    = 0x04, ///< wall clock time and date
+  INFO_SOURCE_SKIN    = 0x08, ///< skin settings
+  INFO_SOURCE_LIST    = 0x10, ///< containers and their focused items
+  INFO_SOURCE_GUI     = 0x20, ///< windows, dialogs and controls
+  INFO_SOURCE_SYSTEM  = 0x40, ///< anything else
+  INFO_SOURCE_ALL     = 0x7f
+};
+
 /*!
  \ingroup info
  \brief Base class, wrapping boolean conditions and expressions
@@ -51,37 +69,52 @@ public:
   inline bool Get(const CGUIListItem *item = NULL)
   {
     if (item && m_listItemDependent)
+    {
       Update(item);
+      m_updateCount.fetch_add(1, std::memory_order_relaxed);
+    }
     else if (m_dirty)
     {
       Update(NULL);
       m_dirty = false;
+      m_updateCount.fetch_add(1, std::memory_order_relaxed);
     }
     return m_value;
   }
 
-  bool operator==(const InfoBool &right) const
-  {
-    return (m_context == right.m_context &&
-            m_expression == right.m_expression);
-  }
+  /*! \brief Expressions are compared case insensitive */
+  bool operator==(const InfoBool &right) const;
 
   /*! \brief Update the value of this info bool
    This is called if and only if the info bool is dirty, allowing it to update it's current value
    */
   virtual void Update(const CGUIListItem *item) {};
 
+  /*! \brief Get the expression as written, parameters of conditions may be case sensitive */
   const std::string &GetExpression() const { return m_expression; }
   bool ListItemDependent() const { return m_listItemDependent; }
+
+  /*! \brief Get the data sources this info bool depends on
+   \return a combination of InfoSource flags
+   */
+  unsigned int GetSources() const { return m_sources; }
+
+  /*! \brief Get the number of updates done by all info bools and restart counting
+   \return the number of calls to Update() since the last call
+   */
+  static unsigned int ResetUpdateCount() { return m_updateCount.exchange(0); }
 protected:
 
   bool m_value;                ///< current value
   int m_context;               ///< contextual information to go with the condition
   bool m_listItemDependent;    ///< do not cache if a listitem pointer is given
+  unsigned int m_sources;      ///< InfoSource flags, re-evaluate when one of them changed
 
 private:
   std::string  m_expression;   ///< original expression
   bool         m_dirty;        ///< whether we need an update
+
+  static std::atomic<unsigned int> m_updateCount;
 };
 
 typedef std::shared_ptr<InfoBool> InfoPtr;
@@ -21,7 +21,9 @@
 #include "InfoExpression.h"
 #include <stack>
 #include "utils/log.h"
+#include "utils/StringUtils.h"
 #include "GUIInfoManager.h"
+#include <algorithm>
 #include <list>
 #include <memory>
 
@@ -31,6 +33,9 @@ InfoSingle::InfoSingle(const std::string &expression, int context)
 : InfoBool(expression, context)
 {
   m_condition = g_infoManager.TranslateSingleString(expression, m_listItemDependent);
+  m_sources = g_infoManager.GetInfoSources(m_condition);
+  if (m_listItemDependent)
+    m_sources |= INFO_SOURCE_LIST;
 }
 
 void InfoSingle::Update(const CGUIListItem *item)
@@ -41,16 +46,61 @@ void InfoSingle::Update(const CGUIListItem *item)
 InfoExpression::InfoExpression(const std::string &expression, int context)
 : InfoBool(expression, context)
 {
+  // the expression depends on whatever its operands depend on
+  m_sources = INFO_SOURCE_NONE;
   if (!Parse(expression))
   {
     CLog::Log(LOGERROR, "Error parsing boolean expression %s", expression.c_str());
-    m_expression_tree = std::make_shared<InfoLeaf>(g_infoManager.Register("false", 0), false);
+    EmitLoad(g_infoManager.Register("false", 0), false);
   }
 }
 
 void InfoExpression::Update(const CGUIListItem *item)
 {
-  m_value = m_expression_tree->Evaluate(item);
+  const size_t size = m_program.size();
+  bool value = false;
+  bool jumped = false;
+  size_t pc = 0;
+  while (pc < size)
+  {
+    const Instruction &instruction = m_program[pc];
+    switch (instruction.m_op)
+    {
+    case OP_LOAD:
+      value = m_operands[instruction.m_arg]->Get(item);
+      break;
+    case OP_LOAD_NOT:
+      value = !m_operands[instruction.m_arg]->Get(item);
+      break;
+    case OP_JUMP_IF_TRUE:
+    case OP_JUMP_IF_FALSE:
+      if (value == (instruction.m_op == OP_JUMP_IF_TRUE))
+      {
+        size_t target = instruction.m_arg;
+        /* Move the operand which decided the group to the front so we
+         * evaluate faster next time. All jumps of a program are the same,
+         * so the load and its jump can be rotated as a pair.
+         */
+        if (pc > 1)
+          std::rotate(m_program.begin(), m_program.begin() + pc - 1, m_program.begin() + pc + 1);
+        pc = target;
+        jumped = true;
+        continue;
+      }
+      break;
+    }
+    pc++;
+  }
+
+  /* The last operand has no jump after it. If it decided the group, move it
+   * to the front as well, ahead of the jump that preceded it.
+   */
+  if (!jumped && size > 1 && value == (m_program[1].m_op == OP_JUMP_IF_TRUE))
+  {
+    std::rotate(m_program.begin(), m_program.end() - 2, m_program.end());
+    std::iter_swap(m_program.begin(), m_program.begin() + 1);
+  }
+  m_value = value;
 }
 
 /* Expressions are rewritten at parse time into a form which favours the
@@ -71,9 +121,11 @@ void InfoExpression::Update(const CGUIListItem *item)
  *    operations. So [A|B]|[C|D+[[E|F]|G] becomes A|B|C|[D+[E|F|G]].
  */
 
-bool InfoExpression::InfoLeaf::Evaluate(const CGUIListItem *item)
+std::string InfoExpression::InfoLeaf::ToString() const
 {
-  return m_invert ^ m_info->Get(item);
+  std::string operand(m_operand);
+  StringUtils::Trim(operand);
+  return m_invert ? "!" + operand : operand;
 }
 
 InfoExpression::InfoAssociativeGroup::InfoAssociativeGroup(
@@ -96,27 +148,76 @@ void InfoExpression::InfoAssociativeGroup::Merge(std::shared_ptr<InfoAssociative
   m_children.splice(m_children.end(), other->m_children);
 }
 
-bool InfoExpression::InfoAssociativeGroup::Evaluate(const CGUIListItem *item)
+std::string InfoExpression::InfoAssociativeGroup::ToString() const
 {
-  /* Handle either AND or OR by using the relation
-   * A AND B == !(!A OR !B)
-   * to convert ANDs into ORs
-   */
-  std::list<InfoSubexpressionPtr>::iterator last = m_children.end();
-  std::list<InfoSubexpressionPtr>::iterator it = m_children.begin();
-  bool use_and = (m_type == NODE_AND);
-  bool result = use_and ^ (*it)->Evaluate(item);
-  while (!result && ++it != last)
+  std::string expression;
+  for (std::list<InfoSubexpressionPtr>::const_iterator it = m_children.begin(); it != m_children.end(); ++it)
+  {
+    if (it != m_children.begin())
+      expression += m_type == NODE_AND ? '+' : '|';
+    // children of a group are leaves or groups of the other type
+    if ((*it)->Type() == NODE_LEAF)
+      expression += (*it)->ToString();
+    else
+      expression += "[" + (*it)->ToString() + "]";
+  }
+  return expression;
+}
+
+/* The root of the expression tree is compiled into a program of operand loads
+ * separated by conditional jumps to the end:
+ *
+ *   A|B|C    ->   LOAD A, JUMP_IF_TRUE end, LOAD B, JUMP_IF_TRUE end, LOAD C
+ *
+ * The value of the last load executed is the value of the expression. Nested
+ * groups are registered with the info manager as expressions of their own
+ * (D+[E|F] loads the registered bool for E|F), which shares them between all
+ * expressions using them and caches their value for the frame like any other
+ * info bool. They are compiled the same way when they're registered.
+ */
+
+void InfoExpression::Compile(const InfoSubexpressionPtr &root)
+{
+  if (root->Type() == NODE_LEAF)
   {
-    result = use_and ^ (*it)->Evaluate(item);
-    if (result)
+    std::shared_ptr<InfoLeaf> leaf = std::static_pointer_cast<InfoLeaf>(root);
+    EmitLoad(leaf->GetInfo(), leaf->Inverted());
+    return;
+  }
+
+  const std::list<InfoSubexpressionPtr> &children = std::static_pointer_cast<InfoAssociativeGroup>(root)->GetChildren();
+  opcode_t jump = root->Type() == NODE_AND ? OP_JUMP_IF_FALSE : OP_JUMP_IF_TRUE;
+  for (std::list<InfoSubexpressionPtr>::const_iterator it = children.begin(); it != children.end(); ++it)
+  {
+    if (it != children.begin())
+      m_program.push_back(Instruction(jump, 0));
+
+    if ((*it)->Type() == NODE_LEAF)
     {
-      /* Move this child to the head of the list so we evaluate faster next time */
-      m_children.push_front(*it);
-      m_children.erase(it);
+      std::shared_ptr<InfoLeaf> leaf = std::static_pointer_cast<InfoLeaf>(*it);
+      EmitLoad(leaf->GetInfo(), leaf->Inverted());
     }
+    else
+      EmitLoad(g_infoManager.Register((*it)->ToString(), m_context), false);
+  }
+
+  for (std::vector<Instruction>::iterator it = m_program.begin(); it != m_program.end(); ++it)
+  {
+    if (it->m_op == jump)
+      it->m_arg = m_program.size();
   }
-  return use_and ^ result;
+}
+
+void InfoExpression::EmitLoad(const InfoPtr &info, bool invert)
+{
+  /* Propagate any listItem dependency and data sources from the operand to the expression */
+  m_listItemDependent |= info->ListItemDependent();
+  m_sources |= info->GetSources();
+
+  unsigned int operand = std::find(m_operands.begin(), m_operands.end(), info) - m_operands.begin();
+  if (operand == m_operands.size())
+    m_operands.push_back(info);
+  m_program.push_back(Instruction(invert ? OP_LOAD_NOT : OP_LOAD, operand));
 }
 
 /* Expressions are parsed using the shunting-yard algorithm. Binary operators
@@ -248,9 +349,7 @@ bool InfoExpression::Parse(const std::string &expression)
           CLog::Log(LOGERROR, "Bad operand '%s'", operand.c_str());
           return false;
         }
-        /* Propagate any listItem dependency from the operand to the expression */
-        m_listItemDependent |= info->ListItemDependent();
-        nodes.push(std::make_shared<InfoLeaf>(info, invert));
+        nodes.push(std::make_shared<InfoLeaf>(operand, info, invert));
         /* Reuse operand string for next operand */
         operand.clear();
       }
@@ -299,13 +398,11 @@ bool InfoExpression::Parse(const std::string &expression)
       CLog::Log(LOGERROR, "Bad operand '%s'", operand.c_str());
       return false;
     }
-    /* Propagate any listItem dependency from the operand to the expression */
-    m_listItemDependent |= info->ListItemDependent();
-    nodes.push(std::make_shared<InfoLeaf>(info, invert));
+    nodes.push(std::make_shared<InfoLeaf>(operand, info, invert));
   }
   while (!operator_stack.empty())
     OperatorPop(operator_stack, invert, nodes);
 
-  m_expression_tree = nodes.top();
+  Compile(nodes.top());
   return true;
 }
@@ -20,6 +20,7 @@
 
 #pragma once
 
+#include <string>
 #include <vector>
 #include <list>
 #include <stack>
@@ -43,6 +44,11 @@ private:
 };
 
 /*! \brief Class to wrap active boolean expressions
+
+ The expression is parsed into a tree of subexpressions which is then compiled
+ into a flat program, see Compile(). Nested subexpressions are registered with
+ the info manager like any other condition, so identical subexpressions used by
+ different expressions are shared and evaluated once per frame.
  */
 class InfoExpression : public InfoBool
 {
@@ -74,8 +80,8 @@ private:
   {
   public:
     virtual ~InfoSubexpression(void) {}; // so we can destruct derived classes using a pointer to their base class
-    virtual bool Evaluate(const CGUIListItem *item) = 0;
     virtual node_type_t Type() const=0;
+    virtual std::string ToString() const=0;
   };
 
   typedef std::shared_ptr<InfoSubexpression> InfoSubexpressionPtr;
@@ -84,10 +90,13 @@ private:
   class InfoLeaf : public InfoSubexpression
   {
   public:
-    InfoLeaf(InfoPtr info, bool invert) : m_info(info), m_invert(invert) {};
-    virtual bool Evaluate(const CGUIListItem *item);
+    InfoLeaf(const std::string &operand, InfoPtr info, bool invert) : m_operand(operand), m_info(info), m_invert(invert) {};
     virtual node_type_t Type() const { return NODE_LEAF; };
+    virtual std::string ToString() const;
+    const InfoPtr &GetInfo() const { return m_info; };
+    bool Inverted() const { return m_invert; };
   private:
+    std::string m_operand; ///< the condition as written, parameters may be case sensitive
     InfoPtr m_info;
     bool m_invert;
   };
@@ -99,17 +108,38 @@ private:
     InfoAssociativeGroup(node_type_t type, const InfoSubexpressionPtr &left, const InfoSubexpressionPtr &right);
     void AddChild(const InfoSubexpressionPtr &child);
     void Merge(std::shared_ptr<InfoAssociativeGroup> other);
-    virtual bool Evaluate(const CGUIListItem *item);
     virtual node_type_t Type() const { return m_type; };
+    virtual std::string ToString() const;
+    const std::list<InfoSubexpressionPtr> &GetChildren() const { return m_children; };
   private:
     node_type_t m_type;
     std::list<InfoSubexpressionPtr> m_children;
   };
 
+  // An instruction of the compiled expression
+  typedef enum
+  {
+    OP_LOAD,          // value = operand
+    OP_LOAD_NOT,      // value = !operand
+    OP_JUMP_IF_TRUE,  // skip the rest of an OR group
+    OP_JUMP_IF_FALSE, // skip the rest of an AND group
+  } opcode_t;
+
+  struct Instruction
+  {
+    Instruction(opcode_t op, unsigned int arg) : m_op(op), m_arg(arg) {};
+    opcode_t m_op;
+    unsigned int m_arg; ///< operand index or jump target
+  };
+
   static operator_t GetOperator(char ch);
   static void OperatorPop(std::stack<operator_t> &operator_stack, bool &invert, std::stack<InfoSubexpressionPtr> &nodes);
   bool Parse(const std::string &expression);
-  InfoSubexpressionPtr m_expression_tree;
+  void Compile(const InfoSubexpressionPtr &root);
+  void EmitLoad(const InfoPtr &info, bool invert);
+
+  std::vector<Instruction> m_program;
+  std::vector<InfoPtr> m_operands;
 };
 
 };
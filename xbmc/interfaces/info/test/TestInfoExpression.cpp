@@ -0,0 +1,245 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "FileItem.h"
+#include "GUIInfoManager.h"
+#include "addons/Skin.h"
+#include "filesystem/Directory.h"
+#include "guilib/GUIIncludes.h"
+#include "test/TestUtils.h"
+#include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
+#include "utils/URIUtils.h"
+#include "utils/XBMCTinyXML.h"
+
+#include "gtest/gtest.h"
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+// random expression of true/false operands, returns the value it should have
+bool Generate(CTestRandom &random, int depth, std::string &expression)
+{
+  bool invert = random.Next(3) == 0;
+  if (invert)
+    expression += "!";
+
+  if (depth == 0 || random.Next(3) == 0)
+  {
+    bool value = random.Next(2) == 0;
+    expression += value ? "true" : "false";
+    return value ^ invert;
+  }
+
+  bool isAnd = random.Next(2) == 0;
+  unsigned int count = 2 + random.Next(3);
+  bool value = isAnd;
+  expression += "[";
+  for (unsigned int i = 0; i < count; i++)
+  {
+    if (i)
+      expression += isAnd ? " + " : " | ";
+    bool child = Generate(random, depth - 1, expression);
+    value = isAnd ? value && child : value || child;
+  }
+  expression += "]";
+  return value ^ invert;
+}
+
+// conditions whose providers aren't started by the test environment
+bool CanEvaluate(const std::string &condition)
+{
+  static const char *unavailable[] = { "system.hasaddon", "system.addonisenabled", "library.",
+                                       "weather.", "pvr.", "adsp.", "system.internetstate" };
+  std::string lower(condition);
+  StringUtils::ToLower(lower);
+  for (unsigned int i = 0; i < sizeof(unavailable) / sizeof(unavailable[0]); i++)
+  {
+    if (lower.find(unavailable[i]) != std::string::npos)
+      return false;
+  }
+  return true;
+}
+
+void CollectConditions(const TiXmlElement *element, std::vector<std::string> &conditions)
+{
+  for (; element; element = element->NextSiblingElement())
+  {
+    const char *condition = element->Attribute("condition");
+    if (condition)
+      conditions.push_back(condition);
+
+    const std::string &value = element->ValueStr();
+    if ((value == "visible" || value == "enable" || value == "selected" || value == "usealttexture") &&
+        element->FirstChild() && element->FirstChild()->Type() == TiXmlNode::TINYXML_TEXT)
+      conditions.push_back(element->FirstChild()->ValueStr());
+
+    CollectConditions(element->FirstChildElement(), conditions);
+  }
+}
+
+double Milliseconds(int64_t ticks)
+{
+  return ticks * 1000.0 / CurrentHostFrequency();
+}
+
+}
+
+TEST(TestInfoExpression, Evaluate)
+{
+  CTestRandom random(1);
+  for (int i = 0; i < 500; i++)
+  {
+    std::string expression;
+    bool value = Generate(random, 4, expression);
+    EXPECT_EQ(value, g_infoManager.EvaluateBool(expression)) << expression;
+    // a second evaluation runs with the reordered program
+    INFO::InfoPtr info = g_infoManager.Register(expression);
+    info->SetDirty();
+    EXPECT_EQ(value, info->Get()) << expression;
+  }
+}
+
+TEST(TestInfoExpression, SharedSubexpressions)
+{
+  INFO::InfoPtr first = g_infoManager.Register("!false + [true | false]");
+  INFO::InfoPtr second = g_infoManager.Register("[true|false]+true");
+  EXPECT_TRUE(first->Get());
+  EXPECT_TRUE(second->Get());
+
+  // both use the one registered bool for the nested group
+  INFO::InfoPtr shared = g_infoManager.Register("true|false");
+  EXPECT_GE(shared.use_count(), 4);
+}
+
+TEST(TestInfoExpression, Reorder)
+{
+  INFO::InfoPtr info = g_infoManager.Register("false | false | true");
+  g_infoManager.ResetCache();
+  INFO::InfoBool::ResetUpdateCount();
+  EXPECT_TRUE(info->Get());
+  EXPECT_EQ(3u, INFO::InfoBool::ResetUpdateCount());
+
+  // the last operand decided, it's evaluated first from now on
+  g_infoManager.ResetCache();
+  EXPECT_TRUE(info->Get());
+  EXPECT_EQ(2u, INFO::InfoBool::ResetUpdateCount());
+}
+
+/* Loads the Confluence windows with their includes, registers every condition
+ * they use and times the evaluation of all of them per frame. Disabled by
+ * default, run with --gtest_also_run_disabled_tests.
+ */
+TEST(TestInfoExpression, DISABLED_ConfluenceBenchmark)
+{
+  std::string skinPath = XBMC_REF_FILE_PATH("addons/skin.confluence");
+  std::string xmlPath = URIUtils::AddFileToFolder(skinPath, "720p");
+
+  ADDON::AddonProps props("skin.confluence", ADDON::ADDON_SKIN, "1.0.0", "1.0.0");
+  props.path = skinPath;
+  std::shared_ptr<ADDON::CSkinInfo> previousSkin = g_SkinInfo;
+  g_SkinInfo.reset(new ADDON::CSkinInfo(props));
+
+  CFileItemList items;
+  ASSERT_TRUE(XFILE::CDirectory::GetDirectory(xmlPath, items, ".xml"));
+
+  int64_t start = CurrentHostCounter();
+  CGUIIncludes includes;
+  for (int i = 0; i < items.Size(); i++)
+  {
+    if (StringUtils::StartsWithNoCase(URIUtils::GetFileName(items[i]->GetPath()), "includes"))
+      includes.LoadIncludes(items[i]->GetPath());
+  }
+
+  std::vector<std::string> conditions;
+  for (int i = 0; i < items.Size(); i++)
+  {
+    CXBMCTinyXML doc;
+    if (!doc.LoadFile(items[i]->GetPath()) || !doc.RootElement() ||
+        doc.RootElement()->ValueStr() != "window")
+      continue;
+    includes.ResolveIncludes(doc.RootElement());
+    CollectConditions(doc.RootElement(), conditions);
+  }
+
+  unsigned int boolsBefore = g_infoManager.GetInfoBoolCount();
+  std::vector<INFO::InfoPtr> bools;
+  for (std::vector<std::string>::const_iterator it = conditions.begin(); it != conditions.end(); ++it)
+  {
+    if (CanEvaluate(*it))
+      bools.push_back(g_infoManager.Register(*it));
+  }
+  int64_t load = CurrentHostCounter() - start;
+  ASSERT_FALSE(bools.empty());
+
+  const int frames = 100;
+  std::vector<bool> values(bools.size());
+  start = CurrentHostCounter();
+  for (int f = 0; f < frames; f++)
+  {
+    g_infoManager.ResetCache();
+    for (size_t i = 0; i < bools.size(); i++)
+    {
+      if (bools[i])
+        values[i] = bools[i]->Get();
+    }
+  }
+  int64_t full = CurrentHostCounter() - start;
+
+  unsigned int updates = 0;
+  start = CurrentHostCounter();
+  for (int f = 0; f < frames; f++)
+  {
+    g_infoManager.ResetChangedCache();
+    updates += g_infoManager.GetInfoBoolUpdates();
+    for (size_t i = 0; i < bools.size(); i++)
+    {
+      if (bools[i])
+        bools[i]->Get();
+    }
+  }
+  int64_t incremental = CurrentHostCounter() - start;
+
+  // nothing changed in between, skipping the re-evaluation can't change a value
+  for (size_t i = 0; i < bools.size(); i++)
+  {
+    if (bools[i])
+      EXPECT_EQ(values[i], bools[i]->Get()) << bools[i]->GetExpression();
+  }
+
+  char value[32];
+  RecordProperty("conditions", (int)bools.size());
+  RecordProperty("registeredBools", (int)(g_infoManager.GetInfoBoolCount() - boolsBefore));
+  snprintf(value, sizeof(value), "%.2f", Milliseconds(load));
+  RecordProperty("loadMs", value);
+  snprintf(value, sizeof(value), "%.3f", Milliseconds(full) / frames);
+  RecordProperty("frameMs", value);
+  snprintf(value, sizeof(value), "%.3f", Milliseconds(incremental) / frames);
+  RecordProperty("incrementalFrameMs", value);
+  RecordProperty("incrementalUpdatesPerFrame", (int)(updates / frames));
+
+  bools.clear();
+  g_infoManager.Clear();
+  g_SkinInfo = previousSkin;
+}
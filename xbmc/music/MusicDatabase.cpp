@@ -548,6 +548,275 @@ bool CMusicDatabase::AddAlbum(CAlbum& album)
   return true;
 }
 
+bool CMusicDatabase::AddAlbums(VECALBUMS& albums, const volatile bool *stop /* = NULL */)
+{
+  if (NULL == m_pDB.get()) return false;
+  if (NULL == m_pDS.get()) return false;
+
+  BeginTransaction();
+  try
+  {
+    std::vector<std::string> albumArtists;
+    std::vector<std::string> albumGenres;
+    std::vector<std::string> songArtists;
+    std::vector<std::string> songGenres;
+
+    for (VECALBUMS::iterator album = albums.begin(); album != albums.end(); ++album)
+    {
+      if (stop && *stop)
+        break;
+
+      album->idAlbum = AddAlbum(album->strAlbum,
+                                album->strMusicBrainzAlbumID,
+                                GetArtistString(album->strArtistDesc, album->artistCredits),
+                                album->GetGenreString(),
+                                album->iYear,
+                                album->bCompilation, album->releaseType);
+      if (album->idAlbum < 0)
+      {
+        CLog::Log(LOGERROR, "%s unable to add album %s", __FUNCTION__, album->strAlbum.c_str());
+        continue;
+      }
+
+      // Add the album artists
+      for (VECARTISTCREDITS::iterator artistCredit = album->artistCredits.begin(); artistCredit != album->artistCredits.end(); ++artistCredit)
+      {
+        artistCredit->idArtist = AddArtistCached(artistCredit->GetArtist(), artistCredit->GetMusicBrainzArtistID());
+        albumArtists.push_back(PrepareSQL("(%i,%i,'%s','%s',%i,%i)",
+                                          artistCredit->idArtist,
+                                          album->idAlbum,
+                                          artistCredit->GetArtist().c_str(),
+                                          artistCredit->GetJoinPhrase().c_str(),
+                                          artistCredit == album->artistCredits.begin() ? 0 : 1,
+                                          (int)std::distance(album->artistCredits.begin(), artistCredit)));
+      }
+
+      if (!AddAlbumSongs(*album, songArtists, songGenres, albumGenres))
+      {
+        CLog::Log(LOGERROR, "%s unable to add the songs of album %s", __FUNCTION__, album->strAlbum.c_str());
+        RollbackTransaction();
+        EmptyCache();
+        return false;
+      }
+
+      for (VECSONGS::const_iterator infoSong = album->infoSongs.begin(); infoSong != album->infoSongs.end(); ++infoSong)
+        AddAlbumInfoSong(album->idAlbum, *infoSong);
+
+      for (std::map<std::string, std::string>::const_iterator albumArt = album->art.begin();
+                                                              albumArt != album->art.end();
+                                                            ++albumArt)
+        SetArtForItem(album->idAlbum, MediaTypeAlbum, albumArt->first, albumArt->second);
+    }
+
+    ExecuteMultiRowInsert("REPLACE INTO album_artist (idArtist, idAlbum, strArtist, strJoinPhrase, boolFeatured, iOrder) VALUES ", albumArtists);
+    ExecuteMultiRowInsert("REPLACE INTO song_artist (idArtist, idSong, strArtist, strJoinPhrase, boolFeatured, iOrder) VALUES ", songArtists);
+    ExecuteMultiRowInsert("REPLACE INTO song_genre (idGenre, idSong, iOrder) VALUES ", songGenres);
+    ExecuteMultiRowInsert("REPLACE INTO album_genre (idGenre, idAlbum, iOrder) VALUES ", albumGenres);
+
+    if (CommitTransaction())
+      return true;
+    RollbackTransaction();
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s failed", __FUNCTION__);
+    RollbackTransaction();
+  }
+  // ids handed out in the rolled back transaction may be handed out again
+  EmptyCache();
+  return false;
+}
+
+bool CMusicDatabase::AddAlbumSongs(CAlbum& album, std::vector<std::string>& songArtists,
+                                   std::vector<std::string>& songGenres, std::vector<std::string>& albumGenres)
+{
+  // Songs already in the album, keyed the same way AddSong() looks them up
+  std::set<std::string> existingSongs;
+  std::string strSQL = PrepareSQL("SELECT strMusicBrainzTrackID, strFileName, strTitle, iTrack FROM song WHERE idAlbum = %i", album.idAlbum);
+  if (!m_pDS->query(strSQL.c_str()))
+    return false;
+  while (!m_pDS->eof())
+  {
+    const dbiplus::sql_record* const record = m_pDS->get_sql_record();
+    if (!record->at(0).get_isNull())
+      existingSongs.insert("mbid:" + record->at(0).get_asString());
+    else
+      existingSongs.insert(StringUtils::Format("file:%s|%s|%i", record->at(1).get_asString().c_str(),
+                                               record->at(2).get_asString().c_str(), record->at(3).get_asInt()));
+    m_pDS->next();
+  }
+  m_pDS->close();
+
+  // New songs are keyed on path, filename and offset so their ids can be read back after the insert
+  std::map<std::string, CSong*> newSongs;
+  std::vector<CSong*> existing;
+  std::vector<std::string> rows;
+  for (VECSONGS::iterator song = album.songs.begin(); song != album.songs.end(); ++song)
+  {
+    song->idAlbum = album.idAlbum;
+    song->idSong = -1;
+
+    // We need at least the title
+    if (song->strTitle.empty())
+      continue;
+
+    bool bHasKaraoke = false;
+#ifdef HAS_KARAOKE
+    bHasKaraoke = CKaraokeLyricsFactory::HasLyrics(song->strFileName);
+#endif
+
+    std::string strPath, strFileName;
+    URIUtils::Split(song->strFileName, strPath, strFileName);
+    int idPath = AddPath(strPath);
+
+    std::string songKey;
+    if (!song->strMusicBrainzTrackID.empty())
+      songKey = "mbid:" + song->strMusicBrainzTrackID;
+    else
+      songKey = StringUtils::Format("file:%s|%s|%i", strFileName.c_str(), song->strTitle.c_str(), song->iTrack);
+    std::string rowKey = StringUtils::Format("%i|%i|%s", idPath, song->iStartOffset, strFileName.c_str());
+
+    // Karaoke songs, songs already in the database and duplicates within the album go through AddSong()
+    if (bHasKaraoke || !existingSongs.insert(songKey).second || newSongs.find(rowKey) != newSongs.end())
+    {
+      existing.push_back(&(*song));
+      continue;
+    }
+    newSongs.insert(std::make_pair(rowKey, &(*song)));
+
+    std::string row = PrepareSQL("(NULL, %i, %i, '%s', '%s', '%s', %i, %i, %i, '%s'",
+                                 album.idAlbum,
+                                 idPath,
+                                 GetArtistString(song->strArtistDesc, song->artistCredits).c_str(),
+                                 StringUtils::Join(song->genre, g_advancedSettings.m_musicItemSeparator).c_str(),
+                                 song->strTitle.c_str(),
+                                 song->iTrack, song->iDuration, song->iYear,
+                                 strFileName.c_str());
+
+    if (song->strMusicBrainzTrackID.empty())
+      row += PrepareSQL(",NULL");
+    else
+      row += PrepareSQL(",'%s'", song->strMusicBrainzTrackID.c_str());
+
+    if (song->lastPlayed.IsValid())
+      row += PrepareSQL(",%i,%i,%i,'%s'", song->iTimesPlayed, song->iStartOffset, song->iEndOffset, song->lastPlayed.GetAsDBDateTime().c_str());
+    else
+      row += PrepareSQL(",%i,%i,%i,NULL", song->iTimesPlayed, song->iStartOffset, song->iEndOffset);
+
+    row += PrepareSQL(",'%c','%s','%s','%s')", song->rating, song->strComment.c_str(), song->strMood.c_str(),
+                      GetFileDateAdded(song->strFileName).GetAsDBDateTime().c_str());
+    rows.push_back(row);
+  }
+
+  if (!rows.empty())
+  {
+    ExecuteMultiRowInsert("INSERT INTO song (idSong,idAlbum,idPath,strArtists,strGenres,strTitle,iTrack,iDuration,iYear,strFileName,strMusicBrainzTrackID,iTimesPlayed,iStartOffset,iEndOffset,lastplayed,rating,comment,mood,dateAdded) VALUES ", rows);
+
+    // Read back the ids of the new songs. Should an older song share the key, the new one has the higher id.
+    strSQL = PrepareSQL("SELECT idSong, idPath, iStartOffset, strFileName FROM song WHERE idAlbum = %i ORDER BY idSong", album.idAlbum);
+    if (!m_pDS->query(strSQL.c_str()))
+      return false;
+    while (!m_pDS->eof())
+    {
+      const dbiplus::sql_record* const record = m_pDS->get_sql_record();
+      std::map<std::string, CSong*>::iterator it = newSongs.find(StringUtils::Format("%i|%i|%s",
+                                                                   record->at(1).get_asInt(),
+                                                                   record->at(2).get_asInt(),
+                                                                   record->at(3).get_asString().c_str()));
+      if (it != newSongs.end())
+        it->second->idSong = record->at(0).get_asInt();
+      m_pDS->next();
+    }
+    m_pDS->close();
+  }
+
+  for (std::vector<CSong*>::iterator it = existing.begin(); it != existing.end(); ++it)
+  {
+    CSong *song = *it;
+    song->idSong = AddSong(song->idAlbum,
+                           song->strTitle, song->strMusicBrainzTrackID,
+                           song->strFileName, song->strComment,
+                           song->strMood, song->strThumb,
+                           GetArtistString(song->strArtistDesc, song->artistCredits), song->genre,
+                           song->iTrack, song->iDuration, song->iYear,
+                           song->iTimesPlayed, song->iStartOffset,
+                           song->iEndOffset,
+                           song->lastPlayed,
+                           song->rating,
+                           song->iKaraokeNumber);
+  }
+
+  for (VECSONGS::iterator song = album.songs.begin(); song != album.songs.end(); ++song)
+  {
+    if (song->idSong < 0)
+      continue;
+
+    for (VECARTISTCREDITS::iterator artistCredit = song->artistCredits.begin(); artistCredit != song->artistCredits.end(); ++artistCredit)
+    {
+      artistCredit->idArtist = AddArtistCached(artistCredit->GetArtist(), artistCredit->GetMusicBrainzArtistID());
+      songArtists.push_back(PrepareSQL("(%i,%i,'%s','%s',%i,%i)",
+                                       artistCredit->idArtist,
+                                       song->idSong,
+                                       artistCredit->GetArtist().c_str(),
+                                       artistCredit->GetJoinPhrase().c_str(),
+                                       artistCredit == song->artistCredits.begin() ? 0 : 1,
+                                       (int)std::distance(song->artistCredits.begin(), artistCredit)));
+    }
+
+    if (!song->strCueSheet.empty())
+      SaveCuesheet(song->strFileName, song->strCueSheet);
+
+    // AddSong() has taken care of everything else for existing songs
+    if (std::find(existing.begin(), existing.end(), &(*song)) != existing.end())
+      continue;
+
+    if (!song->strThumb.empty())
+      SetArtForItem(song->idSong, MediaTypeSong, "thumb", song->strThumb);
+
+    // index will be wrong for albums, but ordering is not all that relevant
+    // for genres anyway
+    int index = 0;
+    for (std::vector<std::string>::const_iterator i = song->genre.begin(); i != song->genre.end(); ++i)
+    {
+      int idGenre = AddGenre(*i);
+      if (idGenre < 0)
+        continue;
+      songGenres.push_back(PrepareSQL("(%i,%i,%i)", idGenre, song->idSong, index));
+      albumGenres.push_back(PrepareSQL("(%i,%i,%i)", idGenre, album.idAlbum, index++));
+    }
+
+    AnnounceUpdate(MediaTypeSong, song->idSong);
+  }
+  return true;
+}
+
+void CMusicDatabase::ExecuteMultiRowInsert(const std::string& strStatement, const std::vector<std::string>& rows)
+{
+  // stay well below SQLite's compound select limit and the server's maximum packet size
+  static const unsigned int maxRows = 250;
+  static const size_t maxLength = 256 * 1024;
+
+  std::string strSQL;
+  unsigned int count = 0;
+  for (std::vector<std::string>::const_iterator row = rows.begin(); row != rows.end(); ++row)
+  {
+    if (strSQL.empty())
+      strSQL = strStatement;
+    else
+      strSQL += ",";
+    strSQL += *row;
+
+    if (++count >= maxRows || strSQL.size() >= maxLength)
+    {
+      m_pDS->exec(strSQL.c_str());
+      strSQL.clear();
+      count = 0;
+    }
+  }
+  if (!strSQL.empty())
+    m_pDS->exec(strSQL.c_str());
+}
+
 bool CMusicDatabase::UpdateAlbum(CAlbum& album)
 {
   BeginTransaction();
@@ -1168,6 +1437,19 @@ bool CMusicDatabase::UpdateArtist(const CArtist& artist)
   return true;
 }
 
+int CMusicDatabase::AddArtistCached(const std::string& strArtist, const std::string& strMusicBrainzArtistID)
+{
+  std::string key = strMusicBrainzArtistID + "|" + strArtist;
+  std::map<std::string, int>::const_iterator it = m_artistCache.find(key);
+  if (it != m_artistCache.end())
+    return it->second;
+
+  int idArtist = AddArtist(strArtist, strMusicBrainzArtistID);
+  if (idArtist >= 0)
+    m_artistCache.insert(std::make_pair(key, idArtist));
+  return idArtist;
+}
+
 int CMusicDatabase::AddArtist(const std::string& strArtist, const std::string& strMusicBrainzArtistID)
 {
   std::string strSQL;
@@ -3624,54 +3906,88 @@ bool CMusicDatabase::GetSongsByWhere(const std::string &baseDir, const Filter &f
     strSQL = PrepareSQL(strSQL, !filter.fields.empty() && filter.fields.compare("*") != 0 ? filter.fields.c_str() : "songview.*") + strSQLExtra;
 
     CLog::Log(LOGDEBUG, "%s query = %s", __FUNCTION__, strSQL.c_str());
-    // run query
-    if (!m_pDS->query(strSQL.c_str()))
-      return false;
 
-    int iRowsFound = m_pDS->num_rows();
-    if (iRowsFound == 0)
+    // without any sorting the database order is final, so the rows can be
+    // streamed straight into items instead of being materialized first
+    if (sortDescription.sortBy == SortByNone)
     {
-      m_pDS->close();
-      return true;
-    }
-
-    // store the total value of items as a property
-    if (total < iRowsFound)
-      total = iRowsFound;
-    items.SetProperty("total", total);
-    
-    DatabaseResults results;
-    results.reserve(iRowsFound);
-    if (!SortUtils::SortFromDataset(sortDescription, MediaTypeSong, m_pDS, results))
-      return false;
+      m_pDS->set_forward_only(true);
+      bool success = m_pDS->query(strSQL);
+      m_pDS->set_forward_only(false);
+      if (!success)
+        return false;
 
-    // get data from returned rows
-    items.Reserve(results.size());
-    const dbiplus::query_data &data = m_pDS->get_result_set().records;
-    int count = 0;
-    for (DatabaseResults::const_iterator it = results.begin(); it != results.end(); ++it)
-    {
-      unsigned int targetRow = (unsigned int)it->at(FieldRow).asInteger();
-      const dbiplus::sql_record* const record = data.at(targetRow);
-      
-      try
+      int count = 0;
+      while (!m_pDS->eof())
       {
         CFileItemPtr item(new CFileItem);
-        GetFileItemFromDataset(record, item.get(), musicUrl);
+        GetFileItemFromDataset(m_pDS->get_sql_record(), item.get(), musicUrl);
         // HACK for sorting by database returned order
         item->m_iprogramCount = ++count;
         items.Add(item);
+        m_pDS->next();
       }
-      catch (...)
+      m_pDS->close();
+
+      if (count == 0)
+        return true;
+
+      // store the total value of items as a property
+      if (total < count)
+        total = count;
+      items.SetProperty("total", total);
+    }
+    else
+    {
+      // run query
+      if (!m_pDS->query(strSQL.c_str()))
+        return false;
+
+      int iRowsFound = m_pDS->num_rows();
+      if (iRowsFound == 0)
       {
         m_pDS->close();
-        CLog::Log(LOGERROR, "%s: out of memory loading query: %s", __FUNCTION__, filter.where.c_str());
-        return (items.Size() > 0);
+        return true;
       }
-    }
 
-    // cleanup
-    m_pDS->close();
+      // store the total value of items as a property
+      if (total < iRowsFound)
+        total = iRowsFound;
+      items.SetProperty("total", total);
+
+      DatabaseResults results;
+      results.reserve(iRowsFound);
+      if (!SortUtils::SortFromDataset(sortDescription, MediaTypeSong, m_pDS, results))
+        return false;
+
+      // get data from returned rows
+      items.Reserve(results.size());
+      const dbiplus::query_data &data = m_pDS->get_result_set().records;
+      int count = 0;
+      for (DatabaseResults::const_iterator it = results.begin(); it != results.end(); ++it)
+      {
+        unsigned int targetRow = (unsigned int)it->at(FieldRow).asInteger();
+        const dbiplus::sql_record* const record = data.at(targetRow);
+
+        try
+        {
+          CFileItemPtr item(new CFileItem);
+          GetFileItemFromDataset(record, item.get(), musicUrl);
+          // HACK for sorting by database returned order
+          item->m_iprogramCount = ++count;
+          items.Add(item);
+        }
+        catch (...)
+        {
+          m_pDS->close();
+          CLog::Log(LOGERROR, "%s: out of memory loading query: %s", __FUNCTION__, filter.where.c_str());
+          return (items.Size() > 0);
+        }
+      }
+
+      // cleanup
+      m_pDS->close();
+    }
 
     // Load some info from embedded cuesheet if present (now only ReplayGain)
     CueInfoLoader cueLoader;
@@ -3684,6 +4000,7 @@ bool CMusicDatabase::GetSongsByWhere(const std::string &baseDir, const Filter &f
   catch (...)
   {
     // cleanup
+    m_pDS->set_forward_only(false);
     m_pDS->close();
     CLog::Log(LOGERROR, "%s(%s) failed", __FUNCTION__, filter.where.c_str());
   }
@@ -4389,13 +4706,20 @@ bool CMusicDatabase::RemoveSongsFromPath(const std::string &path1, MAPSONGS& son
     if (NULL == m_pDB.get()) return false;
     if (NULL == m_pDS.get()) return false;
 
+    // within a batch the removal is rolled back along with a failed AddAlbums()
+    BeginTransaction();
+
     std::string where;
     if (exact)
       where = PrepareSQL(" where strPath='%s'", path.c_str());
     else
       where = PrepareSQL(" where SUBSTR(strPath,1,%i)='%s'", StringUtils::utf8_strlen(path.c_str()), path.c_str());
     std::string sql = "select * from songview" + where;
-    if (!m_pDS->query(sql.c_str())) return false;
+    if (!m_pDS->query(sql.c_str()))
+    {
+      RollbackTransaction();
+      return false;
+    }
     int iRowsFound = m_pDS->num_rows();
     if (iRowsFound > 0)
     {
@@ -4421,11 +4745,13 @@ bool CMusicDatabase::RemoveSongsFromPath(const std::string &path1, MAPSONGS& son
     // and remove the path as well (it'll be re-added later on with the new hash if it's non-empty)
     sql = "delete from path" + where;
     m_pDS->exec(sql.c_str());
+    CommitTransaction();
     return iRowsFound > 0;
   }
   catch (...)
   {
     CLog::Log(LOGERROR, "%s (%s) failed", __FUNCTION__, path.c_str());
+    RollbackTransaction();
   }
   return false;
 }
@@ -5761,6 +6087,21 @@ bool CMusicDatabase::GetFilter(CDbUrl &musicUrl, Filter &filter, SortDescription
   return true;
 }
 
+CDateTime CMusicDatabase::GetFileDateAdded(const std::string& strFileNameAndPath)
+{
+  CDateTime dateAdded;
+  // 1 prefering to use the files mtime(if it's valid) and only using the file's ctime if the mtime isn't valid
+  if (g_advancedSettings.m_iMusicLibraryDateAdded == 1)
+    dateAdded = CFileUtils::GetModificationDate(strFileNameAndPath, false);
+  //2 using the newer datetime of the file's mtime and ctime
+  else if (g_advancedSettings.m_iMusicLibraryDateAdded == 2)
+    dateAdded = CFileUtils::GetModificationDate(strFileNameAndPath, true);
+  //0 using the current datetime if non of the above matches or one returns an invalid datetime
+  if (!dateAdded.IsValid())
+    dateAdded = CDateTime::GetCurrentDateTime();
+  return dateAdded;
+}
+
 void CMusicDatabase::UpdateFileDateAdded(int songId, const std::string& strFileNameAndPath)
 {
   if (songId < 0 || strFileNameAndPath.empty())
@@ -5772,15 +6113,7 @@ void CMusicDatabase::UpdateFileDateAdded(int songId, const std::string& strFileN
     if (NULL == m_pDB.get()) return;
     if (NULL == m_pDS.get()) return;
 
-    // 1 prefering to use the files mtime(if it's valid) and only using the file's ctime if the mtime isn't valid
-    if (g_advancedSettings.m_iMusicLibraryDateAdded == 1)
-      dateAdded = CFileUtils::GetModificationDate(strFileNameAndPath, false);
-    //2 using the newer datetime of the file's mtime and ctime
-    else if (g_advancedSettings.m_iMusicLibraryDateAdded == 2)
-      dateAdded = CFileUtils::GetModificationDate(strFileNameAndPath, true);
-    //0 using the current datetime if non of the above matches or one returns an invalid datetime
-    if (!dateAdded.IsValid())
-      dateAdded = CDateTime::GetCurrentDateTime();
+    dateAdded = GetFileDateAdded(strFileNameAndPath);
 
     m_pDS->exec(PrepareSQL("UPDATE song SET dateAdded='%s' WHERE idSong=%d", dateAdded.GetAsDBDateTime().c_str(), songId));
   }
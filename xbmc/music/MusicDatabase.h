@@ -196,6 +196,21 @@ public:
   // Album
   /////////////////////////////////////////////////
   bool AddAlbum(CAlbum& album);
+
+  /*! \brief Add several albums and all their songs in a single transaction
+   Meant for the library scanner. Artist and genre ids are resolved through the in-memory
+   caches (reset with EmptyCache()), and new songs and the artist/genre links are written
+   with multi-row INSERTs, so a folder of albums takes a handful of round trips rather than
+   several per song.
+   A rollback also empties the caches, as the ids of artists, genres and paths added in the
+   transaction may be handed out again. Called within a batch, the whole batch is rolled back.
+   \param albums [in/out] the albums to add. The ids of albums, songs and artists are filled in.
+   \param stop if given, no more albums are added once it is set. The albums added until then are kept.
+   \return true if the albums were added, false if the transaction was rolled back
+   \sa AddAlbum, CDatabase::BeginBatch
+   */
+  bool AddAlbums(VECALBUMS& albums, const volatile bool *stop = NULL);
+
   /*! \brief Update an album and all its nested entities (artists, songs, infoSongs, etc)
    \param album the album to update
    \return true or false
@@ -503,6 +518,31 @@ private:
   \param strFileNameAndPath path to the file
   */
   void UpdateFileDateAdded(int songId, const std::string& strFileNameAndPath);
+  /*! \brief Get the date a file is considered to be added to the library at
+  \param strFileNameAndPath path to the file
+  \return the file's modification date or the current date, depending on the advanced settings
+  */
+  CDateTime GetFileDateAdded(const std::string& strFileNameAndPath);
+
+  /*! \brief Add the songs of an album for AddAlbums()
+  Songs that are new to the album are inserted in one go. Songs already in the database are
+  updated through AddSong(). The rows for the song_artist, song_genre and album_genre tables are
+  appended to the given vectors rather than written.
+  \return false if the songs of the album could not be looked up, true otherwise
+  */
+  bool AddAlbumSongs(CAlbum& album, std::vector<std::string>& songArtists,
+                     std::vector<std::string>& songGenres, std::vector<std::string>& albumGenres);
+
+  /*! \brief Add an artist, looking it up in the artist cache first
+  \sa AddArtist
+  */
+  int AddArtistCached(const std::string& strArtist, const std::string& strMusicBrainzArtistID);
+
+  /*! \brief Execute an INSERT (or REPLACE) for many rows with as few statements as possible
+  \param strStatement the statement up to and including VALUES
+  \param rows the rows to insert, each a parenthesized list of values
+  */
+  void ExecuteMultiRowInsert(const std::string& strStatement, const std::vector<std::string>& rows);
   void GetFileItemFromDataset(CFileItem* item, const CMusicDbUrl &baseUrl);
   void GetFileItemFromDataset(const dbiplus::sql_record* const record, CFileItem* item, const CMusicDbUrl &baseUrl);
   CSong GetAlbumInfoSongFromDataset(const dbiplus::sql_record* const record, int offset = 0);
@@ -466,14 +466,16 @@ bool CMusicInfoScanner::DoScan(const std::string& strDirectory)
     items.Sort(SortByLabel, SortOrderAscending);
 
     // and then scan in the new information
-    if (RetrieveMusicInfo(strDirectory, items) > 0)
+    int added = RetrieveMusicInfo(strDirectory, items);
+    if (added > 0)
     {
       if (m_handle)
         OnDirectoryScanned(strDirectory);
     }
 
-    // save information about this folder
-    m_musicDatabase.SetPathHash(strDirectory, hash);
+    // save information about this folder, unless it was left as it was to be scanned again
+    if (added >= 0)
+      m_musicDatabase.SetPathHash(strDirectory, hash);
   }
   else
   { // path is the same - no need to rescan
@@ -737,13 +739,27 @@ int CMusicInfoScanner::RetrieveMusicInfo(const std::string& strDirectory, CFileI
 {
   MAPSONGS songsMap;
 
+  // read the tags before the database is locked for the folder
+  CFileItemList scannedItems;
+  bool cancelled = ScanTags(items, scannedItems) == INFO_CANCELLED;
+
+  // the old songs are removed in the same transaction the new ones are added in, so a
+  // failure to add them leaves the folder as it was
+  m_musicDatabase.BeginBatch();
+
   // get all information for all files in current directory from database, and remove them
   if (m_musicDatabase.RemoveSongsFromPath(strDirectory, songsMap))
     m_needsCleanup = true;
 
-  CFileItemList scannedItems;
-  if (ScanTags(items, scannedItems) == INFO_CANCELLED || scannedItems.Size() == 0)
+  if (cancelled || scannedItems.Size() == 0)
+  {
+    if (!m_musicDatabase.CommitBatch())
+    {
+      m_musicDatabase.EmptyCache();
+      return -1;
+    }
     return 0;
+  }
 
   VECALBUMS albums;
   FileItemsToAlbums(scannedItems, albums, &songsMap);
@@ -759,18 +775,27 @@ int CMusicInfoScanner::RetrieveMusicInfo(const std::string& strDirectory, CFileI
   if(ADDON::CAddonMgr::GetInstance().GetDefault(ADDON::ADDON_SCRAPER_ARTISTS, addon))
     artistScraper = std::dynamic_pointer_cast<ADDON::CScraper>(addon);
 
-  // Add each album
   for (VECALBUMS::iterator album = albums.begin(); album != albums.end(); ++album)
   {
-    if (m_bStop)
-      break;
-
     // mark albums without a title as singles
     if (album->strAlbum.empty())
       album->releaseType = CAlbum::Single;
 
     album->strPath = strDirectory;
-    m_musicDatabase.AddAlbum(*album);
+  }
+
+  // Add all albums of the folder at once
+  bool added = m_musicDatabase.AddAlbums(albums, &m_bStop);
+  if (!m_musicDatabase.CommitBatch() || !added)
+  {
+    m_musicDatabase.EmptyCache();
+    return -1;
+  }
+
+  for (VECALBUMS::iterator album = albums.begin(); album != albums.end(); ++album)
+  {
+    if (m_bStop)
+      break;
 
     // Yuk - this is a kludgy way to do what we want to do, but it will work to sort
     // out artist fanart until we can restructure the artist fanart to work more
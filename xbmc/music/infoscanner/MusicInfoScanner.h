@@ -174,6 +174,7 @@ protected:
    Any files which couldn't be scanned (no/bad tags) are discarded in the process.
    \param items [in] list of FileItems to scan
    \param scannedItems [in] list to populate with the scannedItems
+   \return the number of songs added, -1 if the folder could not be updated in the database
    */
   int RetrieveMusicInfo(const std::string& strDirectory, CFileItemList& items);
 
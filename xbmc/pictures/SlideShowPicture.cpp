@@ -21,6 +21,7 @@
 #include "SlideShowPicture.h"
 #include "system.h"
 #include "guilib/GraphicContext.h"
+#include "guilib/GUIFontTTF.h"
 #include "guilib/Texture.h"
 #include "settings/AdvancedSettings.h"
 #include "settings/Settings.h"
@@ -776,6 +777,8 @@ bool CSlideShowPic::UpdateVertexBuffer(Vertex* vericies)
 
 void CSlideShowPic::Render(float *x, float *y, CBaseTexture* pTexture, color_t color)
 {
+  CGUIFontTTFBase::FlushBatch();
+
 #ifdef HAS_DX
   static const DWORD FVF_VERTEX = D3DFVF_XYZ | D3DFVF_DIFFUSE | D3DFVF_TEX1;
 
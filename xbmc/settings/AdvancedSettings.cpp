@@ -119,6 +119,9 @@ void CAdvancedSettings::Initialize()
   m_limiterHold = 0.025f;
   m_limiterRelease = 0.1f;
 
+  m_audioDecodeAhead = 0.0f;
+  m_audioDecodeAheadFiles = 2;
+
   m_seekSteps = { 10, 30, 60, 180, 300, 600, 1800 };
 
   m_omxHWAudioDecode = false;
@@ -292,6 +295,8 @@ void CAdvancedSettings::Initialize()
   m_bVideoLibraryImportWatchedState = false;
   m_bVideoLibraryImportResumePoint = false;
   m_bVideoScannerIgnoreErrors = false;
+  m_iVideoScannerPrefetchThreads = 2;
+  m_iVideoScannerBatchSize = 20;
   m_iVideoLibraryDateAdded = 1; // prefer mtime over ctime and current time
 
   m_iEpgLingerTime = 60 * 24;           /* keep 24 hours by default */
@@ -361,7 +366,9 @@ void CAdvancedSettings::Initialize()
   // the following setting determines the readRate of a player data
   // as multiply of the default data read rate
   m_readBufferFactor = 4.0f;
+  m_demuxReadAhead = 0.0f;
   m_addonPackageFolderSize = 200;
+  m_directoryCacheSize = 32;
 
   m_jsonOutputCompact = true;
   m_jsonTcpPort = 9090;
@@ -498,6 +505,9 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
 
     XMLUtils::GetFloat(pElement, "limiterhold", m_limiterHold, 0.0f, 100.0f);
     XMLUtils::GetFloat(pElement, "limiterrelease", m_limiterRelease, 0.001f, 100.0f);
+
+    XMLUtils::GetFloat(pElement, "decodeahead", m_audioDecodeAhead, 0.0f, 30.0f);
+    XMLUtils::GetInt(pElement, "decodeaheadfiles", m_audioDecodeAheadFiles, 1, 5);
   }
 
   pElement = pRootElement->FirstChildElement("omx");
@@ -767,6 +777,8 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
   if (pElement)
   {
     XMLUtils::GetBoolean(pElement, "ignoreerrors", m_bVideoScannerIgnoreErrors);
+    XMLUtils::GetInt(pElement, "prefetchthreads", m_iVideoScannerPrefetchThreads, 0, 8);
+    XMLUtils::GetInt(pElement, "batchsize", m_iVideoScannerBatchSize, 0, 1000);
   }
 
   // Backward-compatibility of ExternalPlayer config
@@ -793,6 +805,7 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetUInt(pElement, "cachemembuffersize", m_cacheMemBufferSize);
     XMLUtils::GetUInt(pElement, "buffermode", m_networkBufferMode, 0, 3);
     XMLUtils::GetFloat(pElement, "readbufferfactor", m_readBufferFactor);
+    XMLUtils::GetFloat(pElement, "demuxreadahead", m_demuxReadAhead, 0.0f, 30.0f);
   }
 
   pElement = pRootElement->FirstChildElement("jsonrpc");
@@ -863,6 +876,7 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
   XMLUtils::GetFloat(pRootElement,"sleepbeforeflip", m_sleepBeforeFlip, 0.0f, 1.0f);
   XMLUtils::GetBoolean(pRootElement,"virtualshares", m_bVirtualShares);
   XMLUtils::GetUInt(pRootElement, "packagefoldersize", m_addonPackageFolderSize);
+  XMLUtils::GetUInt(pRootElement, "directorycachesize", m_directoryCacheSize, 1, 1024);
   XMLUtils::GetBoolean(pRootElement, "allowdeferredrendering", m_bAllowDeferredRendering);
 
   // EPG
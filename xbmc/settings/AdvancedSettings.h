@@ -147,6 +147,8 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     bool m_VideoPlayerIgnoreDTSinWAV;
     float m_limiterHold;
     float m_limiterRelease;
+    float m_audioDecodeAhead;     ///< \brief seconds of the upcoming playlist entries to decode ahead, 0 to disable
+    int m_audioDecodeAheadFiles;  ///< \brief number of upcoming playlist entries to decode ahead
 
     bool  m_omxHWAudioDecode;
     bool  m_omxDecodeStartWithValidFrame;
@@ -289,6 +291,8 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     bool m_bVideoLibraryImportResumePoint;
 
     bool m_bVideoScannerIgnoreErrors;
+    int m_iVideoScannerPrefetchThreads; ///< \brief number of folders listed ahead of the scanner at once, 0 disables prefetching
+    int m_iVideoScannerBatchSize;       ///< \brief items added to the database per transaction, 0 disables batching
     int m_iVideoLibraryDateAdded;
 
     std::set<std::string> m_vecTokens;
@@ -366,10 +370,12 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     int  m_guiAlgorithmDirtyRegions;
     int  m_guiDirtyRegionNoFlipTimeout;
     unsigned int m_addonPackageFolderSize;
+    unsigned int m_directoryCacheSize; ///< \brief memory used to cache directory listings, in MB
 
     unsigned int m_cacheMemBufferSize;
     unsigned int m_networkBufferMode;
     float m_readBufferFactor;
+    float m_demuxReadAhead; ///< \brief seconds of packets to demux ahead for remote files, 0 to disable
 
     bool m_jsonOutputCompact;
     unsigned int m_jsonTcpPort;
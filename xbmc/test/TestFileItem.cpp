@@ -21,6 +21,11 @@
 #include "FileItem.h"
 #include "URL.h"
 #include "settings/AdvancedSettings.h"
+#include "utils/StringUtils.h"
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
 
 #include "gtest/gtest.h"
 
@@ -136,3 +141,44 @@ const TestFileData BaseMovies[] = {{ "c:\\dir\\filename.avi", false, "c:\\dir\\f
                                    { "/home/user/movies/movie_name/BDMV/index.bdmv", true, "/home/user/movies/movie_name/" }};
 
 INSTANTIATE_TEST_CASE_P(BaseNameMovies, TestFileItemBasePath, ValuesIn(BaseMovies));
+
+#if defined(__GLIBC__)
+// heap memory in use, mallinfo() is deprecated from glibc 2.33 on and its counters wrap at 2 GiB
+static size_t HeapInUse()
+{
+#if __GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33)
+  return mallinfo2().uordblks;
+#else
+  return (unsigned int)mallinfo().uordblks;
+#endif
+}
+#endif
+
+/* Benchmark rather than test, run with --gtest_also_run_disabled_tests: the heap memory taken
+   per item of a large list, shaped like a flattened library view. The result is reported as
+   test properties BytesPerItem and FileItemSize. */
+TEST(TestFileItem, DISABLED_MemoryPerItem)
+{
+#if defined(__GLIBC__)
+  const int count = 10000;
+  size_t before = HeapInUse();
+
+  CFileItemList items;
+  for (int i = 0; i < count; ++i)
+  {
+    CFileItemPtr item(new CFileItem(StringUtils::Format("smb://server/share/Movies/Movie %05i (2015)/Movie %05i (2015).mkv", i, i), false));
+    item->SetLabel(StringUtils::Format("Movie %05i", i));
+    item->SetLabel2("01:45:00");
+    item->SetIconImage("DefaultVideo.png");
+    item->SetMimeType("video/x-matroska");
+    item->SetProperty("IsPlayable", "true");
+    item->SetProperty("original_listitem_url", item->GetPath());
+    items.Add(item);
+  }
+
+  int perItem = (int)((HeapInUse() - before) / count);
+  RecordProperty("BytesPerItem", perItem);
+  RecordProperty("FileItemSize", (int)sizeof(CFileItem));
+  EXPECT_GE(perItem, (int)sizeof(CFileItem));
+#endif
+}
@@ -0,0 +1,113 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "GUIInfoManager.h"
+#include "addons/Skin.h"
+#include "guiinfo/GUIInfoLabels.h"
+#include "settings/SkinSettings.h"
+#include "test/TestUtils.h"
+
+#include "gtest/gtest.h"
+
+class TestGUIInfoManager : public ::testing::Test
+{
+protected:
+  TestGUIInfoManager() : m_previousSkin(g_SkinInfo)
+  {
+    ADDON::AddonProps props("skin.confluence", ADDON::ADDON_SKIN, "1.0.0", "1.0.0");
+    props.path = XBMC_REF_FILE_PATH("addons/skin.confluence");
+    g_SkinInfo.reset(new ADDON::CSkinInfo(props));
+
+    // start from a frame without pending changes
+    g_infoManager.ResetChangedCache();
+  }
+
+  ~TestGUIInfoManager()
+  {
+    g_infoManager.ResetLibraryBools();
+    g_SkinInfo = m_previousSkin;
+  }
+
+  // changes the value behind the info manager's back, the way a source that
+  // forgets to publish would
+  void SetLibraryHasMovies(bool value)
+  {
+    g_infoManager.m_libraryHasMovies = value ? 1 : 0;
+  }
+
+  std::shared_ptr<ADDON::CSkinInfo> m_previousSkin;
+};
+
+TEST_F(TestGUIInfoManager, LibrarySource)
+{
+  g_infoManager.SetLibraryBool(LIBRARY_HAS_MOVIES, false);
+  INFO::InfoPtr info = g_infoManager.Register("library.hascontent(movies)");
+  EXPECT_EQ((unsigned int)INFO::INFO_SOURCE_LIBRARY, info->GetSources());
+  g_infoManager.ResetChangedCache();
+  EXPECT_FALSE(info->Get());
+
+  // not re-evaluated while nothing is published
+  SetLibraryHasMovies(true);
+  g_infoManager.ResetChangedCache();
+  EXPECT_FALSE(info->Get());
+
+  g_infoManager.PublishChange(INFO::INFO_SOURCE_LIBRARY);
+  g_infoManager.ResetChangedCache();
+  EXPECT_TRUE(info->Get());
+
+  // other sources don't affect it
+  SetLibraryHasMovies(false);
+  g_infoManager.PublishChange(INFO::INFO_SOURCE_SKIN);
+  g_infoManager.ResetChangedCache();
+  EXPECT_TRUE(info->Get());
+
+  // SetLibraryBool() publishes by itself
+  g_infoManager.SetLibraryBool(LIBRARY_HAS_MOVIES, false);
+  g_infoManager.ResetChangedCache();
+  EXPECT_FALSE(info->Get());
+}
+
+TEST_F(TestGUIInfoManager, SkinSource)
+{
+  int setting = CSkinSettings::GetInstance().TranslateBool("testguiinfomanager");
+  CSkinSettings::GetInstance().SetBool(setting, false);
+  INFO::InfoPtr info = g_infoManager.Register("skin.hassetting(testguiinfomanager)");
+  EXPECT_EQ((unsigned int)INFO::INFO_SOURCE_SKIN, info->GetSources());
+  g_infoManager.ResetChangedCache();
+  EXPECT_FALSE(info->Get());
+
+  // not re-evaluated while nothing is published
+  g_SkinInfo->SetBool(setting, true);
+  g_infoManager.ResetChangedCache();
+  EXPECT_FALSE(info->Get());
+
+  g_infoManager.PublishChange(INFO::INFO_SOURCE_SKIN);
+  g_infoManager.ResetChangedCache();
+  EXPECT_TRUE(info->Get());
+
+  // expressions take the sources of their operands
+  INFO::InfoPtr expression = g_infoManager.Register("skin.hassetting(testguiinfomanager) + library.hascontent(movies)");
+  EXPECT_EQ((unsigned int)(INFO::INFO_SOURCE_SKIN | INFO::INFO_SOURCE_LIBRARY), expression->GetSources());
+
+  // CSkinSettings publishes by itself
+  CSkinSettings::GetInstance().SetBool(setting, false);
+  g_infoManager.ResetChangedCache();
+  EXPECT_FALSE(info->Get());
+}
@@ -0,0 +1,82 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+#pragma once
+
+#include "utils/SIMDKernels.h"
+#include "utils/TimeUtils.h"
+
+#include "gtest/gtest.h"
+
+#include <stdio.h>
+#include <string>
+
+/* Fixture for classes of SIMD kernels derived from CSIMDKernels. It restores
+ * the automatically selected implementation after each test.
+ */
+template<class Kernels>
+class TestKernels : public testing::Test
+{
+protected:
+  TestKernels() : m_type(Kernels::GetType()) {}
+  ~TestKernels() { Kernels::SetType(m_type); }
+
+  /* Function to select each implementation this CPU supports in turn and call
+   * test(type) with it, the C implementation first.
+   */
+  template<class Test>
+  void ForEachType(Test test)
+  {
+    for (int t = 0; t < CSIMDKernels::TYPE_COUNT; t++)
+    {
+      CSIMDKernels::Type type = (CSIMDKernels::Type)t;
+      if (!Kernels::SetType(type))
+        continue;
+      SCOPED_TRACE(CSIMDKernels::GetTypeName(type));
+      test(type);
+    }
+  }
+
+  /* Function to time count runs of work and record the result as
+   * <type><name> in the test report, in microseconds or, with bytes
+   * given, in GB/s.
+   */
+  template<class Work>
+  void RecordThroughput(CSIMDKernels::Type type, const std::string &name, int count, Work work, double bytes = 0.0)
+  {
+    int64_t start = CurrentHostCounter();
+    for (int i = 0; i < count; i++)
+      work();
+    int64_t elapsed = CurrentHostCounter() - start;
+    if (!elapsed)
+      elapsed = 1;
+
+    std::string key = std::string(CSIMDKernels::GetTypeName(type)) + name;
+    if (bytes > 0.0)
+    {
+      char value[32];
+      snprintf(value, sizeof(value), "%.2f", bytes * count * CurrentHostFrequency() / elapsed / 1e9);
+      RecordProperty((key + "GBs").c_str(), value);
+    }
+    else
+      RecordProperty((key + "Us").c_str(), (int)(elapsed * 1000000 / CurrentHostFrequency()));
+  }
+
+  CSIMDKernels::Type m_type;
+};
@@ -98,6 +98,7 @@ private:
 CXBMCTestUtils::CXBMCTestUtils()
 {
   probability = 0.01;
+  DecodeBenchmarkSeconds = 0.0;
 }
 
 CXBMCTestUtils &CXBMCTestUtils::Instance()
@@ -231,6 +232,16 @@ std::vector<std::string> &CXBMCTestUtils::getGUISettingsFiles()
   return GUISettingsFiles;
 }
 
+std::vector<std::string> &CXBMCTestUtils::getDecodeBenchmarkFiles()
+{
+  return DecodeBenchmarkFiles;
+}
+
+double CXBMCTestUtils::getDecodeBenchmarkSeconds() const
+{
+  return DecodeBenchmarkSeconds;
+}
+
 static const char usage[] =
 "XBMC Test Suite\n"
 "Usage: xbmc-test [options]\n"
@@ -268,6 +279,17 @@ static const char usage[] =
 "    Add multiple GUI settings files from a ',' delimited string of\n"
 "    files to be loaded in test cases that use them.\n"
 "\n"
+"  --add-decodebenchmark-file [FILE]\n"
+"    Add a media file to be decoded by the TestDVDDecodeBenchmark tests.\n"
+"\n"
+"  --add-decodebenchmark-files [FILES]\n"
+"    Add multiple media files from a ',' delimited string of files to be\n"
+"    decoded by the TestDVDDecodeBenchmark tests.\n"
+"\n"
+"  --set-decodebenchmark-seconds [SECONDS]\n"
+"    Stop decoding a benchmark file after this many seconds. The default\n"
+"    of 0 decodes the whole file.\n"
+"\n"
 "  --set-probability [PROBABILITY]\n"
 "    Set the probability variable used by the file corrupting functions.\n"
 "    The variable should be a double type from 0.0 to 1.0. Values given\n"
@@ -334,6 +356,24 @@ void CXBMCTestUtils::ParseArgs(int argc, char **argv)
       for (it = urls.begin(); it < urls.end(); ++it)
         GUISettingsFiles.push_back(*it);
     }
+    else if (arg == "--add-decodebenchmark-file")
+    {
+      DecodeBenchmarkFiles.push_back(argv[++i]);
+    }
+    else if (arg == "--add-decodebenchmark-files")
+    {
+      arg = argv[++i];
+      std::vector<std::string> files = StringUtils::Split(arg, ",");
+      std::vector<std::string>::iterator it;
+      for (it = files.begin(); it < files.end(); ++it)
+        DecodeBenchmarkFiles.push_back(*it);
+    }
+    else if (arg == "--set-decodebenchmark-seconds")
+    {
+      DecodeBenchmarkSeconds = atof(argv[++i]);
+      if (DecodeBenchmarkSeconds < 0.0)
+        DecodeBenchmarkSeconds = 0.0;
+    }
     else if (arg == "--set-probability")
     {
       probability = atof(argv[++i]);
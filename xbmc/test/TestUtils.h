@@ -19,6 +19,7 @@
  */
 #pragma once
 
+#include <stdint.h>
 #include <string>
 #include <vector>
 
@@ -27,6 +28,49 @@ namespace XFILE
   class CFile;
 }
 
+/* Pseudo random numbers for test data, the same sequence for a seed on every
+ * platform and run.
+ */
+class CTestRandom
+{
+public:
+  explicit CTestRandom(unsigned int seed) : m_seed(seed) {}
+
+  /* Function to get the next number in [0, range). */
+  unsigned int Next(unsigned int range = 0x10000)
+  {
+    m_seed = m_seed * 1103515245 + 12345;
+    return (m_seed >> 16) % range;
+  }
+
+  /* Function to get the next number in [-range, range). */
+  float NextFloat(float range)
+  {
+    return ((float)Next() / 32768.0f - 1.0f) * range;
+  }
+
+  /* Function to get count random bytes. */
+  std::vector<uint8_t> Bytes(unsigned int count)
+  {
+    std::vector<uint8_t> bytes(count);
+    for (unsigned int i = 0; i < count; i++)
+      bytes[i] = (uint8_t)Next(0x100);
+    return bytes;
+  }
+
+  /* Function to get count numbers in [-range, range). */
+  std::vector<float> Floats(unsigned int count, float range)
+  {
+    std::vector<float> floats(count);
+    for (unsigned int i = 0; i < count; i++)
+      floats[i] = NextFloat(range);
+    return floats;
+  }
+
+private:
+  unsigned int m_seed;
+};
+
 class CXBMCTestUtils
 {
 public:
@@ -76,6 +120,12 @@ public:
   /* Function to get GUI settings files. */
   std::vector<std::string> &getGUISettingsFiles();
 
+  /* Functions to get the media files and time limit used in the
+   * TestDVDDecodeBenchmark tests.
+   */
+  std::vector<std::string> &getDecodeBenchmarkFiles();
+  double getDecodeBenchmarkSeconds() const;
+
   /* Function used in creating a corrupted file. The parameters are a URL
    * to the original file to be corrupted and a suffix to append to the
    * path of the newly created file. This will return a XFILE::CFile
@@ -102,6 +152,9 @@ private:
   std::vector<std::string> AdvancedSettingsFiles;
   std::vector<std::string> GUISettingsFiles;
 
+  std::vector<std::string> DecodeBenchmarkFiles;
+  double DecodeBenchmarkSeconds;
+
   double probability;
 };
 
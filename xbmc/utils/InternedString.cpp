@@ -0,0 +1,90 @@
+/*
+ *      Copyright (C) 2005-2015 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "InternedString.h"
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
+
+#include <unordered_map>
+
+namespace
+{
+class CStringPool
+{
+public:
+  std::shared_ptr<const std::string> Get(const std::string &str)
+  {
+    CSingleLock lock(m_section);
+    std::weak_ptr<const std::string> &entry = m_strings[str];
+    std::shared_ptr<const std::string> shared = entry.lock();
+    if (!shared)
+    {
+      shared.reset(new std::string(str), CRelease(this));
+      entry = shared;
+    }
+    return shared;
+  }
+
+private:
+  // drops the pool entry along with the last holder of the string
+  class CRelease
+  {
+  public:
+    CRelease(CStringPool *pool) : m_pool(pool) {}
+    void operator()(const std::string *str) const
+    {
+      {
+        CSingleLock lock(m_pool->m_section);
+        std::unordered_map<std::string, std::weak_ptr<const std::string> >::iterator entry = m_pool->m_strings.find(*str);
+        // the string may have been added again while we were waiting for the lock
+        if (entry != m_pool->m_strings.end() && entry->second.expired())
+          m_pool->m_strings.erase(entry);
+      }
+      delete str;
+    }
+  private:
+    CStringPool *m_pool;
+  };
+
+  CCriticalSection m_section;
+  std::unordered_map<std::string, std::weak_ptr<const std::string> > m_strings;
+};
+
+CStringPool &GetPool()
+{
+  // never destroyed, as interned strings may outlive any static
+  static CStringPool *pool = new CStringPool;
+  return *pool;
+}
+}
+
+void CInternedString::Set(const std::string &str)
+{
+  if (str.empty())
+    m_str.reset();
+  else if (!m_str || *m_str != str)
+    m_str = GetPool().Get(str);
+}
+
+const std::string &CInternedString::Empty()
+{
+  static const std::string empty;
+  return empty;
+}
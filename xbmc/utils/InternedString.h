@@ -0,0 +1,60 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2005-2015 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <memory>
+#include <string>
+
+/*!
+ \brief Immutable string shared by all holders of the same value.
+
+ Meant for members of objects kept in large numbers that take few distinct values, such as
+ the icon of a list item.  Equal strings share a single copy out of a pool, which only holds
+ on to a value as long as any CInternedString does.  An empty string takes no allocation.
+ */
+class CInternedString
+{
+public:
+  CInternedString() {}
+  CInternedString(const std::string &str) { Set(str); }
+
+  CInternedString &operator=(const std::string &str)
+  {
+    Set(str);
+    return *this;
+  }
+
+  const std::string &Get() const { return m_str ? *m_str : Empty(); }
+  operator const std::string &() const { return Get(); }
+
+  bool empty() const { return !m_str; }
+  size_t size() const { return m_str ? m_str->size() : 0; }
+  void clear() { m_str.reset(); }
+
+  bool operator==(const std::string &str) const { return Get() == str; }
+  bool operator!=(const std::string &str) const { return Get() != str; }
+
+private:
+  void Set(const std::string &str);
+  static const std::string &Empty();
+
+  std::shared_ptr<const std::string> m_str;
+};
@@ -151,6 +151,17 @@ public:
     return false;
   }
 
+  /*!
+   \brief Function that returns whether the job spends most of its time waiting on I/O.
+
+   CJob subclasses that mostly wait on the network or disks rather than use the CPU may
+   return true, which allows the CJobManager to run more of them than there are CPU cores.
+
+   \return true if the job is I/O bound, false otherwise. Defaults to false.
+   \sa CJobManager
+   */
+  virtual bool IsIOBound() const { return false; }
+
   /*!
    \brief Function for longer jobs to report progress and check whether they have been cancelled.
    
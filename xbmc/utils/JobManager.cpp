@@ -23,6 +23,8 @@
 #include <functional>
 #include <stdexcept>
 #include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "utils/CPUInfo.h"
 #include "utils/log.h"
 
 #include "system.h"
@@ -34,9 +36,10 @@ bool CJob::ShouldCancel(unsigned int progress, unsigned int total) const
   return false;
 }
 
-CJobWorker::CJobWorker(CJobManager *manager) : CThread("JobWorker")
+CJobWorker::CJobWorker(CJobManager *manager, unsigned int slot) : CThread("JobWorker")
 {
   m_jobManager = manager;
+  m_slot = slot;
   Create(true); // start work immediately, and kill ourselves when we're done
 }
 
@@ -69,7 +72,7 @@ void CJobWorker::Process()
     {
       CLog::Log(LOGERROR, "%s error processing job %s", __FUNCTION__, job->GetType());
     }
-    m_jobManager->OnJobComplete(success, job);
+    m_jobManager->OnJobComplete(success, job, this);
   }
 }
 
@@ -179,8 +182,20 @@ CJobManager &CJobManager::GetInstance()
 CJobManager::CJobManager()
 {
   m_jobCounter = 0;
+  m_nextSlot = 0;
   m_running = true;
   m_pauseJobs = false;
+  m_queued = 0;
+  m_idle = 0;
+  m_processing = 0;
+
+  // a worker per core, plus one to cover for jobs blocking now and then,
+  // but never fewer than the 5 workers we used to have
+  m_maxWorkers = std::min(std::max(g_cpuInfo.getCPUCount() + 1, 5), 16);
+
+  // I/O bound jobs may keep up to twice as many workers busy
+  for (unsigned int i = 0; i < 2 * m_maxWorkers; ++i)
+    m_slots.push_back(new CJobSlot);
 }
 
 void CJobManager::Restart()
@@ -197,19 +212,51 @@ void CJobManager::CancelJobs()
   CSingleLock lock(m_section);
   m_running = false;
 
-  // clear any pending jobs
-  for (unsigned int priority = CJob::PRIORITY_LOW_PAUSABLE; priority <= CJob::PRIORITY_HIGH; ++priority)
+  for (Slots::iterator slot = m_slots.begin(); slot != m_slots.end(); ++slot)
   {
-    for_each(m_jobQueue[priority].begin(), m_jobQueue[priority].end(), std::mem_fun_ref(&CWorkItem::FreeJob));
-    m_jobQueue[priority].clear();
+    CSingleLock slotLock((*slot)->m_section);
+
+    // clear any pending jobs
+    for (unsigned int priority = CJob::PRIORITY_LOW_PAUSABLE; priority <= CJob::PRIORITY_HIGH; ++priority)
+    {
+      JobQueue &queue = (*slot)->m_jobQueue[priority];
+      for_each(queue.begin(), queue.end(), std::mem_fun_ref(&CWorkItem::FreeJob));
+      m_queued -= queue.size();
+      (*slot)->m_queued -= queue.size();
+      queue.clear();
+    }
+
+    // cancel any callbacks on jobs still processing
+    if ((*slot)->m_busy)
+      (*slot)->m_current.Cancel();
   }
 
-  // cancel any callbacks on jobs still processing
-  for_each(m_processing.begin(), m_processing.end(), std::mem_fun_ref(&CWorkItem::Cancel));
+  // and any jobs waiting on others
+  for (PendingJobs::iterator i = m_pending.begin(); i != m_pending.end(); ++i)
+    i->second.m_work.FreeJob();
+  m_pending.clear();
+  m_dependents.clear();
+
+  for (unsigned int priority = CJob::PRIORITY_LOW_PAUSABLE; priority <= CJob::PRIORITY_HIGH; ++priority)
+  {
+    JobStatistics stats = GetStatistics(CJob::PRIORITY(priority));
+    if (stats.completed)
+      CLog::Log(LOGDEBUG, "%s priority %u: %u jobs, wait time %" PRIu64 " ms (max %u ms), run time %" PRIu64 " ms (max %u ms)",
+                __FUNCTION__, priority, stats.completed, stats.totalWaitTime, stats.maxWaitTime, stats.totalRunTime, stats.maxRunTime);
+  }
 
   // tell our workers to finish
-  while (m_workers.size())
+  while (true)
   {
+    bool workers = false;
+    for (Slots::const_iterator slot = m_slots.begin(); slot != m_slots.end() && !workers; ++slot)
+    {
+      CSingleLock slotLock((*slot)->m_section);
+      workers = (*slot)->m_worker != NULL;
+    }
+    if (!workers)
+      break;
+
     lock.Leave();
     m_jobEvent.Set();
     Sleep(0); // yield after setting the event to give the workers some time to die
@@ -219,6 +266,17 @@ void CJobManager::CancelJobs()
 
 CJobManager::~CJobManager()
 {
+  for (Slots::iterator slot = m_slots.begin(); slot != m_slots.end(); ++slot)
+    delete *slot;
+}
+
+unsigned int CJobManager::NextJobID()
+{
+  // increment the job counter, ensuring 0 (invalid job) is never hit
+  m_jobCounter++;
+  if (m_jobCounter == 0)
+    m_jobCounter++;
+  return m_jobCounter;
 }
 
 unsigned int CJobManager::AddJob(CJob *job, IJobCallback *callback, CJob::PRIORITY priority)
@@ -228,78 +286,322 @@ unsigned int CJobManager::AddJob(CJob *job, IJobCallback *callback, CJob::PRIORI
   if (!m_running)
     return 0;
 
-  // increment the job counter, ensuring 0 (invalid job) is never hit
-  m_jobCounter++;
-  if (m_jobCounter == 0)
-    m_jobCounter++;
-
   // create a work item for this job
-  CWorkItem work(job, m_jobCounter, priority, callback);
-  m_jobQueue[priority].push_back(work);
-
-  StartWorkers(priority);
+  CWorkItem work(job, NextJobID(), priority, callback);
+  QueueJob(work);
   return work.m_id;
 }
 
-void CJobManager::CancelJob(unsigned int jobID)
+unsigned int CJobManager::AddContinuation(unsigned int jobID, CJob *job, IJobCallback *callback, CJob::PRIORITY priority)
+{
+  return AddJoin(job, std::vector<unsigned int>(1, jobID), callback, priority);
+}
+
+unsigned int CJobManager::AddJoin(CJob *job, const std::vector<unsigned int> &jobIDs, IJobCallback *callback, CJob::PRIORITY priority)
 {
   CSingleLock lock(m_section);
 
-  // check whether we have this job in the queue
-  for (unsigned int priority = CJob::PRIORITY_LOW_PAUSABLE; priority <= CJob::PRIORITY_HIGH; ++priority)
+  if (!m_running)
+    return 0;
+
+  CPendingJob pending;
+  pending.m_work = CWorkItem(job, NextJobID(), priority, callback);
+
+  // register with the jobs that have yet to complete. Holding all slots ensures none of
+  // them completes in the meantime without seeing us.
+  LockSlots();
+  for (std::vector<unsigned int>::const_iterator i = jobIDs.begin(); i != jobIDs.end(); ++i)
+  {
+    CWorkItem *work = FindWork(*i);
+    if (!work)
+      continue;
+    work->m_hasDependents = true;
+    m_dependents[*i].push_back(pending.m_work.m_id);
+    pending.m_remaining++;
+  }
+  UnlockSlots();
+
+  if (pending.m_remaining > 0)
+    m_pending[pending.m_work.m_id] = pending;
+  else
+    QueueJob(pending.m_work);
+
+  return pending.m_work.m_id;
+}
+
+void CJobManager::QueueJob(CWorkItem &work)
+{
+  work.m_queued = XbmcThreads::SystemClockMillis();
+
+  // jobs added from within a job are queued with the worker running it, as they
+  // often work on the same data. Others are spread over all slots.
+  unsigned int slot;
+  const CJobWorker *worker = dynamic_cast<const CJobWorker*>(CThread::GetCurrentThread());
+  if (worker && worker->GetSlot() < m_slots.size())
+    slot = worker->GetSlot();
+  else
+  {
+    slot = m_nextSlot;
+    m_nextSlot = (m_nextSlot + 1) % m_slots.size();
+  }
+
+  {
+    CSingleLock slotLock(m_slots[slot]->m_section);
+    m_slots[slot]->m_jobQueue[work.m_priority].push_back(work);
+    m_slots[slot]->m_queued++;
+    m_queued++;
+  }
+
+  StartWorkers(slot, work.m_priority, work.m_ioBound);
+}
+
+void CJobManager::LockSlots()
+{
+  // always in index order, as workers stealing from each other do
+  for (Slots::iterator slot = m_slots.begin(); slot != m_slots.end(); ++slot)
+    (*slot)->m_section.lock();
+}
+
+void CJobManager::UnlockSlots()
+{
+  for (Slots::reverse_iterator slot = m_slots.rbegin(); slot != m_slots.rend(); ++slot)
+    (*slot)->m_section.unlock();
+}
+
+CJobManager::CWorkItem *CJobManager::FindWork(unsigned int jobID)
+{
+  PendingJobs::iterator pending = m_pending.find(jobID);
+  if (pending != m_pending.end())
+    return &pending->second.m_work;
+
+  for (Slots::iterator slot = m_slots.begin(); slot != m_slots.end(); ++slot)
   {
-    JobQueue::iterator i = find(m_jobQueue[priority].begin(), m_jobQueue[priority].end(), jobID);
-    if (i != m_jobQueue[priority].end())
+    if ((*slot)->m_busy && (*slot)->m_current == jobID)
+      return &(*slot)->m_current;
+
+    for (unsigned int priority = CJob::PRIORITY_LOW_PAUSABLE; priority <= CJob::PRIORITY_HIGH; ++priority)
     {
-      delete i->m_job;
-      m_jobQueue[priority].erase(i);
-      return;
+      JobQueue &queue = (*slot)->m_jobQueue[priority];
+      JobQueue::iterator i = find(queue.begin(), queue.end(), jobID);
+      if (i != queue.end())
+        return &*i;
     }
   }
-  // or if we're processing it
-  Processing::iterator it = find(m_processing.begin(), m_processing.end(), jobID);
-  if (it != m_processing.end())
-    it->m_callback = NULL; // job is in progress, so only thing to do is to remove callback
+  return NULL;
 }
 
-void CJobManager::StartWorkers(CJob::PRIORITY priority)
+void CJobManager::ResolveDependents(unsigned int jobID, bool success, std::vector<CWorkItem> &failed)
 {
-  CSingleLock lock(m_section);
+  Dependents::iterator i = m_dependents.find(jobID);
+  if (i == m_dependents.end())
+    return;
 
-  // check how many free threads we have
-  if (m_processing.size() >= GetMaxWorkers(priority))
+  std::vector<unsigned int> dependents;
+  dependents.swap(i->second);
+  m_dependents.erase(i);
+
+  for (std::vector<unsigned int>::const_iterator id = dependents.begin(); id != dependents.end(); ++id)
+  {
+    // a join may already have failed or been cancelled through another of its jobs
+    PendingJobs::iterator pending = m_pending.find(*id);
+    if (pending == m_pending.end())
+      continue;
+
+    if (success)
+    {
+      if (--pending->second.m_remaining > 0)
+        continue;
+      CWorkItem work(pending->second.m_work);
+      m_pending.erase(pending);
+      QueueJob(work);
+    }
+    else
+    {
+      failed.push_back(pending->second.m_work);
+      m_pending.erase(pending);
+      ResolveDependents(*id, false, failed);
+    }
+  }
+}
+
+void CJobManager::CancelDependents(unsigned int jobID)
+{
+  Dependents::iterator i = m_dependents.find(jobID);
+  if (i == m_dependents.end())
     return;
 
+  std::vector<unsigned int> dependents;
+  dependents.swap(i->second);
+  m_dependents.erase(i);
+
+  for (std::vector<unsigned int>::const_iterator id = dependents.begin(); id != dependents.end(); ++id)
+  {
+    PendingJobs::iterator pending = m_pending.find(*id);
+    if (pending == m_pending.end())
+      continue;
+    pending->second.m_work.FreeJob();
+    m_pending.erase(pending);
+    CancelDependents(*id);
+  }
+}
+
+void CJobManager::CancelJob(unsigned int jobID)
+{
+  CSingleLock lock(m_section);
+
+  // hold all slots so that we can't miss a job being stolen from one slot by another
+  LockSlots();
+
+  // check whether the job is waiting on others
+  PendingJobs::iterator pending = m_pending.find(jobID);
+  bool found = pending != m_pending.end();
+  if (found)
+  {
+    pending->second.m_work.FreeJob();
+    m_pending.erase(pending);
+  }
+
+  for (Slots::iterator slot = m_slots.begin(); slot != m_slots.end() && !found; ++slot)
+  {
+    // check whether we have this job in the queue
+    for (unsigned int priority = CJob::PRIORITY_LOW_PAUSABLE; priority <= CJob::PRIORITY_HIGH && !found; ++priority)
+    {
+      JobQueue &queue = (*slot)->m_jobQueue[priority];
+      JobQueue::iterator i = find(queue.begin(), queue.end(), jobID);
+      if (i != queue.end())
+      {
+        delete i->m_job;
+        queue.erase(i);
+        (*slot)->m_queued--;
+        m_queued--;
+        found = true;
+      }
+    }
+    // or if we're processing it
+    if (!found && (*slot)->m_busy && (*slot)->m_current == jobID)
+    {
+      (*slot)->m_current.m_callback = NULL; // job is in progress, so only thing to do is to remove callback
+      found = true;
+    }
+  }
+
+  UnlockSlots();
+
+  // whatever was to follow the job won't happen now
+  CancelDependents(jobID);
+}
+
+void CJobManager::StartWorkers(unsigned int slot, CJob::PRIORITY priority, bool ioBound)
+{
   // do we have any sleeping threads?
-  if (m_processing.size() < m_workers.size())
+  if (m_idle > 0)
   {
     m_jobEvent.Set();
     return;
   }
 
-  // everyone is busy - we need more workers
-  m_workers.push_back(new CJobWorker(this));
+  // check how many free threads we have
+  uint64_t processing = m_processing;
+  if (ioBound ? (processing >> 32) >= 2 * GetMaxWorkers(priority)
+              : (processing & 0xffffffff) >= GetMaxWorkers(priority))
+    return;
+
+  // everyone is busy - we need more workers, preferably one for the slot the job was queued in
+  for (unsigned int i = 0; i < m_slots.size(); ++i)
+  {
+    CJobSlot &jobSlot = *m_slots[(slot + i) % m_slots.size()];
+    CSingleLock slotLock(jobSlot.m_section);
+    if (!jobSlot.m_worker)
+    {
+      jobSlot.m_worker = new CJobWorker(this, (slot + i) % m_slots.size());
+      return;
+    }
+  }
 }
 
-CJob *CJobManager::PopJob()
+bool CJobManager::ReserveRun(CJob::PRIORITY priority, bool ioBound)
 {
-  CSingleLock lock(m_section);
+  const uint64_t limit = GetMaxWorkers(priority);
+  uint64_t processing = m_processing;
+  while (true)
+  {
+    if (ioBound ? (processing >> 32) >= 2 * limit : (processing & 0xffffffff) >= limit)
+      return false;
+    if (m_processing.compare_exchange_weak(processing, processing + (UINT64_C(1) << 32) + (ioBound ? 0 : 1)))
+      return true;
+  }
+}
+
+void CJobManager::ReleaseRun(bool ioBound)
+{
+  m_processing -= (UINT64_C(1) << 32) + (ioBound ? 0 : 1);
+}
+
+bool CJobManager::TakeJob(unsigned int from, unsigned int to, CJob::PRIORITY priority)
+{
+  CJobSlot &source = *m_slots[from];
+  CJobSlot &target = *m_slots[to];
+
+  // lock the slots in index order, so that workers stealing from each other can't deadlock
+  CSingleLock firstLock(from < to ? source.m_section : target.m_section);
+  CSingleLock secondLock(from < to ? target.m_section : source.m_section);
+
+  JobQueue &queue = source.m_jobQueue[priority];
+  if (queue.empty() || !ReserveRun(priority, queue.front().m_ioBound))
+    return false;
+
+  // pop the job off the queue
+  CWorkItem job = queue.front();
+  queue.pop_front();
+  source.m_queued--;
+  m_queued--;
+
+  unsigned int now = XbmcThreads::SystemClockMillis();
+  unsigned int waitTime = now - job.m_queued;
+  job.m_queued = now;
+
+  // make it the job of our worker
+  target.m_current = job;
+  target.m_busy = true;
+  job.m_job->m_callback = this;
+
+  secondLock.Leave();
+  firstLock.Leave();
+
+  CSingleLock lock(m_statisticsSection);
+  JobStatistics &stats = m_statistics[priority];
+  stats.totalWaitTime += waitTime;
+  stats.maxWaitTime = std::max(stats.maxWaitTime, waitTime);
+  return true;
+}
+
+CJob *CJobManager::PopJob(unsigned int slot)
+{
+  if (m_queued == 0)
+    return NULL;
+
   for (int priority = CJob::PRIORITY_HIGH; priority >= CJob::PRIORITY_LOW_PAUSABLE; --priority)
   {
     // Check whether we're pausing pausable jobs
     if (priority == CJob::PRIORITY_LOW_PAUSABLE && m_pauseJobs)
       continue;
 
-    if (m_jobQueue[priority].size() && m_processing.size() < GetMaxWorkers(CJob::PRIORITY(priority)))
+    // our own slot first, then steal from the others
+    for (unsigned int i = 0; i < m_slots.size(); ++i)
     {
-      // pop the job off the queue
-      CWorkItem job = m_jobQueue[priority].front();
-      m_jobQueue[priority].pop_front();
-
-      // add to the processing vector
-      m_processing.push_back(job);
-      job.m_job->m_callback = this;
-      return job.m_job;
+      unsigned int from = (slot + i) % m_slots.size();
+      if (m_slots[from]->m_queued == 0)
+        continue;
+
+      if (TakeJob(from, slot, CJob::PRIORITY(priority)))
+      {
+        // there's more to do, so wake up another worker to share it
+        if (m_queued > 0 && m_idle > 0)
+          m_jobEvent.Set();
+
+        CSingleLock lock(m_slots[slot]->m_section);
+        return m_slots[slot]->m_current.m_job;
+      }
     }
   }
   return NULL;
@@ -315,18 +617,21 @@ void CJobManager::UnPauseJobs()
 {
   CSingleLock lock(m_section);
   m_pauseJobs = false;
+
+  // the workers may have given up on the paused jobs
+  if (m_queued > 0)
+    StartWorkers(0, CJob::PRIORITY_LOW_PAUSABLE, false);
 }
 
 bool CJobManager::IsProcessing(const CJob::PRIORITY &priority) const
 {
-  CSingleLock lock(m_section);
-
   if (m_pauseJobs)
     return false;
 
-  for(Processing::const_iterator it = m_processing.begin(); it < m_processing.end(); ++it)
+  for (Slots::const_iterator slot = m_slots.begin(); slot != m_slots.end(); ++slot)
   {
-    if (priority == it->m_priority)
+    CSingleLock lock((*slot)->m_section);
+    if ((*slot)->m_busy && priority == (*slot)->m_current.m_priority)
       return true;
   }
   return false;
@@ -335,73 +640,109 @@ bool CJobManager::IsProcessing(const CJob::PRIORITY &priority) const
 int CJobManager::IsProcessing(const std::string &type) const
 {
   int jobsMatched = 0;
-  CSingleLock lock(m_section);
 
   if (m_pauseJobs)
     return 0;
 
-  for(Processing::const_iterator it = m_processing.begin(); it < m_processing.end(); ++it)
+  for (Slots::const_iterator slot = m_slots.begin(); slot != m_slots.end(); ++slot)
   {
-    if (type == std::string(it->m_job->GetType()))
+    CSingleLock lock((*slot)->m_section);
+    if ((*slot)->m_busy && type == std::string((*slot)->m_current.m_job->GetType()))
       jobsMatched++;
   }
   return jobsMatched;
 }
 
+CJobManager::JobStatistics CJobManager::GetStatistics(CJob::PRIORITY priority) const
+{
+  CSingleLock lock(m_statisticsSection);
+  return m_statistics[priority];
+}
+
 CJob *CJobManager::GetNextJob(const CJobWorker *worker)
 {
-  CSingleLock lock(m_section);
+  CJobSlot &slot = *m_slots[worker->GetSlot()];
   while (m_running)
   {
-    // grab a job off the queue if we have one
-    CJob *job = PopJob();
+    // grab a job off the queues if we have one
+    CJob *job = PopJob(worker->GetSlot());
     if (job)
       return job;
+
     // no jobs are left - sleep for 30 seconds to allow new jobs to come in
-    lock.Leave();
+    m_idle++;
     bool newJob = m_jobEvent.WaitMSec(30000);
-    lock.Enter();
-    if (!newJob)
-      break;
+    m_idle--;
+    if (newJob)
+      continue;
+
+    // ensure no jobs have come in during the period after
+    // timeout and before we stopped being idle
+    job = PopJob(worker->GetSlot());
+    if (job)
+      return job;
+
+    // have no jobs. Stay around while jobs are queued in our slot though,
+    // they may just not be allowed to run yet.
+    CSingleLock lock(slot.m_section);
+    if (slot.m_queued == 0)
+    {
+      slot.m_worker = NULL;
+      return NULL;
+    }
   }
-  // ensure no jobs have come in during the period after
-  // timeout and before we held the lock
-  CJob *job = PopJob();
-  if (job)
-    return job;
-  // have no jobs
   RemoveWorker(worker);
   return NULL;
 }
 
 bool CJobManager::OnJobProgress(unsigned int progress, unsigned int total, const CJob *job) const
 {
-  CSingleLock lock(m_section);
-  // find the job in the processing queue, and check whether it's cancelled (no callback)
-  Processing::const_iterator i = find(m_processing.begin(), m_processing.end(), job);
-  if (i != m_processing.end())
+  // the job is most likely running on the calling worker, so look there first
+  unsigned int first = 0;
+  const CJobWorker *worker = dynamic_cast<const CJobWorker*>(CThread::GetCurrentThread());
+  if (worker && worker->GetSlot() < m_slots.size())
+    first = worker->GetSlot();
+
+  // find the job in the processing slots, and check whether it's cancelled (no callback)
+  for (unsigned int i = 0; i < m_slots.size(); ++i)
   {
-    CWorkItem item(*i);
-    lock.Leave(); // leave section prior to call
-    if (item.m_callback)
+    const CJobSlot &slot = *m_slots[(first + i) % m_slots.size()];
+    CSingleLock lock(slot.m_section);
+    if (slot.m_busy && slot.m_current == job)
     {
-      item.m_callback->OnJobProgress(item.m_id, progress, total, job);
-      return false;
+      CWorkItem item(slot.m_current);
+      lock.Leave(); // leave section prior to call
+      if (item.m_callback)
+      {
+        item.m_callback->OnJobProgress(item.m_id, progress, total, job);
+        return false;
+      }
+      break;
     }
   }
   return true; // couldn't find the job, or it's been cancelled
 }
 
-void CJobManager::OnJobComplete(bool success, CJob *job)
+void CJobManager::OnJobComplete(bool success, CJob *job, const CJobWorker *worker)
 {
-  CSingleLock lock(m_section);
-  // remove the job from the processing queue
-  Processing::iterator i = find(m_processing.begin(), m_processing.end(), job);
-  if (i != m_processing.end())
+  CJobSlot &slot = *m_slots[worker->GetSlot()];
+  CSingleLock lock(slot.m_section);
+  // remove the job from the processing slot
+  if (slot.m_busy && slot.m_current == job)
   {
-    // tell any listeners we're done with the job, then delete it
-    CWorkItem item(*i);
+    CWorkItem item(slot.m_current);
     lock.Leave();
+
+    unsigned int runTime = XbmcThreads::SystemClockMillis() - item.m_queued;
+    {
+      CSingleLock statsLock(m_statisticsSection);
+      JobStatistics &stats = m_statistics[item.m_priority];
+      stats.completed++;
+      stats.totalRunTime += runTime;
+      stats.maxRunTime = std::max(stats.maxRunTime, runTime);
+    }
+
+    // tell any listeners we're done with the job, then delete it
     try
     {
       if (item.m_callback)
@@ -411,26 +752,64 @@ void CJobManager::OnJobComplete(bool success, CJob *job)
     {
       CLog::Log(LOGERROR, "%s error processing job %s", __FUNCTION__, item.m_job->GetType());
     }
+
+    // clear the slot. Once jobs depend on this one, it's cleared and they're resolved while
+    // holding m_section, so that no new dependent can slip in between.
+    std::vector<CWorkItem> failed;
     lock.Enter();
-    Processing::iterator j = find(m_processing.begin(), m_processing.end(), job);
-    if (j != m_processing.end())
-      m_processing.erase(j);
-    lock.Leave();
+    if (slot.m_current.m_hasDependents)
+    {
+      lock.Leave();
+      CSingleLock managerLock(m_section);
+      lock.Enter();
+      slot.m_current = CWorkItem();
+      slot.m_busy = false;
+      lock.Leave();
+      ResolveDependents(item.m_id, success, failed);
+    }
+    else
+    {
+      slot.m_current = CWorkItem();
+      slot.m_busy = false;
+      lock.Leave();
+    }
     item.FreeJob();
+
+    // jobs that can't run as a job they depend on failed complete right away
+    for (std::vector<CWorkItem>::iterator i = failed.begin(); i != failed.end(); ++i)
+    {
+      try
+      {
+        if (i->m_callback)
+          i->m_callback->OnJobComplete(i->m_id, false, i->m_job);
+      }
+      catch (...)
+      {
+        CLog::Log(LOGERROR, "%s error processing job %s", __FUNCTION__, i->m_job->GetType());
+      }
+      i->FreeJob();
+    }
+
+    // a worker has become available, which may allow queued jobs of lower priority to run
+    ReleaseRun(item.m_ioBound);
+    if (m_queued > 0 && m_idle > 0)
+      m_jobEvent.Set();
   }
 }
 
 void CJobManager::RemoveWorker(const CJobWorker *worker)
 {
-  CSingleLock lock(m_section);
+  if (worker->GetSlot() >= m_slots.size())
+    return;
+
   // remove our worker
-  Workers::iterator i = find(m_workers.begin(), m_workers.end(), worker);
-  if (i != m_workers.end())
-    m_workers.erase(i); // workers auto-delete
+  CJobSlot &slot = *m_slots[worker->GetSlot()];
+  CSingleLock lock(slot.m_section);
+  if (slot.m_worker == worker)
+    slot.m_worker = NULL; // workers auto-delete
 }
 
-unsigned int CJobManager::GetMaxWorkers(CJob::PRIORITY priority)
+unsigned int CJobManager::GetMaxWorkers(CJob::PRIORITY priority) const
 {
-  static const unsigned int max_workers = 5;
-  return max_workers - (CJob::PRIORITY_HIGH - priority);
+  return m_maxWorkers - (CJob::PRIORITY_HIGH - priority);
 }
@@ -19,9 +19,12 @@
  *
  */
 
+#include <atomic>
+#include <map>
 #include <queue>
 #include <vector>
 #include <string>
+#include <stdint.h>
 #include "threads/CriticalSection.h"
 #include "threads/Thread.h"
 #include "Job.h"
@@ -31,12 +34,18 @@ class CJobManager;
 class CJobWorker : public CThread
 {
 public:
-  CJobWorker(CJobManager *manager);
+  CJobWorker(CJobManager *manager, unsigned int slot);
   virtual ~CJobWorker();
 
   void Process();
+
+  /*!
+   \brief Index of the job slot (queues and current job) owned by this worker
+   */
+  unsigned int GetSlot() const { return m_slot; }
 private:
   CJobManager  *m_jobManager;
+  unsigned int  m_slot;
 };
 
 /*!
@@ -170,6 +179,19 @@ private:
  priority levels.  Lower priority jobs are executed only if there are sufficient
  spare worker threads free to allow for higher priority jobs that may arise.
 
+ Each worker owns a job slot with a queue per priority and its own lock.  Jobs added
+ from within a job go to the slot of the worker running it, other jobs are spread over
+ the slots.  Idle workers take the oldest job of the highest priority from their own
+ slot first and steal from the other slots otherwise, so workers only contend with each
+ other when they share a slot.
+
+ The number of workers depends on the number of CPU cores.  Jobs that are mostly waiting
+ on I/O (see CJob::IsIOBound()) may oversubscribe the CPU up to twice that number.
+
+ Jobs may depend on other jobs (see AddContinuation() and AddJoin()).  Such a job is held
+ back until all the jobs it depends on have completed successfully, and is then queued
+ like any other job, in the slot of the worker that completed the last of them.
+
  \sa CJob and IJobCallback
  */
 class CJobManager
@@ -177,12 +199,25 @@ class CJobManager
   class CWorkItem
   {
   public:
+    CWorkItem()
+    {
+      m_job = NULL;
+      m_id = 0;
+      m_callback = NULL;
+      m_priority = CJob::PRIORITY_LOW;
+      m_ioBound = false;
+      m_hasDependents = false;
+      m_queued = 0;
+    }
     CWorkItem(CJob *job, unsigned int id, CJob::PRIORITY priority, IJobCallback *callback)
     {
       m_job = job;
       m_id = id;
       m_callback = callback;
       m_priority = priority;
+      m_ioBound = job->IsIOBound();
+      m_hasDependents = false;
+      m_queued = 0;
     }
     bool operator==(unsigned int jobID) const
     {
@@ -205,9 +240,58 @@ class CJobManager
     unsigned int  m_id;
     IJobCallback *m_callback;
     CJob::PRIORITY m_priority;
+    bool          m_ioBound;
+    bool          m_hasDependents; ///< other jobs wait for this job to complete
+    unsigned int  m_queued;   ///< time the job was queued (or started, once processing)
+  };
+
+  typedef std::deque<CWorkItem> JobQueue;
+
+  /*!
+   \brief A job waiting for the jobs it depends on to complete
+   */
+  class CPendingJob
+  {
+  public:
+    CPendingJob() : m_remaining(0) {}
+
+    CWorkItem    m_work;
+    unsigned int m_remaining;  ///< number of jobs still to complete before this job may be queued
+  };
+
+  /*!
+   \brief Queues and currently processed job of a single worker
+   */
+  class CJobSlot
+  {
+  public:
+    CJobSlot() : m_queued(0), m_busy(false), m_worker(NULL) {}
+
+    CCriticalSection m_section;
+    JobQueue    m_jobQueue[CJob::PRIORITY_HIGH+1];
+    std::atomic<unsigned int> m_queued;  ///< jobs waiting in m_jobQueue, readable without the lock
+    CWorkItem   m_current;
+    bool        m_busy;
+    CJobWorker *m_worker;
   };
 
 public:
+  /*!
+   \brief Counters of the jobs run at a single priority.
+   Wait time is the time from queueing to the start of processing, run time the time spent in CJob::DoWork().
+   All times are in milliseconds.
+   */
+  struct JobStatistics
+  {
+    JobStatistics() : completed(0), totalWaitTime(0), maxWaitTime(0), totalRunTime(0), maxRunTime(0) {}
+
+    unsigned int completed;
+    uint64_t     totalWaitTime;
+    unsigned int maxWaitTime;
+    uint64_t     totalRunTime;
+    unsigned int maxRunTime;
+  };
+
   /*!
    \brief The only way through which the global instance of the CJobManager should be accessed.
    \return the global instance.
@@ -224,8 +308,37 @@ public:
    */
   unsigned int AddJob(CJob *job, IJobCallback *callback, CJob::PRIORITY priority = CJob::PRIORITY_LOW);
 
+  /*!
+   \brief Add a job to be run once another job has completed successfully.
+   The job is queued as soon as the job it depends on completes successfully.  Should that job
+   fail, the continuation is not run and its callback receives OnJobComplete() with success set
+   to false instead.  Cancelling a job cancels its continuations as well.
+   If the job it depends on has already completed (or is unknown) the job is queued straight away.
+   \param jobID the id of the job to run after, retrieved previously from AddJob(), AddContinuation() or AddJoin()
+   \param job a pointer to the job to add. The job should be subclassed from CJob
+   \param callback a pointer to an IJobCallback instance to receive job progress and completion notices.
+   \param priority the priority that this job should run at.
+   \return a unique identifier for this job, to be used with other interaction
+   \sa AddJob(), AddJoin()
+   */
+  unsigned int AddContinuation(unsigned int jobID, CJob *job, IJobCallback *callback, CJob::PRIORITY priority = CJob::PRIORITY_LOW);
+
+  /*!
+   \brief Add a job to be run once a number of other jobs have all completed successfully.
+   Behaves as AddContinuation() for each of the given jobs: the job fails as soon as one of them
+   fails, and is cancelled as soon as one of them is cancelled.
+   \param job a pointer to the job to add. The job should be subclassed from CJob
+   \param jobIDs the ids of the jobs to run after
+   \param callback a pointer to an IJobCallback instance to receive job progress and completion notices.
+   \param priority the priority that this job should run at.
+   \return a unique identifier for this job, to be used with other interaction
+   \sa AddJob(), AddContinuation()
+   */
+  unsigned int AddJoin(CJob *job, const std::vector<unsigned int> &jobIDs, IJobCallback *callback, CJob::PRIORITY priority = CJob::PRIORITY_LOW);
+
   /*!
    \brief Cancel a job with the given id.
+   Any jobs added as continuation of this job are cancelled as well.
    \param jobID the id of the job to cancel, retrieved previously from AddJob()
    \sa AddJob()
    */
@@ -274,6 +387,19 @@ public:
    */
   bool IsProcessing(const CJob::PRIORITY &priority) const;
 
+  /*!
+   \brief Retrieve the wait and run time counters of the jobs at a priority.
+   \param priority the priority to retrieve the counters for
+   \return the counters accumulated since startup
+   \sa JobStatistics
+   */
+  JobStatistics GetStatistics(CJob::PRIORITY priority) const;
+
+  /*!
+   \brief Number of workers that may process CPU bound jobs at once at the highest priority.
+   */
+  unsigned int GetMaxWorkers() const { return m_maxWorkers; }
+
 protected:
   friend class CJobWorker;
   friend class CJob;
@@ -288,11 +414,12 @@ protected:
   /*!
    \brief Callback from CJobWorker after a job has completed.
    Calls IJobCallback::OnJobComplete(), and then destroys job.
-   \param job a pointer to the calling subclassed CJob instance.
    \param success the result from the DoWork call
+   \param job a pointer to the calling subclassed CJob instance.
+   \param worker the worker that processed the job.
    \sa IJobCallback, CJob
    */
-  void  OnJobComplete(bool success, CJob *job);
+  void  OnJobComplete(bool success, CJob *job, const CJobWorker *worker);
 
   /*!
    \brief Callback from CJob to report progress and check for cancellation.
@@ -312,27 +439,80 @@ private:
   CJobManager const& operator=(CJobManager const&);
   virtual ~CJobManager();
 
-  /*! \brief Pop a job off the job queue and add to the processing queue ready to process
+  /*! \brief Pop a job off the job queues and make it the current job of a slot, ready to process
+   Takes the oldest job of the highest priority that may run, preferring the given slot and
+   stealing from the other slots otherwise.
+   \param slot the slot of the worker requesting a job
    \return the job to process, NULL if no jobs are available
    */
-  CJob *PopJob();
+  CJob *PopJob(unsigned int slot);
+
+  /*! \brief Move the front job of a queue in one slot to be the current job of another
+   \return true if the job was moved, false if the queue was empty or the job may not run yet
+   */
+  bool TakeJob(unsigned int from, unsigned int to, CJob::PRIORITY priority);
+
+  /*! \brief Reserve a place for a job to run, respecting the limit of its priority
+   \return true if the job may run, false otherwise
+   \sa ReleaseRun
+   */
+  bool ReserveRun(CJob::PRIORITY priority, bool ioBound);
+  void ReleaseRun(bool ioBound);
+
+  /*! \brief Assign the next job id, ensuring 0 (invalid job) is never used
+   */
+  unsigned int NextJobID();
+
+  /*! \brief Queue a job that is ready to run in a slot, and wake or start a worker for it
+   Jobs queued from a worker go to that worker's slot.  Requires m_section to be held.
+   */
+  void QueueJob(CWorkItem &work);
+
+  /*! \brief Find a job that has not completed yet, be it queued, processing or waiting on other jobs
+   Requires m_section and all slots to be held.
+   \return the work item of the job, NULL if it has completed or is unknown
+   */
+  CWorkItem *FindWork(unsigned int jobID);
 
-  void StartWorkers(CJob::PRIORITY priority);
+  /*! \brief Queue the dependents of a completed job that have no other jobs left to wait on
+   Dependents of a failed job fail as well and are returned, so that their callbacks can be
+   called once m_section has been released.  Requires m_section to be held.
+   */
+  void ResolveDependents(unsigned int jobID, bool success, std::vector<CWorkItem> &failed);
+
+  /*! \brief Remove and free the jobs waiting on a cancelled job, and on those in turn
+   Requires m_section to be held.
+   */
+  void CancelDependents(unsigned int jobID);
+
+  void LockSlots();
+  void UnlockSlots();
+
+  void StartWorkers(unsigned int slot, CJob::PRIORITY priority, bool ioBound);
   void RemoveWorker(const CJobWorker *worker);
-  static unsigned int GetMaxWorkers(CJob::PRIORITY priority);
+  unsigned int GetMaxWorkers(CJob::PRIORITY priority) const;
 
   unsigned int m_jobCounter;
+  unsigned int m_nextSlot;
+  unsigned int m_maxWorkers;
 
-  typedef std::deque<CWorkItem>    JobQueue;
-  typedef std::vector<CWorkItem>   Processing;
-  typedef std::vector<CJobWorker*> Workers;
+  typedef std::vector<CJobSlot*> Slots;
+  Slots m_slots;
 
-  JobQueue   m_jobQueue[CJob::PRIORITY_HIGH+1];
-  bool       m_pauseJobs;
-  Processing m_processing;
-  Workers    m_workers;
+  std::atomic<bool>         m_pauseJobs;
+  std::atomic<bool>         m_running;
+  std::atomic<unsigned int> m_queued;      ///< jobs waiting in any slot
+  std::atomic<unsigned int> m_idle;        ///< workers waiting for a job
+  std::atomic<uint64_t>     m_processing;  ///< processing jobs, CPU bound in the low and all in the high 32 bits
 
-  CCriticalSection m_section;
+  JobStatistics    m_statistics[CJob::PRIORITY_HIGH+1];
+  CCriticalSection m_statisticsSection;
+
+  typedef std::map<unsigned int, CPendingJob> PendingJobs;
+  typedef std::map<unsigned int, std::vector<unsigned int> > Dependents;
+  PendingJobs      m_pending;     ///< jobs waiting on other jobs, by id
+  Dependents       m_dependents;  ///< ids of the jobs waiting on a job, by id of the job waited on
+
+  CCriticalSection m_section;   ///< serializes adding and cancelling jobs, guards m_pending and m_dependents
   CEvent           m_jobEvent;
-  bool             m_running;
 };
@@ -0,0 +1,103 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "SIMDKernels.h"
+
+/*
+ HAS_<TYPE>_KERNELS is defined for every instruction set the compiler can
+ generate here. SSE4.1 and AVX2 code is compiled per function through
+ TARGET_SSE4 and TARGET_AVX2, so the rest of the build keeps its baseline.
+ */
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP > 1)
+  #define HAS_SSE2_KERNELS
+  #include <emmintrin.h>
+
+  #if defined(_MSC_VER)
+    #define HAS_SSE4_KERNELS
+    #define HAS_AVX2_KERNELS
+    #define TARGET_SSE4
+    #define TARGET_AVX2
+  #elif defined(__clang__) || (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))
+    #define HAS_SSE4_KERNELS
+    #define HAS_AVX2_KERNELS
+    #define TARGET_SSE4 __attribute__((target("sse4.1")))
+    #define TARGET_AVX2 __attribute__((target("avx2")))
+  #endif
+  #if defined(HAS_AVX2_KERNELS)
+    #include <immintrin.h>
+  #endif
+#endif
+
+#if defined(__ARM_NEON__) || defined(__aarch64__)
+  #define HAS_NEON_KERNELS
+  #include <arm_neon.h>
+#endif
+
+/*! \brief Picks one of a set of kernel tables.
+
+ Table is a struct of function pointers. The fastest table the CPU supports is
+ selected on first use, SetType() overrides it (for tests and benchmarks).
+ */
+template<class Table>
+class CSIMDDispatch
+{
+public:
+  /*! \param tables one table per CSIMDKernels::Type, NULL for types without an implementation.
+   The C table must be set.
+   */
+  explicit CSIMDDispatch(const Table* const *tables) : m_tables(tables), m_type(CSIMDKernels::TYPE_COUNT) {}
+
+  /*! \brief Select the implementation to use
+   \return false if the implementation isn't available on this CPU or build
+   */
+  bool SetType(CSIMDKernels::Type type)
+  {
+    if (type >= CSIMDKernels::TYPE_COUNT || !m_tables[type] || !CSIMDKernels::IsSupported(type))
+      return false;
+    m_type = type;
+    return true;
+  }
+
+  CSIMDKernels::Type GetType()
+  {
+    if (m_type == CSIMDKernels::TYPE_COUNT)
+    {
+      const CSIMDKernels::Type preferred[] = { CSIMDKernels::TYPE_AVX2, CSIMDKernels::TYPE_SSE4,
+                                               CSIMDKernels::TYPE_SSE2, CSIMDKernels::TYPE_NEON };
+      for (unsigned int i = 0; i < sizeof(preferred) / sizeof(preferred[0]); i++)
+      {
+        if (SetType(preferred[i]))
+          return m_type;
+      }
+      m_type = CSIMDKernels::TYPE_C;
+    }
+    return m_type;
+  }
+
+  const Table* Get()
+  {
+    return m_tables[GetType()];
+  }
+
+private:
+  const Table* const *m_tables;
+  CSIMDKernels::Type m_type; // written on first use and by SetType() only
+};
@@ -0,0 +1,71 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "SIMDDispatch.h"
+#include "utils/CPUInfo.h"
+
+const char* CSIMDKernels::GetTypeName(Type type)
+{
+  switch (type)
+  {
+  case TYPE_SSE2:
+    return "sse2";
+  case TYPE_SSE4:
+    return "sse4";
+  case TYPE_AVX2:
+    return "avx2";
+  case TYPE_NEON:
+    return "neon";
+  default:
+    return "c";
+  }
+}
+
+bool CSIMDKernels::IsSupported(Type type)
+{
+  switch (type)
+  {
+  case TYPE_C:
+    return true;
+#if defined(HAS_SSE2_KERNELS)
+  case TYPE_SSE2:
+    return (g_cpuInfo.GetCPUFeatures() & CPU_FEATURE_SSE2) != 0;
+#endif
+#if defined(HAS_SSE4_KERNELS)
+  case TYPE_SSE4:
+    return (g_cpuInfo.GetCPUFeatures() & CPU_FEATURE_SSE4) != 0;
+#endif
+#if defined(HAS_AVX2_KERNELS)
+  case TYPE_AVX2:
+    return (g_cpuInfo.GetCPUFeatures() & CPU_FEATURE_AVX2) != 0;
+#endif
+#if defined(HAS_NEON_KERNELS)
+  case TYPE_NEON:
+#if defined(__aarch64__)
+    return true;
+#else
+    // NEON is optional on ARMv7
+    return (g_cpuInfo.GetCPUFeatures() & CPU_FEATURE_NEON) != 0;
+#endif
+#endif
+  default:
+    return false;
+  }
+}
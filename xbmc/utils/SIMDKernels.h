@@ -0,0 +1,40 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*! \brief Instruction sets kernels can be implemented with. */
+class CSIMDKernels
+{
+public:
+  enum Type
+  {
+    TYPE_C = 0,
+    TYPE_SSE2,
+    TYPE_SSE4,
+    TYPE_AVX2,
+    TYPE_NEON,
+    TYPE_COUNT
+  };
+
+  static const char* GetTypeName(Type type);
+
+  /*! \brief Check whether this CPU and build can run kernels of the given type */
+  static bool IsSupported(Type type);
+};
@@ -23,11 +23,20 @@
 #include "URL.h"
 #include "Util.h"
 #include "XBDateTime.h"
+#include "threads/Event.h"
 #include "utils/CharsetConverter.h"
+#include "utils/CPUInfo.h"
+#include "utils/JobManager.h"
 #include "utils/StringUtils.h"
 #include "utils/Variant.h"
 
 #include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
+
+// number of items from which on the sorting is split across the available cores
+#define PARALLEL_SORT_THRESHOLD 8192
 
 std::string ArrayToString(SortAttribute attributes, const CVariant &variant, const std::string &seperator = " / ")
 {
@@ -396,130 +405,250 @@ std::string ByDateTaken(SortAttribute attributes, const SortItem &values)
   return values.at(FieldDateTaken).asString();
 }
 
-bool preliminarySort(const SortItem &left, const SortItem &right, bool handleFolder, bool &result, std::wstring &labelLeft, std::wstring &labelRight)
+/*! \brief Everything the comparator needs from a single item, extracted once before sorting
+ so that comparisons neither look up fields nor collate strings.
+ */
+typedef struct
+{
+  std::string  collationKey;  // of the sort label, see StringUtils::AlphaNumericCollationKey
+  SortSpecial  special;
+  int          folder;  // -1 if the item has no FieldFolder
+} SortKey;
+
+class CSortKeyCompare
 {
-  // make sure both items have the necessary data to do the sorting
-  SortItem::const_iterator itLeftSort, itRightSort;
-  if ((itLeftSort = left.find(FieldSort)) == left.end())
+public:
+  CSortKeyCompare(const std::vector<SortKey> &keys, SortOrder sortOrder, SortAttribute attributes)
+    : m_keys(keys),
+      m_handleFolder((attributes & SortAttributeIgnoreFolders) == 0),
+      m_descending(sortOrder == SortOrderDescending)
+  { }
+
+  bool operator()(size_t left, size_t right) const
   {
-    result = false;
-    return true;
+    const SortKey &keyLeft = m_keys[left];
+    const SortKey &keyRight = m_keys[right];
+
+    // one has a special sort: left is sorted above right if left
+    // should be sorted on top or right should be sorted on bottom
+    if (keyLeft.special != keyRight.special)
+      return keyLeft.special == SortSpecialOnTop || keyRight.special == SortSpecialOnBottom;
+    // both have either sort on top or sort on bottom -> leave as-is
+    if (keyLeft.special != SortSpecialNone)
+      return false;
+
+    if (m_handleFolder && keyLeft.folder >= 0 && keyRight.folder >= 0 &&
+        keyLeft.folder != keyRight.folder)
+      return keyLeft.folder != 0;
+
+    int result = keyLeft.collationKey.compare(keyRight.collationKey);
+    return m_descending ? result > 0 : result < 0;
   }
-  if ((itRightSort = right.find(FieldSort)) == right.end())
+
+private:
+  const std::vector<SortKey> &m_keys;
+  bool m_handleFolder;
+  bool m_descending;
+};
+
+/*! \brief Makes a comparator total by falling back to the original position of equal items,
+ which gives std::partial_sort the same result as a stable sort.
+ */
+class CSortKeyCompareStable
+{
+public:
+  explicit CSortKeyCompareStable(const CSortKeyCompare &compare) : m_compare(compare) { }
+
+  bool operator()(size_t left, size_t right) const
   {
-    result = true;
-    return true;
+    if (m_compare(left, right))
+      return true;
+    if (m_compare(right, left))
+      return false;
+    return left < right;
   }
 
-  // look at special sorting behaviour
-  SortItem::const_iterator itLeft, itRight;
-  SortSpecial leftSortSpecial = SortSpecialNone;
-  SortSpecial rightSortSpecial = SortSpecialNone;
-  if ((itLeft = left.find(FieldSortSpecial)) != left.end() && itLeft->second.asInteger() <= (int64_t)SortSpecialOnBottom)
-    leftSortSpecial = (SortSpecial)itLeft->second.asInteger();
-  if ((itRight = right.find(FieldSortSpecial)) != right.end() && itRight->second.asInteger() <= (int64_t)SortSpecialOnBottom)
-    rightSortSpecial = (SortSpecial)itRight->second.asInteger();
-  
-  // one has a special sort
-  if (leftSortSpecial != rightSortSpecial)
+private:
+  const CSortKeyCompare &m_compare;
+};
+
+/*! \brief A set of independent tasks run by the calling thread together with any job workers
+ that pick up a CParallelSortJob. Tasks are claimed one at a time so the caller never waits on
+ a task that has not been started, even if all job workers are busy.
+ */
+class CParallelSortTasks
+{
+public:
+  typedef std::function<void()> Task;
+
+  explicit CParallelSortTasks(std::vector<Task> &tasks)
+    : m_next(0),
+      m_done(0)
   {
-    // left should be sorted on top
-    // or right should be sorted on bottom
-    // => left is sorted above right
-    if (leftSortSpecial == SortSpecialOnTop ||
-        rightSortSpecial == SortSpecialOnBottom)
-    {
-      result = true;
-      return true;
-    }
-    
-    // otherwise right is sorted above left
-    result = false;
-    return true;
+    m_tasks.swap(tasks);
   }
-  // both have either sort on top or sort on bottom -> leave as-is
-  else if (leftSortSpecial != SortSpecialNone && leftSortSpecial == rightSortSpecial)
+
+  bool RunNext()
   {
-    result = false;
+    unsigned int task = m_next++;
+    if (task >= m_tasks.size())
+      return false;
+
+    m_tasks[task]();
+    if (++m_done == m_tasks.size())
+      m_finished.Set();
     return true;
   }
 
-  if (handleFolder)
+  void Wait() { m_finished.Wait(); }
+
+private:
+  std::vector<Task> m_tasks;
+  std::atomic<unsigned int> m_next;
+  std::atomic<unsigned int> m_done;
+  CEvent m_finished;
+};
+
+class CParallelSortJob : public CJob
+{
+public:
+  explicit CParallelSortJob(const std::shared_ptr<CParallelSortTasks> &tasks) : m_tasks(tasks) { }
+
+  virtual bool DoWork()
   {
-    itLeft = left.find(FieldFolder);
-    itRight = right.find(FieldFolder);
-    if (itLeft != left.end() && itRight != right.end() &&
-        itLeft->second.asBoolean() != itRight->second.asBoolean())
-    {
-      result = itLeft->second.asBoolean();
-      return true;
-    }
+    while (m_tasks->RunNext()) { }
+    return true;
   }
 
-  labelLeft = itLeftSort->second.asWideString();
-  labelRight = itRightSort->second.asWideString();
+  virtual const char *GetType() const { return "sort"; }
 
-  return false;
-}
+private:
+  std::shared_ptr<CParallelSortTasks> m_tasks;
+};
 
-bool SorterAscending(const SortItem &left, const SortItem &right)
+void RunParallel(std::vector<CParallelSortTasks::Task> &tasks)
 {
-  bool result;
-  std::wstring labelLeft, labelRight;
-  if (preliminarySort(left, right, true, result, labelLeft, labelRight))
-    return result;
+  if (tasks.empty())
+    return;
+
+  size_t helpers = tasks.size() - 1;
+  std::shared_ptr<CParallelSortTasks> state(new CParallelSortTasks(tasks));
+  for (size_t i = 0; i < helpers; ++i)
+    CJobManager::GetInstance().AddJob(new CParallelSortJob(state), NULL, CJob::PRIORITY_HIGH);
 
-  return StringUtils::AlphaNumericCompare(labelLeft.c_str(), labelRight.c_str()) < 0;
+  while (state->RunNext()) { }
+  state->Wait();
 }
 
-bool SorterDescending(const SortItem &left, const SortItem &right)
+/*! \brief Stable merge sort of order, with the initial runs sorted and the
+ merges of each pass done in parallel.
+ */
+void ParallelStableSort(std::vector<size_t> &order, const CSortKeyCompare &compare, size_t chunks)
 {
-  bool result;
-  std::wstring labelLeft, labelRight;
-  if (preliminarySort(left, right, true, result, labelLeft, labelRight))
-    return result;
+  std::vector<size_t> bounds;
+  for (size_t chunk = 0; chunk <= chunks; ++chunk)
+    bounds.push_back(order.size() * chunk / chunks);
 
-  return StringUtils::AlphaNumericCompare(labelLeft.c_str(), labelRight.c_str()) > 0;
-}
+  std::vector<CParallelSortTasks::Task> tasks;
+  for (size_t chunk = 0; chunk < chunks; ++chunk)
+  {
+    std::vector<size_t>::iterator first = order.begin() + bounds[chunk];
+    std::vector<size_t>::iterator last = order.begin() + bounds[chunk + 1];
+    tasks.push_back([first, last, &compare]() { std::stable_sort(first, last, compare); });
+  }
+  RunParallel(tasks);
 
-bool SorterIgnoreFoldersAscending(const SortItem &left, const SortItem &right)
-{
-  bool result;
-  std::wstring labelLeft, labelRight;
-  if (preliminarySort(left, right, false, result, labelLeft, labelRight))
-    return result;
+  // merge neighbouring runs pairwise, always with the earlier run first to stay stable
+  std::vector<size_t> buffer(order.size());
+  std::vector<size_t> *source = &order;
+  std::vector<size_t> *target = &buffer;
+  while (bounds.size() > 2)
+  {
+    std::vector<size_t> merged;
+    for (size_t run = 0; run + 1 < bounds.size(); run += 2)
+    {
+      merged.push_back(bounds[run]);
+      std::vector<size_t>::const_iterator first = source->begin() + bounds[run];
+      std::vector<size_t>::const_iterator middle = source->begin() + bounds[run + 1];
+      std::vector<size_t>::const_iterator last = run + 2 < bounds.size() ? source->begin() + bounds[run + 2] : middle;
+      std::vector<size_t>::iterator out = target->begin() + bounds[run];
+      tasks.push_back([first, middle, last, out, &compare]() { std::merge(first, middle, middle, last, out, compare); });
+    }
+    merged.push_back(bounds.back());
+    RunParallel(tasks);
+
+    bounds.swap(merged);
+    std::swap(source, target);
+  }
 
-  return StringUtils::AlphaNumericCompare(labelLeft.c_str(), labelRight.c_str()) < 0;
+  if (source != &order)
+    order.swap(buffer);
 }
 
-bool SorterIgnoreFoldersDescending(const SortItem &left, const SortItem &right)
+/*! \brief Computes the sorted order of items given their keys.
+ Only the first limitEnd positions are guaranteed to be sorted if limitEnd is positive.
+ */
+std::vector<size_t> GetSortedOrder(const std::vector<SortKey> &keys, SortOrder sortOrder, SortAttribute attributes, int limitEnd)
 {
-  bool result;
-  std::wstring labelLeft, labelRight;
-  if (preliminarySort(left, right, false, result, labelLeft, labelRight))
-    return result;
+  std::vector<size_t> order(keys.size());
+  for (size_t i = 0; i < order.size(); ++i)
+    order[i] = i;
 
-  return StringUtils::AlphaNumericCompare(labelLeft.c_str(), labelRight.c_str()) > 0;
-}
+  CSortKeyCompare compare(keys, sortOrder, attributes);
+  if (limitEnd > 0 && (size_t)limitEnd < order.size() / 2)
+  {
+    std::partial_sort(order.begin(), order.begin() + limitEnd, order.end(), CSortKeyCompareStable(compare));
+    return order;
+  }
 
-bool SorterIndirectAscending(const SortItemPtr &left, const SortItemPtr &right)
-{
-  return SorterAscending(*left, *right);
-}
+  size_t chunks = std::min<size_t>(g_cpuInfo.getCPUCount(), order.size() / (PARALLEL_SORT_THRESHOLD / 2));
+  if (order.size() >= PARALLEL_SORT_THRESHOLD && chunks > 1)
+    ParallelStableSort(order, compare, chunks);
+  else
+    std::stable_sort(order.begin(), order.end(), compare);
 
-bool SorterIndirectDescending(const SortItemPtr &left, const SortItemPtr &right)
-{
-  return SorterDescending(*left, *right);
+  return order;
 }
 
-bool SorterIndirectIgnoreFoldersAscending(const SortItemPtr &left, const SortItemPtr &right)
+SortKey PrepareSortKey(SortUtils::SortPreparator preparator, SortAttribute attributes, const Fields &sortingFields, SortItem &item)
 {
-  return SorterIgnoreFoldersAscending(*left, *right);
+  // add all fields to the item that are required for sorting if they are currently missing
+  for (Fields::const_iterator field = sortingFields.begin(); field != sortingFields.end(); ++field)
+  {
+    if (item.find(*field) == item.end())
+      item.insert(std::pair<Field, CVariant>(*field, CVariant::ConstNullVariant));
+  }
+
+  // Prepare the string used for sorting and store it under FieldSort
+  std::wstring sortLabel;
+  g_charsetConverter.utf8ToW(preparator(attributes, item), sortLabel, false);
+  SortItem::const_iterator itSort = item.insert(std::pair<Field, CVariant>(FieldSort, CVariant(sortLabel))).first;
+
+  SortKey key;
+  key.collationKey = StringUtils::AlphaNumericCollationKey(itSort->second.asWideString().c_str());
+
+  key.special = SortSpecialNone;
+  SortItem::const_iterator it = item.find(FieldSortSpecial);
+  if (it != item.end() && it->second.asInteger() <= (int64_t)SortSpecialOnBottom)
+    key.special = (SortSpecial)it->second.asInteger();
+
+  key.folder = -1;
+  it = item.find(FieldFolder);
+  if (it != item.end())
+    key.folder = it->second.asBoolean() ? 1 : 0;
+
+  return key;
 }
 
-bool SorterIndirectIgnoreFoldersDescending(const SortItemPtr &left, const SortItemPtr &right)
+template<class T>
+void ApplySortedOrder(std::vector<T> &items, const std::vector<size_t> &order)
 {
-  return SorterIgnoreFoldersDescending(*left, *right);
+  std::vector<T> sorted;
+  sorted.reserve(items.size());
+  for (std::vector<size_t>::const_iterator it = order.begin(); it != order.end(); ++it)
+    sorted.push_back(std::move(items[*it]));
+
+  items.swap(sorted);
 }
 
 std::map<SortBy, SortUtils::SortPreparator> fillPreparators()
@@ -671,23 +800,13 @@ void SortUtils::Sort(SortBy sortBy, SortOrder sortOrder, SortAttribute attribute
     {
       Fields sortingFields = GetFieldsForSorting(sortBy);
 
-      // Prepare the string used for sorting and store it under FieldSort
+      std::vector<SortKey> keys;
+      keys.reserve(items.size());
       for (DatabaseResults::iterator item = items.begin(); item != items.end(); ++item)
-      {
-        // add all fields to the item that are required for sorting if they are currently missing
-        for (Fields::const_iterator field = sortingFields.begin(); field != sortingFields.end(); ++field)
-        {
-          if (item->find(*field) == item->end())
-            item->insert(std::pair<Field, CVariant>(*field, CVariant::ConstNullVariant));
-        }
-
-        std::wstring sortLabel;
-        g_charsetConverter.utf8ToW(preparator(attributes, *item), sortLabel, false);
-        item->insert(std::pair<Field, CVariant>(FieldSort, CVariant(sortLabel)));
-      }
+        keys.push_back(PrepareSortKey(preparator, attributes, sortingFields, *item));
 
       // Do the sorting
-      std::stable_sort(items.begin(), items.end(), getSorter(sortOrder, attributes));
+      ApplySortedOrder(items, GetSortedOrder(keys, sortOrder, attributes, limitEnd));
     }
   }
 
@@ -710,23 +829,13 @@ void SortUtils::Sort(SortBy sortBy, SortOrder sortOrder, SortAttribute attribute
     {
       Fields sortingFields = GetFieldsForSorting(sortBy);
 
-      // Prepare the string used for sorting and store it under FieldSort
+      std::vector<SortKey> keys;
+      keys.reserve(items.size());
       for (SortItems::iterator item = items.begin(); item != items.end(); ++item)
-      {
-        // add all fields to the item that are required for sorting if they are currently missing
-        for (Fields::const_iterator field = sortingFields.begin(); field != sortingFields.end(); ++field)
-        {
-          if ((*item)->find(*field) == (*item)->end())
-            (*item)->insert(std::pair<Field, CVariant>(*field, CVariant::ConstNullVariant));
-        }
-
-        std::wstring sortLabel;
-        g_charsetConverter.utf8ToW(preparator(attributes, **item), sortLabel, false);
-        (*item)->insert(std::pair<Field, CVariant>(FieldSort, CVariant(sortLabel)));
-      }
+        keys.push_back(PrepareSortKey(preparator, attributes, sortingFields, **item));
 
       // Do the sorting
-      std::stable_sort(items.begin(), items.end(), getSorterIndirect(sortOrder, attributes));
+      ApplySortedOrder(items, GetSortedOrder(keys, sortOrder, attributes, limitEnd));
     }
   }
 
@@ -779,22 +888,6 @@ const SortUtils::SortPreparator& SortUtils::getPreparator(SortBy sortBy)
   return m_preparators[SortByNone];
 }
 
-SortUtils::Sorter SortUtils::getSorter(SortOrder sortOrder, SortAttribute attributes)
-{
-  if (attributes & SortAttributeIgnoreFolders)
-    return sortOrder == SortOrderDescending ? SorterIgnoreFoldersDescending : SorterIgnoreFoldersAscending;
-
-  return sortOrder == SortOrderDescending ? SorterDescending : SorterAscending;
-}
-
-SortUtils::SorterIndirect SortUtils::getSorterIndirect(SortOrder sortOrder, SortAttribute attributes)
-{
-  if (attributes & SortAttributeIgnoreFolders)
-    return sortOrder == SortOrderDescending ? SorterIndirectIgnoreFoldersDescending : SorterIndirectIgnoreFoldersAscending;
-
-  return sortOrder == SortOrderDescending ? SorterIndirectDescending : SorterIndirectAscending;
-}
-
 const Fields& SortUtils::GetFieldsForSorting(SortBy sortBy)
 {
   std::map<SortBy, Fields>::const_iterator it = m_sortingFields.find(sortBy);
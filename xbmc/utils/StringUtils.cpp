@@ -824,6 +824,80 @@ int64_t StringUtils::AlphaNumericCompare(const wchar_t *left, const wchar_t *rig
   return 0; // files are the same
 }
 
+// Appends value to key so that the byte-wise order of the encodings matches
+// the order of the values and no encoding is the prefix of another one.
+static void AppendCollationValue(std::string &key, uint32_t value)
+{
+  if (value < 0x7F)
+    key += (char)(value + 1);
+  else if (value < 0x4000)
+  {
+    key += (char)(0x80 | (value >> 8));
+    key += (char)(value & 0xFF);
+  }
+  else if (value < 0x200000)
+  {
+    key += (char)(0xC0 | (value >> 16));
+    key += (char)((value >> 8) & 0xFF);
+    key += (char)(value & 0xFF);
+  }
+  else
+  {
+    key += (char)0xE0;
+    for (int shift = 24; shift >= 0; shift -= 8)
+      key += (char)((value >> shift) & 0xFF);
+  }
+}
+
+// Appends the collation weights of a single character, terminated by 0 so
+// that a character whose weights are a prefix of another's sorts first.
+static void AppendCollationChar(std::string &key, const std::collate<wchar_t> &coll, wchar_t c)
+{
+  std::wstring weights = coll.transform(&c, &c + 1);
+  for (std::wstring::const_iterator it = weights.begin(); it != weights.end(); ++it)
+    AppendCollationValue(key, (uint32_t)*it);
+  key += '\0';
+}
+
+std::string StringUtils::AlphaNumericCollationKey(const wchar_t *str)
+{
+  const std::collate<wchar_t>& coll = std::use_facet<std::collate<wchar_t> >(g_langInfo.GetSystemLocale());
+  std::string key;
+  key.reserve(wcslen(str) * 2);
+
+  // the weights of '0' mark a number, so numbers sort against other characters like digits do
+  std::string numberMark;
+  AppendCollationChar(numberMark, coll, L'0');
+
+  const wchar_t *c = str;
+  while (*c != 0)
+  {
+    if (*c >= L'0' && *c <= L'9')
+    {
+      // same as AlphaNumericCompare: numbers are compared up to 15 digits at a time
+      const wchar_t *start = c;
+      uint64_t number = 0;
+      while (*c >= L'0' && *c <= L'9' && c < start + 15)
+      {
+        number *= 10;
+        number += *c++ - L'0';
+      }
+      key += numberMark;
+      for (int shift = 48; shift >= 0; shift -= 8)
+        key += (char)((number >> shift) & 0xFF);
+      continue;
+    }
+
+    // case less, taking the current locale into account
+    wchar_t lc = *c++;
+    if (lc >= L'A' && lc <= L'Z')
+      lc += L'a' - L'A';
+    AppendCollationChar(key, coll, lc);
+  }
+
+  return key;
+}
+
 int StringUtils::DateStringToYYYYMMDD(const std::string &dateString)
 {
   std::vector<std::string> days = StringUtils::Split(dateString, '-');
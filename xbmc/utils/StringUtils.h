@@ -104,6 +104,14 @@ public:
   static std::vector<std::string> Split(const std::string& input, const char delimiter, size_t iMaxStrings = 0);
   static int FindNumber(const std::string& strInput, const std::string &strFind);
   static int64_t AlphaNumericCompare(const wchar_t *left, const wchar_t *right);
+  /*! \brief Generates a binary collation key of a string for sorting.
+   Comparing two keys byte-wise (e.g. std::string::compare) gives the same order as
+   AlphaNumericCompare() on the strings, so the (costly) key is computed once per item
+   instead of the comparison being done O(n log n) times.
+   \param str the string to generate the key for.
+   \return the collation key, only valid for the current system locale.
+   */
+  static std::string AlphaNumericCollationKey(const wchar_t *str);
   static long TimeStringToSeconds(const std::string &timeString);
   static void RemoveCRLF(std::string& strLine);
 
@@ -0,0 +1,59 @@
+/*
+ *      Copyright (C) 2005-2015 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/InternedString.h"
+
+#include "gtest/gtest.h"
+
+TEST(TestInternedString, General)
+{
+  CInternedString empty;
+  EXPECT_TRUE(empty.empty());
+  EXPECT_EQ(0U, empty.size());
+  EXPECT_STREQ("", empty.Get().c_str());
+
+  CInternedString a(std::string("DefaultVideo.png"));
+  CInternedString b;
+  b = std::string("DefaultVideo.png");
+  EXPECT_FALSE(a.empty());
+  EXPECT_TRUE(a == "DefaultVideo.png");
+  EXPECT_TRUE(a != "DefaultFolder.png");
+
+  // equal strings share their storage
+  EXPECT_EQ(&a.Get(), &b.Get());
+
+  b = std::string("DefaultFolder.png");
+  EXPECT_NE(&a.Get(), &b.Get());
+  EXPECT_STREQ("DefaultVideo.png", a.Get().c_str());
+  EXPECT_STREQ("DefaultFolder.png", b.Get().c_str());
+
+  b.clear();
+  EXPECT_TRUE(b.empty());
+}
+
+TEST(TestInternedString, Release)
+{
+  {
+    CInternedString a(std::string("TestInternedString.Release"));
+  }
+  // the value is gone from the pool, and added again on demand
+  CInternedString b(std::string("TestInternedString.Release"));
+  EXPECT_STREQ("TestInternedString.Release", b.Get().c_str());
+}
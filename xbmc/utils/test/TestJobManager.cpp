@@ -22,6 +22,10 @@
 #include "settings/Settings.h"
 #include "utils/SystemInfo.h"
 
+#ifdef TARGET_POSIX
+#include "../linux/XTimeUtils.h"
+#endif
+
 #include "gtest/gtest.h"
 
 /* CSysInfoJob::GetInternetState() will test for network connectivity. */
@@ -177,3 +181,102 @@ TEST_F(TestJobManager, IsProcessing)
 
   job->FinishAndStopBlocking();
 }
+
+TEST_F(TestJobManager, Statistics)
+{
+  unsigned int completed = CJobManager::GetInstance().GetStatistics(CJob::PRIORITY_HIGH).completed;
+
+  JobControlPackage package;
+  BroadcastingJob *job (WaitForJobToStartProcessing(CJob::PRIORITY_HIGH, package));
+  job->FinishAndStopBlocking();
+
+  // counters are updated before the job stops processing
+  for (int i = 0; i < 100 && CJobManager::GetInstance().IsProcessing(CJob::PRIORITY_HIGH); ++i)
+    Sleep(10);
+
+  EXPECT_EQ(completed + 1, CJobManager::GetInstance().GetStatistics(CJob::PRIORITY_HIGH).completed);
+}
+
+namespace
+{
+class ResultJob : public CJob
+{
+public:
+  ResultJob(bool result) : m_result(result) {}
+  const char *GetType() const { return "ResultJob"; }
+  bool DoWork() { return m_result; }
+private:
+  bool m_result;
+};
+
+class CompletionCounter : public IJobCallback
+{
+public:
+  CompletionCounter() : m_succeeded(0), m_failed(0) {}
+
+  void OnJobComplete(unsigned int jobID, bool success, CJob *job)
+  {
+    CSingleLock lock(m_section);
+    if (success)
+      m_succeeded++;
+    else
+      m_failed++;
+  }
+
+  bool WaitFor(unsigned int completed)
+  {
+    for (int i = 0; i < 100; ++i)
+    {
+      {
+        CSingleLock lock(m_section);
+        if (m_succeeded + m_failed >= completed)
+          return true;
+      }
+      Sleep(10);
+    }
+    return false;
+  }
+
+  CCriticalSection m_section;
+  unsigned int m_succeeded;
+  unsigned int m_failed;
+};
+}
+
+TEST_F(TestJobManager, Continuation)
+{
+  CompletionCounter counter;
+
+  std::vector<unsigned int> jobs;
+  jobs.push_back(CJobManager::GetInstance().AddJob(new ResultJob(true), &counter));
+  jobs.push_back(CJobManager::GetInstance().AddJob(new ResultJob(true), &counter));
+  unsigned int join = CJobManager::GetInstance().AddJoin(new ResultJob(true), jobs, &counter);
+  EXPECT_NE(0U, join);
+  CJobManager::GetInstance().AddContinuation(join, new ResultJob(true), &counter);
+  ASSERT_TRUE(counter.WaitFor(4));
+
+  CSingleLock lock(counter.m_section);
+  EXPECT_EQ(4U, counter.m_succeeded);
+  EXPECT_EQ(0U, counter.m_failed);
+}
+
+TEST_F(TestJobManager, ContinuationOfFailedJob)
+{
+  CompletionCounter counter;
+
+  // hold the failing job back until we've added its continuations
+  CJobManager::GetInstance().PauseJobs();
+  std::vector<unsigned int> jobs;
+  jobs.push_back(CJobManager::GetInstance().AddJob(new ResultJob(true), &counter));
+  jobs.push_back(CJobManager::GetInstance().AddJob(new ResultJob(false), &counter, CJob::PRIORITY_LOW_PAUSABLE));
+  unsigned int join = CJobManager::GetInstance().AddJoin(new ResultJob(true), jobs, &counter);
+  CJobManager::GetInstance().AddContinuation(join, new ResultJob(true), &counter);
+  CJobManager::GetInstance().UnPauseJobs();
+
+  // the join and its continuation fail without being run
+  ASSERT_TRUE(counter.WaitFor(4));
+
+  CSingleLock lock(counter.m_section);
+  EXPECT_EQ(1U, counter.m_succeeded);
+  EXPECT_EQ(3U, counter.m_failed);
+}
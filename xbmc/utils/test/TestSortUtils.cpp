@@ -19,6 +19,7 @@
  */
 
 #include "utils/SortUtils.h"
+#include "utils/StringUtils.h"
 #include "utils/Variant.h"
 
 #include "gtest/gtest.h"
@@ -115,6 +116,63 @@ TEST(TestSortUtils, Sort_SortDescription)
   EXPECT_STREQ("R Artist", (*items.at(6))[FieldArtist].asString().c_str());
 }
 
+TEST(TestSortUtils, Sort_Limit)
+{
+  SortItems items;
+  for (int i = 0; i < 100; i++)
+  {
+    SortItemPtr item(new SortItem());
+    (*item)[FieldLabel] = StringUtils::Format("Item %02i", (i * 37) % 50);
+    (*item)[FieldId] = i;
+    items.push_back(item);
+  }
+
+  SortUtils::Sort(SortByLabel, SortOrderAscending, SortAttributeNone, items, 6, 2);
+
+  // items with equal labels keep their original order
+  ASSERT_EQ((size_t)4, items.size());
+  EXPECT_STREQ("Item 01", (*items.at(0))[FieldLabel].asString().c_str());
+  EXPECT_EQ(23, (*items.at(0))[FieldId].asInteger());
+  EXPECT_STREQ("Item 01", (*items.at(1))[FieldLabel].asString().c_str());
+  EXPECT_EQ(73, (*items.at(1))[FieldId].asInteger());
+  EXPECT_STREQ("Item 02", (*items.at(2))[FieldLabel].asString().c_str());
+  EXPECT_EQ(46, (*items.at(2))[FieldId].asInteger());
+  EXPECT_STREQ("Item 02", (*items.at(3))[FieldLabel].asString().c_str());
+  EXPECT_EQ(96, (*items.at(3))[FieldId].asInteger());
+}
+
+TEST(TestSortUtils, Sort_Large)
+{
+  DatabaseResults items;
+  for (int i = 0; i < 50000; i++)
+  {
+    DatabaseResult item;
+    item[FieldLabel] = StringUtils::Format("Item %i", (i * 7919) % 1000);
+    item[FieldFolder] = i % 3 == 0;
+    item[FieldId] = i;
+    items.push_back(item);
+  }
+
+  SortUtils::Sort(SortByLabel, SortOrderDescending, SortAttributeNone, items);
+
+  ASSERT_EQ((size_t)50000, items.size());
+  for (size_t i = 1; i < items.size(); i++)
+  {
+    const DatabaseResult &previous = items[i - 1];
+    const DatabaseResult &current = items[i];
+    bool previousFolder = previous.at(FieldFolder).asBoolean();
+    bool currentFolder = current.at(FieldFolder).asBoolean();
+    // folders first, then descending by label with equal labels in their original order
+    ASSERT_TRUE(previousFolder || !currentFolder);
+    if (previousFolder != currentFolder)
+      continue;
+    int result = StringUtils::AlphaNumericCompare(previous.at(FieldSort).asWideString().c_str(), current.at(FieldSort).asWideString().c_str());
+    ASSERT_GE(result, 0);
+    if (result == 0)
+      ASSERT_LT(previous.at(FieldId).asInteger(), current.at(FieldId).asInteger());
+  }
+}
+
 TEST(TestSortUtils, GetFieldsForSorting)
 {
   Fields fields;
@@ -18,7 +18,9 @@
  *
  */
 
+#include "test/TestUtils.h"
 #include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
 #include <algorithm>
 
 #include "gtest/gtest.h"
@@ -313,6 +315,70 @@ TEST(TestStringUtils, AlphaNumericCompare)
   EXPECT_LT(var, ref);
 }
 
+TEST(TestStringUtils, AlphaNumericCollationKey)
+{
+  const wchar_t *strings[] = { L"123abc", L"abc123", L"abc12", L"ABC123", L"abc0123", L"abc",
+                               L"abc 2", L"abc 10", L"The abc", L"the Abc", L"x-ray", L"x ray",
+                               L"1234567890123456789", L"1234567890123456", L"" };
+  const size_t count = sizeof(strings) / sizeof(strings[0]);
+
+  for (size_t i = 0; i < count; i++)
+  {
+    for (size_t j = 0; j < count; j++)
+    {
+      int64_t ref = StringUtils::AlphaNumericCompare(strings[i], strings[j]);
+      int var = StringUtils::AlphaNumericCollationKey(strings[i]).compare(StringUtils::AlphaNumericCollationKey(strings[j]));
+      EXPECT_EQ(ref < 0, var < 0) << strings[i] << " / " << strings[j];
+      EXPECT_EQ(ref > 0, var > 0) << strings[i] << " / " << strings[j];
+    }
+  }
+}
+
+/* Benchmark rather than test, run with --gtest_also_run_disabled_tests: sorting by collation
+   key against sorting with AlphaNumericCompare, reported as test properties. */
+TEST(TestStringUtils, DISABLED_AlphaNumericCollationKeyBenchmark)
+{
+  const wchar_t *articles[] = { L"", L"The ", L"A ", L"An " };
+  const wchar_t *words[] = { L"Star", L"Matrix", L"Part", L"Episode", L"Night", L"Love", L"war", L"Day" };
+  std::vector<std::wstring> titles;
+  CTestRandom random(1);
+  for (int i = 0; i < 100000; i++)
+  {
+    std::wstring title = articles[random.Next(4)];
+    title += words[random.Next(8)];
+    title += L" ";
+    title += words[random.Next(8)];
+    title += L" " + std::to_wstring(random.Next(150));
+    titles.push_back(title);
+  }
+
+  std::vector<std::wstring> compared(titles);
+  int64_t start = CurrentHostCounter();
+  std::stable_sort(compared.begin(), compared.end(), [](const std::wstring &left, const std::wstring &right)
+  {
+    return StringUtils::AlphaNumericCompare(left.c_str(), right.c_str()) < 0;
+  });
+  int64_t compareTime = CurrentHostCounter() - start;
+
+  start = CurrentHostCounter();
+  std::vector<std::pair<std::string, size_t> > keys;
+  keys.reserve(titles.size());
+  for (size_t i = 0; i < titles.size(); i++)
+    keys.push_back(std::make_pair(StringUtils::AlphaNumericCollationKey(titles[i].c_str()), i));
+  std::stable_sort(keys.begin(), keys.end(), [](const std::pair<std::string, size_t> &left, const std::pair<std::string, size_t> &right)
+  {
+    return left.first < right.first;
+  });
+  int64_t keyTime = CurrentHostCounter() - start;
+
+  for (size_t i = 0; i < titles.size(); i++)
+    ASSERT_EQ(compared[i], titles[keys[i].second]);
+
+  int64_t frequency = CurrentHostFrequency();
+  RecordProperty("CompareSortMs", (int)(compareTime * 1000 / frequency));
+  RecordProperty("CollationKeySortMs", (int)(keyTime * 1000 / frequency));
+}
+
 TEST(TestStringUtils, TimeStringToSeconds)
 {
   EXPECT_EQ(77455, StringUtils::TimeStringToSeconds("21:30:55"));
@@ -111,6 +111,9 @@ void CVideoDatabase::CreateTables()
   CLog::Log(LOGINFO, "create stacktimes table");
   m_pDS->exec("CREATE TABLE stacktimes (idFile integer, times text)\n");
 
+  CLog::Log(LOGINFO, "create seekindex table");
+  m_pDS->exec("CREATE TABLE seekindex (idFile integer, fileSize bigint, entries text)\n");
+
   CLog::Log(LOGINFO, "create genre table");
   m_pDS->exec("CREATE TABLE genre ( genre_id integer primary key, name TEXT)\n");
   m_pDS->exec("CREATE TABLE genre_link (genre_id integer, media_id integer, media_type TEXT)");
@@ -233,6 +236,7 @@ void CVideoDatabase::CreateAnalytics()
   m_pDS->exec("CREATE INDEX ix_bookmark ON bookmark (idFile, type)");
   m_pDS->exec("CREATE UNIQUE INDEX ix_settings ON settings ( idFile )\n");
   m_pDS->exec("CREATE UNIQUE INDEX ix_stacktimes ON stacktimes ( idFile )\n");
+  m_pDS->exec("CREATE UNIQUE INDEX ix_seekindex ON seekindex ( idFile )\n");
   m_pDS->exec("CREATE INDEX ix_path ON path ( strPath(255) )");
   m_pDS->exec("CREATE INDEX ix_path2 ON path ( idParentPath )");
   m_pDS->exec("CREATE INDEX ix_files ON files ( idPath, strFilename(255) )");
@@ -326,6 +330,7 @@ void CVideoDatabase::CreateAnalytics()
               "DELETE FROM bookmark WHERE idFile=old.idFile; "
               "DELETE FROM settings WHERE idFile=old.idFile; "
               "DELETE FROM stacktimes WHERE idFile=old.idFile; "
+              "DELETE FROM seekindex WHERE idFile=old.idFile; "
               "DELETE FROM streamdetails WHERE idFile=old.idFile; "
               "END");
 
@@ -4096,6 +4101,81 @@ void CVideoDatabase::SetStackTimes(const std::string& filePath, const std::vecto
   }
 }
 
+bool CVideoDatabase::GetSeekIndex(const std::string &filePath, int64_t fileSize, std::map<int, int64_t> &index)
+{
+  try
+  {
+    int idFile = GetFileId(filePath);
+    if (idFile < 0) return false;
+    if (NULL == m_pDB.get()) return false;
+    if (NULL == m_pDS.get()) return false;
+
+    std::string strSQL = PrepareSQL("select fileSize, entries from seekindex where idFile=%i\n", idFile);
+    m_pDS->query(strSQL.c_str());
+    index.clear();
+    // the index is useless if the file changed since
+    if (m_pDS->num_rows() > 0 && m_pDS->fv("fileSize").get_asInt64() == fileSize)
+    {
+      // entries are stored as differences to the previous entry
+      int time = 0;
+      int64_t pos = 0;
+      std::vector<std::string> entries = StringUtils::Split(m_pDS->fv("entries").get_asString(), ";");
+      for (std::vector<std::string>::const_iterator i = entries.begin(); i != entries.end(); ++i)
+      {
+        std::vector<std::string> entry = StringUtils::Split(*i, ",");
+        if (entry.size() != 2)
+          continue;
+        time += atoi(entry[0].c_str());
+        pos += strtoll(entry[1].c_str(), NULL, 10);
+        index[time] = pos;
+      }
+    }
+    m_pDS->close();
+    return !index.empty();
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s (%s) failed", __FUNCTION__, filePath.c_str());
+  }
+  return false;
+}
+
+void CVideoDatabase::SetSeekIndex(const std::string &filePath, int64_t fileSize, const std::map<int, int64_t> &index)
+{
+  try
+  {
+    if (NULL == m_pDB.get()) return ;
+    if (NULL == m_pDS.get()) return ;
+    // files that aren't in the database don't get an entry just for the index
+    int idFile = GetFileId(filePath);
+    if (idFile < 0)
+      return;
+
+    // delete any existing index
+    m_pDS->exec(PrepareSQL("delete from seekindex where idFile=%i", idFile));
+    if (index.empty())
+      return;
+
+    std::string entries;
+    int time = 0;
+    int64_t pos = 0;
+    for (std::map<int, int64_t>::const_iterator i = index.begin(); i != index.end(); ++i)
+    {
+      if (!entries.empty())
+        entries += ";";
+      entries += StringUtils::Format("%i,%" PRId64, i->first - time, i->second - pos);
+      time = i->first;
+      pos = i->second;
+    }
+
+    m_pDS->exec(PrepareSQL("insert into seekindex (idFile,fileSize,entries) values (%i,%" PRId64 ",'%s')\n", idFile, fileSize, entries.c_str()));
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s (%s) failed", __FUNCTION__, filePath.c_str());
+  }
+}
+
 void CVideoDatabase::RemoveContentForPath(const std::string& strPath, CGUIDialogProgress *progress /* = NULL */)
 {
   if(URIUtils::IsMultiPath(strPath))
@@ -4602,11 +4682,14 @@ void CVideoDatabase::UpdateTables(int iVersion)
     m_pDS->exec("ALTER TABLE tvshow ADD userrating integer");
     m_pDS->exec("ALTER TABLE musicvideo ADD userrating integer");
   }
+
+  if (iVersion < 97)
+    m_pDS->exec("CREATE TABLE seekindex (idFile integer, fileSize bigint, entries text)\n");
 }
 
 int CVideoDatabase::GetSchemaVersion() const
 {
-  return 96;
+  return 97;
 }
 
 bool CVideoDatabase::LookupByFolders(const std::string &path, bool shows)
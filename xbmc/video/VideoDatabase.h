@@ -25,6 +25,7 @@
 #include "utils/SortUtils.h"
 #include "video/VideoDbUrl.h"
 
+#include <map>
 #include <memory>
 #include <set>
 
@@ -556,6 +557,21 @@ public:
   bool GetStackTimes(const std::string &filePath, std::vector<int> &times);
   void SetStackTimes(const std::string &filePath, const std::vector<int> &times);
 
+  /*! \brief Get the keyframe index stored for a file by the demuxer
+   \param filePath path of the file
+   \param fileSize size of the file, the index is only returned if it was stored for the same size
+   \param index keyframe time in ms to byte position
+   \return true if an index was found
+   */
+  bool GetSeekIndex(const std::string &filePath, int64_t fileSize, std::map<int, int64_t> &index);
+  /*! \brief Store the keyframe index of a file, replacing the stored one
+   The index is only stored for files that are in the database already.
+   \param filePath path of the file
+   \param fileSize size of the file
+   \param index keyframe time in ms to byte position, an empty index removes the stored one
+   */
+  void SetSeekIndex(const std::string &filePath, int64_t fileSize, const std::map<int, int64_t> &index);
+
   void GetBookMarksForFile(const std::string& strFilenameAndPath, VECBOOKMARKS& bookmarks, CBookmark::EType type = CBookmark::STANDARD, bool bAppend=false, long partNumber=0);
   void AddBookMarkToFile(const std::string& strFilenameAndPath, const CBookmark &bookmark, CBookmark::EType type = CBookmark::STANDARD);
   bool GetResumeBookMark(const std::string& strFilenameAndPath, CBookmark &bookmark);
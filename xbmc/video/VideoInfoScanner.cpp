@@ -18,6 +18,11 @@
  *
  */
 
+#include <map>
+
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+#include "threads/SingleLock.h"
 #include "threads/SystemClock.h"
 #include "FileItem.h"
 #include "VideoInfoScanner.h"
@@ -45,6 +50,7 @@
 #include "guilib/LocalizeStrings.h"
 #include "guilib/GUIWindowManager.h"
 #include "utils/log.h"
+#include "utils/JobManager.h"
 #include "utils/URIUtils.h"
 #include "utils/Variant.h"
 #include "video/VideoLibraryQueue.h"
@@ -59,8 +65,145 @@ using namespace KODI::MESSAGING;
 
 using KODI::MESSAGING::HELPERS::DialogResponse;
 
+// maximum time a batch of database writes may stay open before it is committed
+#define SCANNER_BATCH_TIME 1000
+
 namespace VIDEO
 {
+  /*! \brief Lists folders on the job manager while the scanner is busy with the database and scrapers.
+   The listing jobs only touch the filesystem and share their results with the scanner through
+   a reference counted state, so they may outlive both the prefetcher and the scanner.
+   */
+  class CDirectoryPrefetcher
+  {
+  public:
+    CDirectoryPrefetcher(unsigned int threads, unsigned int maxPending)
+      : m_state(new CState), m_queue(false, threads, CJob::PRIORITY_LOW), m_maxPending(maxPending)
+    {
+    }
+
+    ~CDirectoryPrefetcher()
+    {
+      Cancel();
+    }
+
+    /*! \brief Queue a folder for listing
+     \return false if too many listings are pending already, true otherwise
+     */
+    bool Prefetch(const std::string &directory, const std::string &dbHash, const std::vector<std::string> &excludes)
+    {
+      CSingleLock lock(m_state->m_section);
+      if (m_state->m_entries.find(directory) != m_state->m_entries.end())
+        return true;
+      if (m_state->m_entries.size() >= m_maxPending)
+        return false;
+
+      EntryPtr entry(new CEntry);
+      m_state->m_entries.insert(std::make_pair(directory, entry));
+      m_queue.AddJob(new CPrefetchJob(m_state, entry, directory, dbHash, excludes));
+      return true;
+    }
+
+    /*! \brief Retrieve the listing of a prefetched folder, waiting for it if it is being listed
+     A listing that hasn't started yet is dropped so that the caller can list the folder itself.
+     \return true if the prefetched listing was retrieved, false otherwise
+     */
+    bool Take(const std::string &directory, CFileItemList &items, std::string &hash, std::string &fastHash)
+    {
+      EntryPtr entry;
+      {
+        CSingleLock lock(m_state->m_section);
+        std::map<std::string, EntryPtr>::iterator it = m_state->m_entries.find(directory);
+        if (it == m_state->m_entries.end())
+          return false;
+        entry = it->second;
+        m_state->m_entries.erase(it);
+        if (entry->m_status == CEntry::QUEUED)
+        {
+          entry->m_status = CEntry::DROPPED;
+          return false;
+        }
+      }
+
+      entry->m_done.Wait();
+      items.Assign(entry->m_items);
+      hash = entry->m_hash;
+      fastHash = entry->m_fastHash;
+      return true;
+    }
+
+    void Cancel()
+    {
+      m_queue.CancelJobs();
+
+      CSingleLock lock(m_state->m_section);
+      for (std::map<std::string, EntryPtr>::iterator it = m_state->m_entries.begin(); it != m_state->m_entries.end(); ++it)
+        it->second->m_status = CEntry::DROPPED;
+      m_state->m_entries.clear();
+    }
+
+  private:
+    class CEntry
+    {
+    public:
+      enum STATUS { QUEUED, RUNNING, DROPPED };
+
+      CEntry() : m_status(QUEUED), m_done(true) {}
+
+      STATUS m_status;
+      CEvent m_done;
+      CFileItemList m_items;
+      std::string m_hash;
+      std::string m_fastHash;
+    };
+    typedef std::shared_ptr<CEntry> EntryPtr;
+
+    class CState
+    {
+    public:
+      CCriticalSection m_section;
+      std::map<std::string, EntryPtr> m_entries;
+    };
+    typedef std::shared_ptr<CState> StatePtr;
+
+    class CPrefetchJob : public CJob
+    {
+    public:
+      CPrefetchJob(const StatePtr &state, const EntryPtr &entry, const std::string &directory,
+                   const std::string &dbHash, const std::vector<std::string> &excludes)
+        : m_state(state), m_entry(entry), m_directory(directory), m_dbHash(dbHash), m_excludes(excludes)
+      {
+      }
+
+      virtual const char *GetType() const { return "videoscannerprefetch"; }
+      virtual bool IsIOBound() const { return true; }
+
+      virtual bool DoWork()
+      {
+        {
+          CSingleLock lock(m_state->m_section);
+          if (m_entry->m_status != CEntry::QUEUED)
+            return false;
+          m_entry->m_status = CEntry::RUNNING;
+        }
+
+        CVideoInfoScanner::FetchDirectory(m_directory, m_dbHash, m_excludes, m_entry->m_items, m_entry->m_hash, m_entry->m_fastHash);
+        m_entry->m_done.Set();
+        return true;
+      }
+
+    private:
+      StatePtr m_state;
+      EntryPtr m_entry;
+      std::string m_directory;
+      std::string m_dbHash;
+      std::vector<std::string> m_excludes;
+    };
+
+    StatePtr m_state;
+    CJobQueue m_queue;
+    unsigned int m_maxPending;
+  };
 
   CVideoInfoScanner::CVideoInfoScanner()
   {
@@ -112,6 +255,10 @@ namespace VIDEO
 
       m_database.Open();
 
+      if (g_advancedSettings.m_iVideoScannerPrefetchThreads > 0)
+        m_prefetcher.reset(new CDirectoryPrefetcher(g_advancedSettings.m_iVideoScannerPrefetchThreads,
+                                                    4 * g_advancedSettings.m_iVideoScannerPrefetchThreads));
+
       m_bCanInterrupt = true;
 
       CLog::Log(LOGNOTICE, "VideoInfoScanner: Starting scan ..");
@@ -162,6 +309,8 @@ namespace VIDEO
         }
       }
 
+      m_prefetcher.reset();
+
       g_infoManager.ResetLibraryBools();
       m_database.Close();
 
@@ -172,6 +321,7 @@ namespace VIDEO
     {
       CLog::Log(LOGERROR, "VideoInfoScanner: Exception while scanning.");
     }
+    m_prefetcher.reset();
     
     m_bRunning = false;
     ANNOUNCEMENT::CAnnouncementManager::GetInstance().Announce(ANNOUNCEMENT::VideoLibrary, "xbmc", "OnScanFinished");
@@ -260,6 +410,10 @@ namespace VIDEO
     bool foundDirectly = false;
     bool bSkip = false;
 
+    // pick up the listing if it has been prefetched while scanning the parent folder
+    std::string hash, fastHash;
+    bool prefetched = m_prefetcher && m_prefetcher->Take(strDirectory, items, hash, fastHash);
+
     SScanSettings settings;
     ScraperPtr info = m_database.GetScraperForPath(strDirectory, settings, foundDirectly);
     CONTENT_TYPE content = info ? info->Content() : CONTENT_NONE;
@@ -281,7 +435,7 @@ namespace VIDEO
     if (content == CONTENT_NONE || ignoreFolder)
       return true;
 
-    std::string hash, dbHash;
+    std::string dbHash;
     if (content == CONTENT_MOVIES ||content == CONTENT_MUSICVIDEOS)
     {
       if (m_handle)
@@ -290,25 +444,9 @@ namespace VIDEO
         m_handle->SetTitle(StringUtils::Format(g_localizeStrings.Get(str).c_str(), info->Name().c_str()));
       }
 
-      std::string fastHash;
-      if (g_advancedSettings.m_bVideoLibraryUseFastHash)
-        fastHash = GetFastHash(strDirectory, regexps);
-
-      if (m_database.GetPathHash(strDirectory, dbHash) && !fastHash.empty() && fastHash == dbHash)
-      { // fast hashes match - no need to process anything
-        hash = fastHash;
-      }
-      else
-      { // need to fetch the folder
-        CDirectory::GetDirectory(strDirectory, items, g_advancedSettings.m_videoExtensions);
-        items.Stack();
-
-        // check whether to re-use previously computed fast hash
-        if (!CanFastHash(items, regexps) || fastHash.empty())
-          GetPathHash(items, hash);
-        else
-          hash = fastHash;
-      }
+      m_database.GetPathHash(strDirectory, dbHash);
+      if (!prefetched)
+        FetchDirectory(strDirectory, dbHash, regexps, items, hash, fastHash);
 
       if (hash == dbHash)
       { // hash matches - skipping
@@ -333,6 +471,8 @@ namespace VIDEO
     }
     else if (content == CONTENT_TVSHOWS)
     {
+      items.Clear();
+      hash.clear();
       if (m_handle)
         m_handle->SetTitle(StringUtils::Format(g_localizeStrings.Get(20319).c_str(), info->Name().c_str()));
 
@@ -384,6 +524,9 @@ namespace VIDEO
     if (m_handle)
       OnDirectoryScanned(strDirectory);
 
+    if (settings.recurse > 0 && content != CONTENT_TVSHOWS)
+      PrefetchDirectories(items);
+
     for (int i = 0; i < items.Size(); ++i)
     {
       CFileItemPtr pItem = items[i];
@@ -421,10 +564,33 @@ namespace VIDEO
 
     m_database.Open();
 
+    // group the writes of several movies and music videos into a single transaction. tvshows are left
+    // alone as the episodes of a single show may take a long time to scrape. The batch is flushed
+    // before every scraper lookup, so the transaction only spans the writes in between.
+    bool batch = content != CONTENT_TVSHOWS && g_advancedSettings.m_iVideoScannerBatchSize > 0;
+    int batchItems = 0;
+    unsigned int batchStart = XbmcThreads::SystemClockMillis();
+    if (batch)
+      m_database.BeginBatch();
+
     bool FoundSomeInfo = false;
     std::vector<int> seenPaths;
     for (int i = 0; i < (int)items.Size(); ++i)
     {
+      if (batch && (batchItems >= g_advancedSettings.m_iVideoScannerBatchSize ||
+                    XbmcThreads::SystemClockMillis() - batchStart >= SCANNER_BATCH_TIME))
+      {
+        if (!m_database.CommitBatch())
+        {
+          FoundSomeInfo = false;
+          batch = false;
+          break;
+        }
+        m_database.BeginBatch();
+        batchItems = 0;
+        batchStart = XbmcThreads::SystemClockMillis();
+      }
+
       m_nfoReader.Close();
       CFileItemPtr pItem = items[i];
 
@@ -465,6 +631,8 @@ namespace VIDEO
         FoundSomeInfo = false;
         break;
       }
+      if (ret == INFO_ADDED)
+        batchItems++;
       if (ret == INFO_ADDED || ret == INFO_HAVE_ALREADY)
         FoundSomeInfo = true;
       else if (ret == INFO_NOT_FOUND)
@@ -489,6 +657,10 @@ namespace VIDEO
         seenPaths.push_back(m_database.GetPathId(pItem->GetPath()));
     }
 
+    // a rolled back batch drops what was added before the failure, so the folder has to be rescanned
+    if (batch && !m_database.CommitBatch())
+      FoundSomeInfo = false;
+
     if (content == CONTENT_TVSHOWS && ! seenPaths.empty())
     {
       std::vector<std::pair<int, std::string>> libPaths;
@@ -1739,6 +1911,9 @@ namespace VIDEO
     if (m_handle && !url.strTitle.empty())
       m_handle->SetText(url.strTitle);
 
+    // don't keep the database locked while the scraper is busy
+    m_database.FlushBatch();
+
     CVideoInfoDownloader imdb(scraper);
     bool ret = imdb.GetDetails(url, movieDetails, pDialog);
 
@@ -1793,7 +1968,7 @@ namespace VIDEO
     return count;
   }
 
-  bool CVideoInfoScanner::CanFastHash(const CFileItemList &items, const std::vector<std::string> &excludes) const
+  bool CVideoInfoScanner::CanFastHash(const CFileItemList &items, const std::vector<std::string> &excludes)
   {
     if (!g_advancedSettings.m_bVideoLibraryUseFastHash)
       return false;
@@ -1807,7 +1982,7 @@ namespace VIDEO
   }
 
   std::string CVideoInfoScanner::GetFastHash(const std::string &directory,
-      const std::vector<std::string> &excludes) const
+      const std::vector<std::string> &excludes)
   {
     XBMC::XBMC_MD5 md5state;
 
@@ -1829,6 +2004,56 @@ namespace VIDEO
     return "";
   }
 
+  void CVideoInfoScanner::FetchDirectory(const std::string &directory, const std::string &dbHash, const std::vector<std::string> &excludes,
+                                         CFileItemList &items, std::string &hash, std::string &fastHash)
+  {
+    if (g_advancedSettings.m_bVideoLibraryUseFastHash)
+      fastHash = GetFastHash(directory, excludes);
+
+    if (!fastHash.empty() && fastHash == dbHash)
+    { // fast hashes match - no need to process anything
+      hash = fastHash;
+      return;
+    }
+
+    // need to fetch the folder
+    CDirectory::GetDirectory(directory, items, g_advancedSettings.m_videoExtensions);
+    items.Stack();
+
+    // check whether to re-use previously computed fast hash
+    if (!CanFastHash(items, excludes) || fastHash.empty())
+      GetPathHash(items, hash);
+    else
+      hash = fastHash;
+  }
+
+  void CVideoInfoScanner::PrefetchDirectories(const CFileItemList &items)
+  {
+    if (!m_prefetcher)
+      return;
+
+    for (int i = 0; i < items.Size(); ++i)
+    {
+      const CFileItemPtr pItem = items[i];
+      if (!pItem->m_bIsFolder || pItem->IsParentFolder() || pItem->IsPlayList())
+        continue;
+
+      // only movie and music video folders are listed up front, tvshows are enumerated by episode
+      SScanSettings settings;
+      bool foundDirectly = false;
+      ScraperPtr info = m_database.GetScraperForPath(pItem->GetPath(), settings, foundDirectly);
+      if (!info || (info->Content() != CONTENT_MOVIES && info->Content() != CONTENT_MUSICVIDEOS))
+        continue;
+      if ((!m_scanAll && settings.noupdate) || CUtil::ExcludeFileOrFolder(pItem->GetPath(), g_advancedSettings.m_moviesExcludeFromScanRegExps))
+        continue;
+
+      std::string dbHash;
+      m_database.GetPathHash(pItem->GetPath(), dbHash);
+      if (!m_prefetcher->Prefetch(pItem->GetPath(), dbHash, g_advancedSettings.m_moviesExcludeFromScanRegExps))
+        break;
+    }
+  }
+
   std::string CVideoInfoScanner::GetRecursiveFastHash(const std::string &directory,
       const std::vector<std::string> &excludes) const
   {
@@ -2074,6 +2299,10 @@ namespace VIDEO
   int CVideoInfoScanner::FindVideo(const std::string &videoName, const ScraperPtr &scraper, CScraperUrl &url, CGUIDialogProgress *progress)
   {
     MOVIELIST movielist;
+
+    // don't keep the database locked while the scraper is busy
+    m_database.FlushBatch();
+
     CVideoInfoDownloader imdb(scraper);
     int returncode = imdb.FindMovie(videoName, movielist, progress);
     if (returncode < 0 || (returncode == 0 && (m_bStop || !DownloadFailed(progress))))
@@ -18,6 +18,8 @@
  *  <http://www.gnu.org/licenses/>.
  *
  */
+#include <memory>
+
 #include "VideoDatabase.h"
 #include "addons/Scraper.h"
 #include "NfoFile.h"
@@ -28,6 +30,8 @@ class CFileItemList;
 
 namespace VIDEO
 {
+  class CDirectoryPrefetcher;
+
   typedef struct SScanSettings
   {
     SScanSettings() { parent_name = parent_name_root = noupdate = exclude = false; recurse = 1;}
@@ -120,6 +124,18 @@ namespace VIDEO
 
     bool EnumerateEpisodeItem(const CFileItem *item, EPISODELIST& episodeList);
 
+    /*! \brief List and hash a movie or music video folder
+     Only touches the filesystem, so it may be called from outside the scanner thread.
+     \param directory folder to list
+     \param dbHash hash of the folder currently stored in the database
+     \param excludes string array of exclude expressions
+     \param items [out] the stacked directory listing, left empty if the fast hash matches dbHash
+     \param hash [out] the hash of the folder
+     \param fastHash [out] the "fast" hash of the folder, empty if fast hashing is unavailable
+     */
+    static void FetchDirectory(const std::string &directory, const std::string &dbHash, const std::vector<std::string> &excludes,
+                               CFileItemList &items, std::string &hash, std::string &fastHash);
+
   protected:
     virtual void Process();
     bool DoScan(const std::string& strDirectory);
@@ -192,7 +208,7 @@ namespace VIDEO
      \param excludes string array of exclude expressions
      \return the md5 hash of the folder"
      */
-    std::string GetFastHash(const std::string &directory, const std::vector<std::string> &excludes) const;
+    static std::string GetFastHash(const std::string &directory, const std::vector<std::string> &excludes);
 
     /*! \brief Retrieve a "fast" hash of the given directory recursively (if available)
      Performs a stat() on the directory, and uses modified time to create a "fast"
@@ -214,7 +230,13 @@ namespace VIDEO
      \param excludes string array of exclude expressions
      \return true if this directory listing can be fast hashed, false otherwise
      */
-    bool CanFastHash(const CFileItemList &items, const std::vector<std::string> &excludes) const;
+    static bool CanFastHash(const CFileItemList &items, const std::vector<std::string> &excludes);
+
+    /*! \brief Start listing the movie and music video subfolders of a folder ahead of the scan
+     The listings are picked up by DoScan() when it recurses into the subfolders.
+     \param items the directory listing whose subfolders should be prefetched
+     */
+    void PrefetchDirectories(const CFileItemList &items);
 
     /*! \brief Process a series folder, filling in episode details and adding them to the database.
      TODO: Ideally we would return INFO_HAVE_ALREADY if we don't have to update any episodes
@@ -249,6 +271,7 @@ namespace VIDEO
     std::set<std::string> m_pathsToCount;
     std::set<int> m_pathsToClean;
     CNfoFile m_nfoReader;
+    std::unique_ptr<CDirectoryPrefetcher> m_prefetcher;
   };
 }
 
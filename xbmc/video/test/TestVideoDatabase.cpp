@@ -0,0 +1,138 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "settings/AdvancedSettings.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+#include "video/VideoDatabase.h"
+
+#include "gtest/gtest.h"
+
+#include <map>
+
+namespace
+{
+
+const std::string FILE_PATH = "/media/videos/recording.ts";
+const int64_t FILE_SIZE = 3000000000LL;
+
+class CTestVideoDatabase : public CVideoDatabase
+{
+public:
+  // creates or updates the database like on startup and leaves it open
+  using CDatabase::Update;
+  using CVideoDatabase::GetFileId;
+};
+
+}
+
+class TestVideoDatabase : public ::testing::Test
+{
+protected:
+  TestVideoDatabase()
+  {
+    // a database of its own, so earlier runs and the real one don't matter
+    m_settings.type = "sqlite3";
+    m_settings.host = CSpecialProtocol::TranslatePath("special://temp/");
+    m_settings.name = "TestVideoDatabase" + StringUtils::CreateUUID();
+  }
+
+  ~TestVideoDatabase()
+  {
+    XFILE::CFile::Delete(GetFile(96));
+    XFILE::CFile::Delete(GetFile(97));
+  }
+
+  std::string GetFile(int version) const
+  {
+    return URIUtils::AddFileToFolder(m_settings.host, StringUtils::Format("%s%d.db", m_settings.name.c_str(), version));
+  }
+
+  std::map<int, int64_t> GetIndex() const
+  {
+    std::map<int, int64_t> index;
+    index[0] = 0;
+    index[5000] = 1234567;
+    index[10040] = 2500000000LL;
+    index[15120] = 2400000000LL; // positions don't have to grow with time
+    return index;
+  }
+
+  DatabaseSettings m_settings;
+};
+
+TEST_F(TestVideoDatabase, SeekIndex)
+{
+  CTestVideoDatabase db;
+  ASSERT_TRUE(db.Update(m_settings));
+
+  // not stored for files that aren't in the database
+  std::map<int, int64_t> loaded;
+  db.SetSeekIndex(FILE_PATH, FILE_SIZE, GetIndex());
+  EXPECT_FALSE(db.GetSeekIndex(FILE_PATH, FILE_SIZE, loaded));
+  EXPECT_EQ(-1, db.GetFileId(FILE_PATH));
+
+  ASSERT_GE(db.AddFile(FILE_PATH), 0);
+  db.SetSeekIndex(FILE_PATH, FILE_SIZE, GetIndex());
+  EXPECT_TRUE(db.GetSeekIndex(FILE_PATH, FILE_SIZE, loaded));
+  EXPECT_EQ(GetIndex(), loaded);
+
+  // the file changed since
+  EXPECT_FALSE(db.GetSeekIndex(FILE_PATH, FILE_SIZE + 1, loaded));
+  EXPECT_TRUE(loaded.empty());
+
+  // an empty index removes the stored one
+  db.SetSeekIndex(FILE_PATH, FILE_SIZE, std::map<int, int64_t>());
+  EXPECT_FALSE(db.GetSeekIndex(FILE_PATH, FILE_SIZE, loaded));
+
+  db.Close();
+}
+
+TEST_F(TestVideoDatabase, UpdateSeekIndex)
+{
+  // turn a new database into one of version 96, which had no seek index
+  {
+    CTestVideoDatabase db;
+    ASSERT_TRUE(db.Update(m_settings));
+    ASSERT_GE(db.AddFile(FILE_PATH), 0);
+    EXPECT_TRUE(db.ExecuteQuery("DROP TABLE seekindex"));
+    EXPECT_TRUE(db.ExecuteQuery("UPDATE version SET idVersion=96"));
+    db.Close();
+  }
+  ASSERT_TRUE(XFILE::CFile::Rename(GetFile(97), GetFile(96)));
+
+  CTestVideoDatabase db;
+  ASSERT_TRUE(db.Update(m_settings));
+  EXPECT_TRUE(XFILE::CFile::Exists(GetFile(97)));
+  EXPECT_EQ("97", db.GetSingleValue("version", "idVersion"));
+
+  std::map<int, int64_t> loaded;
+  db.SetSeekIndex(FILE_PATH, FILE_SIZE, GetIndex());
+  EXPECT_TRUE(db.GetSeekIndex(FILE_PATH, FILE_SIZE, loaded));
+  EXPECT_EQ(GetIndex(), loaded);
+
+  // removed together with the file
+  EXPECT_TRUE(db.ExecuteQuery(db.PrepareSQL("DELETE FROM files WHERE idFile=%i", db.GetFileId(FILE_PATH))));
+  EXPECT_EQ("0", db.GetSingleValue("SELECT COUNT(*) FROM seekindex"));
+
+  db.Close();
+}
@@ -24,7 +24,7 @@
 #include "settings/lib/Setting.h"
 #include "settings/Settings.h"
 #include "utils/StringUtils.h"
-#if HAS_GLES
+#if defined(HAS_GL) || HAS_GLES
 #include "guilib/GUIFontTTFGL.h"
 #endif
 
@@ -56,7 +56,7 @@ bool CWinSystemBase::InitWindowSystem()
 
 bool CWinSystemBase::DestroyWindowSystem()
 {
-#if HAS_GLES
+#if defined(HAS_GL) || HAS_GLES
   CGUIFontTTFGL::DestroyStaticVertexBuffers();
 #endif
   return false;
@@ -27,6 +27,7 @@
 #include "input/ButtonTranslator.h"
 #include "guilib/GUIControlFactory.h"
 #include "guilib/GUIFontManager.h"
+#include "guilib/GUIFontTTF.h"
 #include "guilib/GUITextLayout.h"
 #include "guilib/GUIWindowManager.h"
 #include "guilib/GUIControlProfiler.h"
@@ -140,6 +141,10 @@ void CGUIWindowDebugInfo::Process(unsigned int currentTime, CDirtyRegionList &di
       g_graphicsContext.SetRenderingResolution(g_graphicsContext.GetResInfo(), false);
     }
     info += StringUtils::Format("Mouse: (%d,%d)  ", (int)point.x, (int)point.y);
+    info += StringUtils::Format("Conditions: %u/%u  ", g_infoManager.GetInfoBoolUpdates(), g_infoManager.GetInfoBoolCount());
+    unsigned int drawCalls, uploadedBytes;
+    CGUIFontTTFBase::GetFrameStats(drawCalls, uploadedBytes);
+    info += StringUtils::Format("Text: %u draws %u KB  ", drawCalls, uploadedBytes / 1024);
     if (window)
     {
       CGUIControl *control = window->GetFocusedControl();